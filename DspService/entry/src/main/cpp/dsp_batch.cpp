@@ -0,0 +1,204 @@
+/**
+ * dsp_batch.cpp — batched multi-job processing over one shared region
+ */
+
+#include "dsp_batch.h"
+#include "dsp_shared_memory.h"
+#include "dsp_processor.h"
+#include "dsp_chain.h"
+#include "dsp_denormals.h"
+#include "dsp_thread_pool.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <sys/mman.h>
+
+namespace DspProcessor {
+
+namespace {
+
+/* Does [offset, offset + len) lie inside [dataOffset, regionSize)? */
+bool rangeInData(uint64_t offset, uint64_t len, uint64_t dataOffset, uint64_t regionSize,
+                 uint64_t align)
+{
+    return offset >= dataOffset
+        && offset % align == 0
+        && offset + len <= regionSize;
+}
+
+bool disjoint(uint64_t a, uint64_t aLen, uint64_t b, uint64_t bLen)
+{
+    return a + aLen <= b || b + bLen <= a;
+}
+
+void storeJobStatus(AudioBatchJob* job, int32_t status, int64_t timeNs)
+{
+    job->processingTimeNs = timeNs;
+    __atomic_store_n(&job->status, status, __ATOMIC_RELEASE);
+}
+
+/**
+ * Run one job in place. @p parallel selects the WorkerPool variants, used
+ * when the jobs themselves run one after another.
+ * @return true on success
+ */
+bool runJob(uint8_t* bytes, AudioBatchJob* shared, uint32_t dataOffset,
+            size_t regionSize, bool parallel)
+{
+    /* Snapshot the descriptor so the host cannot change it mid-job */
+    AudioBatchJob job;
+    std::memcpy(&job, shared, sizeof(job));
+    if (!validateBatchJob(job, dataOffset, regionSize)) {
+        storeJobStatus(shared, AUDIO_STATUS_ERROR, 0);
+        return false;
+    }
+
+    ProcessingChain chain;
+    if (job.chainOffset != 0) {
+        AudioChainDescriptor desc;
+        std::memcpy(&desc, bytes + job.chainOffset, sizeof(desc));
+        if (!chain.configure(desc, job.sampleRate, job.channels, job.frames, bytes, regionSize)) {
+            storeJobStatus(shared, AUDIO_STATUS_ERROR, 0);
+            return false;
+        }
+    }
+    storeJobStatus(shared, AUDIO_STATUS_PROCESSING, 0);
+
+    const PcmView view { bytes + job.inputOffset, bytes + job.outputOffset,
+                         job.format, job.channels, job.frames };
+
+    /* Guard mode per job, as for a single request */
+    const bool guarded = guardRequested(job.flags);
+    FrameGuard guard;
+    auto t0 = std::chrono::steady_clock::now();
+    {
+        DenormalScope fpMode(guarded);
+        processFrames(view, 0, job.frames, job.gain, job.bypass != 0,
+                      (job.flags & AUDIO_FLAG_DITHER) != 0,
+                      job.chainOffset != 0 ? &chain : nullptr, parallel, FrameMeter(),
+                      guarded ? &guard : nullptr);
+    }
+    auto t1 = std::chrono::steady_clock::now();
+
+    if (guarded) {
+        const uint64_t count = guard.count();
+        shared->nonFiniteCount = count > UINT32_MAX ? UINT32_MAX : static_cast<uint32_t>(count);
+        if ((job.flags & AUDIO_FLAG_GUARD_STRICT) && count != 0) {
+            storeJobStatus(shared, AUDIO_STATUS_ERROR, 0);
+            return false;
+        }
+    }
+
+    storeJobStatus(shared, AUDIO_STATUS_DONE,
+                   std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count());
+    return true;
+}
+
+void storeBatchStatus(AudioBatchHeader* hdr, int32_t status, int64_t timeNs, uint32_t failed)
+{
+    hdr->jobsFailed = failed;
+    hdr->processingTimeNs = timeNs;
+    __atomic_store_n(&hdr->status, status, __ATOMIC_RELEASE);
+}
+
+} // namespace
+
+bool validateBatchJob(const AudioBatchJob& job, uint32_t dataOffset, size_t regionSize)
+{
+    const uint32_t bps = audioFormatBytes(job.format);
+    if (bps == 0 || job.channels == 0 || job.frames == 0) {
+        return false;
+    }
+
+    const uint64_t pcmBytes = static_cast<uint64_t>(job.frames) * job.channels * bps;
+    const uint64_t in  = job.inputOffset;
+    const uint64_t out = job.outputOffset;
+    const uint64_t align = sampleAlignment(job.format);
+    if (!rangeInData(in, pcmBytes, dataOffset, regionSize, align)
+        || !rangeInData(out, pcmBytes, dataOffset, regionSize, align)) {
+        return false;
+    }
+    if (in != out && !disjoint(in, pcmBytes, out, pcmBytes)) {
+        return false;
+    }
+
+    if (job.chainOffset != 0) {
+        const uint64_t chain = job.chainOffset;
+        const uint64_t chainBytes = sizeof(AudioChainDescriptor);
+        if (!rangeInData(chain, chainBytes, dataOffset, regionSize, sizeof(float))
+            || !disjoint(chain, chainBytes, in, pcmBytes)
+            || !disjoint(chain, chainBytes, out, pcmBytes)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+BatchProcessResult processBatchRegion(void* base, size_t regionSize)
+{
+    BatchProcessResult result { AUDIO_STATUS_ERROR, 0, 0 };
+    if (!base || regionSize < AUDIO_BATCH_HEADER_SIZE) {
+        return result;
+    }
+
+    auto* bytes = static_cast<uint8_t*>(base);
+    auto* hdr   = reinterpret_cast<AudioBatchHeader*>(bytes);
+
+    /* Snapshot the fields that size the job table */
+    const uint32_t jobCount = hdr->jobCount;
+    const uint32_t flags    = hdr->flags;
+    if (hdr->magic != AUDIO_BATCH_MAGIC || hdr->version != AUDIO_BATCH_VERSION
+        || jobCount == 0 || jobCount > AUDIO_BATCH_MAX_JOBS
+        || audioBatchDataOffset(jobCount) > regionSize) {
+        storeBatchStatus(hdr, AUDIO_STATUS_ERROR, 0, 0);
+        return result;
+    }
+    storeBatchStatus(hdr, AUDIO_STATUS_PROCESSING, 0, 0);
+
+    const uint32_t dataOffset = audioBatchDataOffset(jobCount);
+    auto* jobs = reinterpret_cast<AudioBatchJob*>(bytes + AUDIO_BATCH_HEADER_SIZE);
+    std::atomic<uint32_t> failed { 0 };
+
+    auto t0 = std::chrono::steady_clock::now();
+    if (flags & AUDIO_BATCH_FLAG_PARALLEL) {
+        WorkerPool::instance().parallelFor(jobCount, [&](size_t i) {
+            if (!runJob(bytes, &jobs[i], dataOffset, regionSize, false)) {
+                failed.fetch_add(1, std::memory_order_relaxed);
+            }
+        });
+    } else {
+        for (uint32_t i = 0; i < jobCount; ++i) {
+            if (!runJob(bytes, &jobs[i], dataOffset, regionSize, true)) {
+                failed.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+    }
+    auto t1 = std::chrono::steady_clock::now();
+
+    result.status = AUDIO_STATUS_DONE;
+    result.processingTimeNs =
+        std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count();
+    result.jobsFailed = failed.load(std::memory_order_relaxed);
+    storeBatchStatus(hdr, result.status, result.processingTimeNs, result.jobsFailed);
+    return result;
+}
+
+BatchProcessResult processBatch(int fd, size_t regionSize)
+{
+    BatchProcessResult result { AUDIO_STATUS_ERROR, 0, 0 };
+    if (fd < 0 || regionSize < AUDIO_BATCH_HEADER_SIZE || !regionFitsFd(fd, regionSize)) {
+        return result;
+    }
+
+    void* base = mmap(nullptr, regionSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (base == MAP_FAILED) {
+        return result;
+    }
+
+    result = processBatchRegion(base, regionSize);
+    munmap(base, regionSize);
+    return result;
+}
+
+} // namespace DspProcessor
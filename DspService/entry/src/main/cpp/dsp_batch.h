@@ -0,0 +1,58 @@
+/**
+ * dsp_batch.h — batched multi-job processing over one shared region
+ *
+ * PROCESS_BATCH_CODE hands over a region holding an AudioBatchHeader, a
+ * table of AudioBatchJob descriptors and the PCM of every job. All jobs are
+ * processed in one Binder transaction; each job's status and
+ * processingTimeNs are written back into its own descriptor, so one bad
+ * job does not fail the rest. A job with AUDIO_FLAG_GUARD also gets its
+ * replaced NaN / Inf samples in nonFiniteCount.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "AudioSharedBuffer.h"
+
+namespace DspProcessor {
+
+/** Result returned by processBatch() / processBatchRegion() */
+struct BatchProcessResult {
+    /** AUDIO_STATUS_DONE when the job table was valid, AUDIO_STATUS_ERROR otherwise */
+    int32_t  status;
+    /** Wall-clock duration of the whole batch in nanoseconds */
+    int64_t  processingTimeNs;
+    /** Jobs whose own status is AUDIO_STATUS_ERROR */
+    uint32_t jobsFailed;
+};
+
+/**
+ * Check one job descriptor against the region it lives in: geometry,
+ * 4-byte aligned ranges past the job table, exact or no overlap between
+ * input and output, and an optional chain descriptor clear of both.
+ *
+ * @param job        descriptor (a snapshot, not the shared copy)
+ * @param dataOffset first byte after the job table
+ * @param regionSize total size of the region in bytes
+ */
+bool validateBatchJob(const AudioBatchJob& job, uint32_t dataOffset, size_t regionSize);
+
+/**
+ * Process every job of an already-mapped batch region.
+ * With AUDIO_BATCH_FLAG_PARALLEL the jobs are spread over the WorkerPool;
+ * otherwise they run one after another, each using the pool internally.
+ *
+ * @return batch status and timing; the same values are stored in the header
+ */
+BatchProcessResult processBatchRegion(void* base, size_t regionSize);
+
+/**
+ * Map a batch region fd, process it, and unmap it again.
+ * The fd is not closed; ownership stays with the caller. A @p regionSize
+ * larger than the object behind @p fd is an error (see regionFitsFd()).
+ */
+BatchProcessResult processBatch(int fd, size_t regionSize);
+
+} // namespace DspProcessor
@@ -0,0 +1,132 @@
+/**
+ * dsp_buffer_pool.cpp — recycled PCM buffers for results handed to ArkTS
+ */
+
+#include "dsp_buffer_pool.h"
+
+#include <cstdlib>
+
+namespace DspProcessor {
+
+namespace {
+
+/* Every buffer is preceded by one alignment unit holding its block size */
+constexpr size_t kPrefix = BufferPool::kAlignment;
+
+size_t blockBytes(void* buffer)
+{
+    return *reinterpret_cast<size_t*>(static_cast<uint8_t*>(buffer) - kPrefix);
+}
+
+/* Size class for a request, or -1 when it is served uncached */
+int sizeClass(size_t bytes, size_t& classBytes)
+{
+    classBytes = BufferPool::kMinClassBytes;
+    for (int c = 0; classBytes <= BufferPool::kMaxClassBytes; ++c, classBytes <<= 1) {
+        if (bytes <= classBytes) {
+            return c;
+        }
+    }
+    classBytes = bytes;
+    return -1;
+}
+
+void* allocateBlock(size_t bytes)
+{
+    void* raw = nullptr;
+    if (posix_memalign(&raw, BufferPool::kAlignment, kPrefix + bytes) != 0) {
+        return nullptr;
+    }
+    *static_cast<size_t*>(raw) = bytes;
+    return static_cast<uint8_t*>(raw) + kPrefix;
+}
+
+void freeBlock(void* buffer)
+{
+    std::free(static_cast<uint8_t*>(buffer) - kPrefix);
+}
+
+} // namespace
+
+BufferPool& BufferPool::instance()
+{
+    /* Never destroyed: ArrayBuffer finalizers may still run during exit */
+    static BufferPool* pool = new BufferPool();
+    return *pool;
+}
+
+void* BufferPool::acquire(size_t bytes)
+{
+    if (bytes == 0) {
+        return nullptr;
+    }
+    size_t classBytes = 0;
+    const int c = sizeClass(bytes, classBytes);
+
+    {
+        std::lock_guard<std::mutex> lock(lock_);
+        if (c >= 0 && !free_[c].empty()) {
+            void* buffer = free_[c].back();
+            free_[c].pop_back();
+            cachedBytes_ -= classBytes;
+            ++outstanding_;
+            ++hits_;
+            return buffer;
+        }
+        ++misses_;
+    }
+
+    void* buffer = allocateBlock(classBytes);
+    if (buffer) {
+        std::lock_guard<std::mutex> lock(lock_);
+        ++outstanding_;
+    }
+    return buffer;
+}
+
+void BufferPool::release(void* buffer)
+{
+    if (!buffer) {
+        return;
+    }
+    const size_t bytes = blockBytes(buffer);
+    size_t classBytes = 0;
+    const int c = sizeClass(bytes, classBytes);
+
+    {
+        std::lock_guard<std::mutex> lock(lock_);
+        --outstanding_;
+        if (c >= 0 && classBytes == bytes
+            && free_[c].size() < kMaxCachedPerClass
+            && cachedBytes_ + bytes <= kMaxCachedBytes) {
+            free_[c].push_back(buffer);
+            cachedBytes_ += bytes;
+            return;
+        }
+    }
+    freeBlock(buffer);
+}
+
+BufferPool::Stats BufferPool::stats() const
+{
+    std::lock_guard<std::mutex> lock(lock_);
+    return Stats { hits_, misses_, cachedBytes_, outstanding_ };
+}
+
+void BufferPool::trim()
+{
+    std::vector<void*> victims;
+    {
+        std::lock_guard<std::mutex> lock(lock_);
+        for (auto& list : free_) {
+            victims.insert(victims.end(), list.begin(), list.end());
+            list.clear();
+        }
+        cachedBytes_ = 0;
+    }
+    for (void* buffer : victims) {
+        freeBlock(buffer);
+    }
+}
+
+} // namespace DspProcessor
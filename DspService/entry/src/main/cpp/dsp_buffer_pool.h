@@ -0,0 +1,73 @@
+/**
+ * dsp_buffer_pool.h — recycled PCM buffers for results handed to ArkTS
+ *
+ * Results that native code allocates (processAudio output) are returned as
+ * external ArrayBuffers backed by this pool instead of a fresh
+ * napi_create_arraybuffer + memcpy. When the JS side drops the buffer, the
+ * finalizer puts it back here, so steady-state requests of similar size
+ * neither allocate nor fault in new pages.
+ *
+ * Buffers come in power-of-two size classes from 4 KiB to 64 MiB, 64-byte
+ * aligned. Each class keeps at most kMaxCachedPerClass free buffers and the
+ * pool as a whole at most kMaxCachedBytes; larger requests bypass the cache.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+namespace DspProcessor {
+
+class BufferPool {
+public:
+    static constexpr size_t kAlignment         = 64;
+    static constexpr size_t kMinClassBytes     = size_t(1) << 12;   /* 4 KiB  */
+    static constexpr size_t kMaxClassBytes     = size_t(1) << 26;   /* 64 MiB */
+    static constexpr size_t kMaxCachedPerClass = 4;
+    static constexpr size_t kMaxCachedBytes    = size_t(128) << 20;
+
+    struct Stats {
+        uint64_t hits;          /* acquire() served from the cache         */
+        uint64_t misses;        /* acquire() that had to allocate          */
+        size_t   cachedBytes;   /* bytes held in free lists                */
+        size_t   outstanding;   /* buffers acquired and not yet released   */
+    };
+
+    /** The process-wide pool. */
+    static BufferPool& instance();
+
+    BufferPool(const BufferPool&) = delete;
+    BufferPool& operator=(const BufferPool&) = delete;
+
+    /**
+     * Get a buffer of at least @p bytes (contents undefined).
+     * @return kAlignment-aligned pointer, or nullptr if bytes is 0 or
+     *         allocation fails
+     */
+    void* acquire(size_t bytes);
+
+    /** Return a buffer from acquire(); nullptr is ignored. Thread-safe. */
+    void release(void* buffer);
+
+    Stats stats() const;
+
+    /** Free every cached buffer (e.g. on memory pressure). */
+    void trim();
+
+private:
+    static constexpr size_t kClassCount = 15;   /* 2^12 .. 2^26 */
+
+    BufferPool() = default;
+
+    mutable std::mutex  lock_;
+    std::vector<void*>  free_[kClassCount];
+    size_t              cachedBytes_ = 0;
+    size_t              outstanding_ = 0;
+    uint64_t            hits_        = 0;
+    uint64_t            misses_      = 0;
+};
+
+} // namespace DspProcessor
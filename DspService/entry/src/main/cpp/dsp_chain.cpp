@@ -0,0 +1,414 @@
+/**
+ * dsp_chain.cpp — allocation-free, composable DSP processing chain
+ *
+ * Biquads use the RBJ Audio-EQ-Cookbook designs in transposed direct
+ * form II. The compressor is a feed-forward, channel-linked peak detector
+ * with a soft knee and one-pole attack / release smoothing in the dB domain.
+ * Convolver stages run a PartitionedConvolver over an impulse response
+ * stored in the request's region.
+ */
+
+#include "dsp_chain.h"
+#include "dsp_kernels.h"
+#include "dsp_processor.h"
+#include "dsp_thread_pool.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace DspProcessor {
+
+namespace {
+
+constexpr double kPi = 3.14159265358979323846;
+
+/* One-pole smoothing coefficient for a time constant in milliseconds */
+float timeCoef(float ms, uint32_t sampleRate)
+{
+    if (ms <= 0.0f) {
+        return 0.0f;
+    }
+    return static_cast<float>(std::exp(-1.0 / (static_cast<double>(ms) * 0.001 * sampleRate)));
+}
+
+bool designBiquad(uint32_t shape, double fs, double f0, double q, double gainDb,
+                  float out[5])
+{
+    if (!(f0 > 0.0) || !(f0 < fs * 0.5) || !(q > 0.0)) {
+        return false;
+    }
+    const double w0    = 2.0 * kPi * f0 / fs;
+    const double cw    = std::cos(w0);
+    const double alpha = std::sin(w0) / (2.0 * q);
+    const double a     = std::pow(10.0, gainDb / 40.0);
+    const double sq    = 2.0 * std::sqrt(a) * alpha;
+
+    double b0, b1, b2, a0, a1, a2;
+    switch (shape) {
+        case AUDIO_BIQUAD_LOWPASS:
+            b0 = (1.0 - cw) * 0.5; b1 = 1.0 - cw; b2 = b0;
+            a0 = 1.0 + alpha; a1 = -2.0 * cw; a2 = 1.0 - alpha;
+            break;
+        case AUDIO_BIQUAD_HIGHPASS:
+            b0 = (1.0 + cw) * 0.5; b1 = -(1.0 + cw); b2 = b0;
+            a0 = 1.0 + alpha; a1 = -2.0 * cw; a2 = 1.0 - alpha;
+            break;
+        case AUDIO_BIQUAD_BANDPASS:
+            b0 = alpha; b1 = 0.0; b2 = -alpha;
+            a0 = 1.0 + alpha; a1 = -2.0 * cw; a2 = 1.0 - alpha;
+            break;
+        case AUDIO_BIQUAD_NOTCH:
+            b0 = 1.0; b1 = -2.0 * cw; b2 = 1.0;
+            a0 = 1.0 + alpha; a1 = -2.0 * cw; a2 = 1.0 - alpha;
+            break;
+        case AUDIO_BIQUAD_PEAKING:
+            b0 = 1.0 + alpha * a; b1 = -2.0 * cw; b2 = 1.0 - alpha * a;
+            a0 = 1.0 + alpha / a; a1 = -2.0 * cw; a2 = 1.0 - alpha / a;
+            break;
+        case AUDIO_BIQUAD_LOWSHELF:
+            b0 = a * ((a + 1.0) - (a - 1.0) * cw + sq);
+            b1 = 2.0 * a * ((a - 1.0) - (a + 1.0) * cw);
+            b2 = a * ((a + 1.0) - (a - 1.0) * cw - sq);
+            a0 = (a + 1.0) + (a - 1.0) * cw + sq;
+            a1 = -2.0 * ((a - 1.0) + (a + 1.0) * cw);
+            a2 = (a + 1.0) + (a - 1.0) * cw - sq;
+            break;
+        case AUDIO_BIQUAD_HIGHSHELF:
+            b0 = a * ((a + 1.0) + (a - 1.0) * cw + sq);
+            b1 = -2.0 * a * ((a - 1.0) + (a + 1.0) * cw);
+            b2 = a * ((a + 1.0) + (a - 1.0) * cw - sq);
+            a0 = (a + 1.0) - (a - 1.0) * cw + sq;
+            a1 = 2.0 * ((a - 1.0) - (a + 1.0) * cw);
+            a2 = (a + 1.0) - (a - 1.0) * cw - sq;
+            break;
+        default:
+            return false;
+    }
+
+    out[0] = static_cast<float>(b0 / a0);
+    out[1] = static_cast<float>(b1 / a0);
+    out[2] = static_cast<float>(b2 / a0);
+    out[3] = static_cast<float>(a1 / a0);
+    out[4] = static_cast<float>(a2 / a0);
+    return true;
+}
+
+/* Snapshot and check the AudioImpulseHeader at @p offset, taps included */
+bool loadImpulseHeader(const uint8_t* region, size_t regionSize, uint32_t offset,
+                       uint32_t sampleRate, uint32_t channels, AudioImpulseHeader& ir)
+{
+    if (!region || offset % sizeof(float) != 0
+        || static_cast<uint64_t>(offset) + AUDIO_IR_HEADER_SIZE > regionSize) {
+        return false;
+    }
+    std::memcpy(&ir, region + offset, sizeof(ir));
+    const uint64_t tapBytes = static_cast<uint64_t>(ir.channels) * ir.frames * sizeof(float);
+    return ir.magic == AUDIO_IR_MAGIC
+        && (ir.channels == 1 || ir.channels == channels)
+        && ir.frames != 0 && ir.frames <= AUDIO_IR_MAX_FRAMES
+        && (ir.sampleRate == 0 || ir.sampleRate == sampleRate)
+        && static_cast<uint64_t>(offset) + AUDIO_IR_HEADER_SIZE + tapBytes <= regionSize;
+}
+
+/* params[2] of a convolver stage: 0 or a supported partition length */
+bool validPartition(float frames)
+{
+    if (frames == 0.0f) {
+        return true;
+    }
+    if (!(frames >= PartitionedConvolver::kMinPartition && frames <= PartitionedConvolver::kMaxPartition)) {
+        return false;
+    }
+    const uint32_t b = static_cast<uint32_t>(frames);
+    return static_cast<float>(b) == frames && (b & (b - 1)) == 0;
+}
+
+} // namespace
+
+/* ------------------------------------------------------------------ */
+/*  Configuration                                                       */
+/* ------------------------------------------------------------------ */
+bool ProcessingChain::initStage(Stage& node, const AudioChainStage& stage,
+                                uint32_t sampleRate, uint32_t channels,
+                                const uint8_t* region, size_t regionSize)
+{
+    if (sampleRate == 0 || channels == 0 || channels > kMaxChannels) {
+        return false;
+    }
+    std::memset(&node, 0, sizeof(node));
+    node.type = stage.type;
+    const float* p = stage.params;
+
+    switch (stage.type) {
+        case AUDIO_STAGE_GAIN_SOFTCLIP:
+            node.gain = p[0];
+            return std::isfinite(p[0]);
+
+        case AUDIO_STAGE_BIQUAD: {
+            float c[5];
+            if (!designBiquad(stage.subtype, sampleRate, p[0], p[1], p[2], c)) {
+                return false;
+            }
+            node.biquad.b0 = c[0];
+            node.biquad.b1 = c[1];
+            node.biquad.b2 = c[2];
+            node.biquad.a1 = c[3];
+            node.biquad.a2 = c[4];
+            return true;
+        }
+
+        case AUDIO_STAGE_COMPRESSOR:
+            if (!(p[1] >= 1.0f) || !std::isfinite(p[0]) || !(p[4] >= 0.0f)
+                || !std::isfinite(p[5])) {
+                return false;
+            }
+            node.comp.thresholdDb = p[0];
+            node.comp.slope       = 1.0f / p[1] - 1.0f;
+            node.comp.attackCoef  = timeCoef(p[2], sampleRate);
+            node.comp.releaseCoef = timeCoef(p[3], sampleRate);
+            node.comp.kneeDb      = p[4];
+            node.comp.makeupDb    = p[5];
+            return true;
+
+        case AUDIO_STAGE_DC_BLOCKER:
+            if (!(p[0] > 0.0f) || !(p[0] < sampleRate * 0.5f)) {
+                return false;
+            }
+            node.dc.r = static_cast<float>(std::exp(-2.0 * kPi * p[0] / sampleRate));
+            return true;
+
+        case AUDIO_STAGE_CONVOLVER: {
+            /* Checked only; initConvolver() builds the engine */
+            AudioImpulseHeader ir;
+            return loadImpulseHeader(region, regionSize, stage.subtype, sampleRate, channels, ir)
+                && std::isfinite(p[0]) && std::isfinite(p[1]) && validPartition(p[2]);
+        }
+
+        default:
+            return false;
+    }
+}
+
+void ProcessingChain::resetStage(Stage& node)
+{
+    switch (node.type) {
+        case AUDIO_STAGE_BIQUAD:
+            std::memset(node.biquad.z1, 0, sizeof(node.biquad.z1));
+            std::memset(node.biquad.z2, 0, sizeof(node.biquad.z2));
+            break;
+        case AUDIO_STAGE_COMPRESSOR:
+            node.comp.envDb = 0.0f;
+            break;
+        case AUDIO_STAGE_DC_BLOCKER:
+            std::memset(node.dc.x1, 0, sizeof(node.dc.x1));
+            std::memset(node.dc.y1, 0, sizeof(node.dc.y1));
+            break;
+        case AUDIO_STAGE_CONVOLVER:
+            node.conv->reset();
+            break;
+        default:
+            break;
+    }
+}
+
+bool ProcessingChain::validate(const AudioChainDescriptor& desc, uint32_t sampleRate,
+                               uint32_t channels, const uint8_t* region, size_t regionSize)
+{
+    /* Checked here as well as per stage: an empty chain still sizes the
+       gather block of processFrames() */
+    if (desc.magic != AUDIO_CHAIN_MAGIC || desc.stageCount > kMaxStages
+        || channels == 0 || channels > kMaxChannels) {
+        return false;
+    }
+    Stage scratch;
+    for (uint32_t i = 0; i < desc.stageCount; ++i) {
+        if (!initStage(scratch, desc.stages[i], sampleRate, channels, region, regionSize)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool ProcessingChain::configure(const AudioChainDescriptor& desc, uint32_t sampleRate,
+                                uint32_t channels, uint32_t frames, const uint8_t* region,
+                                size_t regionSize)
+{
+    sampleRate_  = sampleRate;
+    channels_    = channels;
+    blockFrames_ = kernelBlockFrames(channels, frames);
+    kernels_     = &channelKernels(channels);
+    region_      = region;
+    regionSize_  = regionSize;
+    clear();
+    if (!validate(desc, sampleRate, channels, region, regionSize)) {
+        return false;
+    }
+    for (uint32_t i = 0; i < desc.stageCount; ++i) {
+        if (!addStage(desc.stages[i])) {
+            /* only a convolver arena that cannot be allocated gets here */
+            clear();
+            return false;
+        }
+    }
+    return true;
+}
+
+bool ProcessingChain::initConvolver(Stage& node, const AudioChainStage& stage, uint32_t index)
+{
+    /* Snapshot again: the host may have rewritten the header since validate() */
+    AudioImpulseHeader ir;
+    if (!loadImpulseHeader(region_, regionSize_, stage.subtype, sampleRate_, channels_, ir)) {
+        return false;
+    }
+    std::unique_ptr<PartitionedConvolver>& engine = convolvers_[index];
+    if (!engine) {
+        engine = std::make_unique<PartitionedConvolver>();
+    }
+    const uint32_t partition = stage.params[2] != 0.0f
+        ? static_cast<uint32_t>(stage.params[2])
+        : PartitionedConvolver::autoPartition(ir.frames, blockFrames_);
+    const float* taps = reinterpret_cast<const float*>(region_ + stage.subtype + AUDIO_IR_HEADER_SIZE);
+    if (!engine->configure(taps, ir.channels, ir.frames, channels_, partition,
+                           stage.params[0], stage.params[1])) {
+        return false;
+    }
+    node.conv = engine.get();
+    return true;
+}
+
+bool ProcessingChain::addStage(const AudioChainStage& stage)
+{
+    if (count_ >= kMaxStages
+        || !initStage(stages_[count_], stage, sampleRate_, channels_, region_, regionSize_)) {
+        return false;
+    }
+    if (stage.type == AUDIO_STAGE_CONVOLVER && !initConvolver(stages_[count_], stage, count_)) {
+        return false;
+    }
+    ++count_;
+    return true;
+}
+
+void ProcessingChain::clear()
+{
+    count_ = 0;
+}
+
+void ProcessingChain::reset()
+{
+    for (uint32_t i = 0; i < count_; ++i) {
+        resetStage(stages_[i]);
+    }
+}
+
+/* ------------------------------------------------------------------ */
+/*  Processing                                                          */
+/* ------------------------------------------------------------------ */
+bool ProcessingChain::isPerChannel(uint32_t type)
+{
+    return type == AUDIO_STAGE_BIQUAD || type == AUDIO_STAGE_DC_BLOCKER
+        || type == AUDIO_STAGE_CONVOLVER;
+}
+
+void ProcessingChain::process(float* pcm, size_t frames)
+{
+    if (count_ == 0 || channels_ == 0) {
+        return;
+    }
+    const SoftClipKernel softClip = softClipKernel();
+
+    const ChannelKernels& k = *kernels_;
+    const size_t blockFrames = blockFrames_;
+
+    for (size_t done = 0; done < frames; done += blockFrames) {
+        const size_t n = std::min(blockFrames, frames - done);
+        float* block = pcm + done * channels_;
+
+        for (uint32_t s = 0; s < count_; ++s) {
+            Stage& node = stages_[s];
+            switch (node.type) {
+                case AUDIO_STAGE_GAIN_SOFTCLIP:
+                    softClip(block, block, n * channels_, node.gain);
+                    break;
+                case AUDIO_STAGE_BIQUAD:
+                    k.biquad(node.biquad, block, n, channels_);
+                    break;
+                case AUDIO_STAGE_COMPRESSOR:
+                    k.compressor(node.comp, block, n, channels_);
+                    break;
+                case AUDIO_STAGE_DC_BLOCKER:
+                    k.dcBlocker(node.dc, block, n, channels_);
+                    break;
+                case AUDIO_STAGE_CONVOLVER:
+                    node.conv->process(block, n);
+                    break;
+                default:
+                    break;
+            }
+        }
+    }
+}
+
+void ProcessingChain::processStageChannels(Stage& node, float* pcm, size_t frames,
+                                           uint32_t chBegin, uint32_t chEnd)
+{
+    if (node.type == AUDIO_STAGE_BIQUAD) {
+        biquadChannels(node.biquad, pcm, frames, channels_, chBegin, chEnd);
+    } else if (node.type == AUDIO_STAGE_DC_BLOCKER) {
+        dcBlockerChannels(node.dc, pcm, frames, channels_, chBegin, chEnd);
+    } else if (node.type == AUDIO_STAGE_CONVOLVER) {
+        /* Same calls as process() makes: a block that ends mid-partition
+           is transformed zero-padded, so the split decides the rounding */
+        for (size_t done = 0; done < frames; done += blockFrames_) {
+            const size_t n = std::min<size_t>(blockFrames_, frames - done);
+            node.conv->processChannels(pcm + done * channels_, n, chBegin, chEnd);
+        }
+    }
+}
+
+void ProcessingChain::processParallel(float* pcm, size_t frames)
+{
+    const size_t numSamples = frames * channels_;
+    if (count_ == 0 || channels_ == 0) {
+        return;
+    }
+    if (numSamples < 2 * kParallelChunkSamples || WorkerPool::instance().threadCount() < 2) {
+        process(pcm, frames);
+        return;
+    }
+
+    /*
+     * Stages only feed forward, so running each stage over the whole buffer
+     * before the next one is equivalent to the block-major order of process().
+     */
+    WorkerPool& pool = WorkerPool::instance();
+    uint32_t s = 0;
+    while (s < count_) {
+        Stage& node = stages_[s];
+
+        if (node.type == AUDIO_STAGE_GAIN_SOFTCLIP) {
+            processBufferParallel(pcm, pcm, numSamples, node.gain, false);
+            ++s;
+        } else if (isPerChannel(node.type)) {
+            uint32_t end = s;
+            while (end < count_ && isPerChannel(stages_[end].type)) {
+                ++end;
+            }
+            pool.parallelFor(channels_, [&, s, end](size_t c) {
+                const uint32_t ch = static_cast<uint32_t>(c);
+                for (uint32_t k = s; k < end; ++k) {
+                    processStageChannels(stages_[k], pcm, frames, ch, ch + 1);
+                }
+            });
+            s = end;
+        } else if (node.type == AUDIO_STAGE_COMPRESSOR) {
+            kernels_->compressor(node.comp, pcm, frames, channels_);
+            ++s;
+        } else {
+            ++s;
+        }
+    }
+}
+
+} // namespace DspProcessor
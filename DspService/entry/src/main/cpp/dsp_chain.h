@@ -0,0 +1,135 @@
+/**
+ * dsp_chain.h — allocation-free, composable DSP processing chain
+ *
+ * A ProcessingChain owns a fixed array of preallocated stage nodes (biquad
+ * EQ, compressor / limiter, DC blocker, gain + soft clip, IR convolver),
+ * each with its own per-channel state. It is configured once per session
+ * from an AudioChainDescriptor and then processes interleaved float32 PCM
+ * in place, block by block, without touching the heap. Convolver stages
+ * allocate their arena and transform their IR in configure() (see
+ * dsp_convolver.h); the IR is read from the region passed in there.
+ *
+ * The per-channel stages run through the ChannelKernels generated for the
+ * stream's channel count (see dsp_channel_kernels.h); configure() picks
+ * them, and the block length, once from the header geometry.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+#include "AudioSharedBuffer.h"
+#include "dsp_channel_kernels.h"
+#include "dsp_convolver.h"
+
+namespace DspProcessor {
+
+class ProcessingChain {
+public:
+    static constexpr uint32_t kMaxStages   = AUDIO_CHAIN_MAX_STAGES;
+    static constexpr uint32_t kMaxChannels = kStageMaxChannels;
+    /* Frames per format-conversion block handed to process() by processFrames() */
+    static constexpr size_t   kBlockFrames = 256;
+
+    ProcessingChain() = default;
+
+    /**
+     * Build the stage list from a descriptor. Resets all stage state.
+     * @param frames  frames per request if known (header.frames), 0 if not;
+     *                together with channels it selects the block length
+     *                (kernelBlockFrames())
+     * @param region  the mapped region the descriptor came from, where
+     *                AUDIO_STAGE_CONVOLVER stages find their impulse
+     *                response (nullptr: no convolver stages allowed)
+     * @return false if the descriptor or any stage parameter is invalid,
+     *         or channels is 0 or above kMaxChannels (even with no
+     *         stages); the chain is then empty
+     */
+    bool configure(const AudioChainDescriptor& desc, uint32_t sampleRate, uint32_t channels,
+                   uint32_t frames = 0, const uint8_t* region = nullptr, size_t regionSize = 0);
+
+    /**
+     * Append one stage to the current configuration. A convolver stage
+     * reads its IR from the region given to configure(), which must still
+     * be mapped.
+     * @return false if the chain is full or the stage is invalid
+     */
+    bool addStage(const AudioChainStage& stage);
+
+    /** Remove all stages (keeps sampleRate / channels). */
+    void clear();
+
+    /** Zero every stage's filter / envelope state. */
+    void reset();
+
+    /** Process interleaved PCM in place. No allocation, no locking. */
+    void process(float* pcm, size_t frames);
+
+    /**
+     * Same result as process(), bit for bit, using the WorkerPool.
+     * Runs stage by stage over the whole buffer: gain + soft clip is split
+     * into frame-aligned chunks, runs of per-channel stages (biquad, DC
+     * blocker, convolver) are split per channel, and the channel-linked
+     * compressor runs on the calling thread.
+     */
+    void processParallel(float* pcm, size_t frames);
+
+    uint32_t stageCount() const { return count_; }
+    uint32_t channels() const { return channels_; }
+
+    /** Frames all stages run over before moving to the next block. */
+    uint32_t blockFrames() const { return blockFrames_; }
+
+    /** Kernels in use: specialised for the channel count or generic. */
+    const ChannelKernels& kernels() const { return *kernels_; }
+
+    /** Use the generic kernels (benchmarks / equivalence checks). */
+    void forceGenericKernels() { kernels_ = &genericChannelKernels(); }
+
+    /**
+     * Check a descriptor without configuring a chain.
+     * @param region  as for configure()
+     * @return true when magic, stage count, channels (1 ~ kMaxChannels)
+     *         and all stage parameters (impulse responses included) are valid
+     */
+    static bool validate(const AudioChainDescriptor& desc, uint32_t sampleRate, uint32_t channels,
+                         const uint8_t* region = nullptr, size_t regionSize = 0);
+
+private:
+    struct Stage {
+        uint32_t type;
+        float    gain;   /* AUDIO_STAGE_GAIN_SOFTCLIP */
+        union {
+            BiquadState     biquad;
+            CompressorState comp;
+            DcBlockerState  dc;
+            PartitionedConvolver* conv;   /* owned by convolvers_ */
+        };
+    };
+
+    static bool initStage(Stage& node, const AudioChainStage& stage,
+                          uint32_t sampleRate, uint32_t channels,
+                          const uint8_t* region, size_t regionSize);
+    bool initConvolver(Stage& node, const AudioChainStage& stage, uint32_t index);
+    static void resetStage(Stage& node);
+
+    static bool isPerChannel(uint32_t type);
+
+    void processStageChannels(Stage& node, float* pcm, size_t frames,
+                              uint32_t chBegin, uint32_t chEnd);
+
+    Stage    stages_[kMaxStages] {};
+    /* Engines of convolver stages by stage index, kept across configure() */
+    std::unique_ptr<PartitionedConvolver> convolvers_[kMaxStages];
+    const uint8_t* region_ = nullptr;
+    size_t   regionSize_ = 0;
+    uint32_t count_      = 0;
+    uint32_t sampleRate_ = 0;
+    uint32_t channels_   = 0;
+    uint32_t blockFrames_ = static_cast<uint32_t>(kBlockFrames);
+    const ChannelKernels* kernels_ = &genericChannelKernels();
+};
+
+} // namespace DspProcessor
@@ -0,0 +1,256 @@
+/**
+ * dsp_channel_kernels.cpp — per-channel stage kernels specialised at compile time
+ *
+ * Fixed kernels copy coefficients and per-channel state into locals first:
+ * pcm is a float* like the state arrays, so without the copy every store
+ * to pcm would force the compiler to reload them.
+ */
+
+#include "dsp_channel_kernels.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace DspProcessor {
+
+namespace {
+
+/* ------------------------------------------------------------------ */
+/*  Frame bodies shared by the fixed and generic kernels                */
+/* ------------------------------------------------------------------ */
+
+/* Gain for one frame whose channel-linked peak is `peak`; updates env */
+inline float compressorGain(const CompressorState& c, float halfKnee, float& env, float peak)
+{
+    /* Static curve: gain reduction in dB (≤ 0) with a quadratic soft knee */
+    const float levelDb = 20.0f * std::log10(peak + 1e-12f);
+    const float over = levelDb - c.thresholdDb;
+    float target = 0.0f;
+    if (over >= halfKnee) {
+        target = c.slope * over;
+    } else if (over > -halfKnee) {
+        const float t = over + halfKnee;
+        target = c.slope * t * t / (2.0f * c.kneeDb);
+    }
+
+    /* Attack when more reduction is needed, release otherwise */
+    const float coef = target < env ? c.attackCoef : c.releaseCoef;
+    env = target + coef * (env - target);
+
+    return std::pow(10.0f, (env + c.makeupDb) * 0.05f);
+}
+
+/* ------------------------------------------------------------------ */
+/*  Fixed kernels: C channels                                          */
+/* ------------------------------------------------------------------ */
+
+/* Frame-major over n frames; the C recursions are independent */
+template <uint32_t C>
+inline void biquadRun(const float k[5], float* z1, float* z2, float* pcm, size_t n)
+{
+#pragma GCC unroll 4
+    for (size_t i = 0; i < n; ++i, pcm += C) {
+        for (uint32_t c = 0; c < C; ++c) {
+            const float in  = pcm[c];
+            const float out = k[0] * in + z1[c];
+            z1[c] = k[1] * in - k[3] * out + z2[c];
+            z2[c] = k[2] * in - k[4] * out;
+            pcm[c] = out;
+        }
+    }
+}
+
+template <uint32_t C>
+void biquadFixed(BiquadState& s, float* pcm, size_t frames, uint32_t)
+{
+    const float k[5] = { s.b0, s.b1, s.b2, s.a1, s.a2 };
+    float z1[C], z2[C];
+    std::copy(s.z1, s.z1 + C, z1);
+    std::copy(s.z2, s.z2 + C, z2);
+
+    biquadRun<C>(k, z1, z2, pcm, frames);
+
+    std::copy(z1, z1 + C, s.z1);
+    std::copy(z2, z2 + C, s.z2);
+}
+
+template <uint32_t C>
+inline void dcBlockerRun(float r, float* x1, float* y1, float* pcm, size_t n)
+{
+#pragma GCC unroll 4
+    for (size_t i = 0; i < n; ++i, pcm += C) {
+        for (uint32_t c = 0; c < C; ++c) {
+            const float in  = pcm[c];
+            const float out = in - x1[c] + r * y1[c];
+            x1[c] = in;
+            y1[c] = out;
+            pcm[c] = out;
+        }
+    }
+}
+
+template <uint32_t C>
+void dcBlockerFixed(DcBlockerState& s, float* pcm, size_t frames, uint32_t)
+{
+    const float r = s.r;
+    float x1[C], y1[C];
+    std::copy(s.x1, s.x1 + C, x1);
+    std::copy(s.y1, s.y1 + C, y1);
+
+    dcBlockerRun<C>(r, x1, y1, pcm, frames);
+
+    std::copy(x1, x1 + C, s.x1);
+    std::copy(y1, y1 + C, s.y1);
+}
+
+template <uint32_t C>
+inline void compressorRun(const CompressorState& c, float halfKnee, float& env,
+                          float* pcm, size_t n)
+{
+    for (size_t i = 0; i < n; ++i, pcm += C) {
+        float peak = 0.0f;
+        for (uint32_t k = 0; k < C; ++k) {
+            peak = std::max(peak, std::fabs(pcm[k]));
+        }
+        const float g = compressorGain(c, halfKnee, env, peak);
+        for (uint32_t k = 0; k < C; ++k) {
+            pcm[k] *= g;
+        }
+    }
+}
+
+template <uint32_t C>
+void compressorFixed(CompressorState& c, float* pcm, size_t frames, uint32_t)
+{
+    const CompressorState params = c;
+    const float halfKnee = params.kneeDb * 0.5f;
+    float env = params.envDb;
+
+    compressorRun<C>(params, halfKnee, env, pcm, frames);
+    c.envDb = env;
+}
+
+/* ------------------------------------------------------------------ */
+/*  Generic kernels: runtime channel count                              */
+/* ------------------------------------------------------------------ */
+
+void biquadGeneric(BiquadState& s, float* pcm, size_t frames, uint32_t channels)
+{
+    biquadChannels(s, pcm, frames, channels, 0, channels);
+}
+
+void dcBlockerGeneric(DcBlockerState& s, float* pcm, size_t frames, uint32_t channels)
+{
+    dcBlockerChannels(s, pcm, frames, channels, 0, channels);
+}
+
+void compressorGeneric(CompressorState& c, float* pcm, size_t frames, uint32_t channels)
+{
+    const float halfKnee = c.kneeDb * 0.5f;
+    float env = c.envDb;
+
+    for (size_t i = 0; i < frames; ++i) {
+        float* frame = pcm + i * channels;
+
+        float peak = 0.0f;
+        for (uint32_t k = 0; k < channels; ++k) {
+            peak = std::max(peak, std::fabs(frame[k]));
+        }
+        const float g = compressorGain(c, halfKnee, env, peak);
+        for (uint32_t k = 0; k < channels; ++k) {
+            frame[k] *= g;
+        }
+    }
+    c.envDb = env;
+}
+
+/* ------------------------------------------------------------------ */
+/*  Dispatch tables                                                     */
+/* ------------------------------------------------------------------ */
+
+template <uint32_t C>
+constexpr ChannelKernels makeKernels()
+{
+    return ChannelKernels { C, &biquadFixed<C>, &dcBlockerFixed<C>, &compressorFixed<C> };
+}
+
+const ChannelKernels kTables[] = {
+    makeKernels<1>(), makeKernels<2>(), makeKernels<6>(), makeKernels<8>(),
+};
+
+const ChannelKernels kGeneric { 0, &biquadGeneric, &dcBlockerGeneric, &compressorGeneric };
+
+int channelRow(uint32_t channels)
+{
+    switch (channels) {
+        case 1: return 0;
+        case 2: return 1;
+        case 6: return 2;
+        case 8: return 3;
+        default: return -1;
+    }
+}
+
+} // namespace
+
+void biquadChannels(BiquadState& s, float* pcm, size_t frames, uint32_t channels,
+                    uint32_t chBegin, uint32_t chEnd)
+{
+    for (uint32_t c = chBegin; c < chEnd; ++c) {
+        float z1 = s.z1[c];
+        float z2 = s.z2[c];
+        float* x = pcm + c;
+        for (size_t i = 0; i < frames; ++i, x += channels) {
+            const float in  = *x;
+            const float out = s.b0 * in + z1;
+            z1 = s.b1 * in - s.a1 * out + z2;
+            z2 = s.b2 * in - s.a2 * out;
+            *x = out;
+        }
+        s.z1[c] = z1;
+        s.z2[c] = z2;
+    }
+}
+
+void dcBlockerChannels(DcBlockerState& s, float* pcm, size_t frames, uint32_t channels,
+                       uint32_t chBegin, uint32_t chEnd)
+{
+    for (uint32_t c = chBegin; c < chEnd; ++c) {
+        float x1 = s.x1[c];
+        float y1 = s.y1[c];
+        float* x = pcm + c;
+        for (size_t i = 0; i < frames; ++i, x += channels) {
+            const float in  = *x;
+            const float out = in - x1 + s.r * y1;
+            x1 = in;
+            y1 = out;
+            *x = out;
+        }
+        s.x1[c] = x1;
+        s.y1[c] = y1;
+    }
+}
+
+uint32_t kernelBlockFrames(uint32_t channels, uint32_t frames)
+{
+    const size_t frameBytes = static_cast<size_t>(std::max(channels, 1u)) * sizeof(float);
+    uint32_t block = kKernelMaxBlockFrames;
+    while (block > kKernelMinBlockFrames
+           && (block * frameBytes > kKernelBlockBytes || (frames != 0 && block > frames))) {
+        block >>= 1;
+    }
+    return block;
+}
+
+const ChannelKernels& channelKernels(uint32_t channels)
+{
+    const int row = channelRow(channels);
+    return row < 0 ? kGeneric : kTables[row];
+}
+
+const ChannelKernels& genericChannelKernels()
+{
+    return kGeneric;
+}
+
+} // namespace DspProcessor
@@ -0,0 +1,94 @@
+/**
+ * dsp_channel_kernels.h — per-channel stage kernels specialised at compile time
+ *
+ * The chain's stateful stages (biquad, DC blocker, channel-linked
+ * compressor) are generated for 1, 2, 6 and 8 channels with the channel
+ * stride a template constant: the channel loop is fully unrolled, the C
+ * independent filter recursions of one frame interleave instead of
+ * waiting on each other, and filter state and coefficients stay in
+ * registers. The frame loop keeps a runtime length: the recursions are
+ * latency-bound, and a compile-time block length measured within noise.
+ *
+ * channelKernels() picks the table for the channel count and falls back
+ * to the generic, runtime-channel kernels for anything else. Every
+ * table produces bit-identical output: only the loop structure differs,
+ * each channel still sees the same operations in the same order.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace DspProcessor {
+
+/** Highest channel count a stage keeps state for (= ProcessingChain) */
+constexpr uint32_t kStageMaxChannels = 8;
+
+/** Range of the chain's block lengths (powers of two) */
+constexpr uint32_t kKernelMinBlockFrames = 64;
+constexpr uint32_t kKernelMaxBlockFrames = 4096;
+
+/** Interleaved float block the chain aims to keep in L1 across all stages */
+constexpr size_t kKernelBlockBytes = 16384;
+
+/** Transposed direct form II biquad: normalised coefficients + state */
+struct BiquadState {
+    float b0, b1, b2, a1, a2;
+    float z1[kStageMaxChannels];
+    float z2[kStageMaxChannels];
+};
+
+/** One-pole DC blocker: y[n] = x[n] - x[n-1] + r * y[n-1] */
+struct DcBlockerState {
+    float r;
+    float x1[kStageMaxChannels];
+    float y1[kStageMaxChannels];
+};
+
+/** Feed-forward, channel-linked peak compressor (dB domain) */
+struct CompressorState {
+    float thresholdDb, slope, kneeDb, makeupDb;
+    float attackCoef, releaseCoef;
+    float envDb;   /* smoothed gain reduction (≤ 0 dB), channel-linked */
+};
+
+/** In-place kernel over `frames` interleaved frames of `channels` channels */
+template <typename State>
+using StageKernel = void (*)(State& state, float* pcm, size_t frames, uint32_t channels);
+
+/** One generated (or the generic) set of stage kernels */
+struct ChannelKernels {
+    uint32_t channels;      /* specialised channel count, 0 = any       */
+    StageKernel<BiquadState>     biquad;
+    StageKernel<DcBlockerState>  dcBlocker;
+    StageKernel<CompressorState> compressor;
+};
+
+/**
+ * Block length for a stream: the largest power of two in
+ * [kKernelMinBlockFrames, kKernelMaxBlockFrames] whose interleaved block
+ * fits kKernelBlockBytes, lowered to at most @p frames when that is known
+ * (0 = unknown) so short requests still get full blocks.
+ */
+uint32_t kernelBlockFrames(uint32_t channels, uint32_t frames);
+
+/**
+ * Kernels generated for exactly @p channels, or the generic table when
+ * that channel count was not generated.
+ */
+const ChannelKernels& channelKernels(uint32_t channels);
+
+/** The runtime-channel fallback table (channels = 0). */
+const ChannelKernels& genericChannelKernels();
+
+/**
+ * Generic kernels on the channel range [chBegin, chEnd) only — the unit
+ * ProcessingChain::processParallel() hands to each worker.
+ */
+void biquadChannels(BiquadState& s, float* pcm, size_t frames, uint32_t channels,
+                    uint32_t chBegin, uint32_t chEnd);
+void dcBlockerChannels(DcBlockerState& s, float* pcm, size_t frames, uint32_t channels,
+                       uint32_t chBegin, uint32_t chEnd);
+
+} // namespace DspProcessor
@@ -0,0 +1,94 @@
+/**
+ * dsp_client_watch.cpp — ownership and reclamation of per-client service state
+ */
+
+#include "dsp_client_watch.h"
+#include "dsp_session.h"
+#include "dsp_stream.h"
+#include "AudioTrace.h"
+
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <signal.h>
+#include <thread>
+
+namespace DspProcessor {
+
+namespace {
+
+std::atomic<int64_t> g_idleTimeoutMs { kDefaultIdleTimeoutMs };
+
+/* Process-wide watcher; stopped and joined at static destruction, before
+   the tables it sweeps (constructed earlier) go away */
+struct Watcher {
+    std::mutex              lock;
+    std::condition_variable wake;
+    std::thread             thread;
+    bool                    stop = false;
+
+    ~Watcher()
+    {
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            stop = true;
+        }
+        wake.notify_all();
+        if (thread.joinable()) {
+            thread.join();
+        }
+    }
+};
+
+Watcher& watcher()
+{
+    static Watcher w;
+    return w;
+}
+
+void watchLoop(Watcher* w)
+{
+    std::unique_lock<std::mutex> lock(w->lock);
+    while (!w->stop) {
+        w->wake.wait_for(lock, std::chrono::milliseconds(kSweepMs));
+        if (w->stop) {
+            break;
+        }
+        lock.unlock();
+        const int64_t now = AudioTrace::nowNs();
+        reapSessions(now);
+        reapStreams(now);
+        lock.lock();
+    }
+}
+
+} // namespace
+
+bool clientAlive(const ClientRef& client)
+{
+    /* EPERM: the process exists but belongs to someone else */
+    return client.pid <= 0 || kill(client.pid, 0) == 0 || errno != ESRCH;
+}
+
+void setIdleTimeoutMs(int64_t ms)
+{
+    g_idleTimeoutMs.store(ms > 0 ? ms : 0, std::memory_order_relaxed);
+}
+
+int64_t idleTimeoutMs()
+{
+    return g_idleTimeoutMs.load(std::memory_order_relaxed);
+}
+
+void startClientWatch()
+{
+    Watcher& w = watcher();
+    std::lock_guard<std::mutex> lock(w.lock);
+    if (!w.thread.joinable() && !w.stop) {
+        w.thread = std::thread(watchLoop, &w);
+    }
+}
+
+} // namespace DspProcessor
@@ -0,0 +1,49 @@
+/**
+ * dsp_client_watch.h — ownership and reclamation of per-client service state
+ *
+ * Sessions pin a mapping (pre-faulted and, where allowed, mlocked) for as
+ * long as they are open, streams a mapping and a worker thread. Both
+ * belong to the Binder caller that opened them: only the same uid may
+ * use or close one, and a client that goes away without CLOSE_SESSION_CODE
+ * / CLOSE_STREAM_CODE must not leave it behind.
+ *
+ * A watcher thread, started with the first open, sweeps the tables every
+ * kSweepMs and reclaims entries whose owning process has exited or which
+ * have not been used for idleTimeoutMs(). Process exit is detected from
+ * the pid recorded at open (kill(pid, 0) reporting ESRCH), which needs no
+ * object from the client the way a death recipient would; the idle
+ * timeout covers pid reuse and callers whose pid is unknown.
+ */
+
+#pragma once
+
+#include <cstdint>
+
+namespace DspProcessor {
+
+/** The caller that opened a session or stream */
+struct ClientRef {
+    int32_t uid = 0;   /* Binder calling uid; 0 = in-process caller       */
+    int32_t pid = 0;   /* calling pid; 0 = unknown (idle timeout only)    */
+};
+
+/** Sweep period of the watcher thread */
+constexpr int64_t kSweepMs = 1000;
+/** Default idleTimeoutMs() */
+constexpr int64_t kDefaultIdleTimeoutMs = 5 * 60 * 1000;
+
+/** Is the client's process still running? Always true for pid 0. */
+bool clientAlive(const ClientRef& client);
+
+/**
+ * Reclaim sessions unused, and streams without a block, for this long.
+ * @param ms  0 = never (only an exited owner is reclaimed)
+ */
+void setIdleTimeoutMs(int64_t ms);
+
+int64_t idleTimeoutMs();
+
+/** Start the watcher thread if it is not running yet. */
+void startClientWatch();
+
+} // namespace DspProcessor
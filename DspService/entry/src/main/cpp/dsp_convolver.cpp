@@ -0,0 +1,216 @@
+/**
+ * dsp_convolver.cpp — uniformly partitioned FFT convolution (overlap-save)
+ */
+
+#include "dsp_convolver.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+
+namespace DspProcessor {
+
+PartitionedConvolver::~PartitionedConvolver()
+{
+    release();
+}
+
+void PartitionedConvolver::release()
+{
+    std::free(arena_);
+    arena_       = nullptr;
+    arenaFloats_ = 0;
+    stateBegin_  = nullptr;
+    channels_    = 0;
+    partition_   = 0;
+    partitions_  = 0;
+    irFrames_    = 0;
+}
+
+uint32_t PartitionedConvolver::autoPartition(uint32_t irFrames, uint32_t maxBlockFrames)
+{
+    const uint32_t limit = std::min(std::max(maxBlockFrames, kMinPartition), kMaxPartition);
+    uint32_t b = std::min(kShortestAutoPartition, limit);
+    while (b < limit && static_cast<uint64_t>(b) * 8 < irFrames) {
+        b <<= 1;
+    }
+    return b;
+}
+
+bool PartitionedConvolver::configure(const float* taps, uint32_t irChannels, uint32_t irFrames,
+                                     uint32_t channels, uint32_t partition, float wet, float dry)
+{
+    release();
+    if (!taps || channels == 0 || channels > kMaxChannels
+        || (irChannels != 1 && irChannels != channels)
+        || irFrames == 0 || irFrames > kMaxIrFrames
+        || partition < kMinPartition || partition > kMaxPartition
+        || (partition & (partition - 1)) != 0
+        || !std::isfinite(wet) || !std::isfinite(dry)
+        || !fft_.init(2 * partition)) {
+        return false;
+    }
+
+    const size_t m = fft_.half();   /* = partition, a multiple of 16 floats */
+    const uint32_t parts = (irFrames + partition - 1) / partition;
+    const size_t irFloats      = 2 * parts * m;
+    const size_t channelFloats = (12 + 2 * static_cast<size_t>(parts)) * m;
+    const size_t total = irChannels * irFloats + channels * channelFloats;
+    if (total * sizeof(float) > kMaxArenaBytes) {
+        return false;
+    }
+    void* raw = nullptr;
+    if (posix_memalign(&raw, 64, total * sizeof(float)) != 0) {
+        return false;
+    }
+    arena_       = static_cast<float*>(raw);
+    arenaFloats_ = total;
+    stateBegin_  = arena_ + irChannels * irFloats;
+    channels_    = channels;
+    partition_   = partition;
+    partitions_  = parts;
+    irFrames_    = irFrames;
+    dry_         = dry;
+
+    float* next = stateBegin_;
+    for (uint32_t ch = 0; ch < channels; ++ch) {
+        Channel& c = state_[ch];
+        c.even    = next;  next += m;
+        c.odd     = next;  next += m;
+        c.fdlRe   = next;  next += parts * m;
+        c.fdlIm   = next;  next += parts * m;
+        c.accRe   = next;  next += m;
+        c.accIm   = next;  next += m;
+        c.yRe     = next;  next += m;
+        c.yIm     = next;  next += m;
+        c.outEven = next;  next += m;
+        c.outOdd  = next;  next += m;
+        c.work    = next;  next += 4 * m;
+        const float* h = arena_ + (irChannels == 1 ? 0 : ch) * irFloats;
+        c.hRe = h;
+        c.hIm = h + parts * m;
+    }
+
+    /* H_p = FFT of taps [pB, pB + B) followed by B zeros, scaled by wet / N
+       so the inverse transform needs no scaling of its own */
+    Channel& scratch = state_[0];
+    const float scale = wet / static_cast<float>(fft_.size());
+    for (uint32_t irc = 0; irc < irChannels; ++irc) {
+        const float* plane = taps + static_cast<size_t>(irc) * irFrames;
+        float* hRe = arena_ + irc * irFloats;
+        float* hIm = hRe + parts * m;
+        for (uint32_t p = 0; p < parts; ++p) {
+            std::memset(scratch.even, 0, m * sizeof(float));
+            std::memset(scratch.odd, 0, m * sizeof(float));
+            const uint32_t first = p * partition;
+            const uint32_t count = std::min(partition, irFrames - first);
+            for (uint32_t t = 0; t < count; ++t) {
+                ((t & 1u) ? scratch.odd : scratch.even)[t / 2] = plane[first + t];
+            }
+            float* re = hRe + p * m;
+            float* im = hIm + p * m;
+            fft_.forward(scratch.even, scratch.odd, re, im, scratch.work);
+            for (size_t k = 0; k < m; ++k) {
+                re[k] *= scale;
+                im[k] *= scale;
+            }
+        }
+    }
+
+    reset();
+    return true;
+}
+
+void PartitionedConvolver::reset()
+{
+    if (!arena_) {
+        return;
+    }
+    std::memset(stateBegin_, 0, (arena_ + arenaFloats_ - stateBegin_) * sizeof(float));
+    for (uint32_t ch = 0; ch < channels_; ++ch) {
+        state_[ch].pos  = 0;
+        state_[ch].slot = 0;
+    }
+}
+
+void PartitionedConvolver::processChannels(float* pcm, size_t frames, uint32_t chBegin,
+                                           uint32_t chEnd)
+{
+    if (!arena_ || !pcm) {
+        return;
+    }
+    chEnd = std::min(chEnd, channels_);
+    for (uint32_t ch = chBegin; ch < chEnd; ++ch) {
+        runChannel(state_[ch], pcm, frames, ch);
+    }
+}
+
+/* Block k is complete: queue its partial sums for block k + 1 and slide
+   the input window by one block */
+void PartitionedConvolver::completeBlock(Channel& c)
+{
+    const size_t m = partition_;
+    const uint32_t parts = partitions_;
+    c.slot = c.slot + 1 == parts ? 0 : c.slot + 1;
+
+    std::memset(c.accRe, 0, m * sizeof(float));
+    std::memset(c.accIm, 0, m * sizeof(float));
+    for (uint32_t p = 1; p < parts; ++p) {
+        const uint32_t slot = (c.slot + parts - p) % parts;   /* block k + 1 − p */
+        fft_.multiplyAccumulate(c.fdlRe + slot * m, c.fdlIm + slot * m,
+                                c.hRe + p * m, c.hIm + p * m, c.accRe, c.accIm);
+    }
+
+    const size_t half = m / 2;
+    std::memcpy(c.even, c.even + half, half * sizeof(float));
+    std::memcpy(c.odd, c.odd + half, half * sizeof(float));
+    std::memset(c.even + half, 0, half * sizeof(float));
+    std::memset(c.odd + half, 0, half * sizeof(float));
+    c.pos = 0;
+}
+
+void PartitionedConvolver::runChannel(Channel& c, float* pcm, size_t frames, uint32_t ch)
+{
+    const uint32_t b = partition_;
+    const size_t m = b;
+    const size_t half = m / 2;     /* window index of the block's first even / odd sample */
+    const size_t stride = channels_;
+    const float dry = dry_;
+
+    for (size_t done = 0; done < frames;) {
+        const uint32_t start = c.pos;
+        const uint32_t take = static_cast<uint32_t>(std::min<size_t>(b - start, frames - done));
+        float* io = pcm + done * stride + ch;
+
+        for (uint32_t f = 0; f < take; ++f) {
+            const uint32_t t = start + f;
+            ((t & 1u) ? c.odd : c.even)[half + t / 2] = io[f * stride];
+        }
+        c.pos += take;
+
+        /* X_k (zero-padded while the block is incomplete) into its slot */
+        float* xRe = c.fdlRe + c.slot * m;
+        float* xIm = c.fdlIm + c.slot * m;
+        fft_.forward(c.even, c.odd, xRe, xIm, c.work);
+        std::memcpy(c.yRe, c.accRe, m * sizeof(float));
+        std::memcpy(c.yIm, c.accIm, m * sizeof(float));
+        fft_.multiplyAccumulate(xRe, xIm, c.hRe, c.hIm, c.yRe, c.yIm);
+        fft_.inverse(c.yRe, c.yIm, c.outEven, c.outOdd, c.work);
+
+        for (uint32_t f = 0; f < take; ++f) {
+            const uint32_t t = start + f;
+            const size_t i = half + t / 2;
+            const float x = (t & 1u) ? c.odd[i] : c.even[i];
+            const float y = (t & 1u) ? c.outOdd[i] : c.outEven[i];
+            io[f * stride] = dry * x + y;
+        }
+
+        if (c.pos == b) {
+            completeBlock(c);
+        }
+        done += take;
+    }
+}
+
+} // namespace DspProcessor
@@ -0,0 +1,133 @@
+/**
+ * dsp_convolver.h — uniformly partitioned FFT convolution (overlap-save)
+ *
+ * A PartitionedConvolver applies a long impulse response (cabinet, room)
+ * to interleaved float32 PCM in place, at a cost that grows with log(B)
+ * and the number of partitions instead of with the IR length.
+ *
+ * The IR is cut into P partitions of B frames; configure() transforms each
+ * one (zero-padded to N = 2B) once, with the wet gain and the 1/N of the
+ * inverse transform folded in. Each channel keeps the spectra of its last
+ * P input blocks in a frequency-domain delay line, so a block costs one
+ * forward and one inverse real FFT of N points plus P spectrum
+ * multiply-accumulates (see RealFft).
+ *
+ * There is no added latency. Output of block k is
+ *
+ *   y_k = last B samples of IFFT( X_k·H_0 + Σ_{p≥1} X_{k−p}·H_p )
+ *
+ * where X_k is the spectrum of [block k−1 | block k]. The sum over p ≥ 1
+ * only involves complete blocks and is accumulated once, when block k−1
+ * completes. A call that ends inside a block transforms the block with its
+ * missing samples as zeros: by causality the samples it does have come
+ * out exact, and the block is transformed again once it is complete.
+ * Calls of whole blocks never take that path.
+ *
+ * All state lives in one 64-byte-aligned arena allocated by configure()
+ * (IR spectra, then per channel: input window, delay line, accumulator,
+ * output and FFT scratch), so processing never allocates. Channels are
+ * independent: processChannels() on disjoint channel ranges may run on
+ * different threads.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "AudioSharedBuffer.h"
+#include "dsp_channel_kernels.h"
+#include "dsp_fft.h"
+
+namespace DspProcessor {
+
+class PartitionedConvolver {
+public:
+    static constexpr uint32_t kMinPartition = RealFft::kMinSize / 2;
+    static constexpr uint32_t kMaxPartition = 8192;
+    static constexpr uint32_t kMaxChannels  = kStageMaxChannels;
+    static constexpr uint32_t kMaxIrFrames  = AUDIO_IR_MAX_FRAMES;
+    /* Upper bound of the arena (IR spectra + channel state) */
+    static constexpr size_t   kMaxArenaBytes = size_t(256) << 20;
+    static constexpr uint32_t kShortestAutoPartition = 256;
+
+    PartitionedConvolver() = default;
+    ~PartitionedConvolver();
+
+    PartitionedConvolver(const PartitionedConvolver&) = delete;
+    PartitionedConvolver& operator=(const PartitionedConvolver&) = delete;
+
+    /**
+     * Partition length used when the stage does not ask for one: about an
+     * eighth of the IR, but not below kShortestAutoPartition (shorter blocks
+     * spend more on the two transforms than they save in multiply-adds) and
+     * at most @p maxBlockFrames (the frames the chain hands over per call,
+     * so whole blocks are the common case). Tuned with audio_bench conv/.
+     */
+    static uint32_t autoPartition(uint32_t irFrames, uint32_t maxBlockFrames);
+
+    /**
+     * Precompute the IR partitions and allocate the arena. Resets all state.
+     * @param taps        irChannels planes of irFrames samples, channel 0 first
+     * @param irChannels  1 (same IR on every channel) or @p channels
+     * @param partition   B, a power of two in [kMinPartition, kMaxPartition]
+     * @param wet         gain of the convolved signal
+     * @param dry         gain of the input mixed back in
+     * @return false for invalid arguments or when the arena cannot be
+     *         allocated; the convolver is then unconfigured
+     */
+    bool configure(const float* taps, uint32_t irChannels, uint32_t irFrames,
+                   uint32_t channels, uint32_t partition, float wet, float dry);
+
+    /** Forget the input history (the IR is kept). */
+    void reset();
+
+    /** Convolve interleaved PCM in place. No allocation, no locking. */
+    void process(float* pcm, size_t frames) { processChannels(pcm, frames, 0, channels_); }
+
+    /** Channels [chBegin, chEnd) of interleaved PCM only. */
+    void processChannels(float* pcm, size_t frames, uint32_t chBegin, uint32_t chEnd);
+
+    bool configured() const { return arena_ != nullptr; }
+    uint32_t channels() const { return channels_; }
+    uint32_t partitionFrames() const { return partition_; }
+    uint32_t partitions() const { return partitions_; }
+    uint32_t irFrames() const { return irFrames_; }
+    size_t arenaBytes() const { return arenaFloats_ * sizeof(float); }
+
+private:
+    struct Channel {
+        float* even;      /* input window [block k−1 | block k], de-interleaved */
+        float* odd;
+        float* fdlRe;     /* P spectra; slot b % P holds block b               */
+        float* fdlIm;
+        float* accRe;     /* Σ_{p≥1} X_{k−p}·H_p of the current block           */
+        float* accIm;
+        float* yRe;
+        float* yIm;
+        float* outEven;   /* inverse transform of the block                    */
+        float* outOdd;
+        float* work;      /* RealFft scratch                                   */
+        const float* hRe; /* this channel's IR spectra, P × N/2 each           */
+        const float* hIm;
+        uint32_t pos;     /* frames of block k received                        */
+        uint32_t slot;    /* delay-line slot of block k                        */
+    };
+
+    void release();
+    void runChannel(Channel& c, float* pcm, size_t frames, uint32_t ch);
+    void completeBlock(Channel& c);
+
+    RealFft  fft_;
+    float*   arena_       = nullptr;
+    size_t   arenaFloats_ = 0;
+    float*   stateBegin_  = nullptr;   /* first float of the channel state */
+    Channel  state_[kMaxChannels] {};
+    uint32_t channels_    = 0;
+    uint32_t partition_   = 0;
+    uint32_t partitions_  = 0;
+    uint32_t irFrames_    = 0;
+    float    dry_         = 0.0f;
+};
+
+} // namespace DspProcessor
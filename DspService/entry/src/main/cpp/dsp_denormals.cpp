@@ -0,0 +1,94 @@
+/**
+ * dsp_denormals.cpp — flush-to-zero scope for the processing threads
+ */
+
+#include "dsp_denormals.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define DSP_HAVE_X86 1
+#endif
+
+namespace DspProcessor {
+
+namespace {
+
+#if defined(__aarch64__)
+constexpr uint64_t kFlushBits = uint64_t(1) << 24;      /* FPCR.FZ          */
+
+inline uint64_t readControl()
+{
+    uint64_t fpcr;
+    __asm__ __volatile__("mrs %0, fpcr" : "=r"(fpcr));
+    return fpcr;
+}
+
+inline void writeControl(uint64_t fpcr)
+{
+    __asm__ __volatile__("msr fpcr, %0" : : "r"(fpcr));
+}
+#elif defined(DSP_HAVE_X86)
+constexpr uint64_t kFlushBits = 0x8040;                 /* MXCSR FTZ | DAZ  */
+
+inline uint64_t readControl()
+{
+    return _mm_getcsr();
+}
+
+inline void writeControl(uint64_t mxcsr)
+{
+    _mm_setcsr(static_cast<unsigned>(mxcsr));
+}
+#else
+/* No known control register: flushing is never on */
+constexpr uint64_t kFlushBits = 0;
+
+inline uint64_t readControl()
+{
+    return 0;
+}
+
+inline void writeControl(uint64_t)
+{
+}
+#endif
+
+inline uint64_t withFlush(uint64_t control, bool flush)
+{
+    return flush ? control | kFlushBits : control & ~kFlushBits;
+}
+
+} // namespace
+
+bool flushDenormalsEnabled()
+{
+    return kFlushBits != 0 && (readControl() & kFlushBits) == kFlushBits;
+}
+
+void setFlushDenormals(bool flush)
+{
+    const uint64_t control = readControl();
+    const uint64_t wanted  = withFlush(control, flush);
+    if (wanted != control) {
+        writeControl(wanted);
+    }
+}
+
+DenormalScope::DenormalScope(bool flush)
+    : saved_(readControl())
+{
+    const uint64_t wanted = withFlush(saved_, flush);
+    if (wanted != saved_) {
+        writeControl(wanted);
+        changed_ = true;
+    }
+}
+
+DenormalScope::~DenormalScope()
+{
+    if (changed_) {
+        writeControl(saved_);
+    }
+}
+
+} // namespace DspProcessor
@@ -0,0 +1,48 @@
+/**
+ * dsp_denormals.h — flush-to-zero scope for the processing threads
+ *
+ * Recursive stages (biquads, compressor envelopes, the convolver's tail)
+ * decay into subnormal floats once their input goes silent, and many cores
+ * take a microcode assist on every subnormal operand or result, which can
+ * slow a block down by one or two orders of magnitude. Flushing them to
+ * zero costs at most the last ~1e-38 of a tail nobody can hear.
+ *
+ *   x86-64   MXCSR.FTZ (results) and MXCSR.DAZ (operands)
+ *   aarch64  FPCR.FZ, which covers both
+ *
+ * The mode is per thread. WorkerPool::parallelFor() hands the caller's
+ * mode to every worker for the duration of the call, so a parallel pass
+ * computes what the same pass on the calling thread alone would.
+ */
+
+#pragma once
+
+#include <cstdint>
+
+namespace DspProcessor {
+
+/** Are subnormals flushed to zero on the calling thread? */
+bool flushDenormalsEnabled();
+
+/** Switch flushing on or off for the calling thread. */
+void setFlushDenormals(bool flush);
+
+/**
+ * Set the calling thread's flush mode for a scope and put the previous
+ * mode back at its end. Touches the control register only when the mode
+ * actually changes.
+ */
+class DenormalScope {
+public:
+    explicit DenormalScope(bool flush);
+    ~DenormalScope();
+
+    DenormalScope(const DenormalScope&) = delete;
+    DenormalScope& operator=(const DenormalScope&) = delete;
+
+private:
+    uint64_t saved_   = 0;
+    bool     changed_ = false;
+};
+
+} // namespace DspProcessor
@@ -0,0 +1,672 @@
+/**
+ * dsp_fft.cpp — vectorised real FFT for the convolution stage
+ *
+ * Complex pass of stride s over M = N/2 points (half = M/2), Stockham
+ * radix-2 with p < half/s, q < s:
+ *
+ *   a = x[s·p + q]                 b = x[s·p + q + half]
+ *   y[2s·p + q] = a + b            y[2s·p + s + q] = (a − b) · w^(s·p)
+ *
+ * with w = exp(-2πi/M). log2(M) passes (s = 1, 2, …, M/2) leave the
+ * spectrum in natural order. Passes with s ≥ the vector width run over q;
+ * narrower ones load whole rows of a and b and interleave sums and
+ * differences s floats at a time.
+ *
+ * Real split of Z = FFT(even + i·odd) into X, for 0 < k < M:
+ *
+ *   E = (Z[k] + conj Z[M−k]) / 2      O = (Z[k] − conj Z[M−k]) / 2i
+ *   X[k] = E + W^k·O                  X[M−k] = conj(E − W^k·O)
+ *
+ * with W = exp(-2πi/N), handled pairwise (k, M−k); the inverse runs it
+ * backwards, unscaled, and takes the complex inverse FFT as a forward FFT
+ * with re / im swapped on the way in and out.
+ */
+
+#include "dsp_fft.h"
+
+#include <cmath>
+
+#if defined(__aarch64__)
+#include <arm_neon.h>
+#define DSP_HAVE_NEON 1
+#elif defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define DSP_HAVE_X86 1
+#endif
+
+namespace DspProcessor {
+
+struct FftKernels {
+    uint32_t width;   /* floats per vector; passes with s < width use passNarrow */
+    void (*passWide)(const float* xr, const float* xi, float* yr, float* yi,
+                     uint32_t half, uint32_t s, const float* wr, const float* wi);
+    /* wr / wi hold one twiddle per element (the expanded tables) */
+    void (*passNarrow)(const float* xr, const float* xi, float* yr, float* yi,
+                       uint32_t half, uint32_t s, const float* wr, const float* wi);
+    void (*splitForward)(const float* zr, const float* zi, float* xr, float* xi,
+                         uint32_t m, const float* wr, const float* wi);
+    void (*splitInverse)(const float* xr, const float* xi, float* zr, float* zi,
+                         uint32_t m, const float* wr, const float* wi);
+    void (*mac)(const float* xr, const float* xi, const float* hr, const float* hi,
+                float* ar, float* ai, uint32_t m);
+};
+
+namespace {
+
+/* ------------------------------------------------------------------ */
+/*  Scalar                                                              */
+/* ------------------------------------------------------------------ */
+void passScalar(const float* xr, const float* xi, float* yr, float* yi,
+                uint32_t half, uint32_t s, const float* wr, const float* wi)
+{
+    const uint32_t rows = half / s;
+    for (uint32_t p = 0; p < rows; ++p) {
+        const float cr = wr[p * s];
+        const float ci = wi[p * s];
+        const size_t in  = static_cast<size_t>(s) * p;
+        const size_t out = 2 * in;
+        for (uint32_t q = 0; q < s; ++q) {
+            const float ar = xr[in + q], ai = xi[in + q];
+            const float br = xr[in + q + half], bi = xi[in + q + half];
+            yr[out + q] = ar + br;
+            yi[out + q] = ai + bi;
+            const float dr = ar - br, di = ai - bi;
+            yr[out + s + q] = dr * cr - di * ci;
+            yi[out + s + q] = dr * ci + di * cr;
+        }
+    }
+}
+
+/* Split pairs k, m − k for k in [k, m/2) */
+void splitForwardPairs(const float* zr, const float* zi, float* xr, float* xi,
+                       uint32_t k, uint32_t m, const float* wr, const float* wi)
+{
+    for (; k < m / 2; ++k) {
+        const uint32_t j = m - k;
+        const float er = 0.5f * (zr[k] + zr[j]), ei = 0.5f * (zi[k] - zi[j]);
+        const float orr = 0.5f * (zi[k] + zi[j]), oi = 0.5f * (zr[j] - zr[k]);
+        const float tr = wr[k] * orr - wi[k] * oi;
+        const float ti = wr[k] * oi + wi[k] * orr;
+        xr[k] = er + tr;
+        xi[k] = ei + ti;
+        xr[j] = er - tr;
+        xi[j] = ti - ei;
+    }
+}
+
+void splitInversePairs(const float* xr, const float* xi, float* zr, float* zi,
+                       uint32_t k, uint32_t m, const float* wr, const float* wi)
+{
+    for (; k < m / 2; ++k) {
+        const uint32_t j = m - k;
+        const float sr = xr[k] + xr[j], si = xi[k] - xi[j];
+        const float dr = xr[k] - xr[j], di = xi[k] + xi[j];
+        const float ur = wr[k] * dr + wi[k] * di;
+        const float ui = wr[k] * di - wi[k] * dr;
+        zr[k] = sr - ui;
+        zi[k] = si + ur;
+        zr[j] = sr + ui;
+        zi[j] = ur - si;
+    }
+}
+
+/* The bins without a partner: DC / Nyquist (packed in bin 0) and m/2 */
+void splitForwardEdges(const float* zr, const float* zi, float* xr, float* xi, uint32_t m)
+{
+    const float dc = zr[0] + zi[0];
+    const float nyquist = zr[0] - zi[0];
+    xr[0] = dc;
+    xi[0] = nyquist;
+    xr[m / 2] = zr[m / 2];
+    xi[m / 2] = -zi[m / 2];
+}
+
+void splitInverseEdges(const float* xr, const float* xi, float* zr, float* zi, uint32_t m)
+{
+    const float dc = xr[0], nyquist = xi[0];
+    zr[0] = dc + nyquist;
+    zi[0] = dc - nyquist;
+    zr[m / 2] = 2.0f * xr[m / 2];
+    zi[m / 2] = -2.0f * xi[m / 2];
+}
+
+void splitForwardScalar(const float* zr, const float* zi, float* xr, float* xi,
+                        uint32_t m, const float* wr, const float* wi)
+{
+    splitForwardEdges(zr, zi, xr, xi, m);
+    splitForwardPairs(zr, zi, xr, xi, 1, m, wr, wi);
+}
+
+void splitInverseScalar(const float* xr, const float* xi, float* zr, float* zi,
+                        uint32_t m, const float* wr, const float* wi)
+{
+    splitInverseEdges(xr, xi, zr, zi, m);
+    splitInversePairs(xr, xi, zr, zi, 1, m, wr, wi);
+}
+
+void macScalar(const float* xr, const float* xi, const float* hr, const float* hi,
+               float* ar, float* ai, uint32_t m)
+{
+    for (uint32_t k = 0; k < m; ++k) {
+        ar[k] += xr[k] * hr[k] - xi[k] * hi[k];
+        ai[k] += xr[k] * hi[k] + xi[k] * hr[k];
+    }
+}
+
+const FftKernels kScalarFft = {
+    1, passScalar, nullptr, splitForwardScalar, splitInverseScalar, macScalar,
+};
+
+/* ------------------------------------------------------------------ */
+/*  NEON (aarch64)                                                      */
+/* ------------------------------------------------------------------ */
+#if defined(DSP_HAVE_NEON)
+
+inline float32x4_t reverseNeon(float32x4_t v)
+{
+    const float32x4_t r = vrev64q_f32(v);
+    return vextq_f32(r, r, 2);
+}
+
+void passWideNeon(const float* xr, const float* xi, float* yr, float* yi,
+                  uint32_t half, uint32_t s, const float* wr, const float* wi)
+{
+    const uint32_t rows = half / s;
+    for (uint32_t p = 0; p < rows; ++p) {
+        const float32x4_t cr = vdupq_n_f32(wr[p * s]);
+        const float32x4_t ci = vdupq_n_f32(wi[p * s]);
+        const size_t in  = static_cast<size_t>(s) * p;
+        const size_t out = 2 * in;
+        for (uint32_t q = 0; q < s; q += 4) {
+            const float32x4_t ar = vld1q_f32(xr + in + q), ai = vld1q_f32(xi + in + q);
+            const float32x4_t br = vld1q_f32(xr + in + q + half), bi = vld1q_f32(xi + in + q + half);
+            vst1q_f32(yr + out + q, vaddq_f32(ar, br));
+            vst1q_f32(yi + out + q, vaddq_f32(ai, bi));
+            const float32x4_t dr = vsubq_f32(ar, br), di = vsubq_f32(ai, bi);
+            vst1q_f32(yr + out + s + q, vfmsq_f32(vmulq_f32(dr, cr), di, ci));
+            vst1q_f32(yi + out + s + q, vfmaq_f32(vmulq_f32(dr, ci), di, cr));
+        }
+    }
+}
+
+/* Rows of s = 1 or 2 floats: sums and rotated differences, row by row */
+void passNarrowNeon(const float* xr, const float* xi, float* yr, float* yi,
+                    uint32_t half, uint32_t s, const float* wr, const float* wi)
+{
+    for (uint32_t i = 0; i < half; i += 4) {
+        const float32x4_t ar = vld1q_f32(xr + i), ai = vld1q_f32(xi + i);
+        const float32x4_t br = vld1q_f32(xr + i + half), bi = vld1q_f32(xi + i + half);
+        const float32x4_t cr = vld1q_f32(wr + i), ci = vld1q_f32(wi + i);
+        const float32x4_t sr = vaddq_f32(ar, br), si = vaddq_f32(ai, bi);
+        const float32x4_t dr = vsubq_f32(ar, br), di = vsubq_f32(ai, bi);
+        const float32x4_t tr = vfmsq_f32(vmulq_f32(dr, cr), di, ci);
+        const float32x4_t ti = vfmaq_f32(vmulq_f32(dr, ci), di, cr);
+        float32x4_t r0, r1, i0, i1;
+        if (s == 1) {
+            r0 = vzip1q_f32(sr, tr);
+            r1 = vzip2q_f32(sr, tr);
+            i0 = vzip1q_f32(si, ti);
+            i1 = vzip2q_f32(si, ti);
+        } else {
+            r0 = vreinterpretq_f32_f64(vzip1q_f64(vreinterpretq_f64_f32(sr), vreinterpretq_f64_f32(tr)));
+            r1 = vreinterpretq_f32_f64(vzip2q_f64(vreinterpretq_f64_f32(sr), vreinterpretq_f64_f32(tr)));
+            i0 = vreinterpretq_f32_f64(vzip1q_f64(vreinterpretq_f64_f32(si), vreinterpretq_f64_f32(ti)));
+            i1 = vreinterpretq_f32_f64(vzip2q_f64(vreinterpretq_f64_f32(si), vreinterpretq_f64_f32(ti)));
+        }
+        vst1q_f32(yr + 2 * i, r0);
+        vst1q_f32(yr + 2 * i + 4, r1);
+        vst1q_f32(yi + 2 * i, i0);
+        vst1q_f32(yi + 2 * i + 4, i1);
+    }
+}
+
+void splitForwardNeon(const float* zr, const float* zi, float* xr, float* xi,
+                      uint32_t m, const float* wr, const float* wi)
+{
+    const float32x4_t h = vdupq_n_f32(0.5f);
+    splitForwardEdges(zr, zi, xr, xi, m);
+    uint32_t k = 1;
+    for (; k + 4 <= m / 2; k += 4) {
+        const uint32_t j = m - k - 3;   /* partners m − k … m − k − 3, reversed */
+        const float32x4_t ar = vld1q_f32(zr + k), ai = vld1q_f32(zi + k);
+        const float32x4_t br = reverseNeon(vld1q_f32(zr + j)), bi = reverseNeon(vld1q_f32(zi + j));
+        const float32x4_t cr = vld1q_f32(wr + k), ci = vld1q_f32(wi + k);
+        const float32x4_t er = vmulq_f32(h, vaddq_f32(ar, br)), ei = vmulq_f32(h, vsubq_f32(ai, bi));
+        const float32x4_t orr = vmulq_f32(h, vaddq_f32(ai, bi)), oi = vmulq_f32(h, vsubq_f32(br, ar));
+        const float32x4_t tr = vfmsq_f32(vmulq_f32(cr, orr), ci, oi);
+        const float32x4_t ti = vfmaq_f32(vmulq_f32(cr, oi), ci, orr);
+        vst1q_f32(xr + k, vaddq_f32(er, tr));
+        vst1q_f32(xi + k, vaddq_f32(ei, ti));
+        vst1q_f32(xr + j, reverseNeon(vsubq_f32(er, tr)));
+        vst1q_f32(xi + j, reverseNeon(vsubq_f32(ti, ei)));
+    }
+    splitForwardPairs(zr, zi, xr, xi, k, m, wr, wi);
+}
+
+void splitInverseNeon(const float* xr, const float* xi, float* zr, float* zi,
+                      uint32_t m, const float* wr, const float* wi)
+{
+    splitInverseEdges(xr, xi, zr, zi, m);
+    uint32_t k = 1;
+    for (; k + 4 <= m / 2; k += 4) {
+        const uint32_t j = m - k - 3;
+        const float32x4_t ar = vld1q_f32(xr + k), ai = vld1q_f32(xi + k);
+        const float32x4_t br = reverseNeon(vld1q_f32(xr + j)), bi = reverseNeon(vld1q_f32(xi + j));
+        const float32x4_t cr = vld1q_f32(wr + k), ci = vld1q_f32(wi + k);
+        const float32x4_t sr = vaddq_f32(ar, br), si = vsubq_f32(ai, bi);
+        const float32x4_t dr = vsubq_f32(ar, br), di = vaddq_f32(ai, bi);
+        const float32x4_t ur = vfmaq_f32(vmulq_f32(cr, dr), ci, di);
+        const float32x4_t ui = vfmsq_f32(vmulq_f32(cr, di), ci, dr);
+        vst1q_f32(zr + k, vsubq_f32(sr, ui));
+        vst1q_f32(zi + k, vaddq_f32(si, ur));
+        vst1q_f32(zr + j, reverseNeon(vaddq_f32(sr, ui)));
+        vst1q_f32(zi + j, reverseNeon(vsubq_f32(ur, si)));
+    }
+    splitInversePairs(xr, xi, zr, zi, k, m, wr, wi);
+}
+
+void macNeon(const float* xr, const float* xi, const float* hr, const float* hi,
+             float* ar, float* ai, uint32_t m)
+{
+    for (uint32_t k = 0; k < m; k += 4) {
+        const float32x4_t vr = vld1q_f32(xr + k), vi = vld1q_f32(xi + k);
+        const float32x4_t cr = vld1q_f32(hr + k), ci = vld1q_f32(hi + k);
+        vst1q_f32(ar + k, vfmsq_f32(vfmaq_f32(vld1q_f32(ar + k), vr, cr), vi, ci));
+        vst1q_f32(ai + k, vfmaq_f32(vfmaq_f32(vld1q_f32(ai + k), vr, ci), vi, cr));
+    }
+}
+
+const FftKernels kNeonFft = {
+    4, passWideNeon, passNarrowNeon, splitForwardNeon, splitInverseNeon, macNeon,
+};
+
+#endif // DSP_HAVE_NEON
+
+/* ------------------------------------------------------------------ */
+/*  SSE2 (x86)                                                          */
+/* ------------------------------------------------------------------ */
+#if defined(DSP_HAVE_X86)
+
+__attribute__((target("sse2")))
+inline __m128 reverseSse2(__m128 v)
+{
+    return _mm_shuffle_ps(v, v, _MM_SHUFFLE(0, 1, 2, 3));
+}
+
+__attribute__((target("sse2")))
+void passWideSse2(const float* xr, const float* xi, float* yr, float* yi,
+                  uint32_t half, uint32_t s, const float* wr, const float* wi)
+{
+    const uint32_t rows = half / s;
+    for (uint32_t p = 0; p < rows; ++p) {
+        const __m128 cr = _mm_set1_ps(wr[p * s]);
+        const __m128 ci = _mm_set1_ps(wi[p * s]);
+        const size_t in  = static_cast<size_t>(s) * p;
+        const size_t out = 2 * in;
+        for (uint32_t q = 0; q < s; q += 4) {
+            const __m128 ar = _mm_loadu_ps(xr + in + q), ai = _mm_loadu_ps(xi + in + q);
+            const __m128 br = _mm_loadu_ps(xr + in + q + half), bi = _mm_loadu_ps(xi + in + q + half);
+            _mm_storeu_ps(yr + out + q, _mm_add_ps(ar, br));
+            _mm_storeu_ps(yi + out + q, _mm_add_ps(ai, bi));
+            const __m128 dr = _mm_sub_ps(ar, br), di = _mm_sub_ps(ai, bi);
+            _mm_storeu_ps(yr + out + s + q, _mm_sub_ps(_mm_mul_ps(dr, cr), _mm_mul_ps(di, ci)));
+            _mm_storeu_ps(yi + out + s + q, _mm_add_ps(_mm_mul_ps(dr, ci), _mm_mul_ps(di, cr)));
+        }
+    }
+}
+
+__attribute__((target("sse2")))
+void passNarrowSse2(const float* xr, const float* xi, float* yr, float* yi,
+                    uint32_t half, uint32_t s, const float* wr, const float* wi)
+{
+    for (uint32_t i = 0; i < half; i += 4) {
+        const __m128 ar = _mm_loadu_ps(xr + i), ai = _mm_loadu_ps(xi + i);
+        const __m128 br = _mm_loadu_ps(xr + i + half), bi = _mm_loadu_ps(xi + i + half);
+        const __m128 cr = _mm_loadu_ps(wr + i), ci = _mm_loadu_ps(wi + i);
+        const __m128 sr = _mm_add_ps(ar, br), si = _mm_add_ps(ai, bi);
+        const __m128 dr = _mm_sub_ps(ar, br), di = _mm_sub_ps(ai, bi);
+        const __m128 tr = _mm_sub_ps(_mm_mul_ps(dr, cr), _mm_mul_ps(di, ci));
+        const __m128 ti = _mm_add_ps(_mm_mul_ps(dr, ci), _mm_mul_ps(di, cr));
+        __m128 r0, r1, i0, i1;
+        if (s == 1) {
+            r0 = _mm_unpacklo_ps(sr, tr);
+            r1 = _mm_unpackhi_ps(sr, tr);
+            i0 = _mm_unpacklo_ps(si, ti);
+            i1 = _mm_unpackhi_ps(si, ti);
+        } else {
+            r0 = _mm_movelh_ps(sr, tr);
+            r1 = _mm_movehl_ps(tr, sr);
+            i0 = _mm_movelh_ps(si, ti);
+            i1 = _mm_movehl_ps(ti, si);
+        }
+        _mm_storeu_ps(yr + 2 * i, r0);
+        _mm_storeu_ps(yr + 2 * i + 4, r1);
+        _mm_storeu_ps(yi + 2 * i, i0);
+        _mm_storeu_ps(yi + 2 * i + 4, i1);
+    }
+}
+
+__attribute__((target("sse2")))
+void splitForwardSse2(const float* zr, const float* zi, float* xr, float* xi,
+                      uint32_t m, const float* wr, const float* wi)
+{
+    const __m128 h = _mm_set1_ps(0.5f);
+    splitForwardEdges(zr, zi, xr, xi, m);
+    uint32_t k = 1;
+    for (; k + 4 <= m / 2; k += 4) {
+        const uint32_t j = m - k - 3;   /* partners m − k … m − k − 3, reversed */
+        const __m128 ar = _mm_loadu_ps(zr + k), ai = _mm_loadu_ps(zi + k);
+        const __m128 br = reverseSse2(_mm_loadu_ps(zr + j)), bi = reverseSse2(_mm_loadu_ps(zi + j));
+        const __m128 cr = _mm_loadu_ps(wr + k), ci = _mm_loadu_ps(wi + k);
+        const __m128 er = _mm_mul_ps(h, _mm_add_ps(ar, br)), ei = _mm_mul_ps(h, _mm_sub_ps(ai, bi));
+        const __m128 orr = _mm_mul_ps(h, _mm_add_ps(ai, bi)), oi = _mm_mul_ps(h, _mm_sub_ps(br, ar));
+        const __m128 tr = _mm_sub_ps(_mm_mul_ps(cr, orr), _mm_mul_ps(ci, oi));
+        const __m128 ti = _mm_add_ps(_mm_mul_ps(cr, oi), _mm_mul_ps(ci, orr));
+        _mm_storeu_ps(xr + k, _mm_add_ps(er, tr));
+        _mm_storeu_ps(xi + k, _mm_add_ps(ei, ti));
+        _mm_storeu_ps(xr + j, reverseSse2(_mm_sub_ps(er, tr)));
+        _mm_storeu_ps(xi + j, reverseSse2(_mm_sub_ps(ti, ei)));
+    }
+    splitForwardPairs(zr, zi, xr, xi, k, m, wr, wi);
+}
+
+__attribute__((target("sse2")))
+void splitInverseSse2(const float* xr, const float* xi, float* zr, float* zi,
+                      uint32_t m, const float* wr, const float* wi)
+{
+    splitInverseEdges(xr, xi, zr, zi, m);
+    uint32_t k = 1;
+    for (; k + 4 <= m / 2; k += 4) {
+        const uint32_t j = m - k - 3;
+        const __m128 ar = _mm_loadu_ps(xr + k), ai = _mm_loadu_ps(xi + k);
+        const __m128 br = reverseSse2(_mm_loadu_ps(xr + j)), bi = reverseSse2(_mm_loadu_ps(xi + j));
+        const __m128 cr = _mm_loadu_ps(wr + k), ci = _mm_loadu_ps(wi + k);
+        const __m128 sr = _mm_add_ps(ar, br), si = _mm_sub_ps(ai, bi);
+        const __m128 dr = _mm_sub_ps(ar, br), di = _mm_add_ps(ai, bi);
+        const __m128 ur = _mm_add_ps(_mm_mul_ps(cr, dr), _mm_mul_ps(ci, di));
+        const __m128 ui = _mm_sub_ps(_mm_mul_ps(cr, di), _mm_mul_ps(ci, dr));
+        _mm_storeu_ps(zr + k, _mm_sub_ps(sr, ui));
+        _mm_storeu_ps(zi + k, _mm_add_ps(si, ur));
+        _mm_storeu_ps(zr + j, reverseSse2(_mm_add_ps(sr, ui)));
+        _mm_storeu_ps(zi + j, reverseSse2(_mm_sub_ps(ur, si)));
+    }
+    splitInversePairs(xr, xi, zr, zi, k, m, wr, wi);
+}
+
+__attribute__((target("sse2")))
+void macSse2(const float* xr, const float* xi, const float* hr, const float* hi,
+             float* ar, float* ai, uint32_t m)
+{
+    for (uint32_t k = 0; k < m; k += 4) {
+        const __m128 vr = _mm_loadu_ps(xr + k), vi = _mm_loadu_ps(xi + k);
+        const __m128 cr = _mm_loadu_ps(hr + k), ci = _mm_loadu_ps(hi + k);
+        const __m128 pr = _mm_sub_ps(_mm_mul_ps(vr, cr), _mm_mul_ps(vi, ci));
+        const __m128 pi = _mm_add_ps(_mm_mul_ps(vr, ci), _mm_mul_ps(vi, cr));
+        _mm_storeu_ps(ar + k, _mm_add_ps(_mm_loadu_ps(ar + k), pr));
+        _mm_storeu_ps(ai + k, _mm_add_ps(_mm_loadu_ps(ai + k), pi));
+    }
+}
+
+const FftKernels kSse2Fft = {
+    4, passWideSse2, passNarrowSse2, splitForwardSse2, splitInverseSse2, macSse2,
+};
+
+/* ------------------------------------------------------------------ */
+/*  AVX2 + FMA (x86)                                                    */
+/* ------------------------------------------------------------------ */
+__attribute__((target("avx2,fma")))
+inline __m256 reverseAvx2(__m256 v)
+{
+    const __m256 swapped = _mm256_permute2f128_ps(v, v, 0x01);
+    return _mm256_permute_ps(swapped, _MM_SHUFFLE(0, 1, 2, 3));
+}
+
+__attribute__((target("avx2,fma")))
+void passWideAvx2(const float* xr, const float* xi, float* yr, float* yi,
+                  uint32_t half, uint32_t s, const float* wr, const float* wi)
+{
+    const uint32_t rows = half / s;
+    for (uint32_t p = 0; p < rows; ++p) {
+        const __m256 cr = _mm256_set1_ps(wr[p * s]);
+        const __m256 ci = _mm256_set1_ps(wi[p * s]);
+        const size_t in  = static_cast<size_t>(s) * p;
+        const size_t out = 2 * in;
+        for (uint32_t q = 0; q < s; q += 8) {
+            const __m256 ar = _mm256_loadu_ps(xr + in + q), ai = _mm256_loadu_ps(xi + in + q);
+            const __m256 br = _mm256_loadu_ps(xr + in + q + half);
+            const __m256 bi = _mm256_loadu_ps(xi + in + q + half);
+            _mm256_storeu_ps(yr + out + q, _mm256_add_ps(ar, br));
+            _mm256_storeu_ps(yi + out + q, _mm256_add_ps(ai, bi));
+            const __m256 dr = _mm256_sub_ps(ar, br), di = _mm256_sub_ps(ai, bi);
+            _mm256_storeu_ps(yr + out + s + q, _mm256_fmsub_ps(dr, cr, _mm256_mul_ps(di, ci)));
+            _mm256_storeu_ps(yi + out + s + q, _mm256_fmadd_ps(dr, ci, _mm256_mul_ps(di, cr)));
+        }
+    }
+}
+
+/* Interleave rows of s floats: lo = a0 b0 a1 b1 …, hi = the second half */
+__attribute__((target("avx2,fma")))
+inline void interleaveAvx2(__m256 a, __m256 b, uint32_t s, __m256& lo, __m256& hi)
+{
+    /* The unpacks work per 128-bit lane; the permutes put the lanes in order */
+    __m256 t0 = a, t1 = b;
+    if (s == 1) {
+        t0 = _mm256_unpacklo_ps(a, b);
+        t1 = _mm256_unpackhi_ps(a, b);
+    } else if (s == 2) {
+        t0 = _mm256_castpd_ps(_mm256_unpacklo_pd(_mm256_castps_pd(a), _mm256_castps_pd(b)));
+        t1 = _mm256_castpd_ps(_mm256_unpackhi_pd(_mm256_castps_pd(a), _mm256_castps_pd(b)));
+    }
+    lo = _mm256_permute2f128_ps(t0, t1, 0x20);
+    hi = _mm256_permute2f128_ps(t0, t1, 0x31);
+}
+
+__attribute__((target("avx2,fma")))
+void passNarrowAvx2(const float* xr, const float* xi, float* yr, float* yi,
+                    uint32_t half, uint32_t s, const float* wr, const float* wi)
+{
+    for (uint32_t i = 0; i < half; i += 8) {
+        const __m256 ar = _mm256_loadu_ps(xr + i), ai = _mm256_loadu_ps(xi + i);
+        const __m256 br = _mm256_loadu_ps(xr + i + half), bi = _mm256_loadu_ps(xi + i + half);
+        const __m256 cr = _mm256_loadu_ps(wr + i), ci = _mm256_loadu_ps(wi + i);
+        const __m256 dr = _mm256_sub_ps(ar, br), di = _mm256_sub_ps(ai, bi);
+        const __m256 tr = _mm256_fmsub_ps(dr, cr, _mm256_mul_ps(di, ci));
+        const __m256 ti = _mm256_fmadd_ps(dr, ci, _mm256_mul_ps(di, cr));
+        __m256 lo, hi;
+        interleaveAvx2(_mm256_add_ps(ar, br), tr, s, lo, hi);
+        _mm256_storeu_ps(yr + 2 * i, lo);
+        _mm256_storeu_ps(yr + 2 * i + 8, hi);
+        interleaveAvx2(_mm256_add_ps(ai, bi), ti, s, lo, hi);
+        _mm256_storeu_ps(yi + 2 * i, lo);
+        _mm256_storeu_ps(yi + 2 * i + 8, hi);
+    }
+}
+
+__attribute__((target("avx2,fma")))
+void splitForwardAvx2(const float* zr, const float* zi, float* xr, float* xi,
+                      uint32_t m, const float* wr, const float* wi)
+{
+    const __m256 h = _mm256_set1_ps(0.5f);
+    splitForwardEdges(zr, zi, xr, xi, m);
+    uint32_t k = 1;
+    for (; k + 8 <= m / 2; k += 8) {
+        const uint32_t j = m - k - 7;   /* partners m − k … m − k − 7, reversed */
+        const __m256 ar = _mm256_loadu_ps(zr + k), ai = _mm256_loadu_ps(zi + k);
+        const __m256 br = reverseAvx2(_mm256_loadu_ps(zr + j));
+        const __m256 bi = reverseAvx2(_mm256_loadu_ps(zi + j));
+        const __m256 cr = _mm256_loadu_ps(wr + k), ci = _mm256_loadu_ps(wi + k);
+        const __m256 er  = _mm256_mul_ps(h, _mm256_add_ps(ar, br));
+        const __m256 ei  = _mm256_mul_ps(h, _mm256_sub_ps(ai, bi));
+        const __m256 orr = _mm256_mul_ps(h, _mm256_add_ps(ai, bi));
+        const __m256 oi  = _mm256_mul_ps(h, _mm256_sub_ps(br, ar));
+        const __m256 tr = _mm256_fmsub_ps(cr, orr, _mm256_mul_ps(ci, oi));
+        const __m256 ti = _mm256_fmadd_ps(cr, oi, _mm256_mul_ps(ci, orr));
+        _mm256_storeu_ps(xr + k, _mm256_add_ps(er, tr));
+        _mm256_storeu_ps(xi + k, _mm256_add_ps(ei, ti));
+        _mm256_storeu_ps(xr + j, reverseAvx2(_mm256_sub_ps(er, tr)));
+        _mm256_storeu_ps(xi + j, reverseAvx2(_mm256_sub_ps(ti, ei)));
+    }
+    splitForwardPairs(zr, zi, xr, xi, k, m, wr, wi);
+}
+
+__attribute__((target("avx2,fma")))
+void splitInverseAvx2(const float* xr, const float* xi, float* zr, float* zi,
+                      uint32_t m, const float* wr, const float* wi)
+{
+    splitInverseEdges(xr, xi, zr, zi, m);
+    uint32_t k = 1;
+    for (; k + 8 <= m / 2; k += 8) {
+        const uint32_t j = m - k - 7;
+        const __m256 ar = _mm256_loadu_ps(xr + k), ai = _mm256_loadu_ps(xi + k);
+        const __m256 br = reverseAvx2(_mm256_loadu_ps(xr + j));
+        const __m256 bi = reverseAvx2(_mm256_loadu_ps(xi + j));
+        const __m256 cr = _mm256_loadu_ps(wr + k), ci = _mm256_loadu_ps(wi + k);
+        const __m256 sr = _mm256_add_ps(ar, br), si = _mm256_sub_ps(ai, bi);
+        const __m256 dr = _mm256_sub_ps(ar, br), di = _mm256_add_ps(ai, bi);
+        const __m256 ur = _mm256_fmadd_ps(cr, dr, _mm256_mul_ps(ci, di));
+        const __m256 ui = _mm256_fmsub_ps(cr, di, _mm256_mul_ps(ci, dr));
+        _mm256_storeu_ps(zr + k, _mm256_sub_ps(sr, ui));
+        _mm256_storeu_ps(zi + k, _mm256_add_ps(si, ur));
+        _mm256_storeu_ps(zr + j, reverseAvx2(_mm256_add_ps(sr, ui)));
+        _mm256_storeu_ps(zi + j, reverseAvx2(_mm256_sub_ps(ur, si)));
+    }
+    splitInversePairs(xr, xi, zr, zi, k, m, wr, wi);
+}
+
+__attribute__((target("avx2,fma")))
+void macAvx2(const float* xr, const float* xi, const float* hr, const float* hi,
+             float* ar, float* ai, uint32_t m)
+{
+    for (uint32_t k = 0; k < m; k += 8) {
+        const __m256 vr = _mm256_loadu_ps(xr + k), vi = _mm256_loadu_ps(xi + k);
+        const __m256 cr = _mm256_loadu_ps(hr + k), ci = _mm256_loadu_ps(hi + k);
+        const __m256 accR = _mm256_fmadd_ps(vr, cr, _mm256_loadu_ps(ar + k));
+        const __m256 accI = _mm256_fmadd_ps(vr, ci, _mm256_loadu_ps(ai + k));
+        _mm256_storeu_ps(ar + k, _mm256_fnmadd_ps(vi, ci, accR));
+        _mm256_storeu_ps(ai + k, _mm256_fmadd_ps(vi, cr, accI));
+    }
+}
+
+const FftKernels kAvx2Fft = {
+    8, passWideAvx2, passNarrowAvx2, splitForwardAvx2, splitInverseAvx2, macAvx2,
+};
+
+#endif // DSP_HAVE_X86
+
+const FftKernels& fftKernelsFor(KernelIsa isa)
+{
+    switch (isa) {
+#if defined(DSP_HAVE_NEON)
+        case KernelIsa::Neon:
+            return kNeonFft;
+#endif
+#if defined(DSP_HAVE_X86)
+        case KernelIsa::Avx2:
+            return kAvx2Fft;
+        case KernelIsa::Sse2:
+            return kSse2Fft;
+#endif
+        default:
+            return kScalarFft;
+    }
+}
+
+} // namespace
+
+/* ------------------------------------------------------------------ */
+/*  RealFft                                                             */
+/* ------------------------------------------------------------------ */
+bool RealFft::init(uint32_t size)
+{
+    if (size < kMinSize || size > kMaxSize || (size & (size - 1)) != 0) {
+        return false;
+    }
+    n_ = size;
+    m_ = size / 2;
+    passes_ = 0;
+    while ((1u << passes_) < m_) {
+        ++passes_;
+    }
+    isa_ = activeKernelIsa();
+    kernels_ = &fftKernelsFor(isa_);
+
+    const uint32_t quarter = m_ / 2;
+    const double twoPi = 6.283185307179586476925;
+    passRe_.resize(quarter);
+    passIm_.resize(quarter);
+    splitRe_.resize(quarter);
+    splitIm_.resize(quarter);
+    for (uint32_t j = 0; j < quarter; ++j) {
+        passRe_[j]  = static_cast<float>(std::cos(twoPi * j / m_));
+        passIm_[j]  = static_cast<float>(-std::sin(twoPi * j / m_));
+        splitRe_[j] = static_cast<float>(std::cos(twoPi * j / n_));
+        splitIm_[j] = static_cast<float>(-std::sin(twoPi * j / n_));
+    }
+    pass2Re_.resize(quarter);
+    pass2Im_.resize(quarter);
+    pass4Re_.resize(quarter);
+    pass4Im_.resize(quarter);
+    for (uint32_t i = 0; i < quarter; ++i) {
+        pass2Re_[i] = passRe_[i & ~1u];
+        pass2Im_[i] = passIm_[i & ~1u];
+        pass4Re_[i] = passRe_[i & ~3u];
+        pass4Im_[i] = passIm_[i & ~3u];
+    }
+    return true;
+}
+
+void RealFft::complexForward(const float* inRe, const float* inIm, float* outRe, float* outIm,
+                             float* tmpRe, float* tmpIm) const
+{
+    const FftKernels& k = *kernels_;
+    const uint32_t half = m_ / 2;
+    const float* srcRe = inRe;
+    const float* srcIm = inIm;
+    for (uint32_t pass = 0; pass < passes_; ++pass) {
+        /* Alternate so that the last pass lands in out */
+        const bool toOut = ((passes_ - 1 - pass) & 1u) == 0;
+        float* dstRe = toOut ? outRe : tmpRe;
+        float* dstIm = toOut ? outIm : tmpIm;
+        const uint32_t s = 1u << pass;
+        if (s >= k.width) {
+            k.passWide(srcRe, srcIm, dstRe, dstIm, half, s, passRe_.data(), passIm_.data());
+        } else {
+            const float* wr = s == 1 ? passRe_.data() : s == 2 ? pass2Re_.data() : pass4Re_.data();
+            const float* wi = s == 1 ? passIm_.data() : s == 2 ? pass2Im_.data() : pass4Im_.data();
+            k.passNarrow(srcRe, srcIm, dstRe, dstIm, half, s, wr, wi);
+        }
+        srcRe = dstRe;
+        srcIm = dstIm;
+    }
+}
+
+void RealFft::forward(const float* even, const float* odd, float* re, float* im, float* work) const
+{
+    float* zr = work;
+    float* zi = work + m_;
+    complexForward(even, odd, zr, zi, work + 2 * m_, work + 3 * m_);
+    kernels_->splitForward(zr, zi, re, im, m_, splitRe_.data(), splitIm_.data());
+}
+
+void RealFft::inverse(const float* re, const float* im, float* even, float* odd, float* work) const
+{
+    /* IFFT(Z) = swap(FFT(swap(Z))): the split writes Z with re / im swapped
+       and the FFT's re / im outputs are odd / even */
+    float* zr = work;
+    float* zi = work + m_;
+    kernels_->splitInverse(re, im, zi, zr, m_, splitRe_.data(), splitIm_.data());
+    complexForward(zr, zi, odd, even, work + 2 * m_, work + 3 * m_);
+}
+
+void RealFft::multiplyAccumulate(const float* xRe, const float* xIm, const float* hRe,
+                                 const float* hIm, float* accRe, float* accIm) const
+{
+    /* Bin 0 packs two real bins (DC, Nyquist): multiply them separately */
+    const float dc = accRe[0] + xRe[0] * hRe[0];
+    const float nyquist = accIm[0] + xIm[0] * hIm[0];
+    kernels_->mac(xRe, xIm, hRe, hIm, accRe, accIm, m_);
+    accRe[0] = dc;
+    accIm[0] = nyquist;
+}
+
+} // namespace DspProcessor
@@ -0,0 +1,92 @@
+/**
+ * dsp_fft.h — vectorised real FFT for the convolution stage
+ *
+ * RealFft transforms N = 2^k real samples into the N/2 + 1 bins of their
+ * spectrum and back. A spectrum is held as two split arrays (re, im) of
+ * N/2 floats in packed form: re[0] is the DC bin and im[0] the Nyquist
+ * bin (both real), entries 1 … N/2−1 are the bins in between.
+ *
+ * The work is one N/2-point complex FFT (Stockham radix-2, out of place,
+ * so every pass reads and writes contiguous vectors and no bit reversal
+ * is needed) plus an O(N) pass that splits the two halves of the packed
+ * real signal. Both run in the SIMD variant of the ISA that was active
+ * when init() was called (see activeKernelIsa()).
+ *
+ * Time-domain signals are passed de-interleaved, even[n] = x[2n] and
+ * odd[n] = x[2n+1] for n < N/2: that is the complex input the FFT
+ * consumes, so callers that fill their buffers sample by sample can
+ * write them in this form directly.
+ *
+ * A RealFft is immutable after init(); one instance may be shared by any
+ * number of threads as long as each passes its own work buffer.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "dsp_kernels.h"
+
+namespace DspProcessor {
+
+struct FftKernels;
+
+class RealFft {
+public:
+    static constexpr uint32_t kMinSize = 64;
+    static constexpr uint32_t kMaxSize = 1u << 17;
+
+    /**
+     * Build the twiddle tables for @p size real points.
+     * @return false unless size is a power of two in [kMinSize, kMaxSize]
+     */
+    bool init(uint32_t size);
+
+    /** Real points N (0 before init()). */
+    uint32_t size() const { return n_; }
+
+    /** Length of every array the transforms take: N/2. */
+    uint32_t half() const { return m_; }
+
+    /** Floats of scratch forward() / inverse() need: 4 · N/2. */
+    size_t workFloats() const { return static_cast<size_t>(4) * m_; }
+
+    /** SIMD variant picked by init(). */
+    KernelIsa isa() const { return isa_; }
+
+    /**
+     * Spectrum of x = (even, odd) into packed (re, im).
+     * Outputs must not overlap the inputs or @p work.
+     */
+    void forward(const float* even, const float* odd, float* re, float* im, float* work) const;
+
+    /**
+     * Unscaled inverse: inverse(forward(x)) = N · x.
+     * Outputs must not overlap the inputs or @p work.
+     */
+    void inverse(const float* re, const float* im, float* even, float* odd, float* work) const;
+
+    /** acc += x · h, bin by bin, on packed spectra of half() entries. */
+    void multiplyAccumulate(const float* xRe, const float* xIm, const float* hRe, const float* hIm,
+                            float* accRe, float* accIm) const;
+
+private:
+    /* N/2-point complex FFT; in → out, tmp holds the intermediate passes */
+    void complexForward(const float* inRe, const float* inIm, float* outRe, float* outIm,
+                        float* tmpRe, float* tmpIm) const;
+
+    uint32_t n_ = 0;
+    uint32_t m_ = 0;
+    uint32_t passes_ = 0;                 /* log2(N/2)                            */
+    KernelIsa isa_ = KernelIsa::Scalar;
+    const FftKernels* kernels_ = nullptr;
+    /* exp(-2πi·j / (N/2)), j < N/4: pass twiddles; twiddle of element i in
+       a pass of stride s is entry i & ~(s-1), expanded for s = 2 and 4 */
+    std::vector<float> passRe_, passIm_, pass2Re_, pass2Im_, pass4Re_, pass4Im_;
+    /* exp(-2πi·k / N), k < N/4: the real split */
+    std::vector<float> splitRe_, splitIm_;
+};
+
+} // namespace DspProcessor
@@ -0,0 +1,1190 @@
+/**
+ * dsp_kernels.cpp — vectorised gain + soft-clip kernels
+ *
+ * Every variant evaluates the same rational approximation:
+ *
+ *   x'   = clamp(x, -7.90531, 7.90531)
+ *   P(x) = x · (a1 + a3·x² + … + a13·x¹²)
+ *   Q(x) = b0 + b2·x² + b4·x⁴ + b6·x⁶
+ *   tanh(x) ≈ |x| < 4e-4 ? x : P(x') / Q(x')
+ *
+ * SIMD loops handle whole vectors; the remainder goes through fastTanh().
+ * The guard variants run the same loops with a finiteness mask in front.
+ */
+
+#include "dsp_kernels.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstring>
+
+#if defined(__aarch64__)
+#include <arm_neon.h>
+#include <sys/auxv.h>
+#include <asm/hwcap.h>
+#define DSP_HAVE_NEON 1
+#elif defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define DSP_HAVE_X86 1
+#endif
+
+namespace DspProcessor {
+
+namespace {
+
+constexpr float kClamp = 7.90531110763549805f;
+constexpr float kTiny  = 0.0004f;
+
+constexpr float kA1  =  4.89352455891786e-03f;
+constexpr float kA3  =  6.37261928875436e-04f;
+constexpr float kA5  =  1.48572235717979e-05f;
+constexpr float kA7  =  5.12229709037114e-08f;
+constexpr float kA9  = -8.60467152213735e-11f;
+constexpr float kA11 =  2.00018790482477e-13f;
+constexpr float kA13 = -2.76076847742355e-16f;
+
+constexpr float kB0  =  4.89352518554385e-03f;
+constexpr float kB2  =  2.26843463243900e-03f;
+constexpr float kB4  =  1.18534705686654e-04f;
+constexpr float kB6  =  1.19825839466702e-06f;
+
+void softClipApproxTail(const float* src, float* dst, size_t n, float gain)
+{
+    for (size_t i = 0; i < n; ++i) {
+        dst[i] = fastTanh(src[i] * gain);
+    }
+}
+
+/* ------------------------------------------------------------------ */
+/*  NEON (aarch64)                                                      */
+/* ------------------------------------------------------------------ */
+#if defined(DSP_HAVE_NEON)
+inline float32x4_t tanhNeon(float32x4_t x)
+{
+    const uint32x4_t tiny = vcltq_f32(vabsq_f32(x), vdupq_n_f32(kTiny));
+    const float32x4_t xc = vmaxq_f32(vdupq_n_f32(-kClamp), vminq_f32(x, vdupq_n_f32(kClamp)));
+    const float32x4_t x2 = vmulq_f32(xc, xc);
+
+    float32x4_t p = vdupq_n_f32(kA13);
+    p = vfmaq_f32(vdupq_n_f32(kA11), p, x2);
+    p = vfmaq_f32(vdupq_n_f32(kA9),  p, x2);
+    p = vfmaq_f32(vdupq_n_f32(kA7),  p, x2);
+    p = vfmaq_f32(vdupq_n_f32(kA5),  p, x2);
+    p = vfmaq_f32(vdupq_n_f32(kA3),  p, x2);
+    p = vfmaq_f32(vdupq_n_f32(kA1),  p, x2);
+    p = vmulq_f32(p, xc);
+
+    float32x4_t q = vdupq_n_f32(kB6);
+    q = vfmaq_f32(vdupq_n_f32(kB4), q, x2);
+    q = vfmaq_f32(vdupq_n_f32(kB2), q, x2);
+    q = vfmaq_f32(vdupq_n_f32(kB0), q, x2);
+
+    return vbslq_f32(tiny, x, vdivq_f32(p, q));
+}
+
+void softClipNeon(const float* src, float* dst, size_t n, float gain)
+{
+    const float32x4_t g = vdupq_n_f32(gain);
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        float32x4_t a = vmulq_f32(vld1q_f32(src + i), g);
+        float32x4_t b = vmulq_f32(vld1q_f32(src + i + 4), g);
+        vst1q_f32(dst + i,     tanhNeon(a));
+        vst1q_f32(dst + i + 4, tanhNeon(b));
+    }
+    softClipApproxTail(src + i, dst + i, n - i, gain);
+}
+#endif
+
+/* ------------------------------------------------------------------ */
+/*  SSE2 / AVX2 (x86)                                                   */
+/* ------------------------------------------------------------------ */
+#if defined(DSP_HAVE_X86)
+__attribute__((target("sse2")))
+inline __m128 tanhSse2(__m128 x)
+{
+    const __m128 absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff));
+    const __m128 tiny = _mm_cmplt_ps(_mm_and_ps(x, absMask), _mm_set1_ps(kTiny));
+    /* min/max return the second operand on NaN, so NaN propagates */
+    const __m128 xc = _mm_max_ps(_mm_set1_ps(-kClamp), _mm_min_ps(_mm_set1_ps(kClamp), x));
+    const __m128 x2 = _mm_mul_ps(xc, xc);
+
+    __m128 p = _mm_set1_ps(kA13);
+    p = _mm_add_ps(_mm_mul_ps(p, x2), _mm_set1_ps(kA11));
+    p = _mm_add_ps(_mm_mul_ps(p, x2), _mm_set1_ps(kA9));
+    p = _mm_add_ps(_mm_mul_ps(p, x2), _mm_set1_ps(kA7));
+    p = _mm_add_ps(_mm_mul_ps(p, x2), _mm_set1_ps(kA5));
+    p = _mm_add_ps(_mm_mul_ps(p, x2), _mm_set1_ps(kA3));
+    p = _mm_add_ps(_mm_mul_ps(p, x2), _mm_set1_ps(kA1));
+    p = _mm_mul_ps(p, xc);
+
+    __m128 q = _mm_set1_ps(kB6);
+    q = _mm_add_ps(_mm_mul_ps(q, x2), _mm_set1_ps(kB4));
+    q = _mm_add_ps(_mm_mul_ps(q, x2), _mm_set1_ps(kB2));
+    q = _mm_add_ps(_mm_mul_ps(q, x2), _mm_set1_ps(kB0));
+
+    const __m128 r = _mm_div_ps(p, q);
+    return _mm_or_ps(_mm_and_ps(tiny, x), _mm_andnot_ps(tiny, r));
+}
+
+__attribute__((target("sse2")))
+void softClipSse2(const float* src, float* dst, size_t n, float gain)
+{
+    const __m128 g = _mm_set1_ps(gain);
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m128 a = _mm_mul_ps(_mm_loadu_ps(src + i), g);
+        __m128 b = _mm_mul_ps(_mm_loadu_ps(src + i + 4), g);
+        _mm_storeu_ps(dst + i,     tanhSse2(a));
+        _mm_storeu_ps(dst + i + 4, tanhSse2(b));
+    }
+    softClipApproxTail(src + i, dst + i, n - i, gain);
+}
+
+__attribute__((target("avx2,fma")))
+inline __m256 tanhAvx2(__m256 x)
+{
+    const __m256 absMask = _mm256_castsi256_ps(_mm256_set1_epi32(0x7fffffff));
+    const __m256 tiny = _mm256_cmp_ps(_mm256_and_ps(x, absMask), _mm256_set1_ps(kTiny), _CMP_LT_OQ);
+    const __m256 xc = _mm256_max_ps(_mm256_set1_ps(-kClamp), _mm256_min_ps(_mm256_set1_ps(kClamp), x));
+    const __m256 x2 = _mm256_mul_ps(xc, xc);
+
+    __m256 p = _mm256_set1_ps(kA13);
+    p = _mm256_fmadd_ps(p, x2, _mm256_set1_ps(kA11));
+    p = _mm256_fmadd_ps(p, x2, _mm256_set1_ps(kA9));
+    p = _mm256_fmadd_ps(p, x2, _mm256_set1_ps(kA7));
+    p = _mm256_fmadd_ps(p, x2, _mm256_set1_ps(kA5));
+    p = _mm256_fmadd_ps(p, x2, _mm256_set1_ps(kA3));
+    p = _mm256_fmadd_ps(p, x2, _mm256_set1_ps(kA1));
+    p = _mm256_mul_ps(p, xc);
+
+    __m256 q = _mm256_set1_ps(kB6);
+    q = _mm256_fmadd_ps(q, x2, _mm256_set1_ps(kB4));
+    q = _mm256_fmadd_ps(q, x2, _mm256_set1_ps(kB2));
+    q = _mm256_fmadd_ps(q, x2, _mm256_set1_ps(kB0));
+
+    return _mm256_blendv_ps(_mm256_div_ps(p, q), x, tiny);
+}
+
+__attribute__((target("avx2,fma")))
+void softClipAvx2(const float* src, float* dst, size_t n, float gain)
+{
+    const __m256 g = _mm256_set1_ps(gain);
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        __m256 a = _mm256_mul_ps(_mm256_loadu_ps(src + i), g);
+        __m256 b = _mm256_mul_ps(_mm256_loadu_ps(src + i + 8), g);
+        _mm256_storeu_ps(dst + i,     tanhAvx2(a));
+        _mm256_storeu_ps(dst + i + 8, tanhAvx2(b));
+    }
+    softClipApproxTail(src + i, dst + i, n - i, gain);
+}
+#endif
+
+/* ------------------------------------------------------------------ */
+/*  Metering                                                            */
+/* ------------------------------------------------------------------ */
+
+/* Samples between flushes of the float lane partials into the double
+   slot sums: keeps the float sums short enough to stay accurate */
+constexpr size_t kMeterSpan = 4096;
+constexpr uint32_t kMeterGroups = MeterLanes::kMaxPeriod / 8;
+
+/* Float partials of one 8-slot group between flushes */
+struct alignas(32) LanePartials {
+    float   inPeak[8];
+    float   outPeak[8];
+    float   inSq[8];
+    float   outSq[8];
+    int32_t clips[8];
+};
+
+inline uint32_t nextSlot(uint32_t pos, uint32_t period)
+{
+    return pos + 1 == period ? 0 : pos + 1;
+}
+
+/* One sample at slot pos. std::max keeps the accumulator when |x| is NaN. */
+inline void meterSide(MeterLanes::Side& side, uint32_t pos, float x)
+{
+    side.peak[pos] = std::max(side.peak[pos], std::fabs(x));
+    side.sum[pos] += static_cast<double>(x) * x;
+}
+
+/* Fused scalar samples [i, end): heads, tails and the scalar kernel */
+template <typename Tanh>
+void softClipMeterSamples(const float* src, float* dst, size_t i, size_t end, float gain,
+                          MeterLanes& m, Tanh tanhFn)
+{
+    for (; i < end; ++i) {
+        const float x = src[i];
+        const float a = x * gain;
+        const float y = tanhFn(a);
+        dst[i] = y;
+        meterSide(m.in, m.pos, x);
+        meterSide(m.out, m.pos, y);
+        m.clips[m.pos] += std::fabs(a) > 1.0f ? 1u : 0u;
+        m.pos = nextSlot(m.pos, m.period);
+    }
+}
+
+/* Input side and clip count of samples [i, end) from slot m.pos; the
+   output side follows through levelMeterSamples() once they are clipped */
+void meterSoftClipInput(const float* src, size_t i, size_t end, float gain, MeterLanes& m)
+{
+    uint32_t pos = m.pos;
+    for (; i < end; ++i) {
+        meterSide(m.in, pos, src[i]);
+        m.clips[pos] += std::fabs(src[i] * gain) > 1.0f ? 1u : 0u;
+        pos = nextSlot(pos, m.period);
+    }
+}
+
+/* Level-only scalar samples [i, end) from slot pos; returns the next slot */
+uint32_t levelMeterSamples(const float* x, size_t i, size_t end, MeterLanes& m, uint32_t pos,
+                           bool output, float clipAbove)
+{
+    MeterLanes::Side& side = output ? m.out : m.in;
+    for (; i < end; ++i) {
+        meterSide(side, pos, x[i]);
+        if (output) {
+            m.clips[pos] += std::fabs(x[i]) > clipAbove ? 1u : 0u;
+        }
+        pos = nextSlot(pos, m.period);
+    }
+    return pos;
+}
+
+/* Scalar samples needed before pos reaches a group boundary */
+inline size_t meterHeadLength(uint32_t pos, size_t n)
+{
+    return std::min<size_t>((8 - pos % 8) % 8, n);
+}
+
+/* End of the SIMD span starting at i: whole steps of @p step samples (the
+   plain kernel's loop step, so the same samples take the scalar tail),
+   at most kMeterSpan */
+inline size_t meterSpanEnd(size_t i, size_t n, size_t step = 8)
+{
+    return i + std::min(kMeterSpan, (n - i) & ~(step - 1));
+}
+
+void zeroPartials(LanePartials* part, uint32_t groups)
+{
+    std::memset(part, 0, groups * sizeof(LanePartials));
+}
+
+/* Fold the group partials into the slots (both sides unless levelOnly) */
+void flushPartials(MeterLanes& m, const LanePartials* part, uint32_t groups,
+                   bool levelOnly, bool output)
+{
+    for (uint32_t g = 0; g < groups; ++g) {
+        for (uint32_t j = 0; j < 8; ++j) {
+            const uint32_t s = g * 8 + j;
+            if (!levelOnly || !output) {
+                m.in.peak[s] = std::max(m.in.peak[s], part[g].inPeak[j]);
+                m.in.sum[s] += part[g].inSq[j];
+            }
+            if (!levelOnly || output) {
+                m.out.peak[s] = std::max(m.out.peak[s], part[g].outPeak[j]);
+                m.out.sum[s] += part[g].outSq[j];
+                m.clips[s]    += static_cast<uint32_t>(part[g].clips[j]);
+            }
+        }
+    }
+}
+
+#if defined(DSP_HAVE_NEON)
+struct MeterAccNeon {
+    float32x4_t inPeak[2], outPeak[2], inSq[2], outSq[2];
+    uint32x4_t  clips[2];
+};
+
+inline void loadAccNeon(MeterAccNeon& a, const LanePartials& p)
+{
+    for (int k = 0; k < 2; ++k) {
+        a.inPeak[k]  = vld1q_f32(p.inPeak + 4 * k);
+        a.outPeak[k] = vld1q_f32(p.outPeak + 4 * k);
+        a.inSq[k]    = vld1q_f32(p.inSq + 4 * k);
+        a.outSq[k]   = vld1q_f32(p.outSq + 4 * k);
+        a.clips[k]   = vld1q_u32(reinterpret_cast<const uint32_t*>(p.clips) + 4 * k);
+    }
+}
+
+inline void storeAccNeon(LanePartials& p, const MeterAccNeon& a)
+{
+    for (int k = 0; k < 2; ++k) {
+        vst1q_f32(p.inPeak + 4 * k, a.inPeak[k]);
+        vst1q_f32(p.outPeak + 4 * k, a.outPeak[k]);
+        vst1q_f32(p.inSq + 4 * k, a.inSq[k]);
+        vst1q_f32(p.outSq + 4 * k, a.outSq[k]);
+        vst1q_u32(reinterpret_cast<uint32_t*>(p.clips) + 4 * k, a.clips[k]);
+    }
+}
+
+/* 8 samples; vmaxnmq keeps the accumulator when |x| is NaN */
+inline void softClipMeterGroupNeon(const float* src, float* dst, float32x4_t g, MeterAccNeon& acc)
+{
+    const float32x4_t one = vdupq_n_f32(1.0f);
+    for (int k = 0; k < 2; ++k) {
+        const float32x4_t x = vld1q_f32(src + 4 * k);
+        const float32x4_t a = vmulq_f32(x, g);
+        const float32x4_t y = tanhNeon(a);
+        vst1q_f32(dst + 4 * k, y);
+        acc.inPeak[k]  = vmaxnmq_f32(acc.inPeak[k], vabsq_f32(x));
+        acc.outPeak[k] = vmaxnmq_f32(acc.outPeak[k], vabsq_f32(y));
+        acc.inSq[k]    = vfmaq_f32(acc.inSq[k], x, x);
+        acc.outSq[k]   = vfmaq_f32(acc.outSq[k], y, y);
+        acc.clips[k]   = vsubq_u32(acc.clips[k], vcagtq_f32(a, one));
+    }
+}
+
+void softClipMeterNeon(const float* src, float* dst, size_t n, float gain, MeterLanes& m)
+{
+    const float32x4_t g = vdupq_n_f32(gain);
+    const uint32_t groups = m.period / 8;
+    size_t i = meterHeadLength(m.pos, n);
+    softClipMeterSamples(src, dst, 0, i, gain, m, fastTanh);
+
+    LanePartials part[kMeterGroups];
+    while (n - i >= 8) {
+        const size_t end = meterSpanEnd(i, n);
+        uint32_t grp = m.pos / 8;
+        zeroPartials(part, groups);
+        if (groups == 1) {
+            MeterAccNeon acc;
+            loadAccNeon(acc, part[0]);
+            for (; i < end; i += 8) {
+                softClipMeterGroupNeon(src + i, dst + i, g, acc);
+            }
+            storeAccNeon(part[0], acc);
+        } else {
+            for (; i < end; i += 8) {
+                MeterAccNeon acc;
+                loadAccNeon(acc, part[grp]);
+                softClipMeterGroupNeon(src + i, dst + i, g, acc);
+                storeAccNeon(part[grp], acc);
+                grp = grp + 1 == groups ? 0 : grp + 1;
+            }
+        }
+        flushPartials(m, part, groups, false, false);
+        m.pos = grp * 8;
+    }
+    softClipMeterSamples(src, dst, i, n, gain, m, fastTanh);
+}
+
+/* One side of a group: peak, sum of squares, clip count */
+struct LevelAccNeon {
+    float32x4_t peak[2], sq[2];
+    uint32x4_t  clips[2];
+};
+
+inline void loadLevelNeon(LevelAccNeon& a, const LanePartials& p, bool output)
+{
+    const float* peak = output ? p.outPeak : p.inPeak;
+    const float* sq   = output ? p.outSq : p.inSq;
+    for (int k = 0; k < 2; ++k) {
+        a.peak[k]  = vld1q_f32(peak + 4 * k);
+        a.sq[k]    = vld1q_f32(sq + 4 * k);
+        a.clips[k] = vld1q_u32(reinterpret_cast<const uint32_t*>(p.clips) + 4 * k);
+    }
+}
+
+inline void storeLevelNeon(LanePartials& p, const LevelAccNeon& a, bool output)
+{
+    float* peak = output ? p.outPeak : p.inPeak;
+    float* sq   = output ? p.outSq : p.inSq;
+    for (int k = 0; k < 2; ++k) {
+        vst1q_f32(peak + 4 * k, a.peak[k]);
+        vst1q_f32(sq + 4 * k, a.sq[k]);
+        vst1q_u32(reinterpret_cast<uint32_t*>(p.clips) + 4 * k, a.clips[k]);
+    }
+}
+
+inline void levelMeterGroupNeon(const float* x, float32x4_t limit, LevelAccNeon& acc)
+{
+    for (int k = 0; k < 2; ++k) {
+        const float32x4_t v = vld1q_f32(x + 4 * k);
+        acc.peak[k]  = vmaxnmq_f32(acc.peak[k], vabsq_f32(v));
+        acc.sq[k]    = vfmaq_f32(acc.sq[k], v, v);
+        acc.clips[k] = vsubq_u32(acc.clips[k], vcagtq_f32(v, limit));
+    }
+}
+
+void levelMeterNeon(const float* x, size_t n, MeterLanes& m, bool output, float clipAbove)
+{
+    const uint32_t groups = m.period / 8;
+    const float32x4_t limit = vdupq_n_f32(clipAbove);
+    size_t i = meterHeadLength(m.pos, n);
+    uint32_t pos = levelMeterSamples(x, 0, i, m, m.pos, output, clipAbove);
+
+    LanePartials part[kMeterGroups];
+    while (n - i >= 8) {
+        const size_t end = meterSpanEnd(i, n);
+        uint32_t grp = pos / 8;
+        zeroPartials(part, groups);
+        if (groups == 1) {
+            LevelAccNeon acc;
+            loadLevelNeon(acc, part[0], output);
+            for (; i < end; i += 8) {
+                levelMeterGroupNeon(x + i, limit, acc);
+            }
+            storeLevelNeon(part[0], acc, output);
+        } else {
+            for (; i < end; i += 8) {
+                LevelAccNeon acc;
+                loadLevelNeon(acc, part[grp], output);
+                levelMeterGroupNeon(x + i, limit, acc);
+                storeLevelNeon(part[grp], acc, output);
+                grp = grp + 1 == groups ? 0 : grp + 1;
+            }
+        }
+        flushPartials(m, part, groups, true, output);
+        pos = grp * 8;
+    }
+    levelMeterSamples(x, i, n, m, pos, output, clipAbove);
+}
+#endif
+
+#if defined(DSP_HAVE_X86)
+struct MeterAccSse2 {
+    __m128  inPeak[2], outPeak[2], inSq[2], outSq[2];
+    __m128i clips[2];
+};
+
+__attribute__((target("sse2")))
+inline void loadAccSse2(MeterAccSse2& a, const LanePartials& p)
+{
+    for (int k = 0; k < 2; ++k) {
+        a.inPeak[k]  = _mm_load_ps(p.inPeak + 4 * k);
+        a.outPeak[k] = _mm_load_ps(p.outPeak + 4 * k);
+        a.inSq[k]    = _mm_load_ps(p.inSq + 4 * k);
+        a.outSq[k]   = _mm_load_ps(p.outSq + 4 * k);
+        a.clips[k]   = _mm_load_si128(reinterpret_cast<const __m128i*>(p.clips + 4 * k));
+    }
+}
+
+__attribute__((target("sse2")))
+inline void storeAccSse2(LanePartials& p, const MeterAccSse2& a)
+{
+    for (int k = 0; k < 2; ++k) {
+        _mm_store_ps(p.inPeak + 4 * k, a.inPeak[k]);
+        _mm_store_ps(p.outPeak + 4 * k, a.outPeak[k]);
+        _mm_store_ps(p.inSq + 4 * k, a.inSq[k]);
+        _mm_store_ps(p.outSq + 4 * k, a.outSq[k]);
+        _mm_store_si128(reinterpret_cast<__m128i*>(p.clips + 4 * k), a.clips[k]);
+    }
+}
+
+/* 8 samples. max_ps returns its second operand on NaN: the accumulator. */
+__attribute__((target("sse2")))
+inline void softClipMeterGroupSse2(const float* src, float* dst, __m128 g, MeterAccSse2& acc)
+{
+    const __m128 absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff));
+    const __m128 one = _mm_set1_ps(1.0f);
+    for (int k = 0; k < 2; ++k) {
+        const __m128 x = _mm_loadu_ps(src + 4 * k);
+        const __m128 a = _mm_mul_ps(x, g);
+        const __m128 y = tanhSse2(a);
+        _mm_storeu_ps(dst + 4 * k, y);
+        acc.inPeak[k]  = _mm_max_ps(_mm_and_ps(x, absMask), acc.inPeak[k]);
+        acc.outPeak[k] = _mm_max_ps(_mm_and_ps(y, absMask), acc.outPeak[k]);
+        acc.inSq[k]    = _mm_add_ps(acc.inSq[k], _mm_mul_ps(x, x));
+        acc.outSq[k]   = _mm_add_ps(acc.outSq[k], _mm_mul_ps(y, y));
+        const __m128 clip = _mm_cmpgt_ps(_mm_and_ps(a, absMask), one);
+        acc.clips[k] = _mm_sub_epi32(acc.clips[k], _mm_castps_si128(clip));
+    }
+}
+
+__attribute__((target("sse2")))
+void softClipMeterSse2(const float* src, float* dst, size_t n, float gain, MeterLanes& m)
+{
+    const __m128 g = _mm_set1_ps(gain);
+    const uint32_t groups = m.period / 8;
+    size_t i = meterHeadLength(m.pos, n);
+    softClipMeterSamples(src, dst, 0, i, gain, m, fastTanh);
+
+    LanePartials part[kMeterGroups];
+    while (n - i >= 8) {
+        const size_t end = meterSpanEnd(i, n);
+        uint32_t grp = m.pos / 8;
+        zeroPartials(part, groups);
+        if (groups == 1) {
+            /* channels divide 8: the accumulators stay in registers */
+            MeterAccSse2 acc;
+            loadAccSse2(acc, part[0]);
+            for (; i < end; i += 8) {
+                softClipMeterGroupSse2(src + i, dst + i, g, acc);
+            }
+            storeAccSse2(part[0], acc);
+        } else {
+            for (; i < end; i += 8) {
+                MeterAccSse2 acc;
+                loadAccSse2(acc, part[grp]);
+                softClipMeterGroupSse2(src + i, dst + i, g, acc);
+                storeAccSse2(part[grp], acc);
+                grp = grp + 1 == groups ? 0 : grp + 1;
+            }
+        }
+        flushPartials(m, part, groups, false, false);
+        m.pos = grp * 8;
+    }
+    softClipMeterSamples(src, dst, i, n, gain, m, fastTanh);
+}
+
+/* One side of a group: peak, sum of squares, clip count */
+struct LevelAccSse2 {
+    __m128  peak[2], sq[2];
+    __m128i clips[2];
+};
+
+__attribute__((target("sse2")))
+inline void loadLevelSse2(LevelAccSse2& a, const LanePartials& p, bool output)
+{
+    const float* peak = output ? p.outPeak : p.inPeak;
+    const float* sq   = output ? p.outSq : p.inSq;
+    for (int k = 0; k < 2; ++k) {
+        a.peak[k]  = _mm_load_ps(peak + 4 * k);
+        a.sq[k]    = _mm_load_ps(sq + 4 * k);
+        a.clips[k] = _mm_load_si128(reinterpret_cast<const __m128i*>(p.clips + 4 * k));
+    }
+}
+
+__attribute__((target("sse2")))
+inline void storeLevelSse2(LanePartials& p, const LevelAccSse2& a, bool output)
+{
+    float* peak = output ? p.outPeak : p.inPeak;
+    float* sq   = output ? p.outSq : p.inSq;
+    for (int k = 0; k < 2; ++k) {
+        _mm_store_ps(peak + 4 * k, a.peak[k]);
+        _mm_store_ps(sq + 4 * k, a.sq[k]);
+        _mm_store_si128(reinterpret_cast<__m128i*>(p.clips + 4 * k), a.clips[k]);
+    }
+}
+
+__attribute__((target("sse2")))
+inline void levelMeterGroupSse2(const float* x, __m128 limit, LevelAccSse2& acc)
+{
+    const __m128 absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff));
+    for (int k = 0; k < 2; ++k) {
+        const __m128 v   = _mm_loadu_ps(x + 4 * k);
+        const __m128 mag = _mm_and_ps(v, absMask);
+        acc.peak[k]  = _mm_max_ps(mag, acc.peak[k]);
+        acc.sq[k]    = _mm_add_ps(acc.sq[k], _mm_mul_ps(v, v));
+        acc.clips[k] = _mm_sub_epi32(acc.clips[k], _mm_castps_si128(_mm_cmpgt_ps(mag, limit)));
+    }
+}
+
+__attribute__((target("sse2")))
+void levelMeterSse2(const float* x, size_t n, MeterLanes& m, bool output, float clipAbove)
+{
+    const __m128 limit = _mm_set1_ps(clipAbove);
+    const uint32_t groups = m.period / 8;
+    size_t i = meterHeadLength(m.pos, n);
+    uint32_t pos = levelMeterSamples(x, 0, i, m, m.pos, output, clipAbove);
+
+    LanePartials part[kMeterGroups];
+    while (n - i >= 8) {
+        const size_t end = meterSpanEnd(i, n);
+        uint32_t grp = pos / 8;
+        zeroPartials(part, groups);
+        if (groups == 1) {
+            LevelAccSse2 acc;
+            loadLevelSse2(acc, part[0], output);
+            for (; i < end; i += 8) {
+                levelMeterGroupSse2(x + i, limit, acc);
+            }
+            storeLevelSse2(part[0], acc, output);
+        } else {
+            for (; i < end; i += 8) {
+                LevelAccSse2 acc;
+                loadLevelSse2(acc, part[grp], output);
+                levelMeterGroupSse2(x + i, limit, acc);
+                storeLevelSse2(part[grp], acc, output);
+                grp = grp + 1 == groups ? 0 : grp + 1;
+            }
+        }
+        flushPartials(m, part, groups, true, output);
+        pos = grp * 8;
+    }
+    levelMeterSamples(x, i, n, m, pos, output, clipAbove);
+}
+
+struct MeterAccAvx2 {
+    __m256  inPeak, outPeak, inSq, outSq;
+    __m256i clips;
+};
+
+__attribute__((target("avx2,fma")))
+inline void loadAccAvx2(MeterAccAvx2& a, const LanePartials& p)
+{
+    a.inPeak  = _mm256_load_ps(p.inPeak);
+    a.outPeak = _mm256_load_ps(p.outPeak);
+    a.inSq    = _mm256_load_ps(p.inSq);
+    a.outSq   = _mm256_load_ps(p.outSq);
+    a.clips   = _mm256_load_si256(reinterpret_cast<const __m256i*>(p.clips));
+}
+
+__attribute__((target("avx2,fma")))
+inline void storeAccAvx2(LanePartials& p, const MeterAccAvx2& a)
+{
+    _mm256_store_ps(p.inPeak, a.inPeak);
+    _mm256_store_ps(p.outPeak, a.outPeak);
+    _mm256_store_ps(p.inSq, a.inSq);
+    _mm256_store_ps(p.outSq, a.outSq);
+    _mm256_store_si256(reinterpret_cast<__m256i*>(p.clips), a.clips);
+}
+
+/* 8 samples = one vector = one slot group */
+__attribute__((target("avx2,fma")))
+inline void softClipMeterGroupAvx2(const float* src, float* dst, __m256 g, MeterAccAvx2& acc)
+{
+    const __m256 absMask = _mm256_castsi256_ps(_mm256_set1_epi32(0x7fffffff));
+    const __m256 x = _mm256_loadu_ps(src);
+    const __m256 a = _mm256_mul_ps(x, g);
+    const __m256 y = tanhAvx2(a);
+    _mm256_storeu_ps(dst, y);
+    acc.inPeak  = _mm256_max_ps(_mm256_and_ps(x, absMask), acc.inPeak);
+    acc.outPeak = _mm256_max_ps(_mm256_and_ps(y, absMask), acc.outPeak);
+    acc.inSq    = _mm256_fmadd_ps(x, x, acc.inSq);
+    acc.outSq   = _mm256_fmadd_ps(y, y, acc.outSq);
+    const __m256 clip = _mm256_cmp_ps(_mm256_and_ps(a, absMask), _mm256_set1_ps(1.0f), _CMP_GT_OQ);
+    acc.clips = _mm256_sub_epi32(acc.clips, _mm256_castps_si256(clip));
+}
+
+__attribute__((target("avx2,fma")))
+void softClipMeterAvx2(const float* src, float* dst, size_t n, float gain, MeterLanes& m)
+{
+    const __m256 g = _mm256_set1_ps(gain);
+    const uint32_t groups = m.period / 8;
+    /* Head and tail call softClipApproxTail() from here, as softClipAvx2()
+       does, so the scalar samples get the same FMA contraction */
+    size_t i = meterHeadLength(m.pos, n);
+    meterSoftClipInput(src, 0, i, gain, m);
+    softClipApproxTail(src, dst, i, gain);
+    m.pos = levelMeterSamples(dst, 0, i, m, m.pos, true, INFINITY);
+
+    LanePartials part[kMeterGroups];
+    while (n - i >= 16) {
+        const size_t end = meterSpanEnd(i, n, 16);
+        uint32_t grp = m.pos / 8;
+        zeroPartials(part, groups);
+        if (groups == 1) {
+            /* One accumulator set: the tanh divide bounds the loop, and a
+               second set would spill next to the polynomial constants */
+            MeterAccAvx2 acc;
+            loadAccAvx2(acc, part[0]);
+            for (; i < end; i += 16) {
+                softClipMeterGroupAvx2(src + i, dst + i, g, acc);
+                softClipMeterGroupAvx2(src + i + 8, dst + i + 8, g, acc);
+            }
+            storeAccAvx2(part[0], acc);
+        } else {
+            for (; i < end; i += 8) {
+                MeterAccAvx2 acc;
+                loadAccAvx2(acc, part[grp]);
+                softClipMeterGroupAvx2(src + i, dst + i, g, acc);
+                storeAccAvx2(part[grp], acc);
+                grp = grp + 1 == groups ? 0 : grp + 1;
+            }
+        }
+        flushPartials(m, part, groups, false, false);
+        m.pos = grp * 8;
+    }
+    meterSoftClipInput(src, i, n, gain, m);
+    softClipApproxTail(src + i, dst + i, n - i, gain);
+    m.pos = levelMeterSamples(dst, i, n, m, m.pos, true, INFINITY);
+}
+
+struct LevelAccAvx2 {
+    __m256  peak, sq;
+    __m256i clips;
+};
+
+__attribute__((target("avx2,fma")))
+inline void loadLevelAvx2(LevelAccAvx2& a, const LanePartials& p, bool output)
+{
+    a.peak  = _mm256_load_ps(output ? p.outPeak : p.inPeak);
+    a.sq    = _mm256_load_ps(output ? p.outSq : p.inSq);
+    a.clips = _mm256_load_si256(reinterpret_cast<const __m256i*>(p.clips));
+}
+
+__attribute__((target("avx2,fma")))
+inline void storeLevelAvx2(LanePartials& p, const LevelAccAvx2& a, bool output)
+{
+    _mm256_store_ps(output ? p.outPeak : p.inPeak, a.peak);
+    _mm256_store_ps(output ? p.outSq : p.inSq, a.sq);
+    _mm256_store_si256(reinterpret_cast<__m256i*>(p.clips), a.clips);
+}
+
+__attribute__((target("avx2,fma")))
+inline void levelMeterGroupAvx2(const float* x, __m256 limit, LevelAccAvx2& acc)
+{
+    const __m256 absMask = _mm256_castsi256_ps(_mm256_set1_epi32(0x7fffffff));
+    const __m256 v   = _mm256_loadu_ps(x);
+    const __m256 mag = _mm256_and_ps(v, absMask);
+    acc.peak  = _mm256_max_ps(mag, acc.peak);
+    acc.sq    = _mm256_fmadd_ps(v, v, acc.sq);
+    acc.clips = _mm256_sub_epi32(acc.clips, _mm256_castps_si256(_mm256_cmp_ps(mag, limit, _CMP_GT_OQ)));
+}
+
+__attribute__((target("avx2,fma")))
+void levelMeterAvx2(const float* x, size_t n, MeterLanes& m, bool output, float clipAbove)
+{
+    const __m256 limit = _mm256_set1_ps(clipAbove);
+    const uint32_t groups = m.period / 8;
+    size_t i = meterHeadLength(m.pos, n);
+    uint32_t pos = levelMeterSamples(x, 0, i, m, m.pos, output, clipAbove);
+
+    LanePartials part[kMeterGroups];
+    while (n - i >= 8) {
+        const size_t end = meterSpanEnd(i, n);
+        uint32_t grp = pos / 8;
+        zeroPartials(part, groups);
+        if (groups == 1) {
+            /* Two accumulator sets so consecutive vectors do not chain */
+            LevelAccAvx2 acc0, acc1;
+            loadLevelAvx2(acc0, part[0], output);
+            loadLevelAvx2(acc1, part[0], output);
+            for (; i + 16 <= end; i += 16) {
+                levelMeterGroupAvx2(x + i, limit, acc0);
+                levelMeterGroupAvx2(x + i + 8, limit, acc1);
+            }
+            if (i < end) {
+                levelMeterGroupAvx2(x + i, limit, acc0);
+                i += 8;
+            }
+            acc0.peak  = _mm256_max_ps(acc0.peak, acc1.peak);
+            acc0.sq    = _mm256_add_ps(acc0.sq, acc1.sq);
+            acc0.clips = _mm256_add_epi32(acc0.clips, acc1.clips);
+            storeLevelAvx2(part[0], acc0, output);
+        } else {
+            for (; i < end; i += 8) {
+                LevelAccAvx2 acc;
+                loadLevelAvx2(acc, part[grp], output);
+                levelMeterGroupAvx2(x + i, limit, acc);
+                storeLevelAvx2(part[grp], acc, output);
+                grp = grp + 1 == groups ? 0 : grp + 1;
+            }
+        }
+        flushPartials(m, part, groups, true, output);
+        pos = grp * 8;
+    }
+    levelMeterSamples(x, i, n, m, pos, output, clipAbove);
+}
+#endif
+
+void softClipMeterScalar(const float* src, float* dst, size_t n, float gain, MeterLanes& m)
+{
+    softClipMeterSamples(src, dst, 0, n, gain, m, [](float a) { return std::tanh(a); });
+}
+
+void levelMeterScalar(const float* x, size_t n, MeterLanes& m, bool output, float clipAbove)
+{
+    levelMeterSamples(x, 0, n, m, m.pos, output, clipAbove);
+}
+
+/* ------------------------------------------------------------------ */
+/*  Non-finite guard                                                    */
+/* ------------------------------------------------------------------ */
+
+/* A float is NaN or ±Inf exactly when its exponent bits are all set. SIMD
+   variants compare the exponent field as integers, so the test does not
+   depend on the FP environment (DAZ, FZ) and never raises an exception;
+   the lanes of the compare mask (all ones = -1) are subtracted from a
+   counter vector, reduced once at the end. */
+constexpr uint32_t kExponentMask = 0x7f800000u;
+
+inline bool nonFinite(float x)
+{
+    uint32_t bits;
+    std::memcpy(&bits, &x, sizeof(bits));
+    return (bits & kExponentMask) == kExponentMask;
+}
+
+size_t sanitizeSamples(const float* src, float* dst, size_t n)
+{
+    size_t bad = 0;
+    for (size_t i = 0; i < n; ++i) {
+        const float x = src[i];
+        const bool drop = nonFinite(x);
+        bad += drop ? 1u : 0u;
+        dst[i] = drop ? 0.0f : x;
+    }
+    return bad;
+}
+
+/* Remainder of a SIMD guard kernel (< 16 samples): the plain kernel's
+   tail on sanitized copies, so it rounds exactly as the plain kernel does
+   (inlined into the same target, with the same contractions) */
+inline size_t softClipGuardTail(const float* src, float* dst, size_t n, float gain)
+{
+    float tail[16];
+    const size_t bad = sanitizeSamples(src, tail, n);
+    softClipApproxTail(tail, dst, n, gain);
+    return bad;
+}
+
+size_t softClipGuardScalar(const float* src, float* dst, size_t n, float gain)
+{
+    size_t bad = 0;
+    for (size_t i = 0; i < n; ++i) {
+        float x = src[i];
+        if (nonFinite(x)) {
+            x = 0.0f;
+            ++bad;
+        }
+        dst[i] = std::tanh(x * gain);
+    }
+    return bad;
+}
+
+#if defined(DSP_HAVE_NEON)
+inline float32x4_t finiteNeon(float32x4_t x, uint32x4_t& bad)
+{
+    const uint32x4_t exp  = vdupq_n_u32(kExponentMask);
+    const uint32x4_t bits = vreinterpretq_u32_f32(x);
+    const uint32x4_t mask = vceqq_u32(vandq_u32(bits, exp), exp);
+    bad = vsubq_u32(bad, mask);
+    return vreinterpretq_f32_u32(vbicq_u32(bits, mask));
+}
+
+size_t softClipGuardNeon(const float* src, float* dst, size_t n, float gain)
+{
+    const float32x4_t g = vdupq_n_f32(gain);
+    uint32x4_t bad = vdupq_n_u32(0);
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        float32x4_t a = vmulq_f32(finiteNeon(vld1q_f32(src + i), bad), g);
+        float32x4_t b = vmulq_f32(finiteNeon(vld1q_f32(src + i + 4), bad), g);
+        vst1q_f32(dst + i,     tanhNeon(a));
+        vst1q_f32(dst + i + 4, tanhNeon(b));
+    }
+    return vaddvq_u32(bad) + softClipGuardTail(src + i, dst + i, n - i, gain);
+}
+
+size_t sanitizeNeon(const float* src, float* dst, size_t n)
+{
+    uint32x4_t bad = vdupq_n_u32(0);
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        const float32x4_t a = finiteNeon(vld1q_f32(src + i), bad);
+        const float32x4_t b = finiteNeon(vld1q_f32(src + i + 4), bad);
+        vst1q_f32(dst + i,     a);
+        vst1q_f32(dst + i + 4, b);
+    }
+    return vaddvq_u32(bad) + sanitizeSamples(src + i, dst + i, n - i);
+}
+#endif
+
+#if defined(DSP_HAVE_X86)
+__attribute__((target("sse2")))
+inline __m128 finiteSse2(__m128 x, __m128i& bad)
+{
+    const __m128i exp  = _mm_set1_epi32(static_cast<int>(kExponentMask));
+    const __m128i mask = _mm_cmpeq_epi32(_mm_and_si128(_mm_castps_si128(x), exp), exp);
+    bad = _mm_sub_epi32(bad, mask);
+    return _mm_andnot_ps(_mm_castsi128_ps(mask), x);
+}
+
+__attribute__((target("sse2")))
+inline size_t laneSumSse2(__m128i v)
+{
+    alignas(16) uint32_t lanes[4];
+    _mm_store_si128(reinterpret_cast<__m128i*>(lanes), v);
+    return static_cast<size_t>(lanes[0]) + lanes[1] + lanes[2] + lanes[3];
+}
+
+__attribute__((target("sse2")))
+size_t softClipGuardSse2(const float* src, float* dst, size_t n, float gain)
+{
+    const __m128 g = _mm_set1_ps(gain);
+    __m128i bad = _mm_setzero_si128();
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m128 a = _mm_mul_ps(finiteSse2(_mm_loadu_ps(src + i), bad), g);
+        __m128 b = _mm_mul_ps(finiteSse2(_mm_loadu_ps(src + i + 4), bad), g);
+        _mm_storeu_ps(dst + i,     tanhSse2(a));
+        _mm_storeu_ps(dst + i + 4, tanhSse2(b));
+    }
+    return laneSumSse2(bad) + softClipGuardTail(src + i, dst + i, n - i, gain);
+}
+
+__attribute__((target("sse2")))
+size_t sanitizeSse2(const float* src, float* dst, size_t n)
+{
+    __m128i bad = _mm_setzero_si128();
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        const __m128 a = finiteSse2(_mm_loadu_ps(src + i), bad);
+        const __m128 b = finiteSse2(_mm_loadu_ps(src + i + 4), bad);
+        _mm_storeu_ps(dst + i,     a);
+        _mm_storeu_ps(dst + i + 4, b);
+    }
+    return laneSumSse2(bad) + sanitizeSamples(src + i, dst + i, n - i);
+}
+
+__attribute__((target("avx2,fma")))
+inline __m256 finiteAvx2(__m256 x, __m256i& bad)
+{
+    const __m256i exp  = _mm256_set1_epi32(static_cast<int>(kExponentMask));
+    const __m256i mask = _mm256_cmpeq_epi32(_mm256_and_si256(_mm256_castps_si256(x), exp), exp);
+    bad = _mm256_sub_epi32(bad, mask);
+    return _mm256_andnot_ps(_mm256_castsi256_ps(mask), x);
+}
+
+__attribute__((target("avx2,fma")))
+inline size_t laneSumAvx2(__m256i v)
+{
+    const __m128i s = _mm_add_epi32(_mm256_castsi256_si128(v), _mm256_extracti128_si256(v, 1));
+    return laneSumSse2(s);
+}
+
+__attribute__((target("avx2,fma")))
+size_t softClipGuardAvx2(const float* src, float* dst, size_t n, float gain)
+{
+    const __m256 g = _mm256_set1_ps(gain);
+    __m256i bad = _mm256_setzero_si256();
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        __m256 a = _mm256_mul_ps(finiteAvx2(_mm256_loadu_ps(src + i), bad), g);
+        __m256 b = _mm256_mul_ps(finiteAvx2(_mm256_loadu_ps(src + i + 8), bad), g);
+        _mm256_storeu_ps(dst + i,     tanhAvx2(a));
+        _mm256_storeu_ps(dst + i + 8, tanhAvx2(b));
+    }
+    return laneSumAvx2(bad) + softClipGuardTail(src + i, dst + i, n - i, gain);
+}
+
+__attribute__((target("avx2,fma")))
+size_t sanitizeAvx2(const float* src, float* dst, size_t n)
+{
+    __m256i bad = _mm256_setzero_si256();
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        const __m256 a = finiteAvx2(_mm256_loadu_ps(src + i), bad);
+        const __m256 b = finiteAvx2(_mm256_loadu_ps(src + i + 8), bad);
+        _mm256_storeu_ps(dst + i,     a);
+        _mm256_storeu_ps(dst + i + 8, b);
+    }
+    return laneSumAvx2(bad) + sanitizeSamples(src + i, dst + i, n - i);
+}
+#endif
+
+SoftClipKernel kernelFor(KernelIsa isa)
+{
+    switch (isa) {
+#if defined(DSP_HAVE_NEON)
+        case KernelIsa::Neon: return softClipNeon;
+#endif
+#if defined(DSP_HAVE_X86)
+        case KernelIsa::Sse2: return softClipSse2;
+        case KernelIsa::Avx2: return softClipAvx2;
+#endif
+        default:              return softClipScalar;
+    }
+}
+
+SoftClipMeterKernel meterKernelFor(KernelIsa isa)
+{
+    switch (isa) {
+#if defined(DSP_HAVE_NEON)
+        case KernelIsa::Neon: return softClipMeterNeon;
+#endif
+#if defined(DSP_HAVE_X86)
+        case KernelIsa::Sse2: return softClipMeterSse2;
+        case KernelIsa::Avx2: return softClipMeterAvx2;
+#endif
+        default:              return softClipMeterScalar;
+    }
+}
+
+LevelMeterKernel levelKernelFor(KernelIsa isa)
+{
+    switch (isa) {
+#if defined(DSP_HAVE_NEON)
+        case KernelIsa::Neon: return levelMeterNeon;
+#endif
+#if defined(DSP_HAVE_X86)
+        case KernelIsa::Sse2: return levelMeterSse2;
+        case KernelIsa::Avx2: return levelMeterAvx2;
+#endif
+        default:              return levelMeterScalar;
+    }
+}
+
+SoftClipGuardKernel guardKernelFor(KernelIsa isa)
+{
+    switch (isa) {
+#if defined(DSP_HAVE_NEON)
+        case KernelIsa::Neon: return softClipGuardNeon;
+#endif
+#if defined(DSP_HAVE_X86)
+        case KernelIsa::Sse2: return softClipGuardSse2;
+        case KernelIsa::Avx2: return softClipGuardAvx2;
+#endif
+        default:              return softClipGuardScalar;
+    }
+}
+
+SanitizeKernel sanitizeKernelFor(KernelIsa isa)
+{
+    switch (isa) {
+#if defined(DSP_HAVE_NEON)
+        case KernelIsa::Neon: return sanitizeNeon;
+#endif
+#if defined(DSP_HAVE_X86)
+        case KernelIsa::Sse2: return sanitizeSse2;
+        case KernelIsa::Avx2: return sanitizeAvx2;
+#endif
+        default:              return sanitizeSamples;
+    }
+}
+
+KernelIsa detectKernelIsa()
+{
+#if defined(DSP_HAVE_NEON)
+    if (getauxval(AT_HWCAP) & HWCAP_ASIMD) {
+        return KernelIsa::Neon;
+    }
+#elif defined(DSP_HAVE_X86)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+        return KernelIsa::Avx2;
+    }
+    if (__builtin_cpu_supports("sse2")) {
+        return KernelIsa::Sse2;
+    }
+#endif
+    return KernelIsa::Scalar;
+}
+
+std::atomic<int> g_activeIsa { -1 };
+
+} // namespace
+
+void softClipScalar(const float* src, float* dst, size_t numSamples, float gain)
+{
+    for (size_t i = 0; i < numSamples; ++i) {
+        dst[i] = std::tanh(src[i] * gain);
+    }
+}
+
+float fastTanh(float x)
+{
+    /* !(a >= b) is also true for NaN, which then passes through */
+    if (!(std::fabs(x) >= kTiny)) {
+        return x;
+    }
+    const float xc = x > kClamp ? kClamp : (x < -kClamp ? -kClamp : x);
+    const float x2 = xc * xc;
+
+    float p = kA13;
+    p = p * x2 + kA11;
+    p = p * x2 + kA9;
+    p = p * x2 + kA7;
+    p = p * x2 + kA5;
+    p = p * x2 + kA3;
+    p = p * x2 + kA1;
+    p = p * xc;
+
+    float q = kB6;
+    q = q * x2 + kB4;
+    q = q * x2 + kB2;
+    q = q * x2 + kB0;
+
+    return p / q;
+}
+
+bool isKernelIsaSupported(KernelIsa isa)
+{
+    if (isa == KernelIsa::Scalar) {
+        return true;
+    }
+#if defined(DSP_HAVE_NEON)
+    return isa == KernelIsa::Neon && (getauxval(AT_HWCAP) & HWCAP_ASIMD);
+#elif defined(DSP_HAVE_X86)
+    __builtin_cpu_init();
+    if (isa == KernelIsa::Sse2) {
+        return __builtin_cpu_supports("sse2");
+    }
+    if (isa == KernelIsa::Avx2) {
+        return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+    }
+#endif
+    return false;
+}
+
+KernelIsa activeKernelIsa()
+{
+    int isa = g_activeIsa.load(std::memory_order_relaxed);
+    if (isa < 0) {
+        isa = static_cast<int>(detectKernelIsa());
+        g_activeIsa.store(isa, std::memory_order_relaxed);
+    }
+    return static_cast<KernelIsa>(isa);
+}
+
+SoftClipKernel softClipKernel()
+{
+    return kernelFor(activeKernelIsa());
+}
+
+SoftClipMeterKernel softClipMeterKernel()
+{
+    return meterKernelFor(activeKernelIsa());
+}
+
+LevelMeterKernel levelMeterKernel()
+{
+    return levelKernelFor(activeKernelIsa());
+}
+
+SoftClipGuardKernel softClipGuardKernel()
+{
+    return guardKernelFor(activeKernelIsa());
+}
+
+SanitizeKernel sanitizeKernel()
+{
+    return sanitizeKernelFor(activeKernelIsa());
+}
+
+void MeterLanes::reset(uint32_t numChannels, uint32_t first)
+{
+    channels     = numChannels != 0 ? numChannels : 1;
+    firstChannel = first % channels;
+    /* lcm(channels, 8) */
+    uint32_t a = channels, b = 8;
+    while (b != 0) {
+        const uint32_t t = a % b;
+        a = b;
+        b = t;
+    }
+    period = channels / a * 8;
+    pos    = 0;
+    std::memset(&in, 0, sizeof(in));
+    std::memset(&out, 0, sizeof(out));
+    std::memset(clips, 0, sizeof(clips));
+}
+
+bool forceKernelIsa(KernelIsa isa)
+{
+    if (!isKernelIsaSupported(isa)) {
+        return false;
+    }
+    g_activeIsa.store(static_cast<int>(isa), std::memory_order_relaxed);
+    return true;
+}
+
+const char* kernelIsaName(KernelIsa isa)
+{
+    switch (isa) {
+        case KernelIsa::Sse2: return "sse2";
+        case KernelIsa::Avx2: return "avx2";
+        case KernelIsa::Neon: return "neon";
+        default:              return "scalar";
+    }
+}
+
+} // namespace DspProcessor
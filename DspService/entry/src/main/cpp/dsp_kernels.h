@@ -0,0 +1,155 @@
+/**
+ * dsp_kernels.h — vectorised gain + soft-clip kernels
+ *
+ * dst[i] = tanh(src[i] * gain), with tanh evaluated by a [13/6] rational
+ * approximation (odd numerator, even denominator) on |x| ≤ 7.90531, where
+ * float tanh already rounds to ±1. Inputs with |x| < 4e-4 pass through
+ * unchanged (tanh(x) = x to float precision), so denormals are preserved.
+ *
+ * Accuracy against std::tanh, measured exhaustively over all 2^32 float
+ * inputs (gain = 1):
+ *   SSE2 (mul+add)  max absolute error 4.2e-7, max 7 ULP
+ *   AVX2 (FMA)      max absolute error 3.0e-7, max 5 ULP
+ * NaN inputs produce NaN in every variant.
+ *
+ * The kernel is chosen once at runtime from the CPU features:
+ *   aarch64 → NEON, x86-64 → AVX2+FMA when available, else SSE2.
+ * The scalar std::tanh loop is kept as reference and as fallback.
+ *
+ * Metering variants do the same work and, in the same pass, reduce input
+ * and output levels into MeterLanes: every SIMD lane keeps its own peak,
+ * sum of squares and clip count, so nothing leaves the registers until
+ * the end of a span. Lanes map to channels through the sample position;
+ * see MeterLanes.
+ *
+ * Guard variants (AUDIO_FLAG_GUARD) read every NaN / ±Inf input sample as
+ * 0 and return how many there were; on finite input they produce exactly
+ * what the plain kernels do.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace DspProcessor {
+
+/** Instruction-set variants of the soft-clip kernel */
+enum class KernelIsa {
+    Scalar,   /* std::tanh reference loop */
+    Sse2,
+    Avx2,
+    Neon,
+};
+
+/** dst[i] = tanh(src[i] * gain); src and dst may alias exactly. */
+using SoftClipKernel = void (*)(const float* src, float* dst, size_t numSamples, float gain);
+
+/**
+ * Level accumulators of an interleaved stream, one slot per sample
+ * position modulo period. period = lcm(channels, 8) is a multiple of
+ * every SIMD width, so a vector always covers the same slots and each
+ * slot always holds the same channel: slot s is channel
+ * (firstChannel + s) % channels.
+ */
+struct MeterLanes {
+    /* lcm(c, 8) for c ≤ 8 */
+    static constexpr uint32_t kMaxPeriod = 56;
+
+    struct Side {
+        float  peak[kMaxPeriod];   /* max |x|          */
+        double sum[kMaxPeriod];    /* sum of x²        */
+    };
+
+    uint32_t channels     = 1;
+    uint32_t firstChannel = 0;     /* channel of the first sample         */
+    uint32_t period       = 8;
+    uint32_t pos          = 0;     /* slot of the next sample             */
+    Side     in;
+    Side     out;
+    uint64_t clips[kMaxPeriod];
+
+    /**
+     * Zero every slot for a stream of @p channels (1 ~ 8) starting at
+     * channel @p first.
+     */
+    void reset(uint32_t channels, uint32_t first = 0);
+
+    /** Move pos past @p samples (after a level-only pass). */
+    void advance(size_t samples) { pos = static_cast<uint32_t>((pos + samples) % period); }
+
+    /** Copy the output side to the input side (bypass: in == out). */
+    void mirrorOutput() { in = out; }
+};
+
+/**
+ * Soft clip with metering: dst[i] = tanh(src[i] * gain), and per slot
+ * the peak / sum of squares of src (in) and dst (out), plus the count of
+ * samples with |src[i] * gain| > 1 (clips). Advances lanes.pos.
+ */
+using SoftClipMeterKernel = void (*)(const float* src, float* dst, size_t numSamples, float gain,
+                                     MeterLanes& lanes);
+
+/**
+ * Levels only, starting at slot lanes.pos (which is not advanced, so the
+ * same span can be metered as input and then as output).
+ *
+ * @param output     accumulate into lanes.out (else lanes.in)
+ * @param clipAbove  count |x| > clipAbove into lanes.clips (output only)
+ */
+using LevelMeterKernel = void (*)(const float* x, size_t numSamples, MeterLanes& lanes,
+                                  bool output, float clipAbove);
+
+/**
+ * Guarded soft clip: dst[i] = tanh(src'[i] * gain), src' being src with
+ * NaN / ±Inf replaced by 0. src and dst may alias exactly.
+ * @return number of non-finite samples in src
+ */
+using SoftClipGuardKernel = size_t (*)(const float* src, float* dst, size_t numSamples, float gain);
+
+/**
+ * dst[i] = src[i], NaN / ±Inf replaced by 0; src and dst may alias exactly.
+ * @return number of samples replaced
+ */
+using SanitizeKernel = size_t (*)(const float* src, float* dst, size_t numSamples);
+
+/** Reference / fallback implementation using std::tanh. */
+void softClipScalar(const float* src, float* dst, size_t numSamples, float gain);
+
+/** Scalar evaluation of the same rational approximation the SIMD kernels use. */
+float fastTanh(float x);
+
+/** Best kernel for this CPU (selected on first use). */
+SoftClipKernel softClipKernel();
+
+/** Metering variant of softClipKernel(), same ISA and same output. */
+SoftClipMeterKernel softClipMeterKernel();
+
+/** Level-only meter for the active ISA. */
+LevelMeterKernel levelMeterKernel();
+
+/** Guard variant of softClipKernel(), same ISA and same output on finite input. */
+SoftClipGuardKernel softClipGuardKernel();
+
+/** Non-finite replacement pass for the active ISA. */
+SanitizeKernel sanitizeKernel();
+
+/** tanh(1): |output| above this means |input × gain| was above full scale */
+constexpr float kSoftClipKnee = 0.76159415595576489f;
+
+/** ISA of the kernel returned by softClipKernel(). */
+KernelIsa activeKernelIsa();
+
+/**
+ * Override the runtime selection (benchmarks / accuracy checks).
+ * @return false if isa is not supported on this CPU; selection unchanged
+ */
+bool forceKernelIsa(KernelIsa isa);
+
+/** True when isa can run on this CPU. */
+bool isKernelIsaSupported(KernelIsa isa);
+
+/** Human-readable ISA name ("scalar", "sse2", "avx2", "neon"). */
+const char* kernelIsaName(KernelIsa isa);
+
+} // namespace DspProcessor
@@ -0,0 +1,145 @@
+/**
+ * dsp_live_control.cpp — gain / bypass that the host may change mid-buffer
+ */
+
+#include "dsp_live_control.h"
+#include "dsp_kernels.h"
+#include "AudioLiveControl.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace DspProcessor {
+
+namespace {
+
+/* Ramp length when the host leaves rampFrames at 0 */
+uint32_t defaultRampFrames(uint32_t sampleRate)
+{
+    return std::max<uint32_t>(1u, sampleRate / 100u);   /* 10 ms */
+}
+
+/* Gain is applied as-is elsewhere; only reject values that would poison the ramp */
+bool usable(const AudioControl::Values& v)
+{
+    return std::isfinite(v.gain);
+}
+
+} // namespace
+
+bool LiveControl::attach(const AudioControlBlock* block, uint32_t sampleRate, uint32_t channels)
+{
+    block_ = nullptr;
+    if (!block || channels == 0 || channels > kMaxChannels) {
+        return false;
+    }
+
+    AudioControl::Values v;
+    uint32_t seq = 0;
+    if (!AudioControl::read(block, v, &seq) || !usable(v)) {
+        v = AudioControl::Values();
+        seq = AudioControl::sequence(block) & ~1u;
+    }
+
+    block_      = block;
+    sequence_   = seq;
+    sampleRate_ = sampleRate;
+    channels_   = channels;
+    gain_       = gainTarget_ = v.gain;
+    mix_        = mixTarget_  = v.bypass != 0 ? 1.0f : 0.0f;
+    gainStep_   = mixStep_    = 0.0f;
+    left_       = 0;
+    return true;
+}
+
+void LiveControl::poll()
+{
+    if (!block_ || AudioControl::sequence(block_) == sequence_) {
+        return;
+    }
+
+    AudioControl::Values v;
+    uint32_t seq = 0;
+    if (!AudioControl::read(block_, v, &seq)) {
+        return;   /* writer busy: keep going, try again next block */
+    }
+    sequence_ = seq;
+    if (!usable(v)) {
+        return;
+    }
+
+    const float mixTarget = v.bypass != 0 ? 1.0f : 0.0f;
+    if (v.gain == gainTarget_ && mixTarget == mixTarget_) {
+        return;
+    }
+
+    /* Restart from wherever the current ramp has got to */
+    const uint32_t ramp = v.rampFrames != 0 ? v.rampFrames : defaultRampFrames(sampleRate_);
+    gainTarget_ = v.gain;
+    mixTarget_  = mixTarget;
+    gainStep_   = (gainTarget_ - gain_) / static_cast<float>(ramp);
+    mixStep_    = (mixTarget_ - mix_) / static_cast<float>(ramp);
+    left_       = ramp;
+}
+
+void LiveControl::process(const float* src, float* dst, size_t frames)
+{
+    for (size_t f = 0; f < frames; f += kBlockFrames) {
+        const size_t n = std::min<size_t>(kBlockFrames, frames - f);
+        poll();
+        processBlock(src + f * channels_, dst + f * channels_, n);
+    }
+}
+
+void LiveControl::processBlock(const float* src, float* dst, size_t frames)
+{
+    const uint32_t ch = channels_;
+    size_t f = 0;
+
+    if (left_ != 0) {
+        /* Per-frame gain into a scratch block, one SIMD soft-clip pass over
+           it (gain 1 is exact), then the per-frame dry / wet crossfade */
+        const size_t n = std::min<size_t>(left_, frames);
+        alignas(64) float wet[kBlockFrames * kMaxChannels];
+        float mix[kBlockFrames];
+        for (size_t i = 0; i < n; ++i) {
+            gain_ += gainStep_;
+            mix_  += mixStep_;
+            mix[i] = mix_;
+            for (uint32_t c = 0; c < ch; ++c) {
+                wet[i * ch + c] = src[i * ch + c] * gain_;
+            }
+        }
+        softClipKernel()(wet, wet, n * ch, 1.0f);
+        for (size_t i = 0; i < n; ++i) {
+            for (uint32_t c = 0; c < ch; ++c) {
+                const float dry = src[i * ch + c];
+                const float w   = wet[i * ch + c];
+                dst[i * ch + c] = w + mix[i] * (dry - w);
+            }
+        }
+        f = n;
+
+        left_ -= static_cast<uint32_t>(n);
+        if (left_ == 0) {
+            /* land exactly on the target, whatever the float drift */
+            gain_ = gainTarget_;
+            mix_  = mixTarget_;
+        }
+    }
+    if (f == frames) {
+        return;
+    }
+
+    const size_t rest = (frames - f) * ch;
+    if (mix_ >= 1.0f) {
+        if (dst != src) {
+            std::memmove(dst + f * ch, src + f * ch, rest * sizeof(float));
+        }
+    } else {
+        softClipKernel()(src + f * ch, dst + f * ch, rest, gain_);
+    }
+}
+
+} // namespace DspProcessor
@@ -0,0 +1,79 @@
+/**
+ * dsp_live_control.h — gain / bypass that the host may change mid-buffer
+ *
+ * A LiveControl follows one AudioControlBlock. Between blocks of
+ * kBlockFrames it re-reads the block (one atomic load when nothing
+ * changed) and, on a change, ramps linearly to the new values over the
+ * block's rampFrames:
+ *
+ *   gain    interpolated per frame before the soft clip
+ *   bypass  crossfade out = wet + mix * (dry - wet), mix 0 → 1 or 1 → 0
+ *
+ * Outside a ramp the regular soft-clip kernel runs, so steady-state output
+ * is bit-identical to processBuffer() with the same gain / bypass.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "AudioSharedBuffer.h"
+
+namespace DspProcessor {
+
+class LiveControl {
+public:
+    /** Frames between two reads of the control block */
+    static constexpr uint32_t kBlockFrames = 256;
+    /** Same limit as ProcessingChain (sizes the format conversion block) */
+    static constexpr uint32_t kMaxChannels = 8;
+
+    LiveControl() = default;
+
+    /**
+     * Follow @p block and adopt its current values without a ramp.
+     * @return false if block is nullptr or channels is 0 or above
+     *         kMaxChannels (not attached; use the static parameters)
+     */
+    bool attach(const AudioControlBlock* block, uint32_t sampleRate, uint32_t channels);
+
+    bool attached() const { return block_ != nullptr; }
+
+    /** Re-read the control block and start a ramp if the values changed. */
+    void poll();
+
+    /**
+     * Process interleaved float32 frames, polling every kBlockFrames.
+     * src and dst may be the same pointer.
+     */
+    void process(const float* src, float* dst, size_t frames);
+
+    /** Current (smoothed) gain. */
+    float gain() const { return gain_; }
+
+    /** True while fully bypassed and not ramping. */
+    bool bypassed() const { return left_ == 0 && mix_ >= 1.0f; }
+
+    /** True while a change is being ramped in. */
+    bool ramping() const { return left_ != 0; }
+
+private:
+    /* frames ≤ kBlockFrames */
+    void processBlock(const float* src, float* dst, size_t frames);
+
+    const AudioControlBlock* block_ = nullptr;
+    uint32_t sequence_   = 0;
+    uint32_t sampleRate_ = 0;
+    uint32_t channels_   = 0;
+
+    float    gain_       = 1.0f;
+    float    gainTarget_ = 1.0f;
+    float    gainStep_   = 0.0f;
+    float    mix_        = 0.0f;   /* 0 = processed, 1 = dry (bypass) */
+    float    mixTarget_  = 0.0f;
+    float    mixStep_    = 0.0f;
+    uint32_t left_       = 0;      /* frames until the ramp ends      */
+};
+
+} // namespace DspProcessor
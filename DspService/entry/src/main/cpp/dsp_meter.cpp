@@ -0,0 +1,245 @@
+/**
+ * dsp_meter.cpp — per-channel levels and loudness measured while processing
+ */
+
+#include "dsp_meter.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+namespace DspProcessor {
+
+namespace {
+
+/* BS.1770-4 K-weighting, as designed for any sample rate (libebur128) */
+constexpr double kShelfHz   = 1681.974450955533;
+constexpr double kShelfDb   = 3.999843853973347;
+constexpr double kShelfQ    = 0.7071752369554196;
+constexpr double kHighPassHz = 38.13547087602444;
+constexpr double kHighPassQ  = 0.5003270373238773;
+
+float channelWeight(uint32_t channels, uint32_t c)
+{
+    if (channels == 6) {
+        return c == 3 ? 0.0f : (c >= 4 ? 1.41f : 1.0f);   /* 5.1: LFE out, surrounds +1.5 dB */
+    }
+    return 1.0f;
+}
+
+} // namespace
+
+/* ------------------------------------------------------------------ */
+/*  LevelMeter                                                          */
+/* ------------------------------------------------------------------ */
+bool LevelMeter::begin(uint32_t channels)
+{
+    *this = LevelMeter();
+    if (channels == 0 || channels > kMaxChannels) {
+        return false;
+    }
+    channels_ = channels;
+    return true;
+}
+
+void LevelMeter::fold(const MeterLanes& lanes, uint32_t channelBase)
+{
+    for (uint32_t s = 0; s < lanes.period; ++s) {
+        const uint32_t c = channelBase + (lanes.firstChannel + s) % lanes.channels;
+        if (c >= channels_) {
+            continue;
+        }
+        inPeak_[c]  = std::max(inPeak_[c], lanes.in.peak[s]);
+        outPeak_[c] = std::max(outPeak_[c], lanes.out.peak[s]);
+        inSum_[c]  += lanes.in.sum[s];
+        outSum_[c] += lanes.out.sum[s];
+        clips_[c]  += lanes.clips[s];
+    }
+}
+
+void LevelMeter::merge(const LevelMeter& other)
+{
+    for (uint32_t c = 0; c < channels_; ++c) {
+        inPeak_[c]  = std::max(inPeak_[c], other.inPeak_[c]);
+        outPeak_[c] = std::max(outPeak_[c], other.outPeak_[c]);
+        inSum_[c]  += other.inSum_[c];
+        outSum_[c] += other.outSum_[c];
+        clips_[c]  += other.clips_[c];
+    }
+}
+
+MeterResult LevelMeter::result(uint32_t frames) const
+{
+    MeterResult r;
+    r.channels = channels_;
+    r.frames   = frames;
+    const double n = frames != 0 ? static_cast<double>(frames) : 1.0;
+    uint64_t total = 0;
+    for (uint32_t c = 0; c < channels_; ++c) {
+        r.inPeak[c]    = inPeak_[c];
+        r.outPeak[c]   = outPeak_[c];
+        r.inRms[c]     = static_cast<float>(std::sqrt(inSum_[c] / n));
+        r.outRms[c]    = static_cast<float>(std::sqrt(outSum_[c] / n));
+        r.clipCount[c] = static_cast<uint32_t>(std::min<uint64_t>(clips_[c], UINT32_MAX));
+        total += clips_[c];
+    }
+    r.clipTotal = static_cast<uint32_t>(std::min<uint64_t>(total, UINT32_MAX));
+    return r;
+}
+
+/* ------------------------------------------------------------------ */
+/*  LoudnessMeter                                                       */
+/* ------------------------------------------------------------------ */
+bool LoudnessMeter::configure(uint32_t sampleRate, uint32_t channels)
+{
+    channels_ = 0;
+    if (sampleRate == 0 || channels == 0 || channels > kMaxChannels) {
+        return false;
+    }
+
+    const double rate = static_cast<double>(sampleRate);
+    double k = std::tan(M_PI * kShelfHz / rate);
+    const double vh = std::pow(10.0, kShelfDb / 20.0);
+    const double vb = std::pow(vh, 0.4996667741545416);
+    double a0 = 1.0 + k / kShelfQ + k * k;
+    pb0_ = (vh + vb * k / kShelfQ + k * k) / a0;
+    pb1_ = 2.0 * (k * k - vh) / a0;
+    pb2_ = (vh - vb * k / kShelfQ + k * k) / a0;
+    pa1_ = 2.0 * (k * k - 1.0) / a0;
+    pa2_ = (1.0 - k / kShelfQ + k * k) / a0;
+
+    /* RLB high pass: b = 1, -2, 1 (unnormalised, as in the standard) */
+    k  = std::tan(M_PI * kHighPassHz / rate);
+    a0 = 1.0 + k / kHighPassQ + k * k;
+    ra1_ = 2.0 * (k * k - 1.0) / a0;
+    ra2_ = (1.0 - k / kHighPassQ + k * k) / a0;
+
+    channels_    = channels;
+    blockFrames_ = std::max<uint32_t>(1u, sampleRate / 10u);
+    reset();
+    return true;
+}
+
+void LoudnessMeter::reset()
+{
+    for (Channel& ch : ch_) {
+        ch = Channel();
+    }
+}
+
+void LoudnessMeter::filterInto(Channel& ch, const float* x, size_t count, size_t stride)
+{
+    double s1a = ch.s1a, s2a = ch.s2a, s1b = ch.s1b, s2b = ch.s2b;
+    size_t i = 0;
+    while (i < count) {
+        /* Up to the end of the current 100 ms block */
+        const uint64_t inBlock = ch.frames % blockFrames_;
+        const size_t slot = static_cast<size_t>((ch.frames / blockFrames_) % kWindowBlocks);
+        if (inBlock == 0) {
+            ch.energy[slot] = 0.0;
+        }
+        const size_t run = static_cast<size_t>(std::min<uint64_t>(blockFrames_ - inBlock, count - i));
+
+        double sum = 0.0;
+        for (size_t j = 0; j < run; ++j) {
+            const double in = x[(i + j) * stride];
+            const double p  = pb0_ * in + s1a;
+            s1a = pb1_ * in - pa1_ * p + s2a;
+            s2a = pb2_ * in - pa2_ * p;
+            const double y  = p + s1b;
+            s1b = -2.0 * p - ra1_ * y + s2b;
+            s2b = p - ra2_ * y;
+            sum += y * y;
+        }
+        ch.energy[slot] += sum;
+        ch.frames += run;
+        i += run;
+    }
+    ch.s1a = s1a;
+    ch.s2a = s2a;
+    ch.s1b = s1b;
+    ch.s2b = s2b;
+}
+
+void LoudnessMeter::process(const float* x, size_t samples, uint32_t firstChannel)
+{
+    const uint32_t n = channels_;
+    if (n == 0) {
+        return;
+    }
+    for (uint32_t k = 0; k < n && k < samples; ++k) {
+        const uint32_t c = (firstChannel + k) % n;
+        const size_t count = (samples - k + n - 1) / n;
+        filterInto(ch_[c], x + k, count, n);
+    }
+}
+
+void LoudnessMeter::processChannel(uint32_t channel, const float* x, size_t frames)
+{
+    if (channel < channels_) {
+        filterInto(ch_[channel], x, frames, 1);
+    }
+}
+
+float LoudnessMeter::shortTermLufs() const
+{
+    if (channels_ == 0) {
+        return -std::numeric_limits<float>::infinity();
+    }
+    uint64_t frames = ch_[0].frames;
+    for (uint32_t c = 1; c < channels_; ++c) {
+        frames = std::min(frames, ch_[c].frames);
+    }
+    if (frames == 0) {
+        return -std::numeric_limits<float>::infinity();
+    }
+
+    /* The current (partial) block and the 29 before it */
+    const uint64_t last  = (frames - 1) / blockFrames_;
+    const uint64_t first = last >= kWindowBlocks - 1 ? last - (kWindowBlocks - 1) : 0;
+    const double windowFrames = static_cast<double>(frames - first * blockFrames_);
+
+    double weighted = 0.0;
+    for (uint32_t c = 0; c < channels_; ++c) {
+        double energy = 0.0;
+        for (uint64_t b = first; b <= last; ++b) {
+            energy += ch_[c].energy[b % kWindowBlocks];
+        }
+        weighted += channelWeight(channels_, c) * energy / windowFrames;
+    }
+    if (!(weighted > 0.0)) {
+        return -std::numeric_limits<float>::infinity();
+    }
+    return static_cast<float>(-0.691 + 10.0 * std::log10(weighted));
+}
+
+/* ------------------------------------------------------------------ */
+/*  Header block                                                        */
+/* ------------------------------------------------------------------ */
+void storeMeterBlock(AudioMeterBlock* block, const MeterResult& result)
+{
+    if (!block) {
+        return;
+    }
+    AudioMeterBlock b;
+    std::memset(&b, 0, sizeof(b));
+    b.channels  = result.channels;
+    b.frames    = result.frames;
+    b.clipTotal = result.clipTotal;
+    b.valid     = result.channels != 0 ? AUDIO_METER_VALID_LEVELS : 0u;
+    if (result.hasLoudness) {
+        b.loudnessLufs = result.loudnessLufs;
+        b.valid |= AUDIO_METER_VALID_LOUDNESS;
+    }
+    for (uint32_t c = 0; c < result.channels && c < AUDIO_METER_MAX_CHANNELS; ++c) {
+        b.inPeak[c]    = result.inPeak[c];
+        b.outPeak[c]   = result.outPeak[c];
+        b.inRms[c]     = result.inRms[c];
+        b.outRms[c]    = result.outRms[c];
+        b.clipCount[c] = result.clipCount[c];
+    }
+    std::memcpy(block, &b, sizeof(b));
+}
+
+} // namespace DspProcessor
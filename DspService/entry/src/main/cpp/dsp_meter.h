@@ -0,0 +1,135 @@
+/**
+ * dsp_meter.h — per-channel levels and loudness measured while processing
+ *
+ * processFrames() can meter a request in the same pass that processes it:
+ * the soft-clip kernel reduces input / output peak, sum of squares and
+ * the saturated-sample count per SIMD lane (see MeterLanes in
+ * dsp_kernels.h), and a LevelMeter folds the lanes of every span or
+ * parallel chunk into per-channel totals. Chunk totals are merged in
+ * chunk order, so the result does not depend on the thread count.
+ *
+ * LoudnessMeter adds ITU-R BS.1770 short-term loudness: each channel runs
+ * through the K-weighting filter (high shelf + RLB high pass) on the block
+ * that was just processed, and the mean square of the last 3 s (30 blocks
+ * of 100 ms) is weighted per channel and summed. Its state carries over
+ * between calls, so a session's loudness follows the stream.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "AudioSharedBuffer.h"
+#include "dsp_kernels.h"
+
+namespace DspProcessor {
+
+/** Levels of one request; what AudioMeterBlock carries */
+struct MeterResult {
+    static constexpr uint32_t kMaxChannels = AUDIO_METER_MAX_CHANNELS;
+
+    uint32_t channels    = 0;   /* 0 = not metered                       */
+    uint32_t frames      = 0;
+    float    inPeak[kMaxChannels]  = {};
+    float    outPeak[kMaxChannels] = {};
+    float    inRms[kMaxChannels]   = {};
+    float    outRms[kMaxChannels]  = {};
+    uint32_t clipCount[kMaxChannels] = {};
+    uint32_t clipTotal   = 0;
+    bool     hasLoudness = false;
+    float    loudnessLufs = 0.0f;   /* -inf for digital silence          */
+};
+
+/** Per-channel level totals of one request */
+class LevelMeter {
+public:
+    static constexpr uint32_t kMaxChannels = MeterResult::kMaxChannels;
+
+    /**
+     * Start metering a stream of @p channels interleaved channels.
+     * @return false (and meter nothing) for 0 or more than kMaxChannels
+     */
+    bool begin(uint32_t channels);
+
+    bool active() const { return channels_ != 0; }
+    uint32_t channels() const { return channels_; }
+
+    /**
+     * Add the slots of @p lanes to the totals; lane channel c counts as
+     * channel channelBase + c (planar streams meter each plane with one
+     * lane channel and pass the plane index).
+     */
+    void fold(const MeterLanes& lanes, uint32_t channelBase = 0);
+
+    /** Add the totals of another meter of the same stream. */
+    void merge(const LevelMeter& other);
+
+    /** Peaks / RMS over @p frames frames per channel. */
+    MeterResult result(uint32_t frames) const;
+
+private:
+    uint32_t channels_ = 0;
+    float    inPeak_[kMaxChannels]  = {};
+    float    outPeak_[kMaxChannels] = {};
+    double   inSum_[kMaxChannels]   = {};
+    double   outSum_[kMaxChannels]  = {};
+    uint64_t clips_[kMaxChannels]   = {};
+};
+
+/** BS.1770 short-term loudness of a stream */
+class LoudnessMeter {
+public:
+    static constexpr uint32_t kMaxChannels = MeterResult::kMaxChannels;
+    /* 3 s window in 100 ms blocks */
+    static constexpr uint32_t kWindowBlocks = 30;
+
+    /**
+     * Set up the K-weighting filters for @p sampleRate and clear the window.
+     * @return false for a sample rate of 0 or a bad channel count
+     */
+    bool configure(uint32_t sampleRate, uint32_t channels);
+
+    bool configured() const { return channels_ != 0; }
+
+    /** Clear filter state and window (keeps the configuration). */
+    void reset();
+
+    /**
+     * Add interleaved samples; x[0] is channel @p firstChannel. Spans may
+     * end mid-frame: every channel keeps its own position.
+     */
+    void process(const float* x, size_t samples, uint32_t firstChannel = 0);
+
+    /** Add @p frames consecutive samples of one channel (a planar plane). */
+    void processChannel(uint32_t channel, const float* x, size_t frames);
+
+    /**
+     * Loudness of the last 3 s (less at the start of a stream), in LUFS;
+     * -inf for silence. Channel weights: 1.0, except 5.1 (6 channels,
+     * L R C LFE Ls Rs) where LFE is left out and the surrounds get 1.41.
+     */
+    float shortTermLufs() const;
+
+private:
+    struct Channel {
+        /* K-weighting cascade, transposed direct form II */
+        double s1a = 0, s2a = 0, s1b = 0, s2b = 0;
+        uint64_t frames = 0;                 /* samples seen on this channel */
+        double energy[kWindowBlocks] = {};   /* sum of y² per 100 ms block   */
+    };
+
+    void filterInto(Channel& ch, const float* x, size_t count, size_t stride);
+
+    uint32_t channels_    = 0;
+    uint32_t blockFrames_ = 0;
+    /* pre-filter (b, a) and RLB high pass (b, a), a0 = 1 */
+    double pb0_ = 0, pb1_ = 0, pb2_ = 0, pa1_ = 0, pa2_ = 0;
+    double ra1_ = 0, ra2_ = 0;
+    Channel ch_[kMaxChannels];
+};
+
+/** Copy a result into a meter block (service-owned; before status is stored). */
+void storeMeterBlock(AudioMeterBlock* block, const MeterResult& result);
+
+} // namespace DspProcessor
@@ -3,39 +3,224 @@
  *
  * Exported JavaScript API:
  *
- *   processAudio(inputBuffer: ArrayBuffer, gain: number, bypass: number)
- *       : { outputBuffer: ArrayBuffer; processingTimeNs: number }
+ *   processAudio(inputBuffer: ArrayBuffer | TypedArray, gain: number, bypass: number,
+ *                channels?: number, sampleRate?: number)
+ *       : { outputBuffer: ArrayBuffer; processingTimeNs: number; meter?: DspMeter }
  *
  *       inputBuffer  — float32 interleaved PCM (raw bytes)
  *       gain         — linear gain (0.0 ~ 2.0)
  *       bypass       — 0 = process, 1 = bypass
- *       outputBuffer — processed float32 PCM (same size as input)
+ *       channels     — 1..8: meter per channel in the same pass (the buffer
+ *                      must hold whole frames); 0 / omitted = no meter
+ *       sampleRate   — with channels: also measure BS.1770 loudness of
+ *                      this buffer (runs serially)
+ *       outputBuffer — processed float32 PCM (same size as input); an
+ *                      external ArrayBuffer over a BufferPool block that
+ *                      is recycled when JS drops it
  *       processingTimeNs — wall-clock DSP time in nanoseconds
+ *       meter        — { channels, frames, clipTotal, inPeak[], outPeak[],
+ *                        inRms[], outRms[], clipCount[], loudnessLufs? }
+ *
+ *   processAudioInto(input: ArrayBuffer | TypedArray, output: ArrayBuffer | TypedArray,
+ *                    gain: number, bypass: number)
+ *       : { status: number; processingTimeNs: number }
+ *
+ *       Processes straight into caller-owned memory — no allocation, no
+ *       copy. output may be the same buffer as input (in place) but must
+ *       not partially overlap it, must hold at least as many bytes, and
+ *       both views must be 4-byte aligned.
+ *
+ *   processSharedMemory(fd: number, size: number, receiveNs?: number)
+ *       : { status: number; processingTimeNs: number }
+ *
+ *       fd     — Ashmem fd holding AudioSharedHeader (v2 or v1) + input/output PCM
+ *       size   — total Ashmem size in bytes
+ *       receiveNs — traceNow() taken when the request arrived (traced
+ *                   requests; default: when the call starts)
+ *       Maps the region, processes inputOffset → outputOffset in place and
+ *       writes status / processingTimeNs into the header. The fd stays open.
+ *
+ *   openStream(fd: number, size: number, clientId?: number, clientPid?: number): number
+ *       Maps an AudioStreamBuffer region and starts its block worker.
+ *       Returns a stream id (> 0) or AUDIO_STATUS_ERROR. The fd stays open.
+ *       Owned like a session (see openSession).
+ *
+ *   closeStream(streamId: number, clientId?: number): number
+ *   closeAllStreams(): void
+ *       Closes one (owner's clientId only) / every stream, joins the
+ *       worker and unmaps the region.
+ *
+ *   openSession(fd: number, size: number, clientId?: number, clientPid?: number): number
+ *       Maps (pre-faulted) a shared region once and returns a session id
+ *       (> 0) or AUDIO_STATUS_ERROR. The fd stays open. The session
+ *       belongs to clientId (the Binder calling uid, default 0 = local);
+ *       it is reclaimed once clientPid exits or it idles too long.
+ *
+ *   processSession(sessionId: number, frameOffset: number, frameCount: number,
+ *                  receiveNs?: number, clientId?: number)
+ *       : { status: number; processingTimeNs: number }
+ *       Processes a frame range of the session's region in place. Fails
+ *       for a clientId other than the owner's.
+ *
+ *   processBatch(fd: number, size: number)
+ *       : { status: number; processingTimeNs: number; jobsFailed: number }
+ *       Processes every job of an AudioBatchHeader / AudioBatchJob region in
+ *       one call; per-job status and time are written into the job table.
+ *
+ *   closeSession(sessionId: number, clientId?: number): number
+ *   closeAllSessions(): void
+ *       Unmap one (owner's clientId only) / every session.
+ *
+ *   setIdleTimeout(ms: number): void
+ *       Reclaim sessions unused, and streams without a block, for ms
+ *       (0 = only when the owner exits).
+ *
+ *   setWorkerThreads(threads: number): number
+ *       Resizes the process-wide DSP worker pool (0 = one per core) and
+ *       returns the resulting thread count.
+ *
+ *   processAudioAsync(inputBuffer, gain, bypass, channels?, sampleRate?): Promise<DspProcessResult>
+ *   processAudioIntoAsync(input, output, gain, bypass): Promise<DspSharedResult>
+ *   processSharedMemoryAsync(fd, size, receiveNs?, clientId?): Promise<DspSharedResult>
+ *   processSessionAsync(sessionId, frameOffset, frameCount, receiveNs?, clientId?)
+ *       : Promise<DspSharedResult>
+ *   processBatchAsync(fd, size, clientId?): Promise<DspBatchResult>
+ *       Same as the synchronous calls, but the DSP runs on a worker of the
+ *       request scheduler (dsp_scheduler.h) and the Promise settles on the
+ *       JS thread. Several jobs may be outstanding at once; inputBuffer / fd
+ *       must stay untouched until the Promise settles.
+ *       clientId — queue key, the Binder calling uid (default 0 = local);
+ *                  a session request must come from the session's owner
+ *       Session requests are due within the playback time of their frames,
+ *       others within the scheduler's budget; batch jobs yield to the rest.
+ *       A request refused by admission control is not run: it settles with
+ *       status AUDIO_STATUS_BUSY (-2), and processAudioAsync rejects.
+ *
+ *   getAsyncStats(): { queued: number; inFlight: number; completed: number }
+ *       Jobs waiting for a worker, jobs currently running, and jobs settled
+ *       since load — for caller-side backpressure.
+ *
+ *   configureScheduler(workers: number, maxQueuedPerClient?: number,
+ *                      maxQueuedTotal?: number, maxInFlightPerClient?: number,
+ *                      maxQueuedLocal?: number, maxInFlightLocal?: number): number
+ *       Restarts the scheduler workers (0 = one per core, each pinned) with
+ *       new admission limits and returns the worker count. Queued requests
+ *       still run first. Calls without a clientId (local) use the two
+ *       *Local limits instead of the per-client ones; 0 = bounded only by
+ *       maxQueuedTotal / the worker count.
+ *
+ *   getSchedulerStats(): DspSchedulerStats
+ *       Worker count, current queue depth, and per client: queued /
+ *       running / submitted / completed / rejected requests, deadline
+ *       misses, and average / max / last queue time and average run time.
+ *
+ *   getBufferPoolStats()
+ *       : { hits: number; misses: number; cachedBytes: number; outstanding: number }
+ *       Recycling counters of the pool behind processAudio output buffers.
+ *
+ *   traceNow(): number
+ *       CLOCK_MONOTONIC in nanoseconds, the clock of AudioTraceBlock stamps.
+ *   setTracing(enabled: boolean): void
+ *       Record the phases of traced requests into the native trace buffer.
+ *   dumpTrace(path: string): boolean
+ *       Write the buffer as Chrome trace-event JSON.
  */
 
 #include "napi/native_api.h"
+#include "dsp_batch.h"
+#include "dsp_buffer_pool.h"
+#include "dsp_client_watch.h"
+#include "dsp_meter.h"
 #include "dsp_processor.h"
+#include "dsp_scheduler.h"
+#include "dsp_shared_memory.h"
+#include "dsp_session.h"
+#include "dsp_stream.h"
+#include "dsp_thread_pool.h"
+#include "AudioTrace.h"
 #include <hilog/log.h>
+#include <atomic>
 #include <cstring>
+#include <string>
 
 #define LOG_DOMAIN 0x0000
 #define LOG_TAG    "DspServiceNative"
 #define LOGI(fmt, ...) OH_LOG_INFO(LOG_APP, LOG_TAG ": " fmt, ##__VA_ARGS__)
 #define LOGE(fmt, ...) OH_LOG_ERROR(LOG_APP, LOG_TAG ": " fmt, ##__VA_ARGS__)
 
+static bool GetBufferArg(napi_env env, napi_value value, void** data, size_t* length);
+static napi_value MakePooledBuffer(napi_env env, void* data, size_t bytes);
+static napi_value MakeProcessResult(napi_env env, napi_value outputAb, int64_t processingTimeNs,
+                                    const DspProcessor::MeterResult* meter = nullptr);
+static napi_value MakeSharedResult(napi_env env, const DspProcessor::SharedProcessResult& res);
+static napi_value MakeBatchResult(napi_env env, const DspProcessor::BatchProcessResult& res);
+static std::string GetStringArg(napi_env env, napi_value value);
+
 /* ------------------------------------------------------------------ */
 /*  processAudio                                                        */
 /* ------------------------------------------------------------------ */
+
+/** Optional metering arguments of processAudio / processAudioAsync */
+struct ProcessMeterArgs {
+    uint32_t channels   = 0;   /* 0 = no meter */
+    uint32_t sampleRate = 0;   /* 0 = no loudness */
+};
+
+static ProcessMeterArgs GetProcessMeterArgs(napi_env env, const napi_value* args, size_t argc)
+{
+    ProcessMeterArgs m;
+    int64_t channels = 0;
+    int64_t rate = 0;
+    if (argc > 3 && napi_get_value_int64(env, args[3], &channels) == napi_ok
+        && channels > 0 && channels <= static_cast<int64_t>(AUDIO_METER_MAX_CHANNELS)) {
+        m.channels = static_cast<uint32_t>(channels);
+    }
+    if (m.channels != 0 && argc > 4 && napi_get_value_int64(env, args[4], &rate) == napi_ok
+        && rate > 0 && rate <= static_cast<int64_t>(UINT32_MAX)) {
+        m.sampleRate = static_cast<uint32_t>(rate);
+    }
+    return m;
+}
+
+/**
+ * processAudioInto() metered as @p m asks; @p out.channels stays 0 when
+ * the call was not metered (no channels, or a partial frame).
+ */
+static int64_t ProcessAudioMetered(const float* src, float* dst, size_t numSamples, float gain,
+                                   bool bypass, const ProcessMeterArgs& m,
+                                   DspProcessor::MeterResult& out)
+{
+    DspProcessor::LevelMeter levels;
+    DspProcessor::LoudnessMeter loudness;
+    DspProcessor::FrameMeter meter;
+    if (m.channels != 0 && numSamples % m.channels == 0 && levels.begin(m.channels)) {
+        meter.levels = &levels;
+        if (m.sampleRate != 0 && loudness.configure(m.sampleRate, m.channels)) {
+            meter.loudness = &loudness;
+        }
+    }
+    const int64_t timeNs = DspProcessor::processAudioInto(src, dst, numSamples, gain, bypass,
+                                                          true, meter);
+    if (meter.levels) {
+        out = levels.result(static_cast<uint32_t>(numSamples / m.channels));
+        if (meter.loudness) {
+            out.hasLoudness  = true;
+            out.loudnessLufs = loudness.shortTermLufs();
+        }
+    }
+    return timeNs;
+}
+
 static napi_value ProcessAudio(napi_env env, napi_callback_info info)
 {
-    size_t argc = 3;
-    napi_value args[3];
+    size_t argc = 5;
+    napi_value args[5];
     napi_get_cb_info(env, info, &argc, args, nullptr, nullptr);
 
-    /* arg0: inputBuffer (ArrayBuffer) */
+    /* arg0: inputBuffer (ArrayBuffer or TypedArray) */
     void*  bufData = nullptr;
     size_t bufLen  = 0;
-    napi_get_arraybuffer_info(env, args[0], &bufData, &bufLen);
+    GetBufferArg(env, args[0], &bufData, &bufLen);
 
     /* arg1: gain (number) */
     double gain = 1.0;
@@ -45,21 +230,148 @@ static napi_value ProcessAudio(napi_env env, napi_callback_info info)
     int32_t bypass = 0;
     napi_get_value_int32(env, args[2], &bypass);
 
-    const int numSamples = static_cast<int>(bufLen / sizeof(float));
-    LOGI("processAudio samples=%d gain=%.3f bypass=%d", numSamples, (float)gain, bypass);
+    /* arg3 / arg4: channels / sampleRate (optional, metering) */
+    const ProcessMeterArgs meterArgs = GetProcessMeterArgs(env, args, argc);
 
-    auto res = DspProcessor::processAudio(bufData, numSamples,
-                                          static_cast<float>(gain), bypass != 0);
+    const size_t numSamples = bufLen / sizeof(float);
+    const size_t outBytes   = numSamples * sizeof(float);
+    LOGI("processAudio samples=%zu gain=%.3f bypass=%d", numSamples, (float)gain, bypass);
 
-    /* Create output ArrayBuffer */
-    napi_value outputAb;
-    void* outData = nullptr;
-    napi_create_arraybuffer(env, res.outputBytes.size(), &outData, &outputAb);
-    if (outData && !res.outputBytes.empty()) {
-        std::memcpy(outData, res.outputBytes.data(), res.outputBytes.size());
+    /* Output goes straight into a pooled block that becomes the result buffer */
+    void* outData = DspProcessor::BufferPool::instance().acquire(outBytes);
+    int64_t timeNs = 0;
+    DspProcessor::MeterResult meter;
+    if (outData) {
+        timeNs = ProcessAudioMetered(static_cast<const float*>(bufData), static_cast<float*>(outData),
+                                     numSamples, static_cast<float>(gain), bypass != 0, meterArgs, meter);
+    } else if (outBytes > 0) {
+        LOGE("processAudio: no buffer for %zu bytes", outBytes);
     }
+    return MakeProcessResult(env, MakePooledBuffer(env, outData, outData ? outBytes : 0), timeNs,
+                             meter.channels != 0 ? &meter : nullptr);
+}
 
-    /* Build result object: { outputBuffer, processingTimeNs } */
+/* Element size of a TypedArray type, in bytes */
+static size_t TypedArrayElementSize(napi_typedarray_type type)
+{
+    switch (type) {
+        case napi_int8_array:
+        case napi_uint8_array:
+        case napi_uint8_clamped_array:
+            return 1;
+        case napi_int16_array:
+        case napi_uint16_array:
+            return 2;
+        case napi_int32_array:
+        case napi_uint32_array:
+        case napi_float32_array:
+            return 4;
+        default:
+            return 8;
+    }
+}
+
+/**
+ * Raw bytes behind an ArrayBuffer or TypedArray argument. For a TypedArray
+ * @p data already points at its byteOffset and @p length is its byteLength.
+ * @return false (data = nullptr, length = 0) for any other value
+ */
+static bool GetBufferArg(napi_env env, napi_value value, void** data, size_t* length)
+{
+    *data   = nullptr;
+    *length = 0;
+
+    bool isTyped = false;
+    if (napi_is_typedarray(env, value, &isTyped) == napi_ok && isTyped) {
+        napi_typedarray_type type;
+        size_t     count  = 0;
+        size_t     offset = 0;
+        napi_value arrayBuffer;
+        if (napi_get_typedarray_info(env, value, &type, &count, data,
+                                     &arrayBuffer, &offset) != napi_ok) {
+            *data = nullptr;
+            return false;
+        }
+        *length = count * TypedArrayElementSize(type);
+        return true;
+    }
+    if (napi_get_arraybuffer_info(env, value, data, length) != napi_ok) {
+        *data   = nullptr;
+        *length = 0;
+        return false;
+    }
+    return true;
+}
+
+static void ReleasePooledBuffer(napi_env /* env */, void* data, void* /* hint */)
+{
+    DspProcessor::BufferPool::instance().release(data);
+}
+
+/**
+ * Hand a BufferPool block to JS as an external ArrayBuffer; ownership moves
+ * to the ArrayBuffer, whose finalizer returns the block to the pool.
+ * Falls back to a copy if the engine refuses external buffers.
+ */
+static napi_value MakePooledBuffer(napi_env env, void* data, size_t bytes)
+{
+    napi_value ab = nullptr;
+    if (data && bytes > 0
+        && napi_create_external_arraybuffer(env, data, bytes, ReleasePooledBuffer,
+                                            nullptr, &ab) == napi_ok) {
+        return ab;
+    }
+
+    void* copy = nullptr;
+    napi_create_arraybuffer(env, data ? bytes : 0, &copy, &ab);
+    if (copy && data && bytes > 0) {
+        std::memcpy(copy, data, bytes);
+    }
+    DspProcessor::BufferPool::instance().release(data);
+    return ab;
+}
+
+/* number[] of the first @p count values */
+template <typename T>
+static napi_value MakeNumberArray(napi_env env, const T* values, uint32_t count)
+{
+    napi_value arr;
+    napi_create_array_with_length(env, count, &arr);
+    for (uint32_t i = 0; i < count; ++i) {
+        napi_value v;
+        napi_create_double(env, static_cast<double>(values[i]), &v);
+        napi_set_element(env, arr, i, v);
+    }
+    return arr;
+}
+
+static napi_value MakeMeterResult(napi_env env, const DspProcessor::MeterResult& m)
+{
+    napi_value obj;
+    napi_create_object(env, &obj);
+    auto setNumber = [env, obj](const char* key, double value) {
+        napi_value v;
+        napi_create_double(env, value, &v);
+        napi_set_named_property(env, obj, key, v);
+    };
+    setNumber("channels",  m.channels);
+    setNumber("frames",    m.frames);
+    setNumber("clipTotal", m.clipTotal);
+    napi_set_named_property(env, obj, "inPeak",    MakeNumberArray(env, m.inPeak, m.channels));
+    napi_set_named_property(env, obj, "outPeak",   MakeNumberArray(env, m.outPeak, m.channels));
+    napi_set_named_property(env, obj, "inRms",     MakeNumberArray(env, m.inRms, m.channels));
+    napi_set_named_property(env, obj, "outRms",    MakeNumberArray(env, m.outRms, m.channels));
+    napi_set_named_property(env, obj, "clipCount", MakeNumberArray(env, m.clipCount, m.channels));
+    if (m.hasLoudness) {
+        setNumber("loudnessLufs", m.loudnessLufs);   /* -Infinity for silence */
+    }
+    return obj;
+}
+
+static napi_value MakeProcessResult(napi_env env, napi_value outputAb, int64_t processingTimeNs,
+                                    const DspProcessor::MeterResult* meter)
+{
+    /* Build result object: { outputBuffer, processingTimeNs, meter? } */
     napi_value obj;
     napi_create_object(env, &obj);
 
@@ -68,14 +380,866 @@ static napi_value ProcessAudio(napi_env env, napi_callback_info info)
     napi_create_string_utf8(env, "processingTimeNs", NAPI_AUTO_LENGTH, &keyTime);
 
     napi_value valTime;
-    napi_create_double(env, static_cast<double>(res.processingTimeNs), &valTime);
+    napi_create_double(env, static_cast<double>(processingTimeNs), &valTime);
 
     napi_set_property(env, obj, keyBuf,  outputAb);
     napi_set_property(env, obj, keyTime, valTime);
+    if (meter) {
+        napi_set_named_property(env, obj, "meter", MakeMeterResult(env, *meter));
+    }
+
+    return obj;
+}
+
+/* ------------------------------------------------------------------ */
+/*  processAudioInto                                                    */
+/* ------------------------------------------------------------------ */
+
+/** Validated arguments of processAudioInto / processAudioIntoAsync */
+struct ProcessIntoArgs {
+    const float* src        = nullptr;
+    float*       dst        = nullptr;
+    size_t       numSamples = 0;
+    float        gain       = 1.0f;
+    bool         bypass     = false;
+};
+
+static bool GetProcessIntoArgs(napi_env env, const napi_value* args, ProcessIntoArgs& out)
+{
+    void*  inData  = nullptr;
+    void*  outData = nullptr;
+    size_t inLen   = 0;
+    size_t outLen  = 0;
+    if (!GetBufferArg(env, args[0], &inData, &inLen) || !GetBufferArg(env, args[1], &outData, &outLen)) {
+        LOGE("processAudioInto: input / output must be ArrayBuffer or TypedArray");
+        return false;
+    }
+
+    double  gain   = 1.0;
+    int32_t bypass = 0;
+    napi_get_value_double(env, args[2], &gain);
+    napi_get_value_int32(env, args[3], &bypass);
+
+    const uintptr_t in  = reinterpret_cast<uintptr_t>(inData);
+    const uintptr_t dst = reinterpret_cast<uintptr_t>(outData);
+    if (inLen % sizeof(float) != 0 || outLen < inLen) {
+        LOGE("processAudioInto: bad sizes in=%zu out=%zu", inLen, outLen);
+        return false;
+    }
+    if (inLen > 0 && ((in | dst) % alignof(float) != 0)) {
+        LOGE("processAudioInto: views must be 4-byte aligned");
+        return false;
+    }
+    /* In place is fine; a shifted overlap would read already-written samples */
+    if (inLen > 0 && in != dst && in < dst + inLen && dst < in + inLen) {
+        LOGE("processAudioInto: input and output partially overlap");
+        return false;
+    }
+
+    out.src        = static_cast<const float*>(inData);
+    out.dst        = static_cast<float*>(outData);
+    out.numSamples = inLen / sizeof(float);
+    out.gain       = static_cast<float>(gain);
+    out.bypass     = bypass != 0;
+    return true;
+}
+
+static napi_value ProcessAudioInto(napi_env env, napi_callback_info info)
+{
+    size_t argc = 4;
+    napi_value args[4];
+    napi_get_cb_info(env, info, &argc, args, nullptr, nullptr);
+
+    DspProcessor::SharedProcessResult res { AUDIO_STATUS_ERROR, 0 };
+    ProcessIntoArgs a;
+    if (argc >= 4 && GetProcessIntoArgs(env, args, a)) {
+        res.processingTimeNs = DspProcessor::processAudioInto(a.src, a.dst, a.numSamples,
+                                                              a.gain, a.bypass, true);
+        res.status = AUDIO_STATUS_DONE;
+    }
+    return MakeSharedResult(env, res);
+}
+
+/* ------------------------------------------------------------------ */
+/*  processSharedMemory                                                 */
+/* ------------------------------------------------------------------ */
+static napi_value ProcessSharedMemory(napi_env env, napi_callback_info info)
+{
+    size_t argc = 3;
+    napi_value args[3];
+    napi_get_cb_info(env, info, &argc, args, nullptr, nullptr);
+
+    /* arg0: fd (number), arg1: size (number), arg2: receiveNs (optional) */
+    int32_t fd = -1;
+    int64_t size = 0;
+    int64_t receiveNs = 0;
+    napi_get_value_int32(env, args[0], &fd);
+    napi_get_value_int64(env, args[1], &size);
+    if (argc > 2) {
+        napi_get_value_int64(env, args[2], &receiveNs);
+    }
+
+    DspProcessor::SharedProcessResult res { AUDIO_STATUS_ERROR, 0 };
+    if (size > 0) {
+        res = DspProcessor::processSharedMemory(fd, static_cast<size_t>(size), receiveNs);
+    }
+    if (res.status != AUDIO_STATUS_DONE) {
+        LOGE("processSharedMemory failed fd=%d size=%lld", fd, static_cast<long long>(size));
+    }
+    return MakeSharedResult(env, res);
+}
+
+static napi_value MakeSharedResult(napi_env env, const DspProcessor::SharedProcessResult& res)
+{
+    /* Build result object: { status, processingTimeNs } */
+    napi_value obj;
+    napi_create_object(env, &obj);
+
+    napi_value valStatus, valTime;
+    napi_create_int32(env, res.status, &valStatus);
+    napi_create_double(env, static_cast<double>(res.processingTimeNs), &valTime);
+
+    napi_set_named_property(env, obj, "status",           valStatus);
+    napi_set_named_property(env, obj, "processingTimeNs", valTime);
+
+    return obj;
+}
+
+/* Optional caller uid at args[index] (0 = local caller) */
+static int32_t GetUidArg(napi_env env, const napi_value* args, size_t argc, size_t index)
+{
+    int32_t uid = 0;
+    if (argc > index) {
+        napi_get_value_int32(env, args[index], &uid);
+    }
+    return uid;
+}
+
+/* Optional caller uid and pid at args[index], args[index + 1] */
+static DspProcessor::ClientRef GetOwnerArgs(napi_env env, const napi_value* args, size_t argc,
+                                            size_t index)
+{
+    DspProcessor::ClientRef owner;
+    owner.uid = GetUidArg(env, args, argc, index);
+    if (argc > index + 1) {
+        napi_get_value_int32(env, args[index + 1], &owner.pid);
+    }
+    return owner;
+}
+
+/* ------------------------------------------------------------------ */
+/*  openStream / closeStream                                            */
+/* ------------------------------------------------------------------ */
+static napi_value OpenStream(napi_env env, napi_callback_info info)
+{
+    size_t argc = 4;
+    napi_value args[4];
+    napi_get_cb_info(env, info, &argc, args, nullptr, nullptr);
+
+    int32_t fd = -1;
+    int64_t size = 0;
+    napi_get_value_int32(env, args[0], &fd);
+    napi_get_value_int64(env, args[1], &size);
+    const DspProcessor::ClientRef owner = GetOwnerArgs(env, args, argc, 2);
+
+    int32_t id = size > 0 ? DspProcessor::openStream(fd, static_cast<size_t>(size), owner)
+                          : AUDIO_STATUS_ERROR;
+    LOGI("openStream fd=%d size=%lld uid=%d id=%d", fd, static_cast<long long>(size), owner.uid, id);
+
+    napi_value result;
+    napi_create_int32(env, id, &result);
+    return result;
+}
+
+static napi_value CloseStream(napi_env env, napi_callback_info info)
+{
+    size_t argc = 2;
+    napi_value args[2];
+    napi_get_cb_info(env, info, &argc, args, nullptr, nullptr);
+
+    int32_t id = 0;
+    napi_get_value_int32(env, args[0], &id);
+
+    int32_t status = DspProcessor::closeStream(id, GetUidArg(env, args, argc, 1));
+    LOGI("closeStream id=%d status=%d", id, status);
+
+    napi_value result;
+    napi_create_int32(env, status, &result);
+    return result;
+}
+
+static napi_value CloseAllStreams(napi_env env, napi_callback_info /* info */)
+{
+    DspProcessor::closeAllStreams();
+
+    napi_value result;
+    napi_get_undefined(env, &result);
+    return result;
+}
+
+/* ------------------------------------------------------------------ */
+/*  Sessions                                                            */
+/* ------------------------------------------------------------------ */
+
+static napi_value OpenSession(napi_env env, napi_callback_info info)
+{
+    size_t argc = 4;
+    napi_value args[4];
+    napi_get_cb_info(env, info, &argc, args, nullptr, nullptr);
+
+    int32_t fd = -1;
+    int64_t size = 0;
+    napi_get_value_int32(env, args[0], &fd);
+    napi_get_value_int64(env, args[1], &size);
+    const DspProcessor::ClientRef owner = GetOwnerArgs(env, args, argc, 2);
+
+    int32_t id = size > 0 ? DspProcessor::openSession(fd, static_cast<size_t>(size), owner)
+                          : AUDIO_STATUS_ERROR;
+    LOGI("openSession fd=%d size=%lld uid=%d id=%d", fd, static_cast<long long>(size), owner.uid, id);
+
+    napi_value result;
+    napi_create_int32(env, id, &result);
+    return result;
+}
+
+static napi_value ProcessSession(napi_env env, napi_callback_info info)
+{
+    size_t argc = 5;
+    napi_value args[5];
+    napi_get_cb_info(env, info, &argc, args, nullptr, nullptr);
+
+    int32_t  id = 0;
+    uint32_t frameOffset = 0, frameCount = 0;
+    int64_t  receiveNs = 0;
+    napi_get_value_int32(env, args[0], &id);
+    napi_get_value_uint32(env, args[1], &frameOffset);
+    napi_get_value_uint32(env, args[2], &frameCount);
+    if (argc > 3) {
+        napi_get_value_int64(env, args[3], &receiveNs);
+    }
+
+    auto res = DspProcessor::processSession(id, frameOffset, frameCount, receiveNs,
+                                            GetUidArg(env, args, argc, 4));
+    if (res.status != AUDIO_STATUS_DONE) {
+        LOGE("processSession failed id=%d offset=%u count=%u", id, frameOffset, frameCount);
+    }
+    return MakeSharedResult(env, res);
+}
+
+static napi_value CloseSession(napi_env env, napi_callback_info info)
+{
+    size_t argc = 2;
+    napi_value args[2];
+    napi_get_cb_info(env, info, &argc, args, nullptr, nullptr);
+
+    int32_t id = 0;
+    napi_get_value_int32(env, args[0], &id);
+
+    int32_t status = DspProcessor::closeSession(id, GetUidArg(env, args, argc, 1));
+    LOGI("closeSession id=%d status=%d", id, status);
+
+    napi_value result;
+    napi_create_int32(env, status, &result);
+    return result;
+}
+
+static napi_value CloseAllSessions(napi_env env, napi_callback_info /* info */)
+{
+    DspProcessor::closeAllSessions();
+
+    napi_value result;
+    napi_get_undefined(env, &result);
+    return result;
+}
+
+static napi_value SetIdleTimeout(napi_env env, napi_callback_info info)
+{
+    size_t argc = 1;
+    napi_value args[1];
+    napi_get_cb_info(env, info, &argc, args, nullptr, nullptr);
+
+    int64_t ms = 0;
+    if (argc > 0) {
+        napi_get_value_int64(env, args[0], &ms);
+    }
+    DspProcessor::setIdleTimeoutMs(ms);
+
+    napi_value result;
+    napi_get_undefined(env, &result);
+    return result;
+}
+
+/* ------------------------------------------------------------------ */
+/*  processBatch                                                        */
+/* ------------------------------------------------------------------ */
+static napi_value ProcessBatch(napi_env env, napi_callback_info info)
+{
+    size_t argc = 2;
+    napi_value args[2];
+    napi_get_cb_info(env, info, &argc, args, nullptr, nullptr);
+
+    int32_t fd = -1;
+    int64_t size = 0;
+    napi_get_value_int32(env, args[0], &fd);
+    napi_get_value_int64(env, args[1], &size);
+
+    DspProcessor::BatchProcessResult res { AUDIO_STATUS_ERROR, 0, 0 };
+    if (size > 0) {
+        res = DspProcessor::processBatch(fd, static_cast<size_t>(size));
+    }
+    if (res.status != AUDIO_STATUS_DONE || res.jobsFailed != 0) {
+        LOGE("processBatch fd=%d size=%lld status=%d failed=%u",
+             fd, static_cast<long long>(size), res.status, res.jobsFailed);
+    }
+    return MakeBatchResult(env, res);
+}
+
+static napi_value MakeBatchResult(napi_env env, const DspProcessor::BatchProcessResult& res)
+{
+    /* Build result object: { status, processingTimeNs, jobsFailed } */
+    napi_value obj;
+    napi_create_object(env, &obj);
+
+    napi_value valStatus, valTime, valFailed;
+    napi_create_int32(env, res.status, &valStatus);
+    napi_create_double(env, static_cast<double>(res.processingTimeNs), &valTime);
+    napi_create_uint32(env, res.jobsFailed, &valFailed);
+
+    napi_set_named_property(env, obj, "status",           valStatus);
+    napi_set_named_property(env, obj, "processingTimeNs", valTime);
+    napi_set_named_property(env, obj, "jobsFailed",       valFailed);
+
+    return obj;
+}
+
+/* ------------------------------------------------------------------ */
+/*  setWorkerThreads                                                    */
+/* ------------------------------------------------------------------ */
+static napi_value SetWorkerThreads(napi_env env, napi_callback_info info)
+{
+    size_t argc = 1;
+    napi_value args[1];
+    napi_get_cb_info(env, info, &argc, args, nullptr, nullptr);
+
+    uint32_t threads = 0;
+    napi_get_value_uint32(env, args[0], &threads);
+
+    auto& pool = DspProcessor::WorkerPool::instance();
+    pool.setThreadCount(threads);
+    LOGI("setWorkerThreads requested=%u actual=%u", threads, pool.threadCount());
+
+    napi_value result;
+    napi_create_uint32(env, pool.threadCount(), &result);
+    return result;
+}
+
+/* ------------------------------------------------------------------ */
+/*  Async jobs                                                          */
+/* ------------------------------------------------------------------ */
+
+/* Jobs go through the process-wide Scheduler (dsp_scheduler.h): run()
+ * executes on a pinned scheduler worker, in per-client fair / deadline
+ * order, so neither the JS thread nor the Binder thread waits on the DSP.
+ * Each job carries a thread-safe function, and settle() runs back on the JS
+ * thread and turns the native result into JS values. A request refused by
+ * admission control settles at once through busy(). */
+struct AsyncJob : DspProcessor::ScheduledJob {
+    napi_threadsafe_function tsfn = nullptr;
+    napi_deferred   deferred  = nullptr;
+    napi_ref        bufferRef = nullptr;   /* keeps a borrowed ArrayBuffer alive */
+    napi_ref        outputRef = nullptr;   /* ... and a borrowed output buffer   */
+    DspProcessor::JobParams params;
+
+    virtual napi_value settle(napi_env env) = 0;
+
+    /** Promise value of a refused request; nullptr rejects the Promise. */
+    virtual napi_value busy(napi_env /* env */) { return nullptr; }
+
+    void finished() override
+    {
+        napi_call_threadsafe_function(tsfn, this, napi_tsfn_nonblocking);
+        napi_release_threadsafe_function(tsfn, napi_tsfn_release);
+    }
+};
+
+static std::atomic<int64_t> g_asyncCompleted { 0 };
+
+static void RejectJob(napi_env env, napi_deferred deferred, const char* message)
+{
+    napi_value msg, err;
+    napi_create_string_utf8(env, message, NAPI_AUTO_LENGTH, &msg);
+    napi_create_error(env, nullptr, msg, &err);
+    napi_reject_deferred(env, deferred, err);
+}
+
+static void DeleteJob(napi_env env, AsyncJob* job)
+{
+    if (env && job->bufferRef) {
+        napi_delete_reference(env, job->bufferRef);
+    }
+    if (env && job->outputRef) {
+        napi_delete_reference(env, job->outputRef);
+    }
+    delete job;
+}
+
+/* Thread-safe function callback: on the JS thread after run(); env is
+   null when the environment is going away and nothing can be settled */
+static void SettleJob(napi_env env, napi_value /* jsCallback */, void* /* context */, void* data)
+{
+    auto* job = static_cast<AsyncJob*>(data);
+    if (env) {
+        napi_resolve_deferred(env, job->deferred, job->settle(env));
+        g_asyncCompleted.fetch_add(1, std::memory_order_relaxed);
+    }
+    DeleteJob(env, job);
+}
+
+/* Settle a SharedProcessResult-style request that never ran */
+static napi_value MakeBusyResult(napi_env env)
+{
+    return MakeSharedResult(env, DspProcessor::SharedProcessResult { AUDIO_STATUS_BUSY, 0 });
+}
+
+/**
+ * Submit a job to the scheduler and return its Promise. Takes ownership
+ * of @p job.
+ */
+static napi_value QueueAsyncJob(napi_env env, AsyncJob* job, const char* resourceName)
+{
+    napi_value promise, name;
+    napi_create_promise(env, &job->deferred, &promise);
+    napi_create_string_utf8(env, resourceName, NAPI_AUTO_LENGTH, &name);
+
+    if (napi_create_threadsafe_function(env, nullptr, nullptr, name, 0, 1, nullptr, nullptr,
+                                        nullptr, SettleJob, &job->tsfn) != napi_ok) {
+        LOGE("%s: failed to create completion callback", resourceName);
+        RejectJob(env, job->deferred, "failed to queue dsp async job");
+        DeleteJob(env, job);
+        return promise;
+    }
+
+    const int32_t admitted = DspProcessor::Scheduler::instance().submit(job, job->params);
+    if (admitted != AUDIO_STATUS_PROCESSING) {
+        LOGE("%s: refused by the scheduler (client %llu, status %d)", resourceName,
+             static_cast<unsigned long long>(job->params.client), admitted);
+        napi_value value = admitted == AUDIO_STATUS_BUSY ? job->busy(env) : nullptr;
+        if (value) {
+            napi_resolve_deferred(env, job->deferred, value);
+        } else {
+            RejectJob(env, job->deferred, admitted == AUDIO_STATUS_BUSY ? "dsp service busy"
+                                                                        : "failed to queue dsp async job");
+        }
+        g_asyncCompleted.fetch_add(1, std::memory_order_relaxed);
+        napi_release_threadsafe_function(job->tsfn, napi_tsfn_abort);
+        DeleteJob(env, job);
+    }
+    return promise;
+}
+
+struct ProcessAudioJob : AsyncJob {
+    const void* input  = nullptr;
+    size_t numSamples  = 0;
+    float  gain        = 1.0f;
+    bool   bypass      = false;
+    ProcessMeterArgs meterArgs;
+    void*  output      = nullptr;   /* pooled block, owned until settle() */
+    int64_t timeNs     = 0;
+    DspProcessor::MeterResult meter;
+
+    ~ProcessAudioJob() override
+    {
+        DspProcessor::BufferPool::instance().release(output);
+    }
+    void run() override
+    {
+        output = DspProcessor::BufferPool::instance().acquire(numSamples * sizeof(float));
+        if (output) {
+            timeNs = ProcessAudioMetered(static_cast<const float*>(input), static_cast<float*>(output),
+                                         numSamples, gain, bypass, meterArgs, meter);
+        }
+    }
+    napi_value settle(napi_env env) override
+    {
+        void* block = output;
+        output = nullptr;   /* ownership moves to the ArrayBuffer */
+        return MakeProcessResult(env, MakePooledBuffer(env, block, block ? numSamples * sizeof(float) : 0),
+                                 timeNs, meter.channels != 0 ? &meter : nullptr);
+    }
+};
+
+struct ProcessIntoJob : AsyncJob {
+    ProcessIntoArgs args;
+    DspProcessor::SharedProcessResult result { AUDIO_STATUS_ERROR, 0 };
+
+    void run() override
+    {
+        result.processingTimeNs = DspProcessor::processAudioInto(args.src, args.dst, args.numSamples,
+                                                                 args.gain, args.bypass, true);
+        result.status = AUDIO_STATUS_DONE;
+    }
+    napi_value settle(napi_env env) override
+    {
+        return MakeSharedResult(env, result);
+    }
+    napi_value busy(napi_env env) override
+    {
+        return MakeBusyResult(env);
+    }
+};
+
+struct SharedMemoryJob : AsyncJob {
+    int32_t fd   = -1;
+    int64_t size = 0;
+    int64_t receiveNs = 0;
+    DspProcessor::SharedProcessResult result { AUDIO_STATUS_ERROR, 0 };
+
+    void run() override
+    {
+        if (size > 0) {
+            result = DspProcessor::processSharedMemory(fd, static_cast<size_t>(size), receiveNs);
+        }
+    }
+    napi_value settle(napi_env env) override
+    {
+        if (result.status != AUDIO_STATUS_DONE) {
+            LOGE("processSharedMemoryAsync failed fd=%d size=%lld", fd, static_cast<long long>(size));
+        }
+        return MakeSharedResult(env, result);
+    }
+    napi_value busy(napi_env env) override
+    {
+        return MakeBusyResult(env);
+    }
+};
+
+struct SessionJob : AsyncJob {
+    int32_t  id          = 0;
+    uint32_t frameOffset = 0;
+    uint32_t frameCount  = 0;
+    int64_t  receiveNs   = 0;
+    int32_t  uid         = 0;
+    DspProcessor::SharedProcessResult result { AUDIO_STATUS_ERROR, 0 };
+
+    void run() override
+    {
+        result = DspProcessor::processSession(id, frameOffset, frameCount, receiveNs, uid);
+    }
+    napi_value settle(napi_env env) override
+    {
+        if (result.status != AUDIO_STATUS_DONE) {
+            LOGE("processSessionAsync failed id=%d offset=%u count=%u", id, frameOffset, frameCount);
+        }
+        return MakeSharedResult(env, result);
+    }
+    napi_value busy(napi_env env) override
+    {
+        return MakeBusyResult(env);
+    }
+};
+
+struct BatchJob : AsyncJob {
+    int32_t fd   = -1;
+    int64_t size = 0;
+    DspProcessor::BatchProcessResult result { AUDIO_STATUS_ERROR, 0, 0 };
+
+    void run() override
+    {
+        if (size > 0) {
+            result = DspProcessor::processBatch(fd, static_cast<size_t>(size));
+        }
+    }
+    napi_value settle(napi_env env) override
+    {
+        if (result.status != AUDIO_STATUS_DONE || result.jobsFailed != 0) {
+            LOGE("processBatchAsync fd=%d size=%lld status=%d failed=%u",
+                 fd, static_cast<long long>(size), result.status, result.jobsFailed);
+        }
+        return MakeBatchResult(env, result);
+    }
+    napi_value busy(napi_env env) override
+    {
+        return MakeBatchResult(env, DspProcessor::BatchProcessResult { AUDIO_STATUS_BUSY, 0, 0 });
+    }
+};
+
+/* Optional clientId argument (the Binder calling uid); 0 = local caller */
+static uint64_t GetClientArg(napi_env env, const napi_value* args, size_t argc, size_t index)
+{
+    int64_t client = 0;
+    if (argc > index) {
+        napi_get_value_int64(env, args[index], &client);
+    }
+    return client > 0 ? static_cast<uint64_t>(client) : DspProcessor::kLocalClient;
+}
+
+static napi_value ProcessAudioAsync(napi_env env, napi_callback_info info)
+{
+    size_t argc = 5;
+    napi_value args[5];
+    napi_get_cb_info(env, info, &argc, args, nullptr, nullptr);
+
+    auto* job = new ProcessAudioJob();
+
+    void*  bufData = nullptr;
+    size_t bufLen  = 0;
+    GetBufferArg(env, args[0], &bufData, &bufLen);
+    napi_create_reference(env, args[0], 1, &job->bufferRef);
+
+    double  gain   = 1.0;
+    int32_t bypass = 0;
+    napi_get_value_double(env, args[1], &gain);
+    napi_get_value_int32(env, args[2], &bypass);
+
+    job->input      = bufData;
+    job->numSamples = bufLen / sizeof(float);
+    job->gain       = static_cast<float>(gain);
+    job->bypass     = bypass != 0;
+    job->meterArgs  = GetProcessMeterArgs(env, args, argc);
+    return QueueAsyncJob(env, job, "dspProcessAudio");
+}
+
+static napi_value ProcessAudioIntoAsync(napi_env env, napi_callback_info info)
+{
+    size_t argc = 4;
+    napi_value args[4];
+    napi_get_cb_info(env, info, &argc, args, nullptr, nullptr);
+
+    ProcessIntoArgs a;
+    if (argc < 4 || !GetProcessIntoArgs(env, args, a)) {
+        napi_deferred deferred;
+        napi_value promise;
+        napi_create_promise(env, &deferred, &promise);
+        RejectJob(env, deferred, "processAudioIntoAsync: invalid buffers");
+        return promise;
+    }
+
+    auto* job = new ProcessIntoJob();
+    job->args = a;
+    napi_create_reference(env, args[0], 1, &job->bufferRef);
+    napi_create_reference(env, args[1], 1, &job->outputRef);
+    return QueueAsyncJob(env, job, "dspProcessAudioInto");
+}
+
+static napi_value ProcessSharedMemoryAsync(napi_env env, napi_callback_info info)
+{
+    size_t argc = 4;
+    napi_value args[4];
+    napi_get_cb_info(env, info, &argc, args, nullptr, nullptr);
+
+    auto* job = new SharedMemoryJob();
+    napi_get_value_int32(env, args[0], &job->fd);
+    napi_get_value_int64(env, args[1], &job->size);
+    if (argc > 2) {
+        napi_get_value_int64(env, args[2], &job->receiveNs);
+    }
+    job->params.client    = GetClientArg(env, args, argc, 3);
+    job->params.arrivalNs = job->receiveNs;
+    return QueueAsyncJob(env, job, "dspProcessSharedMemory");
+}
+
+static napi_value ProcessSessionAsync(napi_env env, napi_callback_info info)
+{
+    size_t argc = 5;
+    napi_value args[5];
+    napi_get_cb_info(env, info, &argc, args, nullptr, nullptr);
+
+    auto* job = new SessionJob();
+    napi_get_value_int32(env, args[0], &job->id);
+    napi_get_value_uint32(env, args[1], &job->frameOffset);
+    napi_get_value_uint32(env, args[2], &job->frameCount);
+    if (argc > 3) {
+        napi_get_value_int64(env, args[3], &job->receiveNs);
+    }
+    /* Real-time deadline: the block has to be back before it is played */
+    job->params.client    = GetClientArg(env, args, argc, 4);
+    job->uid              = GetUidArg(env, args, argc, 4);
+    job->params.arrivalNs = job->receiveNs != 0 ? job->receiveNs : AudioTrace::nowNs();
+    const int64_t budgetNs = DspProcessor::sessionFramesNs(job->id, job->frameCount);
+    if (budgetNs > 0) {
+        job->params.deadlineNs = job->params.arrivalNs + budgetNs;
+    }
+    return QueueAsyncJob(env, job, "dspProcessSession");
+}
 
+static napi_value ProcessBatchAsync(napi_env env, napi_callback_info info)
+{
+    size_t argc = 3;
+    napi_value args[3];
+    napi_get_cb_info(env, info, &argc, args, nullptr, nullptr);
+
+    auto* job = new BatchJob();
+    napi_get_value_int32(env, args[0], &job->fd);
+    napi_get_value_int64(env, args[1], &job->size);
+    job->params.client   = GetClientArg(env, args, argc, 2);
+    job->params.jobClass = DspProcessor::JobClass::Batch;
+    return QueueAsyncJob(env, job, "dspProcessBatch");
+}
+
+static napi_value GetAsyncStats(napi_env env, napi_callback_info /* info */)
+{
+    const DspProcessor::SchedulerStats stats = DspProcessor::Scheduler::instance().stats();
+
+    napi_value obj, valQueued, valInFlight, valCompleted;
+    napi_create_object(env, &obj);
+    napi_create_uint32(env, stats.queued, &valQueued);
+    napi_create_uint32(env, stats.inFlight, &valInFlight);
+    napi_create_double(env, static_cast<double>(g_asyncCompleted.load(std::memory_order_relaxed)), &valCompleted);
+
+    napi_set_named_property(env, obj, "queued",    valQueued);
+    napi_set_named_property(env, obj, "inFlight",  valInFlight);
+    napi_set_named_property(env, obj, "completed", valCompleted);
     return obj;
 }
 
+static napi_value ConfigureScheduler(napi_env env, napi_callback_info info)
+{
+    size_t argc = 6;
+    napi_value args[6];
+    napi_get_cb_info(env, info, &argc, args, nullptr, nullptr);
+
+    auto& scheduler = DspProcessor::Scheduler::instance();
+    DspProcessor::SchedulerConfig config = scheduler.config();
+    if (argc > 0) {
+        napi_get_value_uint32(env, args[0], &config.workers);
+    }
+    if (argc > 1) {
+        napi_get_value_uint32(env, args[1], &config.maxQueuedPerClient);
+    }
+    if (argc > 2) {
+        napi_get_value_uint32(env, args[2], &config.maxQueuedTotal);
+    }
+    if (argc > 3) {
+        napi_get_value_uint32(env, args[3], &config.maxInFlightPerClient);
+    }
+    if (argc > 4) {
+        napi_get_value_uint32(env, args[4], &config.maxQueuedLocal);
+    }
+    if (argc > 5) {
+        napi_get_value_uint32(env, args[5], &config.maxInFlightLocal);
+    }
+    scheduler.configure(config);
+
+    const DspProcessor::SchedulerStats stats = scheduler.stats();
+    LOGI("configureScheduler workers=%u perClient=%u total=%u inFlight=%u local=%u/%u",
+         stats.workers, config.maxQueuedPerClient, config.maxQueuedTotal, config.maxInFlightPerClient,
+         config.maxQueuedLocal, config.maxInFlightLocal);
+
+    napi_value result;
+    napi_create_uint32(env, stats.workers, &result);
+    return result;
+}
+
+static void SetNumberProperty(napi_env env, napi_value obj, const char* name, double value)
+{
+    napi_value v;
+    napi_create_double(env, value, &v);
+    napi_set_named_property(env, obj, name, v);
+}
+
+static napi_value GetSchedulerStats(napi_env env, napi_callback_info /* info */)
+{
+    const DspProcessor::SchedulerStats stats = DspProcessor::Scheduler::instance().stats();
+
+    napi_value obj, clients;
+    napi_create_object(env, &obj);
+    SetNumberProperty(env, obj, "workers",  stats.workers);
+    SetNumberProperty(env, obj, "queued",   stats.queued);
+    SetNumberProperty(env, obj, "inFlight", stats.inFlight);
+
+    napi_create_array_with_length(env, stats.clients.size(), &clients);
+    for (size_t i = 0; i < stats.clients.size(); ++i) {
+        const DspProcessor::ClientStats& c = stats.clients[i];
+        const double completed = c.completed != 0 ? static_cast<double>(c.completed) : 1.0;
+
+        napi_value item;
+        napi_create_object(env, &item);
+        SetNumberProperty(env, item, "client",         static_cast<double>(c.client));
+        SetNumberProperty(env, item, "queued",         c.queued);
+        SetNumberProperty(env, item, "inFlight",       c.inFlight);
+        SetNumberProperty(env, item, "submitted",      static_cast<double>(c.submitted));
+        SetNumberProperty(env, item, "completed",      static_cast<double>(c.completed));
+        SetNumberProperty(env, item, "rejected",       static_cast<double>(c.rejected));
+        SetNumberProperty(env, item, "deadlineMisses", static_cast<double>(c.deadlineMisses));
+        SetNumberProperty(env, item, "queueTimeAvgNs", static_cast<double>(c.queueTimeTotalNs) / completed);
+        SetNumberProperty(env, item, "queueTimeMaxNs", static_cast<double>(c.queueTimeMaxNs));
+        SetNumberProperty(env, item, "queueTimeLastNs", static_cast<double>(c.queueTimeLastNs));
+        SetNumberProperty(env, item, "runTimeAvgNs",   static_cast<double>(c.runTimeTotalNs) / completed);
+        napi_set_element(env, clients, static_cast<uint32_t>(i), item);
+    }
+    napi_set_named_property(env, obj, "clients", clients);
+    return obj;
+}
+
+static napi_value GetBufferPoolStats(napi_env env, napi_callback_info /* info */)
+{
+    const auto stats = DspProcessor::BufferPool::instance().stats();
+
+    napi_value obj, valHits, valMisses, valCached, valOutstanding;
+    napi_create_object(env, &obj);
+    napi_create_double(env, static_cast<double>(stats.hits), &valHits);
+    napi_create_double(env, static_cast<double>(stats.misses), &valMisses);
+    napi_create_double(env, static_cast<double>(stats.cachedBytes), &valCached);
+    napi_create_double(env, static_cast<double>(stats.outstanding), &valOutstanding);
+
+    napi_set_named_property(env, obj, "hits",        valHits);
+    napi_set_named_property(env, obj, "misses",      valMisses);
+    napi_set_named_property(env, obj, "cachedBytes", valCached);
+    napi_set_named_property(env, obj, "outstanding", valOutstanding);
+    return obj;
+}
+
+/* ------------------------------------------------------------------ */
+/*  Tracing                                                             */
+/* ------------------------------------------------------------------ */
+static napi_value TraceNow(napi_env env, napi_callback_info /* info */)
+{
+    napi_value result;
+    napi_create_int64(env, AudioTrace::nowNs(), &result);
+    return result;
+}
+
+static napi_value SetTracing(napi_env env, napi_callback_info info)
+{
+    size_t argc = 1;
+    napi_value args[1];
+    napi_get_cb_info(env, info, &argc, args, nullptr, nullptr);
+
+    bool on = false;
+    napi_get_value_bool(env, args[0], &on);
+    AudioTrace::setEnabled(on);
+    LOGI("setTracing %d (compiled in: %d)", on ? 1 : 0, AUDIO_TRACING);
+
+    napi_value result;
+    napi_get_undefined(env, &result);
+    return result;
+}
+
+static napi_value DumpTrace(napi_env env, napi_callback_info info)
+{
+    size_t argc = 1;
+    napi_value args[1];
+    napi_get_cb_info(env, info, &argc, args, nullptr, nullptr);
+
+    const std::string path = GetStringArg(env, args[0]);
+    const bool ok = !path.empty() && AudioTrace::writeChromeTrace(path);
+    LOGI("dumpTrace %s events=%zu ok=%d", path.c_str(), AudioTrace::eventCount(), ok ? 1 : 0);
+
+    napi_value result;
+    napi_get_boolean(env, ok, &result);
+    return result;
+}
+
+static std::string GetStringArg(napi_env env, napi_value value)
+{
+    size_t len = 0;
+    napi_get_value_string_utf8(env, value, nullptr, 0, &len);
+    std::string str(len + 1, '\0');
+    napi_get_value_string_utf8(env, value, &str[0], len + 1, &len);
+    str.resize(len);
+    return str;
+}
+
 /* ------------------------------------------------------------------ */
 /*  Module registration                                                 */
 /* ------------------------------------------------------------------ */
@@ -85,7 +1249,56 @@ static napi_value Init(napi_env env, napi_value exports)
     napi_property_descriptor desc[] = {
         { "processAudio", nullptr, ProcessAudio,
           nullptr, nullptr, nullptr, napi_default, nullptr },
+        { "processAudioInto", nullptr, ProcessAudioInto,
+          nullptr, nullptr, nullptr, napi_default, nullptr },
+        { "processSharedMemory", nullptr, ProcessSharedMemory,
+          nullptr, nullptr, nullptr, napi_default, nullptr },
+        { "openStream", nullptr, OpenStream,
+          nullptr, nullptr, nullptr, napi_default, nullptr },
+        { "closeStream", nullptr, CloseStream,
+          nullptr, nullptr, nullptr, napi_default, nullptr },
+        { "closeAllStreams", nullptr, CloseAllStreams,
+          nullptr, nullptr, nullptr, napi_default, nullptr },
+        { "openSession", nullptr, OpenSession,
+          nullptr, nullptr, nullptr, napi_default, nullptr },
+        { "processSession", nullptr, ProcessSession,
+          nullptr, nullptr, nullptr, napi_default, nullptr },
+        { "closeSession", nullptr, CloseSession,
+          nullptr, nullptr, nullptr, napi_default, nullptr },
+        { "closeAllSessions", nullptr, CloseAllSessions,
+          nullptr, nullptr, nullptr, napi_default, nullptr },
+        { "setIdleTimeout", nullptr, SetIdleTimeout,
+          nullptr, nullptr, nullptr, napi_default, nullptr },
+        { "processBatch", nullptr, ProcessBatch,
+          nullptr, nullptr, nullptr, napi_default, nullptr },
+        { "setWorkerThreads", nullptr, SetWorkerThreads,
+          nullptr, nullptr, nullptr, napi_default, nullptr },
+        { "processAudioAsync", nullptr, ProcessAudioAsync,
+          nullptr, nullptr, nullptr, napi_default, nullptr },
+        { "processAudioIntoAsync", nullptr, ProcessAudioIntoAsync,
+          nullptr, nullptr, nullptr, napi_default, nullptr },
+        { "processSharedMemoryAsync", nullptr, ProcessSharedMemoryAsync,
+          nullptr, nullptr, nullptr, napi_default, nullptr },
+        { "processSessionAsync", nullptr, ProcessSessionAsync,
+          nullptr, nullptr, nullptr, napi_default, nullptr },
+        { "processBatchAsync", nullptr, ProcessBatchAsync,
+          nullptr, nullptr, nullptr, napi_default, nullptr },
+        { "getAsyncStats", nullptr, GetAsyncStats,
+          nullptr, nullptr, nullptr, napi_default, nullptr },
+        { "configureScheduler", nullptr, ConfigureScheduler,
+          nullptr, nullptr, nullptr, napi_default, nullptr },
+        { "getSchedulerStats", nullptr, GetSchedulerStats,
+          nullptr, nullptr, nullptr, napi_default, nullptr },
+        { "getBufferPoolStats", nullptr, GetBufferPoolStats,
+          nullptr, nullptr, nullptr, napi_default, nullptr },
+        { "traceNow", nullptr, TraceNow,
+          nullptr, nullptr, nullptr, napi_default, nullptr },
+        { "setTracing", nullptr, SetTracing,
+          nullptr, nullptr, nullptr, napi_default, nullptr },
+        { "dumpTrace", nullptr, DumpTrace,
+          nullptr, nullptr, nullptr, napi_default, nullptr },
     };
+    AudioTrace::setProcessName("DspService");
     napi_define_properties(env, exports, sizeof(desc) / sizeof(desc[0]), desc);
     return exports;
 }
@@ -4,43 +4,706 @@
  * Supported modes:
  *   bypass = true  → output = input  (verbatim copy)
  *   bypass = false → output = tanh(input * gain)   (gain + soft clip)
+ *
+ * The soft-clip loop is the vectorised kernel selected in dsp_kernels.cpp;
+ * int16 / int24 conversions come from shared/AudioFormatConvert.cpp.
+ * A FrameGuard switches float input to the guard kernels (see FrameGuard).
  */
 
 #include "dsp_processor.h"
+#include "dsp_buffer_pool.h"
+#include "dsp_chain.h"
+#include "dsp_kernels.h"
+#include "dsp_live_control.h"
+#include "dsp_meter.h"
+#include "dsp_resampler.h"
+#include "dsp_thread_pool.h"
+#include "AudioFormatConvert.h"
 
+#include <algorithm>
 #include <chrono>
-#include <cmath>
 #include <cstring>
+#include <vector>
 
 namespace DspProcessor {
 
+namespace {
+
+/* float scratch per conversion step: 4 KiB, stays in L1 between the
+   decode, soft-clip and encode passes; a multiple of every SIMD width */
+constexpr size_t kConvertBlockSamples = 1024;
+
+/* Seed of the dither sequence that starts at sample @p position of the
+   stream. Spans are seeded from where they sit in the stream, not from the
+   start of the call, so a session's calls never repeat a sequence */
+uint32_t ditherSeed(uint64_t position)
+{
+    return static_cast<uint32_t>(position ^ (position >> 32)) * 0x9e3779b1u + 1u;
+}
+
+/* The formats that can carry NaN / Inf */
+bool floatFormat(uint32_t format)
+{
+    return format == AUDIO_FORMAT_FLOAT32 || format == AUDIO_FORMAT_FLOAT32_PLANAR;
+}
+
+/* decode → gain + soft clip → encode, one L1 block at a time */
+void processPackedChunk(const uint8_t* src, uint8_t* dst, size_t numSamples,
+                        uint32_t format, float gain, bool dither, uint32_t seed)
+{
+    const size_t bps = AudioFormat::bytesPerSample(format);
+    const SoftClipKernel softClip = softClipKernel();
+    AudioFormat::Dither state;
+    if (dither) {
+        AudioFormat::seedDither(state, seed);
+    }
+
+    alignas(64) float block[kConvertBlockSamples];
+    for (size_t i = 0; i < numSamples; i += kConvertBlockSamples) {
+        const size_t n = std::min(kConvertBlockSamples, numSamples - i);
+        AudioFormat::decode(format, src + i * bps, block, n);
+        softClip(block, block, n, gain);
+        AudioFormat::encode(format, block, dst + i * bps, n, dither ? &state : nullptr);
+    }
+}
+
+/* Interleaved integer formats without a chain */
+void processPacked(const uint8_t* src, uint8_t* dst, size_t numSamples, uint32_t format,
+                   float gain, bool bypass, bool dither, uint64_t ditherSample, bool parallel)
+{
+    const size_t bps = AudioFormat::bytesPerSample(format);
+    if (bypass) {
+        if (dst != src) {
+            std::memmove(dst, src, numSamples * bps);
+        }
+        return;
+    }
+
+    const size_t chunks = (numSamples + kParallelChunkSamples - 1) / kParallelChunkSamples;
+    auto runChunk = [=](size_t chunk) {
+        const size_t begin = chunk * kParallelChunkSamples;
+        const size_t n = std::min(kParallelChunkSamples, numSamples - begin);
+        processPackedChunk(src + begin * bps, dst + begin * bps, n, format, gain, dither,
+                           ditherSeed(ditherSample + begin));
+    };
+    if (parallel && chunks >= 2) {
+        WorkerPool::instance().parallelFor(chunks, runChunk);
+    } else {
+        for (size_t chunk = 0; chunk < chunks; ++chunk) {
+            runChunk(chunk);
+        }
+    }
+}
+
+static_assert(LiveControl::kMaxChannels <= ProcessingChain::kMaxChannels,
+              "processFormattedBlocks() gathers live control streams too");
+
+/* Any format through a stateful float stage (chain, live control): gather
+   into an interleaved float block, run it, scatter back. Stays serial.
+   Both stages refuse more than ProcessingChain::kMaxChannels channels when
+   configured; a view that gets here anyway is left untouched. */
+template <typename Stage>
+void processFormattedBlocks(const PcmView& view, uint32_t frameOffset, uint32_t frameCount,
+                            bool dither, uint64_t ditherFrame, FrameGuard* guard, Stage&& stage)
+{
+    const uint32_t ch  = view.channels;
+    if (ch == 0 || ch > ProcessingChain::kMaxChannels) {
+        return;
+    }
+    const size_t   bps = AudioFormat::bytesPerSample(view.format);
+    const bool planar  = AudioFormat::isPlanar(view.format);
+    const SanitizeKernel sanitize = guard && floatFormat(view.format) ? sanitizeKernel() : nullptr;
+    AudioFormat::Dither state;
+    if (dither) {
+        AudioFormat::seedDither(state, ditherSeed(ditherFrame * ch));
+    }
+
+    alignas(64) float block[ProcessingChain::kBlockFrames * ProcessingChain::kMaxChannels];
+    for (uint32_t f = 0; f < frameCount; f += ProcessingChain::kBlockFrames) {
+        const size_t n = std::min<size_t>(ProcessingChain::kBlockFrames, frameCount - f);
+        const size_t first = static_cast<size_t>(frameOffset) + f;
+        if (planar) {
+            const float* in = reinterpret_cast<const float*>(view.input);
+            for (uint32_t c = 0; c < ch; ++c) {
+                const float* plane = in + static_cast<size_t>(c) * view.frames + first;
+                for (size_t i = 0; i < n; ++i) {
+                    block[i * ch + c] = plane[i];
+                }
+            }
+        } else {
+            AudioFormat::decode(view.format, view.input + first * ch * bps, block, n * ch);
+        }
+        if (sanitize) {
+            guard->add(sanitize(block, block, n * ch));
+        }
+
+        stage(block, n);
+
+        if (planar) {
+            float* out = reinterpret_cast<float*>(view.output);
+            for (uint32_t c = 0; c < ch; ++c) {
+                float* plane = out + static_cast<size_t>(c) * view.frames + first;
+                for (size_t i = 0; i < n; ++i) {
+                    plane[i] = block[i * ch + c];
+                }
+            }
+        } else {
+            AudioFormat::encode(view.format, block, view.output + first * ch * bps, n * ch,
+                                dither ? &state : nullptr);
+        }
+    }
+}
+
+void processChainFormatted(const PcmView& view, uint32_t frameOffset, uint32_t frameCount,
+                           bool dither, uint64_t ditherFrame, ProcessingChain& chain,
+                           FrameGuard* guard)
+{
+    processFormattedBlocks(view, frameOffset, frameCount, dither, ditherFrame, guard,
+                           [&chain](float* block, size_t n) { chain.process(block, n); });
+}
+
+/* ---- non-finite guard ---------------------------------------------- */
+
+/* processBuffer() through the guard kernels; returns the samples replaced */
+size_t guardBuffer(const float* src, float* dst, size_t numSamples, float gain, bool bypass)
+{
+    return bypass ? sanitizeKernel()(src, dst, numSamples)
+                  : softClipGuardKernel()(src, dst, numSamples, gain);
+}
+
+/* processBuffer() / processBufferParallel(), guarded when guard is set;
+   the same chunks as processBufferParallel(), so the same kernel path */
+void processSpan(const float* src, float* dst, size_t numSamples, float gain, bool bypass,
+                 bool parallel, FrameGuard* guard)
+{
+    if (!guard) {
+        if (parallel) {
+            processBufferParallel(src, dst, numSamples, gain, bypass);
+        } else {
+            processBuffer(src, dst, numSamples, gain, bypass);
+        }
+        return;
+    }
+    const size_t chunks = (numSamples + kParallelChunkSamples - 1) / kParallelChunkSamples;
+    if (!parallel || chunks < 2) {
+        guard->add(guardBuffer(src, dst, numSamples, gain, bypass));
+        return;
+    }
+    WorkerPool::instance().parallelFor(chunks, [=](size_t chunk) {
+        const size_t begin = chunk * kParallelChunkSamples;
+        const size_t n = std::min(kParallelChunkSamples, numSamples - begin);
+        guard->add(guardBuffer(src + begin, dst + begin, n, gain, bypass));
+    });
+}
+
+/* ---- metering ------------------------------------------------------ */
+
+bool metering(const FrameMeter& meter)
+{
+    return meter.levels && meter.levels->active();
+}
+
+/* Run fn(begin, n, lanes) over [0, numSamples) in kParallelChunkSamples
+   chunks and fold the lanes into levels. Parallel chunks get their own
+   lanes and totals, merged in chunk order. mirror: the spans were bypassed
+   and only metered as output, which is also the input. */
+template <typename Fn>
+void runMeteredChunks(size_t numSamples, uint32_t laneChannels, uint32_t channelBase,
+                      bool parallel, bool mirror, LevelMeter& levels, Fn&& fn)
+{
+    const size_t chunks = (numSamples + kParallelChunkSamples - 1) / kParallelChunkSamples;
+    if (parallel && chunks >= 2) {
+        std::vector<LevelMeter> parts(chunks);
+        WorkerPool::instance().parallelFor(chunks, [&](size_t chunk) {
+            const size_t begin = chunk * kParallelChunkSamples;
+            const size_t n = std::min(kParallelChunkSamples, numSamples - begin);
+            MeterLanes lanes;
+            lanes.reset(laneChannels, static_cast<uint32_t>(begin % laneChannels));
+            fn(begin, n, lanes);
+            if (mirror) {
+                lanes.mirrorOutput();
+            }
+            parts[chunk].begin(levels.channels());
+            parts[chunk].fold(lanes, channelBase);
+        });
+        for (const LevelMeter& part : parts) {
+            levels.merge(part);
+        }
+        return;
+    }
+
+    MeterLanes lanes;
+    lanes.reset(laneChannels, 0);
+    for (size_t begin = 0; begin < numSamples; begin += kParallelChunkSamples) {
+        fn(begin, std::min(kParallelChunkSamples, numSamples - begin), lanes);
+    }
+    if (mirror) {
+        lanes.mirrorOutput();
+    }
+    levels.fold(lanes, channelBase);
+}
+
+/* Gain + soft clip (or bypass copy) of contiguous floats, metered by the
+   fused kernel. With a loudness meter, loud(block, offset, n) sees each
+   L1 block of output while it is still in cache. With a guard each L1
+   block is sanitized into dst first and then processed in place there. */
+template <typename Loud>
+void meteredSpan(const float* src, float* dst, size_t n, float gain, bool bypass,
+                 MeterLanes& lanes, LoudnessMeter* loudness, FrameGuard* guard, Loud&& loud)
+{
+    const SoftClipMeterKernel softClip = softClipMeterKernel();
+    const LevelMeterKernel level = levelMeterKernel();
+    const SanitizeKernel sanitize = guard ? sanitizeKernel() : nullptr;
+    const size_t block = bypass || loudness || guard ? kConvertBlockSamples : std::max<size_t>(n, 1);
+    for (size_t i = 0; i < n; i += block) {
+        const size_t m = std::min(block, n - i);
+        const float* in = src + i;
+        if (sanitize) {
+            guard->add(sanitize(in, dst + i, m));
+            in = dst + i;
+        }
+        if (bypass) {
+            if (dst + i != in) {
+                std::memmove(dst + i, in, m * sizeof(float));
+            }
+            level(dst + i, m, lanes, true, 1.0f);
+            lanes.advance(m);
+        } else {
+            softClip(in, dst + i, m, gain, lanes);
+        }
+        if (loudness) {
+            loud(dst + i, i, m);
+        }
+    }
+}
+
+/* processPackedChunk() with metering; the encoded output is the same */
+void processPackedChunkMetered(const uint8_t* src, uint8_t* dst, size_t numSamples,
+                               uint32_t format, float gain, bool bypass, bool dither,
+                               uint32_t seed, MeterLanes& lanes, LoudnessMeter* loudness)
+{
+    const size_t bps = AudioFormat::bytesPerSample(format);
+    const SoftClipMeterKernel softClip = softClipMeterKernel();
+    const LevelMeterKernel level = levelMeterKernel();
+    const uint32_t firstChannel = (lanes.firstChannel + lanes.pos) % lanes.channels;
+    AudioFormat::Dither state;
+    if (dither) {
+        AudioFormat::seedDither(state, seed);
+    }
+
+    alignas(64) float block[kConvertBlockSamples];
+    for (size_t i = 0; i < numSamples; i += kConvertBlockSamples) {
+        const size_t n = std::min(kConvertBlockSamples, numSamples - i);
+        AudioFormat::decode(format, src + i * bps, block, n);
+        if (bypass) {
+            level(block, n, lanes, true, 1.0f);
+            lanes.advance(n);
+            if (dst != src) {
+                std::memmove(dst + i * bps, src + i * bps, n * bps);
+            }
+        } else {
+            softClip(block, block, n, gain, lanes);
+            AudioFormat::encode(format, block, dst + i * bps, n, dither ? &state : nullptr);
+        }
+        if (loudness) {
+            loudness->process(block, n, static_cast<uint32_t>((firstChannel + i) % lanes.channels));
+        }
+    }
+}
+
+/* An in-place float stage (chain, live control) on interleaved frames,
+   metered before and after; stage returns the output clip threshold.
+   A guard sanitizes src into dst, and the stage then runs in place. */
+template <typename Stage>
+void meteredStage(const float* src, float* dst, size_t frames, uint32_t channels,
+                  MeterLanes& lanes, LoudnessMeter* loudness, FrameGuard* guard, Stage&& stage)
+{
+    const LevelMeterKernel level = levelMeterKernel();
+    const size_t n = frames * channels;
+    if (guard) {
+        guard->add(sanitizeKernel()(src, dst, n));
+        src = dst;
+    }
+    level(src, n, lanes, false, 0.0f);
+    const float clipAbove = stage(src, dst, frames);
+    level(dst, n, lanes, true, clipAbove);
+    lanes.advance(n);
+    if (loudness) {
+        loudness->process(dst, n);
+    }
+}
+
+/* Chain or live control through the format blocks, metered per block */
+template <typename Stage>
+void processFormattedMetered(const PcmView& view, uint32_t frameOffset, uint32_t frameCount,
+                             bool dither, uint64_t ditherFrame, const FrameMeter& meter,
+                             FrameGuard* guard, Stage&& stage)
+{
+    MeterLanes lanes;
+    lanes.reset(view.channels, 0);
+    processFormattedBlocks(view, frameOffset, frameCount, dither, ditherFrame, guard, [&](float* block, size_t n) {
+        meteredStage(block, block, n, view.channels, lanes, meter.loudness, nullptr, stage);
+    });
+    meter.levels->fold(lanes);
+}
+
+void processFramesMetered(const PcmView& view, uint32_t frameOffset, uint32_t frameCount,
+                          float gain, bool bypass, bool dither, ProcessingChain* chain,
+                          bool parallel, const FrameMeter& meter, FrameGuard* guard,
+                          uint64_t ditherFrame)
+{
+    const uint32_t ch = view.channels;
+    LevelMeter& levels = *meter.levels;
+    LoudnessMeter* loudness = meter.loudness;
+    /* The loudness filters run in stream order */
+    parallel = parallel && !loudness;
+
+    if (chain) {
+        processFormattedMetered(view, frameOffset, frameCount, dither, ditherFrame, meter, guard,
+                                [chain](const float*, float* block, size_t n) {
+                                    chain->process(block, n);
+                                    return 1.0f;   /* beyond full scale */
+                                });
+        return;
+    }
+
+    if (view.format == AUDIO_FORMAT_FLOAT32) {
+        const float* src = reinterpret_cast<const float*>(view.input) + frameOffset * ch;
+        float*       dst = reinterpret_cast<float*>(view.output) + frameOffset * ch;
+        runMeteredChunks(static_cast<size_t>(frameCount) * ch, ch, 0, parallel, bypass, levels,
+                         [&](size_t begin, size_t n, MeterLanes& lanes) {
+            meteredSpan(src + begin, dst + begin, n, gain, bypass, lanes, loudness, guard,
+                        [&](const float* block, size_t offset, size_t m) {
+                loudness->process(block, m, static_cast<uint32_t>((begin + offset) % ch));
+            });
+        });
+        return;
+    }
+
+    if (view.format == AUDIO_FORMAT_FLOAT32_PLANAR) {
+        /* One lane channel per plane, folded into its channel */
+        for (uint32_t c = 0; c < ch; ++c) {
+            const size_t first = static_cast<size_t>(c) * view.frames + frameOffset;
+            const float* src = reinterpret_cast<const float*>(view.input) + first;
+            float*       dst = reinterpret_cast<float*>(view.output) + first;
+            runMeteredChunks(frameCount, 1, c, parallel, bypass, levels,
+                             [&](size_t begin, size_t n, MeterLanes& lanes) {
+                meteredSpan(src + begin, dst + begin, n, gain, bypass, lanes, loudness, guard,
+                            [&](const float* block, size_t, size_t m) {
+                    loudness->processChannel(c, block, m);
+                });
+            });
+        }
+        return;
+    }
+
+    const size_t bps = AudioFormat::bytesPerSample(view.format);
+    const uint8_t* src = view.input + static_cast<size_t>(frameOffset) * ch * bps;
+    uint8_t*       dst = view.output + static_cast<size_t>(frameOffset) * ch * bps;
+    runMeteredChunks(static_cast<size_t>(frameCount) * ch, ch, 0, parallel, bypass, levels,
+                     [&](size_t begin, size_t n, MeterLanes& lanes) {
+        processPackedChunkMetered(src + begin * bps, dst + begin * bps, n, view.format, gain,
+                                  bypass, dither, ditherSeed(ditherFrame * ch + begin),
+                                  lanes, loudness);
+    });
+}
+
+/* ---- sample-rate conversion --------------------------------------- */
+
+/* Input range of a view through the resampler into interleaved floats;
+   formats other than FLOAT32, and guarded FLOAT32, are decoded / gathered
+   (sanitized) one L1 block at a time */
+size_t resampleFrames(const PcmView& view, uint32_t frameOffset, uint32_t frameCount,
+                      Resampler& resampler, FrameGuard* guard, float* out)
+{
+    const uint32_t ch = view.channels;
+    if (view.format == AUDIO_FORMAT_FLOAT32 && !guard) {
+        const float* in = reinterpret_cast<const float*>(view.input) + static_cast<size_t>(frameOffset) * ch;
+        return resampler.process(in, frameCount, out);
+    }
+
+    const size_t bps = AudioFormat::bytesPerSample(view.format);
+    const bool planar = AudioFormat::isPlanar(view.format);
+    const SanitizeKernel sanitize = guard && floatFormat(view.format) ? sanitizeKernel() : nullptr;
+    const uint32_t blockFrames = static_cast<uint32_t>(kConvertBlockSamples / ch);
+    alignas(64) float block[kConvertBlockSamples];
+    size_t produced = 0;
+    for (uint32_t f = 0; f < frameCount; f += blockFrames) {
+        const size_t n = std::min<size_t>(blockFrames, frameCount - f);
+        const size_t first = static_cast<size_t>(frameOffset) + f;
+        if (planar) {
+            const float* in = reinterpret_cast<const float*>(view.input);
+            for (uint32_t c = 0; c < ch; ++c) {
+                const float* plane = in + static_cast<size_t>(c) * view.frames + first;
+                for (size_t i = 0; i < n; ++i) {
+                    block[i * ch + c] = plane[i];
+                }
+            }
+        } else if (sanitize) {
+            /* FLOAT32: the sanitize pass is the copy */
+            const float* in = reinterpret_cast<const float*>(view.input) + first * ch;
+            guard->add(sanitize(in, block, n * ch));
+        } else {
+            AudioFormat::decode(view.format, view.input + first * ch * bps, block, n * ch);
+        }
+        if (planar && sanitize) {
+            guard->add(sanitize(block, block, n * ch));
+        }
+        produced += resampler.process(block, n, out + produced * ch);
+    }
+    return produced;
+}
+
+/* Interleaved floats into frames [offset, offset + n) of an output region */
+void storeFrames(const float* pcm, size_t n, uint32_t channels, uint32_t format,
+                 uint8_t* output, uint32_t outputFrames, uint32_t offset, bool dither,
+                 uint64_t ditherFrame)
+{
+    if (AudioFormat::isPlanar(format)) {
+        float* out = reinterpret_cast<float*>(output);
+        for (uint32_t c = 0; c < channels; ++c) {
+            float* plane = out + static_cast<size_t>(c) * outputFrames + offset;
+            for (size_t i = 0; i < n; ++i) {
+                plane[i] = pcm[i * channels + c];
+            }
+        }
+        return;
+    }
+    AudioFormat::Dither state;
+    if (dither) {
+        AudioFormat::seedDither(state, ditherSeed(ditherFrame * channels));
+    }
+    const size_t bps = AudioFormat::bytesPerSample(format);
+    AudioFormat::encode(format, pcm, output + static_cast<size_t>(offset) * channels * bps,
+                        n * channels, dither ? &state : nullptr);
+}
+
+} // namespace
+
+void processBuffer(const float* src, float* dst, size_t numSamples,
+                   float gain, bool bypass)
+{
+    if (bypass) {
+        /* Bypass: copy input to output unchanged (no-op when in-place) */
+        if (dst != src) {
+            std::memmove(dst, src, numSamples * sizeof(float));
+        }
+        return;
+    }
+
+    /* Apply gain then soft-clip via tanh to prevent overflow */
+    softClipKernel()(src, dst, numSamples, gain);
+}
+
+void processBufferParallel(const float* src, float* dst, size_t numSamples,
+                           float gain, bool bypass)
+{
+    const size_t chunks = (numSamples + kParallelChunkSamples - 1) / kParallelChunkSamples;
+    if (chunks < 2) {
+        processBuffer(src, dst, numSamples, gain, bypass);
+        return;
+    }
+
+    /* Chunks start on multiples of the SIMD width, so every sample goes
+       through the same kernel path as in the single-threaded call */
+    WorkerPool::instance().parallelFor(chunks, [=](size_t chunk) {
+        const size_t begin = chunk * kParallelChunkSamples;
+        const size_t n = begin + kParallelChunkSamples <= numSamples
+                         ? kParallelChunkSamples : numSamples - begin;
+        processBuffer(src + begin, dst + begin, n, gain, bypass);
+    });
+}
+
 ProcessResult processAudio(const void* inputPcm, int numSamples,
                            float gain, bool bypass)
 {
     ProcessResult result;
     result.outputBytes.resize(static_cast<size_t>(numSamples) * sizeof(float));
-    result.processingTimeNs = 0;
 
     const float* src = static_cast<const float*>(inputPcm);
     float*       dst = reinterpret_cast<float*>(result.outputBytes.data());
 
+    result.processingTimeNs =
+        processAudioInto(src, dst, static_cast<size_t>(numSamples), gain, bypass, false);
+    return result;
+}
+
+int64_t processAudioInto(const float* src, float* dst, size_t numSamples,
+                         float gain, bool bypass, bool parallel)
+{
     auto t0 = std::chrono::steady_clock::now();
 
-    if (bypass) {
-        /* Bypass: copy input to output unchanged */
-        std::memcpy(dst, src, static_cast<size_t>(numSamples) * sizeof(float));
+    if (parallel) {
+        processBufferParallel(src, dst, numSamples, gain, bypass);
     } else {
-        /* Apply gain then soft-clip via tanh to prevent overflow */
-        for (int i = 0; i < numSamples; ++i) {
-            dst[i] = std::tanh(src[i] * gain);
-        }
+        processBuffer(src, dst, numSamples, gain, bypass);
     }
 
     auto t1 = std::chrono::steady_clock::now();
-    result.processingTimeNs =
-        std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count();
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count();
+}
 
-    return result;
+int64_t processAudioInto(const float* src, float* dst, size_t numSamples,
+                         float gain, bool bypass, bool parallel, const FrameMeter& meter)
+{
+    /* Whole frames only: the meter needs to know every sample's channel */
+    if (!metering(meter) || numSamples % meter.levels->channels() != 0) {
+        return processAudioInto(src, dst, numSamples, gain, bypass, parallel);
+    }
+    const uint32_t ch = meter.levels->channels();
+    const PcmView view { reinterpret_cast<const uint8_t*>(src), reinterpret_cast<uint8_t*>(dst),
+                         AUDIO_FORMAT_FLOAT32, ch, static_cast<uint32_t>(numSamples / ch) };
+
+    auto t0 = std::chrono::steady_clock::now();
+    processFrames(view, 0, view.frames, gain, bypass, false, nullptr, parallel, meter);
+    auto t1 = std::chrono::steady_clock::now();
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count();
+}
+
+void processFrames(const PcmView& view, uint32_t frameOffset, uint32_t frameCount,
+                   float gain, bool bypass, bool dither, ProcessingChain* chain,
+                   bool parallel, const FrameMeter& meter, FrameGuard* guard,
+                   uint64_t ditherFrame)
+{
+    if (metering(meter)) {
+        processFramesMetered(view, frameOffset, frameCount, gain, bypass, dither, chain,
+                             parallel, meter, guard, ditherFrame);
+        return;
+    }
+
+    const size_t ch = view.channels;
+
+    if (view.format == AUDIO_FORMAT_FLOAT32) {
+        const float* src = reinterpret_cast<const float*>(view.input) + frameOffset * ch;
+        float*       dst = reinterpret_cast<float*>(view.output) + frameOffset * ch;
+        const size_t numSamples = static_cast<size_t>(frameCount) * ch;
+        if (chain) {
+            processSpan(src, dst, numSamples, 1.0f, true, false, guard);
+            if (parallel) {
+                chain->processParallel(dst, frameCount);
+            } else {
+                chain->process(dst, frameCount);
+            }
+        } else {
+            processSpan(src, dst, numSamples, gain, bypass, parallel, guard);
+        }
+        return;
+    }
+
+    if (chain) {
+        processChainFormatted(view, frameOffset, frameCount, dither, ditherFrame, *chain, guard);
+        return;
+    }
+
+    if (view.format == AUDIO_FORMAT_FLOAT32_PLANAR) {
+        /* Gain + soft clip is per sample: run each plane's range as one span */
+        for (size_t c = 0; c < ch; ++c) {
+            const size_t first = c * view.frames + frameOffset;
+            const float* src = reinterpret_cast<const float*>(view.input) + first;
+            float*       dst = reinterpret_cast<float*>(view.output) + first;
+            processSpan(src, dst, frameCount, gain, bypass, parallel, guard);
+        }
+        return;
+    }
+
+    const size_t bps = AudioFormat::bytesPerSample(view.format);
+    processPacked(view.input + frameOffset * ch * bps, view.output + frameOffset * ch * bps,
+                  static_cast<size_t>(frameCount) * ch, view.format, gain, bypass, dither,
+                  ditherFrame * ch, parallel);
+}
+
+void processFramesLive(const PcmView& view, uint32_t frameOffset, uint32_t frameCount,
+                       bool dither, LiveControl& live, const FrameMeter& meter, FrameGuard* guard,
+                       uint64_t ditherFrame)
+{
+    if (metering(meter)) {
+        /* Live output is soft clipped unless fully bypassed */
+        auto stage = [&live](const float* src, float* dst, size_t n) {
+            live.process(src, dst, n);
+            return live.bypassed() ? 1.0f : kSoftClipKnee;
+        };
+        if (view.format != AUDIO_FORMAT_FLOAT32) {
+            processFormattedMetered(view, frameOffset, frameCount, dither, ditherFrame, meter, guard,
+                                    stage);
+            return;
+        }
+        const uint32_t ch = view.channels;
+        const float* src = reinterpret_cast<const float*>(view.input) + static_cast<size_t>(frameOffset) * ch;
+        float*       dst = reinterpret_cast<float*>(view.output) + static_cast<size_t>(frameOffset) * ch;
+        MeterLanes lanes;
+        lanes.reset(ch, 0);
+        for (uint32_t f = 0; f < frameCount; f += LiveControl::kBlockFrames) {
+            const size_t n = std::min<size_t>(LiveControl::kBlockFrames, frameCount - f);
+            meteredStage(src + static_cast<size_t>(f) * ch, dst + static_cast<size_t>(f) * ch, n, ch,
+                         lanes, meter.loudness, guard, stage);
+        }
+        meter.levels->fold(lanes);
+        return;
+    }
+
+    if (view.format == AUDIO_FORMAT_FLOAT32) {
+        const uint32_t ch = view.channels;
+        const float* src = reinterpret_cast<const float*>(view.input) + static_cast<size_t>(frameOffset) * ch;
+        float*       dst = reinterpret_cast<float*>(view.output) + static_cast<size_t>(frameOffset) * ch;
+        if (!guard) {
+            live.process(src, dst, frameCount);
+            return;
+        }
+        /* Sanitize one control block into dst, then run it in place */
+        const SanitizeKernel sanitize = sanitizeKernel();
+        for (uint32_t f = 0; f < frameCount; f += LiveControl::kBlockFrames) {
+            const size_t n = std::min<size_t>(LiveControl::kBlockFrames, frameCount - f);
+            float* block = dst + static_cast<size_t>(f) * ch;
+            guard->add(sanitize(src + static_cast<size_t>(f) * ch, block, n * ch));
+            live.process(block, block, n);
+        }
+        return;
+    }
+    /* The gather block equals LiveControl::kBlockFrames, so the control
+       block is still polled once per block */
+    processFormattedBlocks(view, frameOffset, frameCount, dither, ditherFrame, guard,
+                           [&live](float* block, size_t n) { live.process(block, block, n); });
+}
+
+uint32_t processFramesResampled(const PcmView& view, uint32_t outputFrames, uint32_t frameOffset,
+                                uint32_t frameCount, uint32_t outputOffset, bool flush,
+                                Resampler& resampler, float gain, bool bypass, bool dither,
+                                ProcessingChain* chain, LiveControl* live, bool parallel,
+                                const FrameMeter& meter, FrameGuard* guard, uint64_t ditherFrame)
+{
+    const uint32_t ch = view.channels;
+    const bool direct = view.format == AUDIO_FORMAT_FLOAT32;
+    float* pcm;
+    if (direct) {
+        pcm = reinterpret_cast<float*>(view.output) + static_cast<size_t>(outputOffset) * ch;
+    } else {
+        const size_t capacity = std::max<size_t>(resampler.outputFramesFor(frameCount, flush), 1);
+        pcm = static_cast<float*>(BufferPool::instance().acquire(capacity * ch * sizeof(float)));
+        if (!pcm) {
+            return 0;
+        }
+    }
+
+    size_t n = resampleFrames(view, frameOffset, frameCount, resampler, guard, pcm);
+    if (flush) {
+        n += resampler.flush(pcm + n * ch);
+    }
+
+    /* In place on the converted frames, at the output rate */
+    const PcmView converted { reinterpret_cast<const uint8_t*>(pcm), reinterpret_cast<uint8_t*>(pcm),
+                              AUDIO_FORMAT_FLOAT32, ch, static_cast<uint32_t>(n) };
+    if (live) {
+        processFramesLive(converted, 0, converted.frames, false, *live, meter);
+    } else {
+        processFrames(converted, 0, converted.frames, gain, bypass, false, chain, parallel, meter);
+    }
+
+    if (!direct) {
+        storeFrames(pcm, n, ch, view.format, view.output, outputFrames, outputOffset, dither,
+                    ditherFrame);
+        BufferPool::instance().release(pcm);
+    }
+    return static_cast<uint32_t>(n);
 }
 
 } // namespace DspProcessor
@@ -1,16 +1,61 @@
 /**
  * dsp_processor.h — DSP processing engine declarations
  *
- * All operations work on float32 interleaved PCM samples.
+ * processAudio / processBuffer work on float32 interleaved PCM samples;
+ * processFrames reads and writes any AUDIO_FORMAT_* layout directly.
  */
 
 #pragma once
 
+#include <atomic>
+#include <cstddef>
 #include <cstdint>
 #include <vector>
 
 namespace DspProcessor {
 
+class LevelMeter;
+class LiveControl;
+class LoudnessMeter;
+class ProcessingChain;
+class Resampler;
+
+/**
+ * Levels to measure while processing (see dsp_meter.h). Metering runs in
+ * the processing pass itself: the gain + soft-clip path uses the fused
+ * metering kernels, chains and live control meter each L1 block before
+ * and after the stage.
+ */
+struct FrameMeter {
+    /** begun for the view's channel count; nullptr / inactive = no metering */
+    LevelMeter*    levels   = nullptr;
+    /** configured for the stream, or nullptr; makes the call run serially */
+    LoudnessMeter* loudness = nullptr;
+};
+
+/**
+ * Non-finite input guard (AUDIO_FLAG_GUARD). NaN / ±Inf samples of float
+ * input are read as 0 by the first pass over them, even in bypass: the
+ * guard soft-clip kernel on the gain + soft-clip path, the sanitize kernel
+ * one L1 block ahead of a chain, live control, metering or the resampler.
+ * Integer formats cannot hold such values and are not scanned. Parallel
+ * chunks add to the same counter.
+ *
+ * Flushing subnormals is up to the caller (DenormalScope, dsp_denormals.h).
+ */
+struct FrameGuard {
+    std::atomic<uint64_t> nonFinite { 0 };
+
+    void add(size_t count)
+    {
+        if (count != 0) {
+            nonFinite.fetch_add(count, std::memory_order_relaxed);
+        }
+    }
+
+    uint64_t count() const { return nonFinite.load(std::memory_order_relaxed); }
+};
+
 /** Result returned by processAudio() */
 struct ProcessResult {
     /** Output PCM as raw bytes (float32 interleaved) */
@@ -31,4 +76,127 @@ struct ProcessResult {
 ProcessResult processAudio(const void* inputPcm, int numSamples,
                            float gain, bool bypass);
 
+/**
+ * Process float32 interleaved PCM from src into a caller-owned dst.
+ * No allocation; src and dst may be the same pointer (in-place).
+ *
+ * @param src        input samples
+ * @param dst        output samples (numSamples floats)
+ * @param numSamples total sample count (frames × channels)
+ * @param gain       linear gain applied before soft-clipping (ignored when bypass=true)
+ * @param bypass     when true, dst receives a verbatim copy of src
+ */
+void processBuffer(const float* src, float* dst, size_t numSamples,
+                   float gain, bool bypass);
+
+/**
+ * processBuffer() / processBufferParallel() with timing, for callers that
+ * own the output memory (caller-provided or pooled ArrayBuffers).
+ *
+ * @param parallel  split large buffers over the WorkerPool
+ * @return wall-clock processing duration in nanoseconds
+ */
+int64_t processAudioInto(const float* src, float* dst, size_t numSamples,
+                         float gain, bool bypass, bool parallel);
+
+/**
+ * processAudioInto() with metering: numSamples holds whole frames of
+ * meter.levels->channels() interleaved channels (otherwise the call is
+ * not metered).
+ */
+int64_t processAudioInto(const float* src, float* dst, size_t numSamples,
+                         float gain, bool bypass, bool parallel, const FrameMeter& meter);
+
+/** Samples per parallel chunk (64 KiB of float32, a multiple of every SIMD width) */
+constexpr size_t kParallelChunkSamples = 16384;
+
+/**
+ * processBuffer() split into cache-sized chunks and run on the WorkerPool.
+ * Bit-exact with processBuffer(); buffers shorter than two chunks are
+ * processed on the calling thread.
+ */
+void processBufferParallel(const float* src, float* dst, size_t numSamples,
+                           float gain, bool bypass);
+
+/** A PCM region pair in one of the AUDIO_FORMAT_* layouts */
+struct PcmView {
+    const uint8_t* input;     /* first byte of the input region              */
+    uint8_t*       output;    /* first byte of the output region (may alias) */
+    uint32_t       format;    /* AUDIO_FORMAT_*, same for input and output   */
+    uint32_t       channels;
+    uint32_t       frames;    /* frames in the region (= plane length)       */
+};
+
+/**
+ * Process frames [frameOffset, frameOffset + frameCount) of a view, reading
+ * and writing its format directly. Integer formats are decoded, processed
+ * and re-encoded one L1-sized block at a time, never as whole-buffer
+ * passes. With a chain, the chain replaces gain / bypass.
+ *
+ * Results do not depend on the thread count: dither is reseeded at every
+ * kParallelChunkSamples boundary of the range, from the stream position.
+ *
+ * @param dither    TPDF-dither integer output (AUDIO_FLAG_DITHER)
+ * @param chain     configured chain for view.channels, or nullptr
+ * @param parallel  use the WorkerPool for large ranges
+ * @param meter     levels / loudness to accumulate the range into; the
+ *                  output is the same with or without metering
+ * @param guard     replace and count non-finite input, or nullptr
+ * @param ditherFrame  position of frame frameOffset in the stream, which
+ *                  seeds the dither; a caller processing one stream over
+ *                  several calls (a session) passes the frames done so
+ *                  far, so no two calls repeat the same dither sequence
+ */
+void processFrames(const PcmView& view, uint32_t frameOffset, uint32_t frameCount,
+                   float gain, bool bypass, bool dither, ProcessingChain* chain,
+                   bool parallel, const FrameMeter& meter = FrameMeter(),
+                   FrameGuard* guard = nullptr, uint64_t ditherFrame = 0);
+
+/**
+ * processFrames() with gain / bypass taken from a live control block:
+ * the block is polled every LiveControl::kBlockFrames frames and changes
+ * are ramped in per sample (see dsp_live_control.h). Runs serially, since
+ * each block depends on when the host changed the parameters.
+ *
+ * @param live  attached to the region's control block; keeps the smoothing
+ *              state, so reuse it across calls on the same stream
+ * @param meter levels / loudness, as for processFrames()
+ * @param guard non-finite input guard, as for processFrames()
+ * @param ditherFrame  as for processFrames()
+ */
+void processFramesLive(const PcmView& view, uint32_t frameOffset, uint32_t frameCount,
+                       bool dither, LiveControl& live, const FrameMeter& meter = FrameMeter(),
+                       FrameGuard* guard = nullptr, uint64_t ditherFrame = 0);
+
+/**
+ * Sample-rate converted processFrames(): input frames [frameOffset,
+ * frameOffset + frameCount) go through @p resampler first, then gain /
+ * chain / live control and metering run on the converted float32 frames
+ * (so input levels are those of the converted signal), which are finally
+ * stored in the view's format at @p outputOffset of the output region.
+ * With view.format FLOAT32 the conversion writes straight into the output
+ * region; other formats go through one pooled float buffer.
+ *
+ * @param outputFrames  frames in the output region (its plane length);
+ *                      view.frames is the input's
+ * @param outputOffset  first output frame; the caller makes sure the
+ *                      resampler.outputFramesFor(frameCount, flush)
+ *                      frames fit from there
+ * @param flush         end the stream (Resampler::flush()) after the input
+ * @param live          gain / bypass from a live control block, or nullptr
+ * @param guard         non-finite input guard; applied before the
+ *                      converter, whose history would otherwise keep a NaN
+ *                      for the rest of the stream
+ * @param ditherFrame   stream position of the first output frame, as for
+ *                      processFrames()
+ * @return frames written, or 0 with the input unconsumed when no scratch
+ *         buffer could be had
+ */
+uint32_t processFramesResampled(const PcmView& view, uint32_t outputFrames, uint32_t frameOffset,
+                                uint32_t frameCount, uint32_t outputOffset, bool flush,
+                                Resampler& resampler, float gain, bool bypass, bool dither,
+                                ProcessingChain* chain, LiveControl* live, bool parallel,
+                                const FrameMeter& meter = FrameMeter(), FrameGuard* guard = nullptr,
+                                uint64_t ditherFrame = 0);
+
 } // namespace DspProcessor
@@ -0,0 +1,510 @@
+/**
+ * dsp_resampler.cpp — streaming polyphase sample-rate converter
+ *
+ * Output j is at input position t = j·M / L = n + p / L. With K taps per
+ * phase its value is
+ *
+ *   y[j] = Σ_{k<K} row_p[k] · x[n − K/2 + 1 + k]
+ *   row_p[k] = g(p / L + K/2 − 1 − k)
+ *
+ * where g(τ) = fc · sinc(fc·τ) · kaiser(τ / (K/2)) is the low-pass in
+ * input-frame units, fc its cutoff relative to the input Nyquist. Each row
+ * is normalised to unit DC gain. When downsampling, fc shrinks by L / M
+ * and K grows by M / L so the transition band keeps its width at the
+ * output rate.
+ */
+
+#include "dsp_resampler.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <mutex>
+#include <tuple>
+#include <vector>
+
+#if defined(__aarch64__)
+#include <arm_neon.h>
+#define DSP_HAVE_NEON 1
+#elif defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define DSP_HAVE_X86 1
+#endif
+
+namespace DspProcessor {
+
+struct ResamplerTable {
+    uint32_t L;
+    uint32_t M;
+    uint32_t taps;            /* per row, a multiple of 8 */
+    uint32_t rows;            /* L, or kInterpolatedPhases + 1 */
+    bool     interpolated;
+    std::vector<float> coefs; /* rows × taps */
+};
+
+namespace {
+
+/* ------------------------------------------------------------------ */
+/*  Quality presets                                                     */
+/* ------------------------------------------------------------------ */
+struct QualityPreset {
+    uint32_t taps;            /* at the lower of the two rates */
+    double   attenuationDb;   /* stop band */
+};
+
+constexpr QualityPreset kPresets[] = {
+    { 16,  60.0 },   /* AUDIO_SRC_QUALITY_LOW    */
+    { 48,  90.0 },   /* AUDIO_SRC_QUALITY_MEDIUM */
+    { 128, 120.0 },  /* AUDIO_SRC_QUALITY_HIGH   */
+};
+
+const QualityPreset* presetFor(uint32_t quality)
+{
+    switch (quality) {
+        case AUDIO_SRC_QUALITY_LOW:
+            return &kPresets[0];
+        case 0:
+        case AUDIO_SRC_QUALITY_MEDIUM:
+            return &kPresets[1];
+        case AUDIO_SRC_QUALITY_HIGH:
+            return &kPresets[2];
+        default:
+            return nullptr;
+    }
+}
+
+/* ------------------------------------------------------------------ */
+/*  Filter design                                                       */
+/* ------------------------------------------------------------------ */
+double besselI0(double x)
+{
+    /* Σ ((x/2)^k / k!)², converges fast for the β used here (< 13) */
+    double sum = 1.0;
+    double term = 1.0;
+    const double q = 0.25 * x * x;
+    for (int k = 1; k < 64 && term > sum * 1e-17; ++k) {
+        term *= q / (static_cast<double>(k) * k);
+        sum += term;
+    }
+    return sum;
+}
+
+std::shared_ptr<const ResamplerTable> buildTable(uint32_t L, uint32_t M, const QualityPreset& preset)
+{
+    auto table = std::make_shared<ResamplerTable>();
+    table->L = L;
+    table->M = M;
+    const double down = M > L ? static_cast<double>(M) / L : 1.0;
+    /* Same rounding as audioSrcHoldFrames(), which bounds latencyFrames() */
+    const uint64_t stretched = M > L ? (static_cast<uint64_t>(preset.taps) * M + L - 1) / L : preset.taps;
+    const uint32_t taps = static_cast<uint32_t>((stretched + 7u) & ~uint64_t(7));
+    table->taps = taps;
+    table->interpolated = L > Resampler::kMaxExactPhases;
+    table->rows = table->interpolated ? Resampler::kInterpolatedPhases + 1 : L;
+
+    /* Kaiser: β from the attenuation, transition width (in units of the
+       lower Nyquist) from β and the length; the stop band starts at the
+       lower Nyquist */
+    const double a = preset.attenuationDb;
+    const double beta = 0.1102 * (a - 8.7);
+    const double transition = 2.0 * (a - 7.95) / (14.36 * preset.taps);
+    const double fc = (1.0 - 0.5 * transition) / down;
+    const double halfLength = 0.5 * taps;
+    const double i0Beta = besselI0(beta);
+    const double pi = 3.14159265358979323846;
+
+    table->coefs.resize(static_cast<size_t>(table->rows) * taps);
+    std::vector<double> row(taps);
+    for (uint32_t r = 0; r < table->rows; ++r) {
+        const double frac = table->interpolated ? static_cast<double>(r) / Resampler::kInterpolatedPhases
+                                                : static_cast<double>(r) / L;
+        double sum = 0.0;
+        for (uint32_t k = 0; k < taps; ++k) {
+            const double tau = frac + halfLength - 1.0 - k;
+            const double u = tau / halfLength;
+            const double window = std::fabs(u) < 1.0 ? besselI0(beta * std::sqrt(1.0 - u * u)) / i0Beta : 0.0;
+            const double arg = pi * fc * tau;
+            const double sinc = std::fabs(arg) < 1e-12 ? 1.0 : std::sin(arg) / arg;
+            row[k] = fc * sinc * window;
+            sum += row[k];
+        }
+        float* dst = table->coefs.data() + static_cast<size_t>(r) * taps;
+        for (uint32_t k = 0; k < taps; ++k) {
+            dst[k] = static_cast<float>(row[k] / sum);
+        }
+    }
+    return table;
+}
+
+/* ------------------------------------------------------------------ */
+/*  Table cache, keyed by the reduced ratio and quality                 */
+/* ------------------------------------------------------------------ */
+constexpr size_t kMaxCachedTables = 16;
+
+std::mutex g_tablesLock;
+std::map<std::tuple<uint32_t, uint32_t, const QualityPreset*>, std::shared_ptr<const ResamplerTable>> g_tables;
+
+std::shared_ptr<const ResamplerTable> acquireTable(uint32_t L, uint32_t M, const QualityPreset& preset)
+{
+    const auto key = std::make_tuple(L, M, &preset);
+    {
+        std::lock_guard<std::mutex> lock(g_tablesLock);
+        auto it = g_tables.find(key);
+        if (it != g_tables.end()) {
+            return it->second;
+        }
+    }
+
+    /* Built outside the lock; a concurrent first use of the same ratio
+       may build it twice, the first one stored wins */
+    std::shared_ptr<const ResamplerTable> table = buildTable(L, M, preset);
+    std::lock_guard<std::mutex> lock(g_tablesLock);
+    auto it = g_tables.find(key);
+    if (it != g_tables.end()) {
+        return it->second;
+    }
+    if (g_tables.size() >= kMaxCachedTables) {
+        /* Make room by dropping tables no converter holds */
+        for (auto e = g_tables.begin(); e != g_tables.end();) {
+            e = e->second.use_count() == 1 ? g_tables.erase(e) : std::next(e);
+        }
+    }
+    if (g_tables.size() < kMaxCachedTables) {
+        g_tables.emplace(key, table);
+    }
+    return table;
+}
+
+uint32_t gcd(uint32_t a, uint32_t b)
+{
+    while (b != 0) {
+        const uint32_t t = a % b;
+        a = b;
+        b = t;
+    }
+    return a;
+}
+
+/* ------------------------------------------------------------------ */
+/*  Inner products, n a multiple of 8                                   */
+/* ------------------------------------------------------------------ */
+float dotScalar(const float* h, const float* x, uint32_t n)
+{
+    float a0 = 0.0f, a1 = 0.0f, a2 = 0.0f, a3 = 0.0f;
+    for (uint32_t k = 0; k < n; k += 4) {
+        a0 += h[k] * x[k];
+        a1 += h[k + 1] * x[k + 1];
+        a2 += h[k + 2] * x[k + 2];
+        a3 += h[k + 3] * x[k + 3];
+    }
+    return (a0 + a1) + (a2 + a3);
+}
+
+#if defined(DSP_HAVE_NEON)
+float dotNeon(const float* h, const float* x, uint32_t n)
+{
+    float32x4_t a0 = vdupq_n_f32(0.0f);
+    float32x4_t a1 = vdupq_n_f32(0.0f);
+    for (uint32_t k = 0; k < n; k += 8) {
+        a0 = vfmaq_f32(a0, vld1q_f32(h + k), vld1q_f32(x + k));
+        a1 = vfmaq_f32(a1, vld1q_f32(h + k + 4), vld1q_f32(x + k + 4));
+    }
+    return vaddvq_f32(vaddq_f32(a0, a1));
+}
+#endif // DSP_HAVE_NEON
+
+#if defined(DSP_HAVE_X86)
+__attribute__((target("sse2")))
+float dotSse2(const float* h, const float* x, uint32_t n)
+{
+    __m128 a0 = _mm_setzero_ps();
+    __m128 a1 = _mm_setzero_ps();
+    for (uint32_t k = 0; k < n; k += 8) {
+        a0 = _mm_add_ps(a0, _mm_mul_ps(_mm_loadu_ps(h + k), _mm_loadu_ps(x + k)));
+        a1 = _mm_add_ps(a1, _mm_mul_ps(_mm_loadu_ps(h + k + 4), _mm_loadu_ps(x + k + 4)));
+    }
+    __m128 s = _mm_add_ps(a0, a1);
+    s = _mm_add_ps(s, _mm_movehl_ps(s, s));
+    s = _mm_add_ss(s, _mm_shuffle_ps(s, s, 1));
+    return _mm_cvtss_f32(s);
+}
+
+__attribute__((target("avx2,fma")))
+float dotAvx2(const float* h, const float* x, uint32_t n)
+{
+    __m256 a0 = _mm256_setzero_ps();
+    __m256 a1 = _mm256_setzero_ps();
+    uint32_t k = 0;
+    for (; k + 16 <= n; k += 16) {
+        a0 = _mm256_fmadd_ps(_mm256_loadu_ps(h + k), _mm256_loadu_ps(x + k), a0);
+        a1 = _mm256_fmadd_ps(_mm256_loadu_ps(h + k + 8), _mm256_loadu_ps(x + k + 8), a1);
+    }
+    if (k < n) {
+        a0 = _mm256_fmadd_ps(_mm256_loadu_ps(h + k), _mm256_loadu_ps(x + k), a0);
+    }
+    const __m256 s8 = _mm256_add_ps(a0, a1);
+    __m128 s = _mm_add_ps(_mm256_castps256_ps128(s8), _mm256_extractf128_ps(s8, 1));
+    s = _mm_add_ps(s, _mm_movehl_ps(s, s));
+    s = _mm_add_ss(s, _mm_shuffle_ps(s, s, 1));
+    return _mm_cvtss_f32(s);
+}
+#endif // DSP_HAVE_X86
+
+using DotFn = float (*)(const float*, const float*, uint32_t);
+
+DotFn dotKernelFor(KernelIsa isa)
+{
+    switch (isa) {
+#if defined(DSP_HAVE_NEON)
+        case KernelIsa::Neon:
+            return dotNeon;
+#endif
+#if defined(DSP_HAVE_X86)
+        case KernelIsa::Avx2:
+            return dotAvx2;
+        case KernelIsa::Sse2:
+            return dotSse2;
+#endif
+        default:
+            return dotScalar;
+    }
+}
+
+} // namespace
+
+/* ------------------------------------------------------------------ */
+/*  Resampler                                                           */
+/* ------------------------------------------------------------------ */
+Resampler::~Resampler()
+{
+    release();
+}
+
+void Resampler::release()
+{
+    std::free(history_);
+    history_    = nullptr;
+    row_        = nullptr;
+    table_.reset();
+    capacity_   = 0;
+    inputRate_  = 0;
+    outputRate_ = 0;
+    channels_   = 0;
+    half_       = 0;
+}
+
+uint32_t Resampler::taps() const
+{
+    return table_ ? table_->taps : 0;
+}
+
+uint32_t Resampler::phases() const
+{
+    return table_ ? table_->rows : 0;
+}
+
+bool Resampler::interpolated() const
+{
+    return table_ && table_->interpolated;
+}
+
+void Resampler::trimTableCache()
+{
+    std::lock_guard<std::mutex> lock(g_tablesLock);
+    for (auto e = g_tables.begin(); e != g_tables.end();) {
+        e = e->second.use_count() == 1 ? g_tables.erase(e) : std::next(e);
+    }
+}
+
+bool Resampler::configure(uint32_t inputRate, uint32_t outputRate, uint32_t channels, uint32_t quality)
+{
+    release();
+    const QualityPreset* preset = presetFor(quality);
+    if (!preset || channels == 0 || channels > kMaxChannels
+        || inputRate < kMinRate || inputRate > kMaxRate
+        || outputRate < kMinRate || outputRate > kMaxRate || inputRate == outputRate) {
+        return false;
+    }
+    const uint32_t g = gcd(inputRate, outputRate);
+    std::shared_ptr<const ResamplerTable> table = acquireTable(outputRate / g, inputRate / g, *preset);
+
+    /* History planes, then one row of blended taps */
+    const uint32_t capacity = table->taps + kHistoryFrames;
+    const size_t floats = static_cast<size_t>(channels) * capacity + table->taps;
+    void* raw = nullptr;
+    if (posix_memalign(&raw, 64, floats * sizeof(float)) != 0) {
+        return false;
+    }
+    table_      = std::move(table);
+    history_    = static_cast<float*>(raw);
+    row_        = history_ + static_cast<size_t>(channels) * capacity;
+    capacity_   = capacity;
+    inputRate_  = inputRate;
+    outputRate_ = outputRate;
+    channels_   = channels;
+    half_       = table_->taps / 2;
+    dot_        = dotKernelFor(activeKernelIsa());
+    reset();
+    return true;
+}
+
+void Resampler::reset()
+{
+    if (!table_) {
+        return;
+    }
+    /* Silence before the stream: the first window starts K/2 − 1 frames early */
+    historyFrames_ = half_ - 1;
+    historyStart_  = -static_cast<int64_t>(historyFrames_);
+    for (uint32_t c = 0; c < channels_; ++c) {
+        std::memset(history_ + static_cast<size_t>(c) * capacity_, 0, historyFrames_ * sizeof(float));
+    }
+    base_     = 0;
+    phase_    = 0;
+    consumed_ = 0;
+    produced_ = 0;
+}
+
+size_t Resampler::outputFramesFor(size_t inputFrames, bool flushing) const
+{
+    if (!table_) {
+        return 0;
+    }
+    /* Outputs j with j·M / L < consumed + n − K/2, i.e. whose last tap is
+       in; flushing: every j with j·M / L < consumed + n */
+    const int64_t reach = static_cast<int64_t>(consumed_ + inputFrames) - (flushing ? 0 : half_);
+    if (reach <= 0) {
+        return 0;
+    }
+    const uint64_t total = (static_cast<uint64_t>(reach) * table_->L + table_->M - 1) / table_->M;
+    return static_cast<size_t>(total - produced_);
+}
+
+size_t Resampler::flushFrames() const
+{
+    if (!table_) {
+        return 0;
+    }
+    const uint64_t total = (consumed_ * table_->L + table_->M - 1) / table_->M;
+    return static_cast<size_t>(total - produced_);
+}
+
+void Resampler::append(const float* in, size_t frames)
+{
+    const uint32_t ch = channels_;
+    for (uint32_t c = 0; c < ch; ++c) {
+        float* dst = history_ + static_cast<size_t>(c) * capacity_ + historyFrames_;
+        const float* src = in + c;
+        for (size_t i = 0; i < frames; ++i) {
+            dst[i] = src[i * ch];
+        }
+    }
+    historyFrames_ += static_cast<uint32_t>(frames);
+}
+
+void Resampler::appendSilence(size_t frames)
+{
+    for (uint32_t c = 0; c < channels_; ++c) {
+        std::memset(history_ + static_cast<size_t>(c) * capacity_ + historyFrames_, 0,
+                    frames * sizeof(float));
+    }
+    historyFrames_ += static_cast<uint32_t>(frames);
+}
+
+/* Drop history before the next output's first tap */
+void Resampler::compact()
+{
+    const int64_t first = base_ - half_ + 1;
+    const uint32_t drop = static_cast<uint32_t>(
+        std::min<int64_t>(std::max<int64_t>(first - historyStart_, 0), historyFrames_));
+    if (drop == 0) {
+        return;
+    }
+    const uint32_t keep = historyFrames_ - drop;
+    for (uint32_t c = 0; c < channels_; ++c) {
+        float* plane = history_ + static_cast<size_t>(c) * capacity_;
+        std::memmove(plane, plane + drop, keep * sizeof(float));
+    }
+    historyStart_ += drop;
+    historyFrames_ = keep;
+}
+
+/* Every output whose taps are in the history (flushing: every output
+   before the end of the stream, the history padded with silence) */
+size_t Resampler::run(float* out, bool flushing)
+{
+    const ResamplerTable& t = *table_;
+    const uint32_t ch = channels_;
+    const uint32_t taps = t.taps;
+    const uint64_t end = flushing ? (consumed_ * t.L + t.M - 1) / t.M : 0;
+    const float phaseScale = static_cast<float>(kInterpolatedPhases) / static_cast<float>(t.L);
+    size_t n = 0;
+
+    for (;;) {
+        if (flushing ? produced_ >= end
+                     : base_ + static_cast<int64_t>(half_) >= static_cast<int64_t>(consumed_)) {
+            break;
+        }
+        const float* row;
+        if (t.interpolated) {
+            /* Blend the two rows around p / L */
+            const float pos = static_cast<float>(phase_) * phaseScale;
+            const uint32_t r = std::min(static_cast<uint32_t>(pos), kInterpolatedPhases - 1);
+            const float alpha = pos - static_cast<float>(r);
+            const float* r0 = t.coefs.data() + static_cast<size_t>(r) * taps;
+            const float* r1 = r0 + taps;
+            for (uint32_t k = 0; k < taps; ++k) {
+                row_[k] = r0[k] + alpha * (r1[k] - r0[k]);
+            }
+            row = row_;
+        } else {
+            row = t.coefs.data() + static_cast<size_t>(phase_) * taps;
+        }
+
+        const size_t first = static_cast<size_t>(base_ - half_ + 1 - historyStart_);
+        for (uint32_t c = 0; c < ch; ++c) {
+            out[n * ch + c] = dot_(row, history_ + static_cast<size_t>(c) * capacity_ + first, taps);
+        }
+        ++n;
+        ++produced_;
+        phase_ += t.M;
+        base_  += phase_ / t.L;
+        phase_ %= t.L;
+    }
+    return n;
+}
+
+size_t Resampler::process(const float* in, size_t inputFrames, float* out)
+{
+    if (!table_ || !in || !out) {
+        return 0;
+    }
+    size_t n = 0;
+    while (inputFrames > 0) {
+        const size_t take = std::min<size_t>(capacity_ - historyFrames_, inputFrames);
+        append(in, take);
+        consumed_ += take;
+        in += take * channels_;
+        inputFrames -= take;
+        n += run(out + n * channels_, false);
+        compact();
+    }
+    return n;
+}
+
+size_t Resampler::flush(float* out)
+{
+    if (!table_ || !out) {
+        return 0;
+    }
+    /* The last output's window ends K/2 frames past the stream; after
+       compact() the history holds at most K frames, so this fits */
+    appendSilence(half_);
+    const size_t n = run(out, true);
+    reset();
+    return n;
+}
+
+} // namespace DspProcessor
@@ -0,0 +1,141 @@
+/**
+ * dsp_resampler.h — streaming polyphase sample-rate converter
+ *
+ * A Resampler converts interleaved float32 PCM from one rate to another
+ * through a windowed-sinc (Kaiser) low-pass evaluated in polyphase form.
+ * The rate ratio is reduced to L / M (44100 → 48000 is 160 / 147); every
+ * output frame j sits at input position j·M / L, tracked exactly as an
+ * integer frame plus a phase in [0, L).
+ *
+ * Up to kMaxExactPhases the coefficient table holds one row of taps per
+ * phase and each output is a single inner product per channel. Ratios
+ * with more phases (48000 → 44099) use kInterpolatedPhases rows and blend
+ * the two rows around the exact position linearly, which keeps any ratio
+ * inside a few hundred KiB of table. Inner products run in the SIMD
+ * variant of the ISA active at configure() (see activeKernelIsa()).
+ *
+ * Tables depend only on (L, M, quality) and are immutable, so they are
+ * shared: configure() takes them from a process-wide cache and computes
+ * a table only the first time a ratio is used.
+ *
+ * Output is time-aligned with the input (no leading filter delay): the
+ * first output frame is input frame 0 filtered. That needs latencyFrames()
+ * frames of look-ahead, so process() holds back the outputs whose taps
+ * reach past the input received so far; flush() produces them from zero
+ * padding at the end of the stream. A stream of n frames yields exactly
+ * ceil(n · L / M) frames in total, however it is split into calls.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+#include "AudioSharedBuffer.h"
+#include "dsp_channel_kernels.h"
+#include "dsp_kernels.h"
+
+namespace DspProcessor {
+
+struct ResamplerTable;
+
+class Resampler {
+public:
+    static constexpr uint32_t kMaxChannels        = kStageMaxChannels;
+    static constexpr uint32_t kMinRate            = AUDIO_SRC_MIN_RATE;
+    static constexpr uint32_t kMaxRate            = AUDIO_SRC_MAX_RATE;
+    /* Ratios with up to this many phases get one table row per phase */
+    static constexpr uint32_t kMaxExactPhases     = 512;
+    static constexpr uint32_t kInterpolatedPhases = 256;
+    /* Input frames buffered per channel on top of the filter length */
+    static constexpr uint32_t kHistoryFrames      = 4096;
+
+    Resampler() = default;
+    ~Resampler();
+
+    Resampler(const Resampler&) = delete;
+    Resampler& operator=(const Resampler&) = delete;
+
+    /**
+     * Set up a conversion and reset the stream.
+     * @param quality  AUDIO_SRC_QUALITY_* (0 = AUDIO_SRC_QUALITY_MEDIUM)
+     * @return false for rates outside [kMinRate, kMaxRate], equal rates,
+     *         an unknown quality or bad channel count; the converter is
+     *         then unconfigured
+     */
+    bool configure(uint32_t inputRate, uint32_t outputRate, uint32_t channels, uint32_t quality);
+
+    /** Start a new stream (the table is kept). */
+    void reset();
+
+    /**
+     * Frames the next process() of @p inputFrames frames will produce,
+     * exactly; with @p flushing, plus those of the flush() after it. A
+     * stream never holds back more than audioSrcHoldFrames() input frames.
+     */
+    size_t outputFramesFor(size_t inputFrames, bool flushing = false) const;
+
+    /** Frames flush() will produce. */
+    size_t flushFrames() const;
+
+    /**
+     * Convert @p inputFrames interleaved frames. Every input frame is
+     * consumed; outputs whose taps reach past it wait for the next call.
+     * @param out  room for outputFramesFor(inputFrames) frames; must not
+     *             overlap @p in
+     * @return frames written to @p out
+     */
+    size_t process(const float* in, size_t inputFrames, float* out);
+
+    /**
+     * End the stream: write the outputs still held back, as if it went on
+     * with silence, and reset().
+     * @param out  room for flushFrames() frames
+     * @return frames written
+     */
+    size_t flush(float* out);
+
+    /** Drop the cached tables no converter uses (memory pressure, benchmarks). */
+    static void trimTableCache();
+
+    bool configured() const { return table_ != nullptr; }
+    uint32_t inputRate() const { return inputRate_; }
+    uint32_t outputRate() const { return outputRate_; }
+    uint32_t channels() const { return channels_; }
+    /** Input frames of look-ahead an output needs (half the filter). */
+    uint32_t latencyFrames() const { return half_; }
+    /** Taps per phase (filter length in input frames). */
+    uint32_t taps() const;
+    /** Table rows; kInterpolatedPhases + 1 when rows are blended. */
+    uint32_t phases() const;
+    bool interpolated() const;
+
+private:
+    using DotKernel = float (*)(const float* h, const float* x, uint32_t n);
+
+    void release();
+    void append(const float* in, size_t frames);
+    void appendSilence(size_t frames);
+    size_t run(float* out, bool flushing);
+    void compact();
+
+    std::shared_ptr<const ResamplerTable> table_;
+    DotKernel dot_         = nullptr;
+    float*    history_     = nullptr;   /* channels planes of capacity_ frames */
+    float*    row_         = nullptr;   /* blended taps of interpolated tables */
+    uint32_t  capacity_    = 0;
+    uint32_t  inputRate_   = 0;
+    uint32_t  outputRate_  = 0;
+    uint32_t  channels_    = 0;
+    uint32_t  half_        = 0;
+    /* Stream position: the next output is at input frame base_ + phase_ / L */
+    int64_t   historyStart_ = 0;        /* input frame of history_[0]          */
+    uint32_t  historyFrames_ = 0;
+    int64_t   base_        = 0;
+    uint32_t  phase_       = 0;
+    uint64_t  consumed_    = 0;         /* input frames received               */
+    uint64_t  produced_    = 0;         /* output frames written               */
+};
+
+} // namespace DspProcessor
@@ -0,0 +1,349 @@
+/**
+ * dsp_scheduler.cpp — fair, deadline-ordered scheduling of client requests
+ */
+
+#include "dsp_scheduler.h"
+#include "dsp_denormals.h"
+#include "AudioSharedBuffer.h"
+#include "AudioTrace.h"
+
+#include <algorithm>
+#include <sched.h>
+
+namespace DspProcessor {
+
+namespace {
+
+/* Cores this process may run on, in ascending order */
+std::vector<int> allowedCpus()
+{
+    std::vector<int> cpus;
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    if (sched_getaffinity(0, sizeof(set), &set) == 0) {
+        for (int c = 0; c < CPU_SETSIZE; ++c) {
+            if (CPU_ISSET(c, &set)) {
+                cpus.push_back(c);
+            }
+        }
+    }
+    return cpus;
+}
+
+/* Pin the calling thread (Linux: pid 0 = this thread) to one core */
+void pinCurrentThread(int cpu)
+{
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    sched_setaffinity(0, sizeof(set), &set);   /* best effort */
+}
+
+/* The scheduler whose worker this thread is, if any */
+thread_local Scheduler* t_worker = nullptr;
+/* Inside a fan-out task: a nested parallelFor runs inline */
+thread_local bool t_inFanout = false;
+
+} // namespace
+
+Scheduler& Scheduler::instance()
+{
+    static Scheduler scheduler;
+    return scheduler;
+}
+
+Scheduler::Scheduler()
+{
+    startWorkers();
+}
+
+Scheduler::~Scheduler()
+{
+    stopWorkers();
+}
+
+void Scheduler::configure(const SchedulerConfig& config)
+{
+    std::lock_guard<std::mutex> guard(configLock_);
+    stopWorkers();
+    {
+        std::lock_guard<std::mutex> lock(lock_);
+        config_ = config;
+        config_.maxQueuedPerClient   = std::max(config_.maxQueuedPerClient, 1u);
+        config_.maxQueuedTotal       = std::max(config_.maxQueuedTotal, 1u);
+        config_.maxInFlightPerClient = std::max(config_.maxInFlightPerClient, 1u);
+    }
+    startWorkers();
+}
+
+SchedulerConfig Scheduler::config() const
+{
+    std::lock_guard<std::mutex> lock(lock_);
+    return config_;
+}
+
+void Scheduler::startWorkers()
+{
+    const std::vector<int> cpus = allowedCpus();
+    unsigned count = config_.workers;
+    if (count == 0) {
+        count = !cpus.empty() ? static_cast<unsigned>(cpus.size()) : std::thread::hardware_concurrency();
+    }
+    count = std::max(count, 1u);
+    {
+        std::lock_guard<std::mutex> lock(lock_);
+        stop_ = false;
+        workerCount_ = count;
+    }
+
+    workers_.reserve(count);
+    for (unsigned i = 0; i < count; ++i) {
+        const int cpu = config_.pinWorkers && !cpus.empty() ? cpus[i % cpus.size()] : -1;
+        workers_.emplace_back([this, i, cpu] {
+            if (cpu >= 0) {
+                pinCurrentThread(cpu);
+            }
+            t_worker = this;
+            workerLoop(i);
+        });
+    }
+}
+
+void Scheduler::stopWorkers()
+{
+    {
+        std::lock_guard<std::mutex> lock(lock_);
+        stop_ = true;
+    }
+    wake_.notify_all();
+    for (auto& t : workers_) {
+        t.join();
+    }
+    workers_.clear();
+}
+
+int32_t Scheduler::submit(ScheduledJob* job, const JobParams& params)
+{
+    if (!job) {
+        return AUDIO_STATUS_ERROR;
+    }
+    const int64_t now = AudioTrace::nowNs();
+
+    {
+        std::lock_guard<std::mutex> lock(lock_);
+        Client& c = clients_[params.client];
+        c.stats.client = params.client;
+        if (c.queue.size() >= queueLimitLocked(params.client) || queued_ >= config_.maxQueuedTotal) {
+            ++c.stats.rejected;
+            return AUDIO_STATUS_BUSY;
+        }
+
+        job->arrivalNs = params.arrivalNs != 0 ? params.arrivalNs : now;
+        const int64_t budgetNs = params.deadlineNs != 0
+            ? std::max<int64_t>(params.deadlineNs - job->arrivalNs, 0)
+            : (params.jobClass == JobClass::Batch ? config_.batchBudgetNs : config_.interactiveBudgetNs);
+        /* A backlog is due one budget after the other: the n-th block of a
+           burst is not needed before n block times, so a bursting client's
+           later requests do not get ahead of another client's first one */
+        job->deadlineNs = std::max(job->arrivalNs, c.lastDeadlineNs) + budgetNs;
+        c.lastDeadlineNs = job->deadlineNs;
+        job->startNs = job->endNs = 0;
+
+        c.queue.push_back(Entry { job, params.jobClass, nextSeq_++ });
+        ++c.stats.queued;
+        ++c.stats.submitted;
+        ++queued_;
+    }
+    wake_.notify_one();
+    return AUDIO_STATUS_PROCESSING;
+}
+
+uint32_t Scheduler::queueLimitLocked(uint64_t client) const
+{
+    if (client != kLocalClient) {
+        return config_.maxQueuedPerClient;
+    }
+    return config_.maxQueuedLocal != 0 ? config_.maxQueuedLocal : config_.maxQueuedTotal;
+}
+
+uint32_t Scheduler::inFlightLimitLocked(uint64_t client) const
+{
+    if (client != kLocalClient) {
+        return config_.maxInFlightPerClient;
+    }
+    return config_.maxInFlightLocal != 0 ? config_.maxInFlightLocal : workerCount_;
+}
+
+/* Best runnable client head: class, then deadline, then submit order. A
+   batch head that has waited batchPromoteNs competes as interactive with
+   the deadline it was promoted at. Linear in the number of clients, which
+   is the number of host apps talking to the service. */
+Scheduler::Client* Scheduler::pickLocked(int64_t now)
+{
+    Client*  best = nullptr;
+    uint32_t bestClass = 0;
+    int64_t  bestDeadline = 0;
+    uint64_t bestSeq = 0;
+    for (auto& kv : clients_) {
+        Client& c = kv.second;
+        if (c.queue.empty() || c.stats.inFlight >= inFlightLimitLocked(kv.first)) {
+            continue;
+        }
+        const Entry& e = c.queue.front();
+        uint32_t cls = static_cast<uint32_t>(e.jobClass);
+        int64_t deadline = e.job->deadlineNs;
+        const int64_t promoteAt = e.job->arrivalNs + config_.batchPromoteNs;
+        if (e.jobClass == JobClass::Batch && now >= promoteAt) {
+            cls = static_cast<uint32_t>(JobClass::Interactive);
+            deadline = std::min(deadline, promoteAt);
+        }
+        if (best && (cls != bestClass ? cls > bestClass
+                     : deadline != bestDeadline ? deadline > bestDeadline
+                     : e.seq > bestSeq)) {
+            continue;
+        }
+        best = &c;
+        bestClass = cls;
+        bestDeadline = deadline;
+        bestSeq = e.seq;
+    }
+    return best;
+}
+
+void Scheduler::workerLoop(unsigned /* index */)
+{
+    std::unique_lock<std::mutex> lock(lock_);
+    for (;;) {
+        Client* c = pickLocked(AudioTrace::nowNs());
+        if (!c) {
+            /* Nothing runnable: help a running job's parallelFor */
+            if (Fanout* f = fanoutLocked()) {
+                ++f->helpers;
+                lock.unlock();
+                {
+                    DenormalScope mode(f->flush);
+                    runFanout(*f);
+                }
+                lock.lock();
+                if (--f->helpers == 0) {
+                    helped_.notify_all();
+                }
+                continue;
+            }
+            /* Drain on stop: leave only once nothing is queued */
+            if (stop_ && queued_ == 0) {
+                return;
+            }
+            wake_.wait(lock);
+            continue;
+        }
+
+        ScheduledJob* job = c->queue.front().job;
+        c->queue.pop_front();
+        --c->stats.queued;
+        ++c->stats.inFlight;
+        --queued_;
+        ++inFlight_;
+        job->startNs = AudioTrace::nowNs();
+        lock.unlock();
+
+        job->run();
+        job->endNs = AudioTrace::nowNs();
+        const int64_t queueNs = job->startNs - job->arrivalNs;
+        const int64_t runNs = job->endNs - job->startNs;
+        const bool late = job->endNs > job->deadlineNs;
+
+        lock.lock();
+        ClientStats& st = c->stats;   /* map nodes are stable */
+        --st.inFlight;
+        --inFlight_;
+        ++st.completed;
+        st.deadlineMisses   += late ? 1 : 0;
+        st.queueTimeTotalNs += queueNs;
+        st.queueTimeMaxNs    = std::max(st.queueTimeMaxNs, queueNs);
+        st.queueTimeLastNs   = queueNs;
+        st.runTimeTotalNs   += runNs;
+        if (stop_) {
+            wake_.notify_all();   /* draining: idle workers re-check queued_ */
+        } else if (!c->queue.empty()) {
+            wake_.notify_one();   /* this client may have been held back */
+        }
+        lock.unlock();
+
+        job->finished();   /* the job may be gone from here on */
+        lock.lock();
+    }
+}
+
+Scheduler::Fanout* Scheduler::fanoutLocked() const
+{
+    for (Fanout* f : fanouts_) {
+        if (f->next.load(std::memory_order_relaxed) < f->total) {
+            return f;
+        }
+    }
+    return nullptr;
+}
+
+void Scheduler::runFanout(Fanout& fanout)
+{
+    t_inFanout = true;
+    for (;;) {
+        const size_t task = fanout.next.fetch_add(1, std::memory_order_relaxed);
+        if (task >= fanout.total) {
+            break;
+        }
+        fanout.fn(fanout.ctx, task);
+    }
+    t_inFanout = false;
+}
+
+bool Scheduler::parallelForOnWorkers(size_t taskCount, void (*fn)(void* ctx, size_t task),
+                                     void* ctx)
+{
+    Scheduler* self = t_worker;
+    if (!self) {
+        return false;
+    }
+    if (t_inFanout || taskCount < 2) {
+        for (size_t i = 0; i < taskCount; ++i) {
+            fn(ctx, i);
+        }
+        return true;
+    }
+
+    Fanout fanout;
+    fanout.fn    = fn;
+    fanout.ctx   = ctx;
+    fanout.total = taskCount;
+    fanout.flush = flushDenormalsEnabled();
+    {
+        std::lock_guard<std::mutex> lock(self->lock_);
+        self->fanouts_.push_back(&fanout);
+    }
+    self->wake_.notify_all();
+
+    self->runFanout(fanout);
+
+    /* Unlisted first, so no worker can join once the tasks are claimed */
+    std::unique_lock<std::mutex> lock(self->lock_);
+    self->fanouts_.erase(std::find(self->fanouts_.begin(), self->fanouts_.end(), &fanout));
+    self->helped_.wait(lock, [&] { return fanout.helpers == 0; });
+    return true;
+}
+
+SchedulerStats Scheduler::stats() const
+{
+    std::lock_guard<std::mutex> lock(lock_);
+    SchedulerStats s;
+    s.workers  = workerCount_;
+    s.queued   = queued_;
+    s.inFlight = inFlight_;
+    s.clients.reserve(clients_.size());
+    for (const auto& kv : clients_) {
+        s.clients.push_back(kv.second.stats);
+    }
+    return s;
+}
+
+} // namespace DspProcessor
@@ -0,0 +1,218 @@
+/**
+ * dsp_scheduler.h — fair, deadline-ordered scheduling of client requests
+ *
+ * Asynchronous requests no longer run on whichever thread delivered them.
+ * They are submitted to one process-wide Scheduler, which keeps a FIFO
+ * queue per client (the calling uid) and feeds a fixed set of workers, one
+ * pinned to each core the process may run on. A free worker takes the best
+ * client head:
+ *   - interactive requests before batch requests; a batch request that has
+ *     waited batchPromoteNs competes as interactive, so batch work is
+ *     delayed but never starved;
+ *   - within a class, the earliest deadline first, then the oldest request.
+ *     Deadlines of one client are chained: a request is due one budget
+ *     after max(its arrival, the client's previous deadline), so a burst
+ *     spreads out over time instead of claiming the front of the queue.
+ * Only queue heads compete, and a client has at most maxInFlightPerClient
+ * requests running, so a burst from one client queues behind itself rather
+ * than in front of everyone else, and a session's requests keep their order.
+ *
+ * Admission control: a request is refused with AUDIO_STATUS_BUSY (it is
+ * not run) while its client already has maxQueuedPerClient requests
+ * waiting or the scheduler holds maxQueuedTotal. Queue time (arrival to
+ * start), run time and deadline misses are kept per client.
+ *
+ * Parallel work of a running request (ProcessIntoJob with parallel=true, an
+ * AUDIO_BATCH_FLAG_PARALLEL table) stays on the scheduler's workers:
+ * WorkerPool::parallelFor() called on a worker shares the tasks with the
+ * workers that have nothing runnable instead of waking the pool's own
+ * threads, so no more threads are runnable than there are workers (one per
+ * core). Queued requests come first; an idle worker helps until the tasks
+ * run out.
+ *
+ * kLocalClient (0) is the service's own app calling the *Async functions
+ * directly. It is not a tenant to be kept fair against itself: its requests
+ * use maxQueuedLocal / maxInFlightLocal instead of the per-client limits,
+ * by default bounded only by maxQueuedTotal and the worker count, so
+ * independent local calls still run side by side. A local caller that
+ * needs order (blocks of one session) awaits each request before the next.
+ *
+ * All stamps use AudioTrace::nowNs(), the clock of the Binder receive time.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace DspProcessor {
+
+/** Priority class of a request */
+enum class JobClass : uint32_t {
+    Interactive = 0,   /* real-time blocks: shared memory, session, local   */
+    Batch       = 1,   /* offline work: PROCESS_BATCH_CODE job tables       */
+};
+
+/** JobParams::client of in-process callers (no Binder uid) */
+constexpr uint64_t kLocalClient = 0;
+
+struct SchedulerConfig {
+    unsigned workers              = 0;      /* 0 = one per allowed core        */
+    bool     pinWorkers           = true;   /* worker i on the i-th allowed core */
+    uint32_t maxQueuedPerClient   = 16;
+    uint32_t maxQueuedTotal       = 128;
+    uint32_t maxInFlightPerClient = 1;
+    /* Limits of kLocalClient instead of the two per-client ones above */
+    uint32_t maxQueuedLocal       = 0;      /* 0 = maxQueuedTotal only         */
+    uint32_t maxInFlightLocal     = 0;      /* 0 = every worker                */
+    /* Deadline of a request that does not bring its own (arrival + budget) */
+    int64_t  interactiveBudgetNs  = 20000000;     /* 20 ms */
+    int64_t  batchBudgetNs        = 1000000000;   /* 1 s   */
+    int64_t  batchPromoteNs       = 50000000;     /* 50 ms */
+};
+
+/**
+ * A request handed to the scheduler. The caller keeps ownership: the
+ * scheduler calls run() and then finished() once on a worker and does not
+ * touch the job afterwards, so finished() may hand it off or delete it.
+ */
+class ScheduledJob {
+public:
+    virtual ~ScheduledJob() = default;
+
+    /** The request itself. */
+    virtual void run() = 0;
+
+    /** After run(); the stamps below are final. */
+    virtual void finished() = 0;
+
+    /* Filled in by the scheduler (AudioTrace::nowNs() clock) */
+    int64_t arrivalNs  = 0;
+    int64_t deadlineNs = 0;
+    int64_t startNs    = 0;
+    int64_t endNs      = 0;
+};
+
+struct JobParams {
+    uint64_t client     = 0;   /* queue key, e.g. the calling uid          */
+    JobClass jobClass   = JobClass::Interactive;
+    int64_t  arrivalNs  = 0;   /* when the request arrived; 0 = now        */
+    int64_t  deadlineNs = 0;   /* absolute, as if nothing were queued (its
+                                  distance from arrival is the budget);
+                                  0 = the class budget                     */
+};
+
+/** Counters of one client since it first submitted */
+struct ClientStats {
+    uint64_t client           = 0;
+    uint32_t queued           = 0;   /* waiting now                         */
+    uint32_t inFlight         = 0;   /* running now                         */
+    uint64_t submitted        = 0;   /* admitted                            */
+    uint64_t completed        = 0;
+    uint64_t rejected         = 0;   /* refused with AUDIO_STATUS_BUSY      */
+    uint64_t deadlineMisses   = 0;   /* finished after their deadline       */
+    int64_t  queueTimeTotalNs = 0;   /* arrival → start, summed             */
+    int64_t  queueTimeMaxNs   = 0;
+    int64_t  queueTimeLastNs  = 0;
+    int64_t  runTimeTotalNs   = 0;   /* start → end, summed                 */
+};
+
+struct SchedulerStats {
+    unsigned workers  = 0;
+    uint32_t queued   = 0;
+    uint32_t inFlight = 0;
+    std::vector<ClientStats> clients;   /* ordered by client id */
+};
+
+class Scheduler {
+public:
+    /** The process-wide scheduler (default config on first use). */
+    static Scheduler& instance();
+
+    ~Scheduler();
+
+    Scheduler(const Scheduler&) = delete;
+    Scheduler& operator=(const Scheduler&) = delete;
+
+    /**
+     * Apply a new configuration. Requests already queued still run (on the
+     * old workers) before this returns; per-client counters are kept.
+     */
+    void configure(const SchedulerConfig& config);
+
+    SchedulerConfig config() const;
+
+    /**
+     * Queue a request.
+     * @return AUDIO_STATUS_PROCESSING when admitted (run() and finished()
+     *         follow on a worker), AUDIO_STATUS_BUSY when refused (the job
+     *         is left untouched)
+     */
+    int32_t submit(ScheduledJob* job, const JobParams& params);
+
+    SchedulerStats stats() const;
+
+    /**
+     * Run fn(ctx, i) for every i in [0, taskCount) on the calling worker and
+     * whichever workers are idle, and wait for all of them. Each task sees
+     * the caller's flushDenormalsEnabled() state; a nested call runs inline.
+     * @return false (nothing run) when the calling thread is not a worker
+     */
+    static bool parallelForOnWorkers(size_t taskCount, void (*fn)(void* ctx, size_t task),
+                                     void* ctx);
+
+private:
+    struct Entry {
+        ScheduledJob* job;
+        JobClass      jobClass;
+        uint64_t      seq;        /* submit order, the final tie-break */
+    };
+    struct Client {
+        std::deque<Entry> queue;
+        int64_t           lastDeadlineNs = 0;   /* of the latest request */
+        ClientStats       stats;
+    };
+    /* A parallelFor of a running job, open to idle workers */
+    struct Fanout {
+        void (*fn)(void*, size_t) = nullptr;
+        void*               ctx     = nullptr;
+        size_t              total   = 0;
+        bool                flush   = false;   /* owner's denormal mode */
+        std::atomic<size_t> next { 0 };
+        unsigned            helpers = 0;       /* under lock_           */
+    };
+
+    Scheduler();
+
+    void startWorkers();
+    void stopWorkers();
+    void workerLoop(unsigned index);
+    Client* pickLocked(int64_t now);
+    Fanout* fanoutLocked() const;
+    void runFanout(Fanout& fanout);
+    uint32_t queueLimitLocked(uint64_t client) const;
+    uint32_t inFlightLimitLocked(uint64_t client) const;
+
+    mutable std::mutex       lock_;
+    std::condition_variable  wake_;
+    std::condition_variable  helped_;       /* a Fanout lost its last helper */
+    std::vector<std::thread> workers_;      /* changed under configLock_ only */
+    std::mutex               configLock_;   /* one configure() at a time      */
+    SchedulerConfig          config_;
+    std::map<uint64_t, Client> clients_;
+    std::vector<Fanout*>     fanouts_;
+    unsigned                 workerCount_ = 0;
+    uint32_t                 queued_   = 0;
+    uint32_t                 inFlight_ = 0;
+    uint64_t                 nextSeq_  = 0;
+    bool                     stop_     = false;
+};
+
+} // namespace DspProcessor
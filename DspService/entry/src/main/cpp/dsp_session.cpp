@@ -0,0 +1,329 @@
+/**
+ * dsp_session.cpp — persistent processing sessions over one shared mapping
+ */
+
+#include "dsp_session.h"
+#include "dsp_chain.h"
+#include "dsp_denormals.h"
+#include "dsp_live_control.h"
+#include "dsp_meter.h"
+#include "dsp_processor.h"
+#include "dsp_resampler.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <sys/mman.h>
+#include <vector>
+
+namespace DspProcessor {
+
+namespace {
+
+struct Session {
+    std::mutex      lock;        /* one processSession() at a time        */
+    ClientRef       owner;
+    std::atomic<int64_t> lastUsedNs { 0 };   /* AudioTrace::nowNs()      */
+    uint8_t*        base = nullptr;
+    size_t          size = 0;
+    bool            locked = false;
+    /* Header snapshot taken at open; the host cannot change geometry,
+       version or offsets later (gain / bypass / flags are re-read per call) */
+    SharedHeaderView hdr;
+    bool            hasChain = false;
+    ProcessingChain chain;
+    /* AUDIO_FLAG_LIVE_CONTROL at open; smoothing carries over between calls */
+    LiveControl     live;
+    /* AUDIO_FLAG_LOUDNESS: the 3 s window follows the session's stream */
+    LoudnessMeter   loudness;
+    /* outputRate at open: the converter's history carries over between
+       calls; outCursor is where the next call's output goes */
+    Resampler       resampler;
+    uint32_t        outCursor = 0;
+    /* Output frames written so far: seeds each call's dither where the
+       last one stopped, so the sequence never restarts */
+    uint64_t        ditherFrame = 0;
+};
+
+std::mutex g_sessionsLock;
+std::map<int32_t, std::shared_ptr<Session>> g_sessions;
+int32_t g_nextSessionId = 1;
+
+std::shared_ptr<Session> findSession(int32_t id)
+{
+    std::lock_guard<std::mutex> lock(g_sessionsLock);
+    auto it = g_sessions.find(id);
+    return it == g_sessions.end() ? nullptr : it->second;
+}
+
+/* Lookup on behalf of a caller: another uid's session counts as unknown */
+std::shared_ptr<Session> findOwnSession(int32_t id, int32_t callerUid)
+{
+    std::shared_ptr<Session> s = findSession(id);
+    return s && s->owner.uid == callerUid ? s : nullptr;
+}
+
+void releaseMapping(Session& s)
+{
+    if (!s.base) {
+        return;
+    }
+    if (s.locked) {
+        munlock(s.base, s.size);
+    }
+    munmap(s.base, s.size);
+    s.base = nullptr;
+}
+
+} // namespace
+
+int32_t openSession(int fd, size_t regionSize, const ClientRef& owner)
+{
+    if (fd < 0 || regionSize < AUDIO_SHM_HEADER_SIZE_V1 || !regionFitsFd(fd, regionSize)) {
+        return AUDIO_STATUS_ERROR;
+    }
+
+    /* MAP_POPULATE pre-faults every page so process calls never fault */
+    void* base = mmap(nullptr, regionSize, PROT_READ | PROT_WRITE,
+                      MAP_SHARED | MAP_POPULATE, fd, 0);
+    if (base == MAP_FAILED) {
+        return AUDIO_STATUS_ERROR;
+    }
+
+    auto session  = std::make_shared<Session>();
+    session->owner = owner;
+    session->lastUsedNs.store(AudioTrace::nowNs(), std::memory_order_relaxed);
+    session->base = static_cast<uint8_t*>(base);
+    session->size = regionSize;
+    /* Best effort: RLIMIT_MEMLOCK may be too small, the mapping is still pre-faulted */
+    session->locked = mlock(base, regionSize) == 0;
+
+    SharedHeaderView& hdr = session->hdr;
+    if (!loadHeader(base, regionSize, hdr) || !validateHeader(hdr, regionSize)) {
+        releaseMapping(*session);
+        return AUDIO_STATUS_ERROR;
+    }
+
+    /* Calls yield a varying number of output frames: no fixed chain block */
+    const uint32_t rate = hdr.processingRate();
+    if (hdr.resampling()
+        && !session->resampler.configure(hdr.sampleRate, hdr.outputRate, hdr.channels, hdr.srcQuality)) {
+        releaseMapping(*session);
+        return AUDIO_STATUS_ERROR;
+    }
+    if (hdr.chainOffset != 0) {
+        AudioChainDescriptor desc;
+        std::memcpy(&desc, session->base + hdr.chainOffset, sizeof(desc));
+        if (!session->chain.configure(desc, rate, hdr.channels, hdr.resampling() ? 0 : hdr.frames,
+                                      session->base, session->size)) {
+            releaseMapping(*session);
+            return AUDIO_STATUS_ERROR;
+        }
+        session->hasChain = true;
+    } else if (hdr.flags & AUDIO_FLAG_LIVE_CONTROL) {
+        session->live.attach(audioShmControl(session->base), rate, hdr.channels);
+    }
+
+    int32_t id;
+    {
+        std::lock_guard<std::mutex> lock(g_sessionsLock);
+        id = g_nextSessionId++;
+        g_sessions.emplace(id, std::move(session));
+    }
+    startClientWatch();
+    return id;
+}
+
+SharedProcessResult processSession(int32_t sessionId, uint32_t frameOffset,
+                                   uint32_t frameCount, int64_t receiveNs, int32_t callerUid)
+{
+    SharedProcessResult result { AUDIO_STATUS_ERROR, 0 };
+    AudioTrace::ServiceStamps stamps;
+    if (AUDIO_TRACING) {
+        stamps.receiveNs = receiveNs != 0 ? receiveNs : AudioTrace::nowNs();
+    }
+    std::shared_ptr<Session> s = findOwnSession(sessionId, callerUid);
+    if (!s) {
+        return result;
+    }
+    s->lastUsedNs.store(AudioTrace::nowNs(), std::memory_order_relaxed);
+
+    std::lock_guard<std::mutex> lock(s->lock);
+    if (!s->base) {
+        return result;
+    }
+    const SharedHeaderView& hdr = s->hdr;
+
+    if (frameCount == 0 || frameOffset > hdr.frames || frameCount > hdr.frames - frameOffset) {
+        storeHeaderStatus(s->base, hdr, AUDIO_STATUS_ERROR, 0);
+        return result;
+    }
+    /* Per-call parameters from the live header; a version change is an error */
+    SharedHeaderView now;
+    if (!loadHeader(s->base, s->size, now) || now.version != hdr.version) {
+        storeHeaderStatus(s->base, hdr, AUDIO_STATUS_ERROR, 0);
+        return result;
+    }
+    storeHeaderStatus(s->base, hdr, AUDIO_STATUS_PROCESSING, 0);
+
+    /* Sessions map once at open: "map" is the session lookup + header load */
+    AudioTraceBlock* traceBlock = AudioTrace::traceBlock(s->base, hdr.headerSize, now.flags, s->size);
+    if (traceBlock) {
+        stamps.mapDoneNs = stamps.dspStartNs = AudioTrace::nowNs();
+    }
+
+    const PcmView view { s->base + hdr.inputOffset, s->base + hdr.outputOffset,
+                         hdr.format, hdr.channels, hdr.frames };
+
+    /* Levels cover this call; loudness the session so far */
+    AudioMeterBlock* meterBlock = audioShmMeter(s->base, hdr.headerSize, now.flags, s->size);
+    LevelMeter levels;
+    FrameMeter meter;
+    if (meterBlock && levels.begin(hdr.channels)) {
+        meter.levels = &levels;
+        if ((now.flags & AUDIO_FLAG_LOUDNESS)
+            && (s->loudness.configured() || s->loudness.configure(hdr.processingRate(), hdr.channels))) {
+            meter.loudness = &s->loudness;
+        }
+    }
+
+    const bool dither = (now.flags & AUDIO_FLAG_DITHER) != 0;
+    const bool guarded = guardRequested(now.flags);
+    FrameGuard guard;
+    FrameGuard* frameGuard = guarded ? &guard : nullptr;
+    uint32_t outOffset = frameOffset;
+    uint32_t outFrames = frameCount;
+    auto t0 = std::chrono::steady_clock::now();
+    DenormalScope fpMode(guarded);
+    if (s->resampler.configured()) {
+        /* Results follow each other from the start of a pass; a pass fits
+           by construction (audioSrcCapacityFrames()), odd ranges wrap */
+        const bool flush = (now.flags & AUDIO_FLAG_SRC_FLUSH) != 0;
+        const uint32_t capacity = hdr.outputCapacity();
+        const size_t expected = s->resampler.outputFramesFor(frameCount, flush);
+        outOffset = frameOffset == 0 ? 0 : s->outCursor;
+        if (outOffset + expected > capacity) {
+            outOffset = 0;
+        }
+        outFrames = processFramesResampled(view, capacity, frameOffset, frameCount, outOffset, flush,
+                                           s->resampler, now.gain, now.bypass != 0, dither,
+                                           s->hasChain ? &s->chain : nullptr,
+                                           s->live.attached() ? &s->live : nullptr, true, meter,
+                                           frameGuard, s->ditherFrame);
+        if (outFrames != expected) {
+            storeHeaderStatus(s->base, hdr, AUDIO_STATUS_ERROR, 0);
+            return result;
+        }
+        s->outCursor = outOffset + outFrames;
+    } else if (s->live.attached()) {
+        processFramesLive(view, frameOffset, frameCount, dither, s->live, meter, frameGuard,
+                          s->ditherFrame);
+    } else {
+        processFrames(view, frameOffset, frameCount, now.gain, now.bypass != 0, dither,
+                      s->hasChain ? &s->chain : nullptr, true, meter, frameGuard, s->ditherFrame);
+    }
+    s->ditherFrame += outFrames;
+    auto t1 = std::chrono::steady_clock::now();
+
+    if (guarded) {
+        storeHeaderGuard(s->base, hdr, guard.count());
+        if ((now.flags & AUDIO_FLAG_GUARD_STRICT) && guard.count() != 0) {
+            storeHeaderStatus(s->base, hdr, AUDIO_STATUS_ERROR, 0);
+            return result;
+        }
+    }
+
+    result.status = AUDIO_STATUS_DONE;
+    result.processingTimeNs =
+        std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count();
+    if (traceBlock) {
+        stamps.dspEndNs = AudioTrace::nowNs();
+    }
+    if (meterBlock) {
+        MeterResult levelsResult = levels.result(outFrames);
+        if (meter.loudness) {
+            levelsResult.hasLoudness  = true;
+            levelsResult.loudnessLufs = s->loudness.shortTermLufs();
+        }
+        storeMeterBlock(meterBlock, levelsResult);
+    }
+    storeHeaderOutput(s->base, hdr, outOffset, outFrames);
+    storeHeaderStatus(s->base, hdr, result.status, result.processingTimeNs);
+    if (traceBlock) {
+        stamps.writeBackNs = AudioTrace::nowNs();
+        AudioTrace::publishServiceTrace(traceBlock, stamps);
+    }
+    return result;
+}
+
+int64_t sessionFramesNs(int32_t sessionId, uint32_t frameCount)
+{
+    std::shared_ptr<Session> s = findSession(sessionId);
+    /* hdr is the snapshot taken at open and never changes afterwards */
+    if (!s || s->hdr.sampleRate == 0) {
+        return 0;
+    }
+    return static_cast<int64_t>(frameCount) * 1000000000LL / s->hdr.sampleRate;
+}
+
+int32_t closeSession(int32_t sessionId, int32_t callerUid)
+{
+    std::shared_ptr<Session> s;
+    {
+        std::lock_guard<std::mutex> lock(g_sessionsLock);
+        auto it = g_sessions.find(sessionId);
+        if (it == g_sessions.end() || it->second->owner.uid != callerUid) {
+            return AUDIO_STATUS_ERROR;
+        }
+        s = std::move(it->second);
+        g_sessions.erase(it);
+    }
+
+    std::lock_guard<std::mutex> lock(s->lock);
+    releaseMapping(*s);
+    return AUDIO_STATUS_DONE;
+}
+
+size_t reapSessions(int64_t nowNs)
+{
+    const int64_t idleNs = idleTimeoutMs() * 1000000;
+    std::vector<std::shared_ptr<Session>> reaped;
+    {
+        std::lock_guard<std::mutex> lock(g_sessionsLock);
+        for (auto it = g_sessions.begin(); it != g_sessions.end();) {
+            const Session& s = *it->second;
+            const bool idle = idleNs > 0
+                && nowNs - s.lastUsedNs.load(std::memory_order_relaxed) > idleNs;
+            if (idle || !clientAlive(s.owner)) {
+                reaped.push_back(std::move(it->second));
+                it = g_sessions.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+    /* A call still running on one finishes first; queued ones then fail */
+    for (auto& s : reaped) {
+        std::lock_guard<std::mutex> lock(s->lock);
+        releaseMapping(*s);
+    }
+    return reaped.size();
+}
+
+void closeAllSessions()
+{
+    std::map<int32_t, std::shared_ptr<Session>> sessions;
+    {
+        std::lock_guard<std::mutex> lock(g_sessionsLock);
+        sessions.swap(g_sessions);
+    }
+    for (auto& kv : sessions) {
+        std::lock_guard<std::mutex> lock(kv.second->lock);
+        releaseMapping(*kv.second);
+    }
+}
+
+} // namespace DspProcessor
@@ -0,0 +1,85 @@
+/**
+ * dsp_session.h — persistent processing sessions over one shared mapping
+ *
+ * OPEN_SESSION_CODE hands the shared region over once; the service maps
+ * it (pre-faulted and, where the rlimit allows, locked), validates and
+ * snapshots the header geometry, and configures any processing chain. Each
+ * PROCESS_SESSION_CODE then runs a frame range through the session's DSP
+ * state with no mmap / munmap on the steady-state path.
+ *
+ * A session belongs to the uid that opened it: processing or closing it
+ * under another uid fails without touching the region. Sessions of an
+ * exited client, or idle past idleTimeoutMs(), are reclaimed by the client
+ * watcher (see dsp_client_watch.h).
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "dsp_client_watch.h"
+#include "dsp_shared_memory.h"
+
+namespace DspProcessor {
+
+/**
+ * Map a shared region and register a session for it.
+ * The fd is not closed; the mapping stays valid after the caller closes it.
+ *
+ * @param fd          region fd (AudioSharedHeader at offset 0)
+ * @param regionSize  size of the region in bytes; no larger than the object
+ *                    behind @p fd (see regionFitsFd())
+ * @param owner       Binder caller opening the session (default: in-process)
+ * @return session id (> 0), or AUDIO_STATUS_ERROR
+ */
+int32_t openSession(int fd, size_t regionSize, const ClientRef& owner = ClientRef());
+
+/**
+ * Process frames [frameOffset, frameOffset + frameCount) of the session's
+ * input region into the same range of its output region. gain / bypass /
+ * flags are re-read from the header; chain state carries over between calls.
+ * A resampled session (outputRate at open) writes the frames its converter
+ * yields after the previous call's (at 0 again when frameOffset is 0) and
+ * reports where in outputFrameOffset / outputFrames; AUDIO_FLAG_SRC_FLUSH
+ * ends the converted stream.
+ * With AUDIO_FLAG_TRACE set (and a traced header layout) the call fills in
+ * the service line of the trace block. AUDIO_FLAG_GUARD applies to the call
+ * alone and stores the NaN / Inf samples it replaced in nonFiniteCount.
+ *
+ * @param receiveNs  AudioTrace::nowNs() when the request arrived (0 = now)
+ * @param callerUid  Binder calling uid; must be the session owner's
+ * @return status and timing; the same values are stored in the header
+ *         (an unknown id or a foreign uid leaves the header alone)
+ */
+SharedProcessResult processSession(int32_t sessionId, uint32_t frameOffset,
+                                   uint32_t frameCount, int64_t receiveNs = 0,
+                                   int32_t callerUid = 0);
+
+/**
+ * Playback time of @p frameCount frames of the session's stream, e.g. the
+ * deadline budget of a processSession() request.
+ * @return nanoseconds, or 0 for an unknown session
+ */
+int64_t sessionFramesNs(int32_t sessionId, uint32_t frameCount);
+
+/**
+ * Unregister a session and unmap its region. Waits for a running
+ * processSession() on the same session to finish.
+ * @param callerUid  Binder calling uid; must be the session owner's
+ * @return AUDIO_STATUS_DONE, or AUDIO_STATUS_ERROR for an unknown id or a
+ *         foreign uid
+ */
+int32_t closeSession(int32_t sessionId, int32_t callerUid = 0);
+
+/**
+ * Close the sessions whose owner has exited or which have not been used
+ * since @p nowNs - idleTimeoutMs(). Called by the client watcher.
+ * @return sessions closed
+ */
+size_t reapSessions(int64_t nowNs);
+
+/** Close every open session (service teardown). */
+void closeAllSessions();
+
+} // namespace DspProcessor
@@ -0,0 +1,384 @@
+/**
+ * dsp_shared_memory.cpp — in-place processing on the shared Ashmem region
+ */
+
+#include "dsp_shared_memory.h"
+#include "dsp_processor.h"
+#include "dsp_chain.h"
+#include "dsp_denormals.h"
+#include "dsp_live_control.h"
+#include "dsp_meter.h"
+#include "dsp_resampler.h"
+
+#include <chrono>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/ioctl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+namespace DspProcessor {
+
+namespace {
+
+/* ASHMEM_GET_SIZE from <linux/ashmem.h>, which not every sysroot ships */
+constexpr unsigned long kAshmemGetSize = _IO(0x77, 4);
+
+/* fcntl() sealing from <linux/fcntl.h>, for the same reason */
+#ifdef F_GET_SEALS
+constexpr int kGetSeals  = F_GET_SEALS;
+constexpr int kSealShrink = F_SEAL_SHRINK;
+#else
+constexpr int kGetSeals  = 1024 + 10;
+constexpr int kSealShrink = 0x0002;
+#endif
+
+/* Does [offset, offset + len) lie inside [headerSize, regionSize)? */
+bool rangeInRegion(uint64_t offset, uint64_t len, uint64_t headerSize, uint64_t regionSize,
+                   uint64_t align)
+{
+    return offset >= headerSize
+        && offset % align == 0
+        && offset + len <= regionSize;
+}
+
+} // namespace
+
+bool regionFitsFd(int fd, size_t regionSize)
+{
+    struct stat st;
+    if (fd < 0 || fstat(fd, &st) != 0) {
+        return false;
+    }
+    uint64_t size = 0;
+    if (S_ISREG(st.st_mode)) {
+        /* A file or memfd can be truncated under a mapping that outlives
+           the call (sessions, streams): only take one that cannot shrink */
+        const int seals = fcntl(fd, kGetSeals);
+        if (seals < 0 || (seals & kSealShrink) == 0) {
+            return false;
+        }
+        size = static_cast<uint64_t>(st.st_size);
+    } else {
+        /* Ashmem keeps its size once mapped (ASHMEM_SET_SIZE then fails) */
+        const int ashmemSize = ioctl(fd, kAshmemGetSize, nullptr);
+        size = ashmemSize > 0 ? static_cast<uint64_t>(ashmemSize) : 0;
+    }
+    return regionSize <= size;
+}
+
+uint32_t sampleAlignment(uint32_t format)
+{
+    /* Packed int24 is read bytewise; the others as native words */
+    return format == AUDIO_FORMAT_S24_PACKED ? 1u : audioFormatBytes(format);
+}
+
+bool loadHeader(const void* base, size_t regionSize, SharedHeaderView& out)
+{
+    out = SharedHeaderView();
+    if (!base || regionSize < AUDIO_SHM_HEADER_SIZE_V1) {
+        return false;
+    }
+    const auto* bytes = static_cast<const uint8_t*>(base);
+    uint32_t magic = 0;
+    std::memcpy(&magic, bytes, sizeof(magic));
+    std::memcpy(&out.version, bytes + AUDIO_HDR_OFFSET_VERSION, sizeof(out.version));
+
+    if (out.version == AUDIO_SHM_VERSION) {
+        if (regionSize < AUDIO_SHM_HEADER_SIZE) {
+            return false;
+        }
+        out.statusOffset = AUDIO_HDR_OFFSET_STATUS;
+        out.timeOffset   = AUDIO_HDR_OFFSET_PROC_TIME_NS;
+
+        /* Request line only; the control and result lines stay untouched */
+        AudioSharedHeader hdr;
+        std::memcpy(&hdr, bytes, AUDIO_HDR_OFFSET_CONTROL);
+        out.headerSize   = hdr.headerSize;
+        out.sampleRate   = hdr.sampleRate;
+        out.channels     = hdr.channels;
+        out.frames       = hdr.frames;
+        out.format       = hdr.format;
+        out.flags        = hdr.flags;
+        out.inputOffset  = hdr.inputOffset;
+        out.outputOffset = hdr.outputOffset;
+        out.chainOffset  = hdr.chainOffset;
+        out.gain         = hdr.gain;
+        out.bypass       = hdr.bypass;
+        out.outputRate   = hdr.outputRate;
+        out.srcQuality   = hdr.srcQuality;
+        return magic == AUDIO_SHM_MAGIC;
+    }
+
+    /* v1, and where an unknown version gets its error status */
+    out.statusOffset = AUDIO_HDR_V1_OFFSET_STATUS;
+    out.timeOffset   = AUDIO_HDR_V1_OFFSET_PROC_TIME_NS;
+    if (out.version != AUDIO_SHM_VERSION_1) {
+        return false;
+    }
+
+    AudioSharedHeaderV1 hdr;
+    std::memcpy(&hdr, bytes, AUDIO_HDR_OFFSET_CONTROL);
+    out.headerSize   = AUDIO_SHM_HEADER_SIZE_V1;
+    out.sampleRate   = hdr.sampleRate;
+    out.channels     = hdr.channels;
+    out.frames       = hdr.frames;
+    out.format       = hdr.format;
+    out.flags        = hdr.flags;
+    out.inputOffset  = hdr.inputOffset;
+    out.outputOffset = hdr.outputOffset;
+    out.chainOffset  = hdr.chainOffset;
+    out.gain         = hdr.gain;
+    out.bypass       = hdr.bypass;
+    return magic == AUDIO_SHM_MAGIC;
+}
+
+void storeHeaderStatus(void* base, const SharedHeaderView& hdr, int32_t status, int64_t timeNs)
+{
+    if (!base || hdr.statusOffset == 0) {
+        return;
+    }
+    auto* bytes = static_cast<uint8_t*>(base);
+    if (hdr.timeOffset % alignof(int64_t) == 0) {
+        __atomic_store_n(reinterpret_cast<int64_t*>(bytes + hdr.timeOffset), timeNs, __ATOMIC_RELAXED);
+    } else {
+        std::memcpy(bytes + hdr.timeOffset, &timeNs, sizeof(timeNs));   /* v1: unaligned */
+    }
+    /* status last: the host polls it to learn the result is complete */
+    __atomic_store_n(reinterpret_cast<int32_t*>(bytes + hdr.statusOffset), status, __ATOMIC_RELEASE);
+}
+
+void storeHeaderOutput(void* base, const SharedHeaderView& hdr, uint32_t frameOffset, uint32_t frames)
+{
+    if (!base || hdr.version != AUDIO_SHM_VERSION || hdr.statusOffset == 0) {
+        return;
+    }
+    auto* bytes = static_cast<uint8_t*>(base);
+    __atomic_store_n(reinterpret_cast<uint32_t*>(bytes + AUDIO_HDR_OFFSET_OUTPUT_FRAME_OFFSET),
+                     frameOffset, __ATOMIC_RELAXED);
+    __atomic_store_n(reinterpret_cast<uint32_t*>(bytes + AUDIO_HDR_OFFSET_OUTPUT_FRAMES),
+                     frames, __ATOMIC_RELAXED);
+}
+
+void storeHeaderGuard(void* base, const SharedHeaderView& hdr, uint64_t nonFinite)
+{
+    if (!base || hdr.version != AUDIO_SHM_VERSION || hdr.statusOffset == 0) {
+        return;
+    }
+    const uint32_t count = nonFinite > UINT32_MAX ? UINT32_MAX : static_cast<uint32_t>(nonFinite);
+    __atomic_store_n(reinterpret_cast<uint32_t*>(static_cast<uint8_t*>(base) + AUDIO_HDR_OFFSET_NON_FINITE),
+                     count, __ATOMIC_RELAXED);
+}
+
+bool validateHeader(const SharedHeaderView& hdr, size_t regionSize)
+{
+    const bool v2 = hdr.version == AUDIO_SHM_VERSION;
+    if (!v2 && hdr.version != AUDIO_SHM_VERSION_1) {
+        return false;
+    }
+    const uint32_t bps = audioFormatBytes(hdr.format);
+    if (bps == 0 || hdr.channels == 0 || hdr.frames == 0) {
+        return false;
+    }
+
+    const uint64_t headerSize = hdr.headerSize;
+    if (headerSize < (v2 ? AUDIO_SHM_HEADER_SIZE : AUDIO_SHM_HEADER_SIZE_V1)
+        || headerSize % (v2 ? AUDIO_SHM_PCM_ALIGN : 1u) != 0
+        || headerSize > regionSize) {
+        return false;
+    }
+
+    /* v2 regions start on cache lines; v1 only needs sample alignment */
+    const uint64_t pcmAlign   = v2 ? AUDIO_SHM_PCM_ALIGN : sampleAlignment(hdr.format);
+    const uint64_t chainAlign = v2 ? AUDIO_SHM_PCM_ALIGN : sizeof(float);
+
+    /* Conversion: v2 only, rates and quality the resampler takes */
+    const bool resampling = hdr.resampling();
+    if (resampling
+        && (!v2 || hdr.sampleRate < AUDIO_SRC_MIN_RATE || hdr.sampleRate > AUDIO_SRC_MAX_RATE
+            || hdr.outputRate < AUDIO_SRC_MIN_RATE || hdr.outputRate > AUDIO_SRC_MAX_RATE
+            || hdr.srcQuality > AUDIO_SRC_QUALITY_HIGH || hdr.channels > Resampler::kMaxChannels)) {
+        return false;
+    }
+
+    const uint64_t pcmBytes = static_cast<uint64_t>(hdr.frames) * hdr.channels * bps;
+    const uint64_t outBytes = static_cast<uint64_t>(hdr.outputCapacity()) * hdr.channels * bps;
+    const uint64_t in  = hdr.inputOffset;
+    const uint64_t out = hdr.outputOffset;
+    if (!rangeInRegion(in, pcmBytes, headerSize, regionSize, pcmAlign)
+        || !rangeInRegion(out, outBytes, headerSize, regionSize, pcmAlign)) {
+        return false;
+    }
+
+    /* Exact aliasing (in-place) is fine, except across a rate change;
+       partial overlap never is */
+    const bool disjoint = in + pcmBytes <= out || out + outBytes <= in;
+    if (!(disjoint || (in == out && !resampling))) {
+        return false;
+    }
+
+    /* Optional chain descriptor must not overlap either PCM region */
+    if (hdr.chainOffset != 0) {
+        const uint64_t chain = hdr.chainOffset;
+        const uint64_t chainBytes = sizeof(AudioChainDescriptor);
+        if (!rangeInRegion(chain, chainBytes, headerSize, regionSize, chainAlign)
+            || !(chain + chainBytes <= in || in + pcmBytes <= chain)
+            || !(chain + chainBytes <= out || out + outBytes <= chain)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+SharedProcessResult processMappedRegion(void* base, size_t regionSize,
+                                        const AudioTrace::ServiceStamps* trace)
+{
+    SharedProcessResult result { AUDIO_STATUS_ERROR, 0 };
+    if (!base || regionSize < AUDIO_SHM_HEADER_SIZE_V1) {
+        return result;
+    }
+
+    auto* bytes = static_cast<uint8_t*>(base);
+    SharedHeaderView hdr;
+    if (!loadHeader(base, regionSize, hdr) || !validateHeader(hdr, regionSize)) {
+        storeHeaderStatus(base, hdr, AUDIO_STATUS_ERROR, 0);
+        return result;
+    }
+    storeHeaderStatus(base, hdr, AUDIO_STATUS_PROCESSING, 0);
+
+    const PcmView view { bytes + hdr.inputOffset, bytes + hdr.outputOffset,
+                         hdr.format, hdr.channels, hdr.frames };
+
+    /* Everything after the converter runs at the output rate */
+    Resampler resampler;
+    const uint32_t rate = hdr.processingRate();
+    const uint32_t frames = audioSrcOutputFrames(hdr.frames, hdr.sampleRate, rate);
+    if (hdr.resampling()
+        && !resampler.configure(hdr.sampleRate, hdr.outputRate, hdr.channels, hdr.srcQuality)) {
+        storeHeaderStatus(base, hdr, AUDIO_STATUS_ERROR, 0);
+        return result;
+    }
+
+    /* Snapshot the descriptor so the host cannot change it mid-configure */
+    ProcessingChain chain;
+    if (hdr.chainOffset != 0) {
+        AudioChainDescriptor desc;
+        std::memcpy(&desc, bytes + hdr.chainOffset, sizeof(desc));
+        if (!chain.configure(desc, rate, hdr.channels, frames, bytes, regionSize)) {
+            storeHeaderStatus(base, hdr, AUDIO_STATUS_ERROR, 0);
+            return result;
+        }
+    }
+
+    /* Live control: gain / bypass may change while the region is processed */
+    LiveControl live;
+    const bool dither = (hdr.flags & AUDIO_FLAG_DITHER) != 0;
+    if ((hdr.flags & AUDIO_FLAG_LIVE_CONTROL) && hdr.chainOffset == 0) {
+        live.attach(audioShmControl(base), rate, hdr.channels);
+    }
+
+    /* Metering: levels always, loudness on request; a new stream per request */
+    AudioMeterBlock* meterBlock = audioShmMeter(base, hdr.headerSize, hdr.flags, regionSize);
+    LevelMeter levels;
+    LoudnessMeter loudness;
+    FrameMeter meter;
+    if (meterBlock && levels.begin(hdr.channels)) {
+        meter.levels = &levels;
+        if ((hdr.flags & AUDIO_FLAG_LOUDNESS) && loudness.configure(rate, hdr.channels)) {
+            meter.loudness = &loudness;
+        }
+    }
+
+    /* Guard mode: the DenormalScope covers the workers too (WorkerPool) */
+    const bool guarded = guardRequested(hdr.flags);
+    FrameGuard guard;
+    FrameGuard* frameGuard = guarded ? &guard : nullptr;
+
+    AudioTraceBlock* traceBlock = AudioTrace::traceBlock(base, hdr.headerSize, hdr.flags, regionSize);
+    AudioTrace::ServiceStamps stamps;
+    if (traceBlock) {
+        if (trace) {
+            stamps = *trace;
+        }
+        stamps.dspStartNs = AudioTrace::nowNs();
+    }
+
+    auto t0 = std::chrono::steady_clock::now();
+    {
+        DenormalScope fpMode(guarded);
+        if (resampler.configured()) {
+            /* One-shot: the whole stream, tail included */
+            if (processFramesResampled(view, hdr.outputCapacity(), 0, hdr.frames, 0, true, resampler,
+                                       hdr.gain, hdr.bypass != 0, dither,
+                                       hdr.chainOffset != 0 ? &chain : nullptr,
+                                       live.attached() ? &live : nullptr, true, meter,
+                                       frameGuard) != frames) {
+                storeHeaderStatus(base, hdr, AUDIO_STATUS_ERROR, 0);
+                return result;
+            }
+        } else if (live.attached()) {
+            processFramesLive(view, 0, hdr.frames, dither, live, meter, frameGuard);
+        } else {
+            processFrames(view, 0, hdr.frames, hdr.gain, hdr.bypass != 0, dither,
+                          hdr.chainOffset != 0 ? &chain : nullptr, true, meter, frameGuard);
+        }
+    }
+    auto t1 = std::chrono::steady_clock::now();
+
+    if (guarded) {
+        storeHeaderGuard(base, hdr, guard.count());
+        if ((hdr.flags & AUDIO_FLAG_GUARD_STRICT) && guard.count() != 0) {
+            storeHeaderStatus(base, hdr, AUDIO_STATUS_ERROR, 0);
+            return result;
+        }
+    }
+
+    result.status = AUDIO_STATUS_DONE;
+    result.processingTimeNs =
+        std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count();
+    if (traceBlock) {
+        stamps.dspEndNs = AudioTrace::nowNs();
+    }
+    if (meterBlock) {
+        /* Published by the status store below; channels 0 = too many to meter */
+        MeterResult levelsResult = levels.result(frames);
+        if (meter.loudness) {
+            levelsResult.hasLoudness  = true;
+            levelsResult.loudnessLufs = loudness.shortTermLufs();
+        }
+        storeMeterBlock(meterBlock, levelsResult);
+    }
+    storeHeaderOutput(base, hdr, 0, frames);
+    storeHeaderStatus(base, hdr, result.status, result.processingTimeNs);
+    if (traceBlock) {
+        stamps.writeBackNs = AudioTrace::nowNs();
+        AudioTrace::publishServiceTrace(traceBlock, stamps);
+    }
+    return result;
+}
+
+SharedProcessResult processSharedMemory(int fd, size_t regionSize, int64_t receiveNs)
+{
+    SharedProcessResult result { AUDIO_STATUS_ERROR, 0 };
+    if (fd < 0 || regionSize < AUDIO_SHM_HEADER_SIZE_V1 || !regionFitsFd(fd, regionSize)) {
+        return result;
+    }
+
+    AudioTrace::ServiceStamps stamps;
+    if (AUDIO_TRACING) {
+        stamps.receiveNs = receiveNs != 0 ? receiveNs : AudioTrace::nowNs();
+    }
+    void* base = mmap(nullptr, regionSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (base == MAP_FAILED) {
+        return result;
+    }
+    if (AUDIO_TRACING) {
+        stamps.mapDoneNs = AudioTrace::nowNs();
+    }
+
+    result = processMappedRegion(base, regionSize, &stamps);
+    munmap(base, regionSize);
+    return result;
+}
+
+} // namespace DspProcessor
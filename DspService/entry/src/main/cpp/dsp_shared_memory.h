@@ -0,0 +1,171 @@
+/**
+ * dsp_shared_memory.h — in-place processing on the shared Ashmem region
+ *
+ * The service maps the Ashmem fd handed over by HostApp, validates the
+ * AudioSharedHeader and runs the DSP kernel from inputOffset straight into
+ * outputOffset. status and processingTimeNs are written back into the
+ * header, so no PCM bytes ever cross into ArkTS.
+ *
+ * If header.chainOffset is set, the AudioChainDescriptor found there is run
+ * instead of the plain gain / bypass pair. Any AUDIO_FORMAT_* is read and
+ * written in place; see processFrames().
+ *
+ * Both header versions are accepted: loadHeader() copies the host-owned
+ * fields of a v2 (aligned) or v1 (packed) header into a SharedHeaderView,
+ * and everything downstream works on that view, so only loading and
+ * storeHeaderStatus() know where the fields live.
+ *
+ * A v2 header flagged AUDIO_FLAG_TRACE gets its AudioTraceBlock service
+ * line filled in (see AudioTrace.h); the caller passes the stamps taken
+ * before the region was reached.
+ *
+ * A v2 header whose outputRate differs from sampleRate is converted to
+ * outputRate first (see dsp_resampler.h and processFramesResampled()).
+ *
+ * AUDIO_FLAG_GUARD / AUDIO_FLAG_GUARD_STRICT run the request with
+ * subnormals flushed to zero (DenormalScope) and non-finite input replaced
+ * (FrameGuard); the count goes to the header's nonFiniteCount. Requests
+ * without them run with IEEE subnormals, whatever mode the thread was in.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "AudioSharedBuffer.h"
+#include "AudioTrace.h"
+
+namespace DspProcessor {
+
+/** Result returned by processSharedMemory() / processMappedRegion() */
+struct SharedProcessResult {
+    /** AUDIO_STATUS_DONE on success, AUDIO_STATUS_ERROR otherwise */
+    int32_t status;
+    /** Wall-clock processing duration in nanoseconds (0 on error) */
+    int64_t processingTimeNs;
+};
+
+/** Host-owned header fields of either version, copied out of the region */
+struct SharedHeaderView {
+    uint32_t version      = 0;
+    uint32_t headerSize   = 0;   /* AUDIO_SHM_HEADER_SIZE_V1 for v1       */
+    uint32_t sampleRate   = 0;
+    uint32_t channels     = 0;
+    uint32_t frames       = 0;
+    uint32_t format       = AUDIO_FORMAT_FLOAT32;
+    uint32_t flags        = 0;
+    uint32_t inputOffset  = 0;
+    uint32_t outputOffset = 0;
+    uint32_t chainOffset  = 0;
+    float    gain         = 1.0f;
+    uint32_t bypass       = 0;
+    uint32_t outputRate   = 0;   /* v2 only; 0 = sampleRate               */
+    uint32_t srcQuality   = 0;
+    /* Where storeHeaderStatus() writes; 0 = nowhere (region too small) */
+    uint32_t statusOffset = 0;
+    uint32_t timeOffset   = 0;
+
+    /** Does the request ask for sample-rate conversion? */
+    bool resampling() const { return outputRate != 0 && outputRate != sampleRate; }
+    /** Rate the DSP runs at: outputRate when resampling, else sampleRate. */
+    uint32_t processingRate() const { return resampling() ? outputRate : sampleRate; }
+    /** Frames in the output region (audioSrcCapacityFrames()). */
+    uint32_t outputCapacity() const
+    {
+        return resampling() ? audioSrcCapacityFrames(frames, sampleRate, outputRate) : frames;
+    }
+};
+
+/**
+ * Copy the host-owned fields of the header at @p base.
+ *
+ * statusOffset / timeOffset are filled in whenever the region can hold
+ * them (unknown versions report through the v1 slots, where every older
+ * host looks), so a failed load can still be answered with an error status.
+ *
+ * @return false for a bad magic, an unknown version or a region too small
+ *         for the header it claims
+ */
+bool loadHeader(const void* base, size_t regionSize, SharedHeaderView& out);
+
+/**
+ * Check that a header describes a layout that fits inside the region.
+ * v2 regions must also start on AUDIO_SHM_PCM_ALIGN boundaries.
+ *
+ * @param hdr        view filled by loadHeader()
+ * @param regionSize total size of the mapped region in bytes
+ * @return true when format, geometry and all PCM ranges are valid
+ */
+bool validateHeader(const SharedHeaderView& hdr, size_t regionSize);
+
+/**
+ * Is the object behind @p fd at least @p regionSize bytes long? The size a
+ * caller claims must be checked before mapping: touching a page past the
+ * end of the object raises SIGBUS and takes the whole service down.
+ * Regular files and memfds report their size through fstat(), Ashmem
+ * through ASHMEM_GET_SIZE; an fd of neither kind is rejected.
+ *
+ * The size must also stay: sessions and streams keep (and mlock) their
+ * mapping across calls, and a host that truncates its memfd afterwards
+ * would fault the service on the next access. Regular files and memfds
+ * are therefore only accepted with F_SEAL_SHRINK set (HostApp's
+ * createSharedMemory() seals its regions); Ashmem cannot be resized once
+ * mapped.
+ */
+bool regionFitsFd(int fd, size_t regionSize);
+
+/** Required byte alignment of a PCM region in the given AUDIO_FORMAT_*. */
+uint32_t sampleAlignment(uint32_t format);
+
+/**
+ * Write processingTimeNs, then publish status with release ordering so a
+ * host polling status also sees the matching time. Uses the slots of the
+ * header version @p hdr was loaded from.
+ */
+void storeHeaderStatus(void* base, const SharedHeaderView& hdr, int32_t status, int64_t timeNs);
+
+/**
+ * Report which output frames a request wrote (outputFrameOffset /
+ * outputFrames, v2 only). Call before storeHeaderStatus(), which
+ * publishes them.
+ */
+void storeHeaderOutput(void* base, const SharedHeaderView& hdr, uint32_t frameOffset, uint32_t frames);
+
+/**
+ * Report the non-finite input samples a guarded request replaced
+ * (nonFiniteCount, v2 only; saturates at UINT32_MAX). Call before
+ * storeHeaderStatus(), which publishes it.
+ */
+void storeHeaderGuard(void* base, const SharedHeaderView& hdr, uint64_t nonFinite);
+
+/** AUDIO_FLAG_GUARD or AUDIO_FLAG_GUARD_STRICT set in @p flags? */
+inline bool guardRequested(uint32_t flags)
+{
+    return (flags & (AUDIO_FLAG_GUARD | AUDIO_FLAG_GUARD_STRICT)) != 0;
+}
+
+/**
+ * Process an already-mapped shared region in place.
+ *
+ * @param base       start of the region (AudioSharedHeader, v1 or v2, at offset 0)
+ * @param regionSize total size of the region in bytes
+ * @param trace      receive / mapDone stamps of a traced request (may be nullptr)
+ * @return status and timing; the same values are stored in the header
+ */
+SharedProcessResult processMappedRegion(void* base, size_t regionSize,
+                                        const AudioTrace::ServiceStamps* trace = nullptr);
+
+/**
+ * Map an Ashmem fd, process it in place, and unmap it again.
+ * The fd is not closed; ownership stays with the caller.
+ *
+ * @param fd         Ashmem file descriptor (readable and writable)
+ * @param regionSize size of the Ashmem region in bytes; larger than the
+ *                   object behind @p fd is an error (see regionFitsFd())
+ * @param receiveNs  AudioTrace::nowNs() when the request arrived (0 = now)
+ * @return status and timing; the same values are stored in the header
+ */
+SharedProcessResult processSharedMemory(int fd, size_t regionSize, int64_t receiveNs = 0);
+
+} // namespace DspProcessor
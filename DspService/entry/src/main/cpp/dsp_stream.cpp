@@ -0,0 +1,186 @@
+/**
+ * dsp_stream.cpp — block-streaming sessions over an AudioStreamBuffer region
+ */
+
+#include "dsp_stream.h"
+#include "dsp_live_control.h"
+#include "dsp_processor.h"
+#include "dsp_shared_memory.h"
+#include "AudioStreamRing.h"
+#include "AudioTrace.h"
+
+#include <atomic>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <sys/mman.h>
+#include <thread>
+#include <vector>
+
+namespace DspProcessor {
+
+namespace {
+
+/* Worker wake-up period so a lost peer never wedges the thread */
+constexpr int kPollMs = 100;
+
+struct StreamSession {
+    void*                base = nullptr;
+    size_t               size = 0;
+    AudioStreamHeader*   hdr  = nullptr;
+    ClientRef            owner;
+    std::atomic<int64_t> lastActiveNs { 0 };   /* AudioTrace::nowNs() of the last block */
+    std::thread          worker;
+};
+
+std::mutex g_streamsLock;
+std::map<int32_t, std::unique_ptr<StreamSession>> g_streams;
+int32_t g_nextStreamId = 1;
+
+/* geometry is the copy validated at open; the header's own configuration
+   line is never read again, the host may have rewritten it since */
+void runStream(AudioStreamHeader* hdr, AudioStream::RingGeometry geometry,
+               std::atomic<int64_t>* lastActiveNs)
+{
+    AudioStream::BlockConsumer input(hdr, geometry, AudioStream::Ring::Input);
+    AudioStream::BlockProducer output(hdr, geometry, AudioStream::Ring::Output);
+    const uint32_t channels = geometry.channels;
+
+    /* Version 2 regions carry a control line; version 1 re-reads the
+       plain gain / bypass fields per block without smoothing */
+    LiveControl live;
+    if (geometry.version >= 2u) {
+        live.attach(&hdr->control, geometry.sampleRate, channels);
+    }
+
+    while (!AudioStream::isClosed(hdr)) {
+        uint32_t frames = 0, flags = 0;
+        const float* src = input.acquire(kPollMs, &frames, &flags);
+        if (!src) {
+            continue;
+        }
+
+        float* dst = nullptr;
+        while (!dst && !AudioStream::isClosed(hdr)) {
+            dst = output.acquire(kPollMs);
+        }
+        if (!dst) {
+            break;
+        }
+
+        if (live.attached()) {
+            live.process(src, dst, frames);
+        } else {
+            processBuffer(src, dst, static_cast<size_t>(frames) * channels,
+                          hdr->gain, hdr->bypass != 0);
+        }
+        output.publish(frames, flags);
+        input.release();
+        lastActiveNs->store(AudioTrace::nowNs(), std::memory_order_relaxed);
+
+        if (flags & AUDIO_STREAM_BLOCK_END) {
+            break;
+        }
+    }
+}
+
+/* Stop the worker and unmap; the session is already out of g_streams */
+void shutdownStream(StreamSession& session)
+{
+    AudioStream::closeRegion(session.hdr);
+    if (session.worker.joinable()) {
+        session.worker.join();
+    }
+    munmap(session.base, session.size);
+}
+
+} // namespace
+
+int32_t openStream(int fd, size_t regionSize, const ClientRef& owner)
+{
+    if (fd < 0 || regionSize < AUDIO_STREAM_HEADER_SIZE_V1 || !regionFitsFd(fd, regionSize)) {
+        return AUDIO_STATUS_ERROR;
+    }
+
+    void* base = mmap(nullptr, regionSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (base == MAP_FAILED) {
+        return AUDIO_STATUS_ERROR;
+    }
+    AudioStream::RingGeometry geometry;
+    if (!AudioStream::validateRegion(base, regionSize, &geometry)) {
+        munmap(base, regionSize);
+        return AUDIO_STATUS_ERROR;
+    }
+
+    auto session  = std::make_unique<StreamSession>();
+    session->base = base;
+    session->size = regionSize;
+    session->hdr  = static_cast<AudioStreamHeader*>(base);
+    session->owner = owner;
+    session->lastActiveNs.store(AudioTrace::nowNs(), std::memory_order_relaxed);
+    session->worker = std::thread(runStream, session->hdr, geometry, &session->lastActiveNs);
+
+    int32_t id;
+    {
+        std::lock_guard<std::mutex> lock(g_streamsLock);
+        id = g_nextStreamId++;
+        g_streams.emplace(id, std::move(session));
+    }
+    startClientWatch();
+    return id;
+}
+
+int32_t closeStream(int32_t streamId, int32_t callerUid)
+{
+    std::unique_ptr<StreamSession> session;
+    {
+        std::lock_guard<std::mutex> lock(g_streamsLock);
+        auto it = g_streams.find(streamId);
+        if (it == g_streams.end() || it->second->owner.uid != callerUid) {
+            return AUDIO_STATUS_ERROR;
+        }
+        session = std::move(it->second);
+        g_streams.erase(it);
+    }
+
+    shutdownStream(*session);
+    return AUDIO_STATUS_DONE;
+}
+
+size_t reapStreams(int64_t nowNs)
+{
+    const int64_t idleNs = idleTimeoutMs() * 1000000;
+    std::vector<std::unique_ptr<StreamSession>> reaped;
+    {
+        std::lock_guard<std::mutex> lock(g_streamsLock);
+        for (auto it = g_streams.begin(); it != g_streams.end();) {
+            const StreamSession& s = *it->second;
+            const bool idle = idleNs > 0
+                && nowNs - s.lastActiveNs.load(std::memory_order_relaxed) > idleNs;
+            if (idle || !clientAlive(s.owner)) {
+                reaped.push_back(std::move(it->second));
+                it = g_streams.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+    for (auto& s : reaped) {
+        shutdownStream(*s);
+    }
+    return reaped.size();
+}
+
+void closeAllStreams()
+{
+    std::map<int32_t, std::unique_ptr<StreamSession>> streams;
+    {
+        std::lock_guard<std::mutex> lock(g_streamsLock);
+        streams.swap(g_streams);
+    }
+    for (auto& kv : streams) {
+        shutdownStream(*kv.second);
+    }
+}
+
+} // namespace DspProcessor
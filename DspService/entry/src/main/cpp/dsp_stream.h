@@ -0,0 +1,53 @@
+/**
+ * dsp_stream.h — block-streaming sessions over an AudioStreamBuffer region
+ *
+ * openStream() maps the region handed over by OPEN_STREAM_CODE and starts
+ * a worker that drains the input ring, processes each block and publishes
+ * it to the output ring. No Binder traffic happens per block.
+ *
+ * A stream belongs to the uid that opened it; only that uid can close it.
+ * Streams of an exited client, or without a block for idleTimeoutMs(),
+ * are closed by the client watcher (see dsp_client_watch.h).
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "dsp_client_watch.h"
+
+namespace DspProcessor {
+
+/**
+ * Map a stream region and start its worker.
+ * The fd is not closed; the mapping stays valid after the caller closes it.
+ *
+ * @param fd          stream region fd (readable and writable)
+ * @param regionSize  size of the region in bytes; no larger than the object
+ *                    behind @p fd (see regionFitsFd())
+ * @param owner       Binder caller opening the stream (default: in-process)
+ * @return stream id (> 0), or AUDIO_STATUS_ERROR
+ */
+int32_t openStream(int fd, size_t regionSize, const ClientRef& owner = ClientRef());
+
+/**
+ * Close the stream, join its worker and unmap the region.
+ * @param streamId   id returned by openStream()
+ * @param callerUid  Binder calling uid; must be the stream owner's
+ * @return AUDIO_STATUS_DONE, or AUDIO_STATUS_ERROR for an unknown id or a
+ *         foreign uid
+ */
+int32_t closeStream(int32_t streamId, int32_t callerUid = 0);
+
+/**
+ * Close the streams whose owner has exited or which have not moved a
+ * block since @p nowNs - idleTimeoutMs(). Called by the client watcher.
+ * @return streams closed
+ */
+size_t reapStreams(int64_t nowNs);
+
+/** Close every open stream (service teardown). */
+void closeAllStreams();
+
+} // namespace DspProcessor
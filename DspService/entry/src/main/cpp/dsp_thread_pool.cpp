@@ -0,0 +1,158 @@
+/**
+ * dsp_thread_pool.cpp — process-wide worker pool for large offline buffers
+ */
+
+#include "dsp_thread_pool.h"
+#include "dsp_denormals.h"
+#include "dsp_scheduler.h"
+
+namespace DspProcessor {
+
+WorkerPool& WorkerPool::instance()
+{
+    static WorkerPool pool;
+    return pool;
+}
+
+WorkerPool::WorkerPool()
+{
+    unsigned hw = std::thread::hardware_concurrency();
+    startWorkers(hw > 1 ? hw - 1 : 0);
+}
+
+WorkerPool::~WorkerPool()
+{
+    stopWorkers();
+}
+
+void WorkerPool::setThreadCount(unsigned threads)
+{
+    if (threads == 0) {
+        threads = std::thread::hardware_concurrency();
+    }
+    if (threads == 0) {
+        threads = 1;
+    }
+
+    std::lock_guard<std::mutex> job(jobLock_);
+    if (threads - 1 == workers_.size()) {
+        return;
+    }
+    stopWorkers();
+    startWorkers(threads - 1);
+}
+
+unsigned WorkerPool::threadCount() const
+{
+    /* workers_ itself is only stable under jobLock_ */
+    return threads_.load(std::memory_order_relaxed);
+}
+
+void WorkerPool::startWorkers(unsigned count)
+{
+    unsigned gen = 0;
+    {
+        std::lock_guard<std::mutex> lock(stateLock_);
+        stop_ = false;
+        gen   = generation_;
+    }
+    /* Workers start from the current generation so none can miss a job */
+    workers_.reserve(count);
+    for (unsigned i = 0; i < count; ++i) {
+        workers_.emplace_back(&WorkerPool::workerLoop, this, gen);
+    }
+    threads_.store(count + 1, std::memory_order_relaxed);
+}
+
+void WorkerPool::stopWorkers()
+{
+    {
+        std::lock_guard<std::mutex> lock(stateLock_);
+        stop_ = true;
+    }
+    wake_.notify_all();
+    threads_.store(1, std::memory_order_relaxed);
+    for (auto& t : workers_) {
+        t.join();
+    }
+    workers_.clear();
+}
+
+void WorkerPool::runTasks()
+{
+    for (;;) {
+        size_t task = next_.fetch_add(1, std::memory_order_relaxed);
+        if (task >= total_) {
+            return;
+        }
+        fn_(ctx_, task);
+    }
+}
+
+void WorkerPool::workerLoop(unsigned seen)
+{
+    for (;;) {
+        bool flush = false;
+        {
+            std::unique_lock<std::mutex> lock(stateLock_);
+            wake_.wait(lock, [&] { return stop_ || generation_ != seen; });
+            if (stop_) {
+                return;
+            }
+            seen  = generation_;
+            flush = flush_;
+        }
+
+        {
+            DenormalScope mode(flush);
+            runTasks();
+        }
+
+        std::lock_guard<std::mutex> lock(stateLock_);
+        if (--active_ == 0) {
+            done_.notify_one();
+        }
+    }
+}
+
+void WorkerPool::parallelFor(size_t taskCount, void (*fn)(void* ctx, size_t task), void* ctx)
+{
+    if (taskCount == 0) {
+        return;
+    }
+
+    /* On a scheduler worker: share with the idle workers, not the pool */
+    if (Scheduler::parallelForOnWorkers(taskCount, fn, ctx)) {
+        return;
+    }
+
+    /* Pool busy (another caller) or nothing to share: run inline */
+    std::unique_lock<std::mutex> job(jobLock_, std::try_to_lock);
+    if (!job.owns_lock() || workers_.empty() || taskCount == 1) {
+        for (size_t i = 0; i < taskCount; ++i) {
+            fn(ctx, i);
+        }
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(stateLock_);
+        fn_    = fn;
+        ctx_   = ctx;
+        total_ = taskCount;
+        flush_ = flushDenormalsEnabled();
+        next_.store(0, std::memory_order_relaxed);
+        active_ = static_cast<unsigned>(workers_.size());
+        ++generation_;
+    }
+    wake_.notify_all();
+
+    runTasks();
+
+    std::unique_lock<std::mutex> lock(stateLock_);
+    done_.wait(lock, [&] { return active_ == 0; });
+    fn_  = nullptr;
+    ctx_ = nullptr;
+}
+
+} // namespace DspProcessor
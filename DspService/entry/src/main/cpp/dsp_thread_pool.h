@@ -0,0 +1,86 @@
+/**
+ * dsp_thread_pool.h — process-wide worker pool for large offline buffers
+ *
+ * Created once per process; parallelFor() hands out task indices through a
+ * shared atomic counter, with the calling thread working alongside the
+ * pool. If another caller already owns the pool the tasks simply run on
+ * the calling thread, so concurrent Binder threads never block each other.
+ * Called on a Scheduler worker, the tasks go to the idle scheduler workers
+ * instead (Scheduler::parallelForOnWorkers()), so async requests never
+ * have the pool's threads runnable next to one worker per core.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace DspProcessor {
+
+class WorkerPool {
+public:
+    /** The process-wide pool (sized to hardware_concurrency on first use). */
+    static WorkerPool& instance();
+
+    ~WorkerPool();
+
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+
+    /**
+     * Resize the pool. Blocks until any running parallelFor() finishes.
+     * @param threads  total threads including the caller; 0 = hardware_concurrency
+     */
+    void setThreadCount(unsigned threads);
+
+    /** Total threads including the caller (1 = single-threaded). */
+    unsigned threadCount() const;
+
+    /**
+     * Run fn(ctx, i) for every i in [0, taskCount) and wait for all of them.
+     * Task order across threads is unspecified; fn must be thread-safe.
+     * Every task sees the caller's flushDenormalsEnabled() state.
+     */
+    void parallelFor(size_t taskCount, void (*fn)(void* ctx, size_t task), void* ctx);
+
+    /** Convenience overload for lambdas / functors. */
+    template <typename Fn>
+    void parallelFor(size_t taskCount, Fn&& fn)
+    {
+        using F = std::remove_reference_t<Fn>;
+        parallelFor(taskCount,
+                    [](void* ctx, size_t task) { (*static_cast<F*>(ctx))(task); },
+                    const_cast<void*>(static_cast<const void*>(&fn)));
+    }
+
+private:
+    WorkerPool();
+
+    void startWorkers(unsigned count);
+    void stopWorkers();
+    void workerLoop(unsigned seen);
+    void runTasks();
+
+    std::vector<std::thread> workers_;    /* resized under jobLock_          */
+    std::atomic<unsigned>    threads_ { 1 }; /* workers_.size() + 1, lock-free */
+    std::mutex               jobLock_;    /* one parallelFor() at a time     */
+    std::mutex               stateLock_;  /* guards the fields below          */
+    std::condition_variable  wake_;
+    std::condition_variable  done_;
+    unsigned                 generation_ = 0;
+    unsigned                 active_     = 0;
+    bool                     stop_       = false;
+
+    void (*fn_)(void*, size_t) = nullptr;
+    void*               ctx_   = nullptr;
+    size_t              total_ = 0;
+    bool                flush_ = false;   /* caller's denormal mode          */
+    std::atomic<size_t> next_ { 0 };
+};
+
+} // namespace DspProcessor
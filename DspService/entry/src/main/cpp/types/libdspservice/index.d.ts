@@ -3,24 +3,386 @@
  * Used by the ArkTS compiler for type-checking.
  */
 
+/** Raw PCM bytes: a whole ArrayBuffer or a view into one */
+export type PcmBuffer = ArrayBuffer | Uint8Array | Float32Array;
+
+/**
+ * Per-channel levels measured in the same pass as the processing.
+ * Levels are linear (1.0 = full scale); arrays have one entry per channel.
+ */
+export class DspMeter {
+  channels: number;
+  /** Frames per channel the levels cover */
+  frames: number;
+  inPeak: number[];
+  outPeak: number[];
+  inRms: number[];
+  outRms: number[];
+  /** Samples driven into saturation (|input × gain| > 1; bypass: |output| > 1) */
+  clipCount: number[];
+  clipTotal: number;
+  /** BS.1770 short-term loudness in LUFS (-Infinity for silence); with sampleRate only */
+  loudnessLufs?: number;
+}
+
 /** Result object returned by processAudio() */
 export class DspProcessResult {
-  /** Processed float32 interleaved PCM (same byte size as input) */
+  /**
+   * Processed float32 interleaved PCM (same byte size as input). Backed by a
+   * native pooled block that is recycled once the buffer is collected.
+   */
   outputBuffer: ArrayBuffer;
   /** Wall-clock DSP processing duration in nanoseconds */
   processingTimeNs: number;
+  /** Present when metered (channels given, whole frames) */
+  meter?: DspMeter;
 }
 
 /**
  * Process a block of float32 interleaved PCM.
  *
- * @param inputBuffer  ArrayBuffer of float32 PCM samples
+ * @param inputBuffer  float32 PCM samples
  * @param gain         linear gain (0.0 ~ 2.0)
  * @param bypass       0 = apply gain+softclip, 1 = copy input unchanged
+ * @param channels     1..8 interleaved channels: meter each channel in the
+ *                     same pass (result.meter); 0 / omitted = no meter
+ * @param sampleRate   with channels: also measure loudness (runs serially)
  * @returns DspProcessResult
  */
 export declare function processAudio(
-  inputBuffer: ArrayBuffer,
+  inputBuffer: PcmBuffer,
   gain: number,
-  bypass: number
+  bypass: number,
+  channels?: number,
+  sampleRate?: number
 ): DspProcessResult;
+
+/** Result object returned by processSharedMemory() */
+export class DspSharedResult {
+  /**
+   * AUDIO_STATUS_DONE (2) on success, AUDIO_STATUS_ERROR (-1) on failure;
+   * the async variants may also settle with AUDIO_STATUS_BUSY (-2) when the
+   * scheduler refused the request (it was not run)
+   */
+  status: number;
+  /** Wall-clock DSP processing duration in nanoseconds */
+  processingTimeNs: number;
+}
+
+/**
+ * Process float32 PCM straight into caller-owned memory: nothing is
+ * allocated or copied. output may be the very same buffer as input
+ * (in place) but must not partially overlap it; it must be at least as
+ * large as input and both views must be 4-byte aligned.
+ *
+ * @returns status AUDIO_STATUS_DONE (2), or AUDIO_STATUS_ERROR (-1) when
+ *          the buffers are rejected
+ */
+export declare function processAudioInto(
+  input: PcmBuffer,
+  output: PcmBuffer,
+  gain: number,
+  bypass: number
+): DspSharedResult;
+
+/**
+ * Map an Ashmem fd and process it in place (zero-copy).
+ * Reads all parameters from the AudioSharedHeader at offset 0 (v2, or the
+ * packed v1 layout), runs the DSP from inputOffset into outputOffset, and
+ * writes status / processingTimeNs back into the header slots of that
+ * version. The fd is not closed.
+ *
+ * A header flagged AUDIO_FLAG_TRACE also gets the service line of its
+ * trace block filled in.
+ *
+ * @param fd         Ashmem file descriptor
+ * @param size       total Ashmem size in bytes
+ * @param receiveNs  traceNow() when the request arrived (default: now)
+ * @returns DspSharedResult
+ */
+export declare function processSharedMemory(
+  fd: number,
+  size: number,
+  receiveNs?: number
+): DspSharedResult;
+
+/**
+ * Map an AudioStreamBuffer region and start draining its input ring.
+ * Blocks then flow through the shared rings without further IPC.
+ * The stream belongs to clientId and is closed once clientPid exits or
+ * no block has moved for the idle timeout (setIdleTimeout).
+ *
+ * @param fd         stream region file descriptor (not closed)
+ * @param size       total region size in bytes
+ * @param clientId   Binder calling uid of the owner (default 0 = local)
+ * @param clientPid  Binder calling pid of the owner (default 0 = unknown,
+ *                   idle timeout only)
+ * @returns stream id (> 0), or -1 on failure
+ */
+export declare function openStream(
+  fd: number,
+  size: number,
+  clientId?: number,
+  clientPid?: number
+): number;
+
+/**
+ * Close a stream opened by openStream() and release its mapping.
+ * @param streamId  id returned by openStream()
+ * @param clientId  Binder calling uid; must be the owner's (default 0 = local)
+ * @returns 2 (AUDIO_STATUS_DONE) on success, -1 for an unknown id or
+ *          another client's stream
+ */
+export declare function closeStream(streamId: number, clientId?: number): number;
+
+/** Close every open stream (service teardown). */
+export declare function closeAllStreams(): void;
+
+/**
+ * Resize the process-wide DSP worker pool used for large buffers.
+ * @param threads  total threads including the caller; 0 = one per core
+ * @returns the resulting thread count
+ */
+export declare function setWorkerThreads(threads: number): number;
+
+/**
+ * Map a shared region once (pre-faulted) and register a processing session.
+ * The header geometry and any processing chain are fixed at this point.
+ * The session belongs to clientId: other uids cannot process or close it.
+ * It is reclaimed once clientPid exits or after the idle timeout
+ * (setIdleTimeout).
+ *
+ * @param fd         region file descriptor (not closed)
+ * @param size       total region size in bytes
+ * @param clientId   Binder calling uid of the owner (default 0 = local)
+ * @param clientPid  Binder calling pid of the owner (default 0 = unknown,
+ *                   idle timeout only)
+ * @returns session id (> 0), or -1 on failure
+ */
+export declare function openSession(
+  fd: number,
+  size: number,
+  clientId?: number,
+  clientPid?: number
+): number;
+
+/**
+ * Process frames [frameOffset, frameOffset + frameCount) of a session in place.
+ * gain / bypass are re-read from the header; chain state carries over.
+ *
+ * @param clientId  Binder calling uid; must be the owner's (default 0 = local)
+ * @returns DspSharedResult (status is also written into the header, except
+ *          for an unknown id or another client's session)
+ */
+export declare function processSession(
+  sessionId: number,
+  frameOffset: number,
+  frameCount: number,
+  receiveNs?: number,
+  clientId?: number
+): DspSharedResult;
+
+/**
+ * Close a session opened by openSession() and unmap its region.
+ * @param clientId  Binder calling uid; must be the owner's (default 0 = local)
+ * @returns 2 (AUDIO_STATUS_DONE) on success, -1 for an unknown id or
+ *          another client's session
+ */
+export declare function closeSession(sessionId: number, clientId?: number): number;
+
+/**
+ * Reclaim sessions unused, and streams without a block, for this long
+ * (default 5 minutes).
+ * @param ms  0 = only when the owning process exits
+ */
+export declare function setIdleTimeout(ms: number): void;
+
+/** Close every open session (service teardown). */
+export declare function closeAllSessions(): void;
+
+/** Result object returned by processBatch() */
+export class DspBatchResult {
+  /**
+   * AUDIO_STATUS_DONE (2) when the job table was valid, -1 otherwise,
+   * -2 (AUDIO_STATUS_BUSY) when processBatchAsync() was refused
+   */
+  status: number;
+  /** Wall-clock duration of the whole batch in nanoseconds */
+  processingTimeNs: number;
+  /** Number of jobs whose own status is -1 */
+  jobsFailed: number;
+}
+
+/**
+ * Map a batch region (AudioBatchHeader + AudioBatchJob table + PCM) and
+ * process every job in one call. Per-job status and processingTimeNs are
+ * written into the job table. The fd is not closed.
+ *
+ * @param fd    region file descriptor
+ * @param size  total region size in bytes
+ * @returns DspBatchResult
+ */
+export declare function processBatch(
+  fd: number,
+  size: number
+): DspBatchResult;
+
+/**
+ * Promise variant of processAudio(). The DSP runs on a native scheduler
+ * worker so the JS thread stays responsive; do not modify inputBuffer until
+ * it settles. Rejects with "dsp service busy" when the scheduler is full.
+ */
+export declare function processAudioAsync(
+  inputBuffer: PcmBuffer,
+  gain: number,
+  bypass: number,
+  channels?: number,
+  sampleRate?: number
+): Promise<DspProcessResult>;
+
+/**
+ * Promise variant of processAudioInto(); rejects if the buffers are
+ * rejected. Leave both buffers untouched until it settles.
+ */
+export declare function processAudioIntoAsync(
+  input: PcmBuffer,
+  output: PcmBuffer,
+  gain: number,
+  bypass: number
+): Promise<DspSharedResult>;
+
+/**
+ * Promise variant of processSharedMemory(). Keep fd open until it settles.
+ *
+ * @param clientId  scheduler queue of the request: the Binder calling uid
+ *                  (rpc.IPCSkeleton.getCallingUid()); default 0 = local
+ */
+export declare function processSharedMemoryAsync(
+  fd: number,
+  size: number,
+  receiveNs?: number,
+  clientId?: number
+): Promise<DspSharedResult>;
+
+/**
+ * Promise variant of processSession(). A client's requests run in order;
+ * different clients share the workers fairly. The request is due within
+ * the playback time of frameCount frames after receiveNs. clientId must
+ * be the session owner's.
+ */
+export declare function processSessionAsync(
+  sessionId: number,
+  frameOffset: number,
+  frameCount: number,
+  receiveNs?: number,
+  clientId?: number
+): Promise<DspSharedResult>;
+
+/**
+ * Promise variant of processBatch(). Keep fd open until it settles.
+ * Runs in the batch class: interactive requests go first.
+ */
+export declare function processBatchAsync(
+  fd: number,
+  size: number,
+  clientId?: number
+): Promise<DspBatchResult>;
+
+/** Counters returned by getAsyncStats() */
+export class AsyncJobStats {
+  /** Jobs queued but not yet picked up by a worker */
+  queued: number;
+  /** Jobs currently executing */
+  inFlight: number;
+  /** Jobs settled (resolved or rejected) since the library was loaded */
+  completed: number;
+}
+
+/** Snapshot of the async job counters, for caller-side backpressure. */
+export declare function getAsyncStats(): AsyncJobStats;
+
+/**
+ * Restart the request scheduler with new limits. Requests already queued
+ * still run first.
+ *
+ * @param workers               worker threads, 0 = one per core (each pinned)
+ * @param maxQueuedPerClient    waiting requests per client before -2 (default 16)
+ * @param maxQueuedTotal        waiting requests overall before -2 (default 128)
+ * @param maxInFlightPerClient  requests of one client running at once (default 1)
+ * @param maxQueuedLocal        waiting calls without a clientId before -2
+ *                              (default 0 = maxQueuedTotal only)
+ * @param maxInFlightLocal      calls without a clientId running at once
+ *                              (default 0 = every worker)
+ * @returns the resulting worker count
+ */
+export declare function configureScheduler(
+  workers: number,
+  maxQueuedPerClient?: number,
+  maxQueuedTotal?: number,
+  maxInFlightPerClient?: number,
+  maxQueuedLocal?: number,
+  maxInFlightLocal?: number
+): number;
+
+/** Per-client counters in DspSchedulerStats */
+export class DspClientStats {
+  /** clientId passed with the requests (0 = local) */
+  client: number;
+  /** Waiting / running now */
+  queued: number;
+  inFlight: number;
+  /** Admitted, finished and refused (AUDIO_STATUS_BUSY) since load */
+  submitted: number;
+  completed: number;
+  rejected: number;
+  /** Requests that finished after their deadline */
+  deadlineMisses: number;
+  /** Arrival (receiveNs) to start on a worker, in nanoseconds */
+  queueTimeAvgNs: number;
+  queueTimeMaxNs: number;
+  queueTimeLastNs: number;
+  /** Start to end on the worker, in nanoseconds */
+  runTimeAvgNs: number;
+}
+
+/** Returned by getSchedulerStats() */
+export class DspSchedulerStats {
+  workers: number;
+  queued: number;
+  inFlight: number;
+  clients: DspClientStats[];
+}
+
+/** Snapshot of the scheduler queues and per-client queue-time metrics. */
+export declare function getSchedulerStats(): DspSchedulerStats;
+
+/** Counters returned by getBufferPoolStats() */
+export class BufferPoolStats {
+  /** processAudio outputs served from a recycled block */
+  hits: number;
+  /** processAudio outputs that needed a fresh allocation */
+  misses: number;
+  /** Bytes held in the pool's free lists */
+  cachedBytes: number;
+  /** Blocks currently owned by live ArrayBuffers or jobs */
+  outstanding: number;
+}
+
+/** Snapshot of the output buffer pool counters. */
+export declare function getBufferPoolStats(): BufferPoolStats;
+
+/**
+ * CLOCK_MONOTONIC in nanoseconds — the clock of every trace stamp, shared
+ * with HostApp. Take it first thing in onRemoteMessageRequest and pass it
+ * on as receiveNs.
+ */
+export declare function traceNow(): number;
+
+/** Record traced requests into the native trace buffer (off by default). */
+export declare function setTracing(enabled: boolean): void;
+
+/**
+ * Write the native trace buffer as Chrome trace-event JSON.
+ * @returns false on an I/O error or when tracing is compiled out
+ */
+export declare function dumpTrace(path: string): boolean;
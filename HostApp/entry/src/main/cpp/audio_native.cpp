@@ -2,21 +2,16 @@
  * audio_native.cpp — HostApp C++ helper implementations
  *
  * Provides:
- *   - Sine-wave PCM generation (float32, interleaved)
- *   - AudioSharedHeader serialisation
- *   - PCM-16 WAV file writer
+ *   - Sine-wave PCM generation (float32, interleaved; see SignalGenerator)
+ *   - AudioSharedHeader serialisation (optionally with a chain descriptor)
+ *   - One-shot WAV file writer (on top of WavWriter)
  */
 
 #include "audio_native.h"
 #include "AudioSharedBuffer.h"
 
-#include <cmath>
+#include <algorithm>
 #include <cstring>
-#include <fstream>
-
-#ifndef M_PI
-#define M_PI 3.14159265358979323846
-#endif
 
 namespace HostAudio {
 
@@ -26,49 +21,123 @@ namespace HostAudio {
 std::vector<uint8_t> generateSineWave(int sampleRate, int frames,
                                       int channels, float freqHz)
 {
-    const int totalSamples = frames * channels;
-    std::vector<float> pcm(totalSamples);
-
-    for (int i = 0; i < frames; ++i) {
-        float s = std::sin(2.0f * static_cast<float>(M_PI) * freqHz
-                           * static_cast<float>(i) / static_cast<float>(sampleRate));
-        for (int ch = 0; ch < channels; ++ch) {
-            pcm[i * channels + ch] = s;
-        }
+    if (sampleRate <= 0 || frames <= 0 || channels <= 0) {
+        return {};
+    }
+    std::vector<uint8_t> out(static_cast<size_t>(frames) * channels * sizeof(float));
+    if (!generateSineWaveInto(sampleRate, channels, freqHz,
+                              reinterpret_cast<float*>(out.data()), static_cast<size_t>(frames))) {
+        return {};
     }
-
-    std::vector<uint8_t> out(totalSamples * sizeof(float));
-    std::memcpy(out.data(), pcm.data(), out.size());
     return out;
 }
 
+bool generateSineWaveInto(int sampleRate, int channels, float freqHz,
+                          float* dst, size_t frames)
+{
+    if (sampleRate <= 0 || channels <= 0) {
+        return false;
+    }
+    SignalConfig cfg;
+    cfg.type       = SignalType::Sine;
+    cfg.sampleRate = static_cast<uint32_t>(sampleRate);
+    cfg.channels   = static_cast<uint32_t>(channels);
+    cfg.toneHz[0]  = freqHz;
+    return generateSignal(cfg, dst, frames);
+}
+
 /* ------------------------------------------------------------------ */
 /*  buildHeader                                                         */
 /* ------------------------------------------------------------------ */
 std::vector<uint8_t> buildHeader(int sampleRate, int channels, int frames,
                                  float gain, int bypass)
 {
+    return buildFormatHeader(sampleRate, channels, frames, gain, bypass,
+                             AUDIO_FORMAT_FLOAT32, 0u);
+}
+
+std::vector<uint8_t> buildFormatHeader(int sampleRate, int channels, int frames,
+                                       float gain, int bypass, uint32_t format,
+                                       uint32_t flags, uint32_t outputRate, uint32_t srcQuality)
+{
+    std::vector<uint8_t> out(audioShmHeaderSizeFor(flags));
+    if (!writeFormatHeader(out.data(), out.size(), sampleRate, channels, frames,
+                           gain, bypass, format, flags, AUDIO_SHM_PCM_ALIGN, outputRate, srcQuality)) {
+        return {};
+    }
+    return out;
+}
+
+bool writeFormatHeader(void* dst, size_t capacity, int sampleRate, int channels,
+                       int frames, float gain, int bypass, uint32_t format,
+                       uint32_t flags, uint32_t pcmAlign, uint32_t outputRate, uint32_t srcQuality)
+{
+    const uint32_t bps = audioFormatBytes(format);
+    if (bps == 0 || !dst || capacity < audioShmHeaderSizeFor(flags)
+        || pcmAlign == 0 || (pcmAlign & (pcmAlign - 1u)) != 0) {
+        return false;
+    }
+
+    const uint32_t outFrames = audioSrcCapacityFrames(static_cast<uint32_t>(frames),
+                                                      static_cast<uint32_t>(sampleRate), outputRate);
+    const AudioShmLayout layout = audioShmRateLayout(static_cast<uint32_t>(frames), outFrames,
+                                                     static_cast<uint32_t>(channels),
+                                                     format, 0, flags, pcmAlign);
     AudioSharedHeader hdr;
     std::memset(&hdr, 0, sizeof(hdr));
 
     hdr.magic        = AUDIO_SHM_MAGIC;
     hdr.version      = AUDIO_SHM_VERSION;
+    hdr.headerSize   = layout.headerSize;
     hdr.sampleRate   = static_cast<uint32_t>(sampleRate);
     hdr.channels     = static_cast<uint32_t>(channels);
     hdr.frames       = static_cast<uint32_t>(frames);
-    hdr.format       = AUDIO_FORMAT_FLOAT32;
-    hdr.inputOffset  = AUDIO_SHM_HEADER_SIZE;
-    hdr.outputOffset = AUDIO_SHM_HEADER_SIZE
-                       + static_cast<uint32_t>(frames)
-                       * static_cast<uint32_t>(channels)
-                       * static_cast<uint32_t>(sizeof(float));
-    hdr.status       = AUDIO_STATUS_IDLE;
-    hdr.processingTimeNs = 0;
+    hdr.format       = format;
+    hdr.flags        = flags;
+    hdr.inputOffset  = layout.inputOffset;
+    hdr.outputOffset = layout.outputOffset;
     hdr.gain         = gain;
     hdr.bypass       = static_cast<uint32_t>(bypass);
+    hdr.outputRate   = outputRate;
+    hdr.srcQuality   = srcQuality;
+
+    /* Control block mirrors gain / bypass; used with AUDIO_FLAG_LIVE_CONTROL */
+    hdr.control.gain   = gain;
+    hdr.control.bypass = static_cast<uint32_t>(bypass);
+
+    hdr.status           = AUDIO_STATUS_IDLE;
+    hdr.processingTimeNs = 0;
+
+    std::memcpy(dst, &hdr, sizeof(hdr));
+    if (flags & AUDIO_FLAG_TRACE) {
+        /* No stamps yet: requestId 0 matches no service echo */
+        std::memset(static_cast<uint8_t*>(dst) + AUDIO_SHM_TRACE_OFFSET, 0, AUDIO_SHM_TRACE_SIZE);
+    }
+    if (flags & AUDIO_FLAG_METER) {
+        /* valid = 0 until the service has metered a request */
+        std::memset(static_cast<uint8_t*>(dst) + audioShmMeterOffset(flags), 0, AUDIO_SHM_METER_SIZE);
+    }
+    return true;
+}
 
-    std::vector<uint8_t> out(sizeof(AudioSharedHeader));
+std::vector<uint8_t> buildChainHeader(int sampleRate, int channels, int frames,
+                                      const AudioChainDescriptor& chain)
+{
+    std::vector<uint8_t> out = buildHeader(sampleRate, channels, frames, 1.0f, 0);
+
+    const AudioShmLayout layout = audioShmLayout(static_cast<uint32_t>(frames),
+                                                 static_cast<uint32_t>(channels),
+                                                 AUDIO_FORMAT_FLOAT32, 1, AUDIO_SHM_PCM_ALIGN);
+    AudioSharedHeader hdr;
+    std::memcpy(&hdr, out.data(), sizeof(hdr));
+    hdr.chainOffset  = layout.chainOffset;
+    hdr.inputOffset  = layout.inputOffset;
+    hdr.outputOffset = layout.outputOffset;
+
+    /* Header, padding up to the descriptor, then the descriptor itself */
+    out.assign(layout.chainOffset + sizeof(AudioChainDescriptor), 0);
     std::memcpy(out.data(), &hdr, sizeof(hdr));
+    std::memcpy(out.data() + layout.chainOffset, &chain, sizeof(AudioChainDescriptor));
     return out;
 }
 
@@ -76,68 +145,24 @@ std::vector<uint8_t> buildHeader(int sampleRate, int channels, int frames,
 /*  WAV file writer                                                     */
 /* ------------------------------------------------------------------ */
 
-#pragma pack(push, 1)
-struct WavHeader {
-    char     riffId[4];      /* "RIFF"                              */
-    uint32_t riffSize;       /* file size − 8                       */
-    char     waveId[4];      /* "WAVE"                              */
-    char     fmtId[4];       /* "fmt "                              */
-    uint32_t fmtSize;        /* 16 for PCM                          */
-    uint16_t audioFormat;    /* 1 = PCM                             */
-    uint16_t numChannels;
-    uint32_t sampleRate;
-    uint32_t byteRate;       /* sampleRate * numChannels * bitDepth/8 */
-    uint16_t blockAlign;     /* numChannels * bitDepth/8            */
-    uint16_t bitsPerSample;  /* 16                                  */
-    char     dataId[4];      /* "data"                              */
-    uint32_t dataSize;       /* PCM-16 data size in bytes           */
-};
-#pragma pack(pop)
-
 bool writeWavFile(const std::string& path, const void* pcmFloat32,
-                  int byteCount, int sampleRate, int channels, int frames)
+                  int byteCount, int sampleRate, int channels, int frames,
+                  WavSampleFormat format)
 {
-    if (!pcmFloat32 || byteCount <= 0) {
+    if (!pcmFloat32 || byteCount <= 0 || sampleRate <= 0 || channels <= 0 || frames <= 0) {
         return false;
     }
 
-    const int numSamples = frames * channels;
-    const float* src = static_cast<const float*>(pcmFloat32);
-
-    /* Convert float32 → int16 with clamping */
-    std::vector<int16_t> pcm16(numSamples);
-    for (int i = 0; i < numSamples; ++i) {
-        float s = src[i];
-        if (s >  1.0f) s =  1.0f;
-        if (s < -1.0f) s = -1.0f;
-        pcm16[i] = static_cast<int16_t>(s * 32767.0f);
-    }
+    /* Never read past the buffer, whatever frames claims */
+    const size_t bufferFrames = static_cast<size_t>(byteCount) / (sizeof(float) * channels);
+    const size_t numFrames = std::min(static_cast<size_t>(frames), bufferFrames);
 
-    const uint32_t dataSize = static_cast<uint32_t>(numSamples) * sizeof(int16_t);
-
-    WavHeader hdr;
-    std::memcpy(hdr.riffId, "RIFF", 4);
-    std::memcpy(hdr.waveId, "WAVE", 4);
-    std::memcpy(hdr.fmtId,  "fmt ", 4);
-    std::memcpy(hdr.dataId, "data", 4);
-    hdr.riffSize      = 36u + dataSize;
-    hdr.fmtSize       = 16u;
-    hdr.audioFormat   = 1u;  /* PCM */
-    hdr.numChannels   = static_cast<uint16_t>(channels);
-    hdr.sampleRate    = static_cast<uint32_t>(sampleRate);
-    hdr.bitsPerSample = 16u;
-    hdr.byteRate      = static_cast<uint32_t>(sampleRate) * channels * 2u;
-    hdr.blockAlign    = static_cast<uint16_t>(channels * 2);
-    hdr.dataSize      = dataSize;
-
-    std::ofstream ofs(path, std::ios::binary | std::ios::trunc);
-    if (!ofs.is_open()) {
+    WavWriter writer;
+    if (!writer.open(path, static_cast<uint32_t>(sampleRate), static_cast<uint32_t>(channels), format)) {
         return false;
     }
-    ofs.write(reinterpret_cast<const char*>(&hdr),       sizeof(WavHeader));
-    ofs.write(reinterpret_cast<const char*>(pcm16.data()), dataSize);
-
-    return ofs.good();
+    const bool ok = writer.append(static_cast<const float*>(pcmFloat32), numFrames);
+    return writer.finalize() && ok;
 }
 
 } // namespace HostAudio
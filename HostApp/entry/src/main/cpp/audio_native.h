@@ -3,16 +3,24 @@
  *
  * Functions exposed to ArkTS via N-API (see napi_init.cpp):
  *   generateSineWave  → ArrayBuffer (float32 PCM)
- *   buildHeader       → number[]   (128 raw bytes of AudioSharedHeader)
+ *   buildHeader       → number[]   (192 raw bytes of AudioSharedHeader)
+ *   buildHeaderInto   → boolean    (same bytes, written into an ArrayBuffer)
  *   writeWavFile      → boolean
+ *
+ * Streaming WAV output lives in wav_writer.h.
  */
 
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
 #include <string>
 #include <vector>
 
+#include "AudioSharedBuffer.h"
+#include "signal_generator.h"
+#include "wav_writer.h"
+
 namespace HostAudio {
 
 /**
@@ -21,35 +29,101 @@ namespace HostAudio {
  * @param frames      number of sample frames
  * @param channels    number of channels (1 or 2)
  * @param freqHz      sine frequency in Hz (e.g. 440.0)
- * @return raw bytes of the float32 PCM (size = frames * channels * 4)
+ * @return raw bytes of the float32 PCM (size = frames * channels * 4),
+ *         empty for invalid parameters
  */
 std::vector<uint8_t> generateSineWave(int sampleRate, int frames,
                                       int channels, float freqHz);
 
 /**
- * Serialize an AudioSharedHeader into a 128-byte byte vector.
+ * Same as generateSineWave(), rendered straight into @p dst
+ * (frames × channels floats), e.g. an ArrayBuffer or a mapped region.
+ * @return false for invalid parameters or a frequency above Nyquist
+ */
+bool generateSineWaveInto(int sampleRate, int channels, float freqHz,
+                          float* dst, size_t frames);
+
+/**
+ * Serialize a v2 AudioSharedHeader into a 192-byte byte vector. The input
+ * PCM starts at AUDIO_SHM_HEADER_SIZE and the output on the next
+ * AUDIO_SHM_PCM_ALIGN boundary after it (see audioShmLayout()).
  * @param sampleRate  stream sample rate
  * @param channels    number of channels
  * @param frames      number of frames
  * @param gain        DSP gain parameter
  * @param bypass      0 = process, 1 = bypass
- * @return 128 bytes suitable for writing to offset 0 of the Ashmem
+ * @return AUDIO_SHM_HEADER_SIZE bytes for offset 0 of the Ashmem
  */
 std::vector<uint8_t> buildHeader(int sampleRate, int channels, int frames,
                                  float gain, int bypass);
 
 /**
- * Write a PCM-16 WAV file from a float32 PCM buffer.
- * Samples are clamped to [-1, 1] and scaled to int16.
+ * Same as buildHeader() for any AUDIO_FORMAT_* PCM layout.
+ * Both regions are frames * channels * audioFormatBytes(format) bytes
+ * (see audioShmFormatTotalSize()).
+ * @param format  AUDIO_FORMAT_* used for both input and output PCM
+ * @param flags   AUDIO_FLAG_* (e.g. AUDIO_FLAG_DITHER for integer output,
+ *                AUDIO_FLAG_LIVE_CONTROL to allow writeLiveControl() updates;
+ *                the control block always starts out as gain / bypass;
+ *                AUDIO_FLAG_TRACE / AUDIO_FLAG_METER append a zeroed
+ *                AudioTraceBlock / AudioMeterBlock and move the PCM regions
+ *                behind them, see audioShmFlagsLayout())
+ * @param outputRate  convert to this rate in the service (0 = none); the
+ *                    output region then holds audioSrcCapacityFrames()
+ *                    frames, see audioShmRateLayout()
+ * @param srcQuality  AUDIO_SRC_QUALITY_* of the conversion
+ * @return audioShmHeaderSizeFor(flags) bytes, or an empty vector for an
+ *         unknown format
+ */
+std::vector<uint8_t> buildFormatHeader(int sampleRate, int channels, int frames,
+                                       float gain, int bypass, uint32_t format,
+                                       uint32_t flags, uint32_t outputRate = 0,
+                                       uint32_t srcQuality = AUDIO_SRC_QUALITY_DEFAULT);
+
+/**
+ * buildFormatHeader() serialised straight into caller memory (e.g. an
+ * ArrayBuffer that is later written to Ashmem) — no intermediate vector.
+ * @param dst       destination, any alignment
+ * @param capacity  bytes available at dst (needs audioShmHeaderSizeFor(flags))
+ * @param pcmAlign  alignment of the PCM regions: AUDIO_SHM_PCM_ALIGN, or
+ *                  AUDIO_SHM_PAGE_ALIGN to give each region its own pages
+ * @return false for an unknown format, an alignment that is not a power of
+ *         two, or a too-small destination
+ */
+bool writeFormatHeader(void* dst, size_t capacity, int sampleRate, int channels,
+                       int frames, float gain, int bypass, uint32_t format,
+                       uint32_t flags, uint32_t pcmAlign = AUDIO_SHM_PCM_ALIGN,
+                       uint32_t outputRate = 0, uint32_t srcQuality = AUDIO_SRC_QUALITY_DEFAULT);
+
+/**
+ * Serialize an AudioSharedHeader followed by a processing-chain descriptor.
+ * The descriptor sits at offset AUDIO_SHM_HEADER_SIZE and the input / output
+ * PCM regions follow it on AUDIO_SHM_PCM_ALIGN boundaries
+ * (see audioShmLayout() / audioShmChainTotalSize()).
+ * @param sampleRate  stream sample rate
+ * @param channels    number of channels
+ * @param frames      number of frames
+ * @param chain       stages to run instead of gain / bypass
+ * @return header + descriptor bytes for offset 0 of the Ashmem
+ */
+std::vector<uint8_t> buildChainHeader(int sampleRate, int channels, int frames,
+                                      const AudioChainDescriptor& chain);
+
+/**
+ * Write a WAV file from a float32 PCM buffer through WavWriter, so memory
+ * use does not grow with the buffer length.
  * @param path       destination file path
  * @param pcmFloat32 pointer to float32 interleaved PCM data
- * @param byteCount  size of pcmFloat32 in bytes
+ * @param byteCount  size of pcmFloat32 in bytes; at most
+ *                   byteCount / (4 * channels) frames are written
  * @param sampleRate stream sample rate
  * @param channels   number of channels
  * @param frames     number of sample frames
+ * @param format     16-bit / 24-bit PCM or 32-bit float data
  * @return true on success
  */
 bool writeWavFile(const std::string& path, const void* pcmFloat32,
-                  int byteCount, int sampleRate, int channels, int frames);
+                  int byteCount, int sampleRate, int channels, int frames,
+                  WavSampleFormat format = WavSampleFormat::Pcm16);
 
 } // namespace HostAudio
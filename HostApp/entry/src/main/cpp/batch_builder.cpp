@@ -0,0 +1,177 @@
+/**
+ * batch_builder.cpp — packs many clips into one PROCESS_BATCH_CODE region
+ */
+
+#include "batch_builder.h"
+#include "shared_memory.h"
+
+#include <cstring>
+#include <limits>
+
+namespace HostAudio {
+
+namespace {
+
+uint64_t alignUp(uint64_t v)
+{
+    return (v + AUDIO_BATCH_ALIGN - 1u) & ~static_cast<uint64_t>(AUDIO_BATCH_ALIGN - 1u);
+}
+
+} // namespace
+
+BatchBuilder::BatchBuilder(bool inPlace)
+    : inPlace_(inPlace)
+{
+}
+
+int32_t BatchBuilder::addClip(const float* pcm, uint32_t sampleRate, uint32_t channels,
+                              uint32_t frames, float gain, uint32_t bypass)
+{
+    return append(pcm, sampleRate, channels, frames, gain, bypass, nullptr);
+}
+
+int32_t BatchBuilder::addChainClip(const float* pcm, uint32_t sampleRate, uint32_t channels,
+                                   uint32_t frames, const AudioChainDescriptor& chain)
+{
+    return append(pcm, sampleRate, channels, frames, 1.0f, 0u, &chain);
+}
+
+int32_t BatchBuilder::append(const float* pcm, uint32_t sampleRate, uint32_t channels,
+                             uint32_t frames, float gain, uint32_t bypass,
+                             const AudioChainDescriptor* chain)
+{
+    if (!pcm || channels == 0 || frames == 0 || jobs_.size() >= AUDIO_BATCH_MAX_JOBS) {
+        return -1;
+    }
+
+    const uint64_t pcmBytes = static_cast<uint64_t>(frames) * channels * sizeof(float);
+
+    Clip clip {};
+    clip.pcm = pcm;
+    clip.inputRel = dataBytes_;
+    uint64_t next = alignUp(dataBytes_ + pcmBytes);
+    clip.outputRel = clip.inputRel;
+    if (!inPlace_) {
+        clip.outputRel = next;
+        next = alignUp(next + pcmBytes);
+    }
+    if (chain) {
+        clip.hasChain = true;
+        clip.chainIndex = chains_.size();
+        clip.chainRel = next;
+        next = alignUp(next + sizeof(AudioChainDescriptor));
+        chains_.push_back(*chain);
+    }
+
+    AudioBatchJob job {};
+    job.frames     = frames;
+    job.channels   = channels;
+    job.sampleRate = sampleRate;
+    job.format     = AUDIO_FORMAT_FLOAT32;
+    job.gain       = gain;
+    job.bypass     = bypass;
+    job.status     = AUDIO_STATUS_IDLE;
+
+    dataBytes_ = next;
+    jobs_.push_back(job);
+    clips_.push_back(clip);
+    return static_cast<int32_t>(jobs_.size() - 1);
+}
+
+void BatchBuilder::clear()
+{
+    dataBytes_ = 0;
+    jobs_.clear();
+    clips_.clear();
+    chains_.clear();
+}
+
+size_t BatchBuilder::regionSize() const
+{
+    const uint64_t total = audioBatchDataOffset(static_cast<uint32_t>(jobs_.size())) + dataBytes_;
+    /* Offsets in AudioBatchJob are 32-bit */
+    if (total > std::numeric_limits<uint32_t>::max()) {
+        return 0;
+    }
+    return static_cast<size_t>(total);
+}
+
+AudioBatchJob BatchBuilder::job(size_t index) const
+{
+    const uint64_t base = audioBatchDataOffset(static_cast<uint32_t>(jobs_.size()));
+    AudioBatchJob j = jobs_[index];
+    const Clip& c = clips_[index];
+    j.inputOffset  = static_cast<uint32_t>(base + c.inputRel);
+    j.outputOffset = static_cast<uint32_t>(base + c.outputRel);
+    j.chainOffset  = c.hasChain ? static_cast<uint32_t>(base + c.chainRel) : 0u;
+    return j;
+}
+
+AudioBatchHeader BatchBuilder::header() const
+{
+    AudioBatchHeader hdr {};
+    hdr.magic    = AUDIO_BATCH_MAGIC;
+    hdr.version  = AUDIO_BATCH_VERSION;
+    hdr.jobCount = static_cast<uint32_t>(jobs_.size());
+    hdr.flags    = parallel_ ? AUDIO_BATCH_FLAG_PARALLEL : 0u;
+    hdr.status   = AUDIO_STATUS_IDLE;
+    return hdr;
+}
+
+bool BatchBuilder::pack(void* region, size_t size) const
+{
+    const size_t need = regionSize();
+    if (!region || jobs_.empty() || need == 0 || size < need) {
+        return false;
+    }
+
+    auto* bytes = static_cast<uint8_t*>(region);
+    const AudioBatchHeader hdr = header();
+    std::memcpy(bytes, &hdr, sizeof(hdr));
+
+    for (size_t i = 0; i < jobs_.size(); ++i) {
+        const AudioBatchJob j = job(i);
+        std::memcpy(bytes + AUDIO_BATCH_HEADER_SIZE + i * AUDIO_BATCH_JOB_SIZE, &j, sizeof(j));
+        std::memcpy(bytes + j.inputOffset, clips_[i].pcm,
+                    static_cast<size_t>(j.frames) * j.channels * sizeof(float));
+        if (clips_[i].hasChain) {
+            std::memcpy(bytes + j.chainOffset, &chains_[clips_[i].chainIndex],
+                        sizeof(AudioChainDescriptor));
+        }
+    }
+    return true;
+}
+
+bool BatchBuilder::packToFd(int fd) const
+{
+    if (fd < 0 || jobs_.empty() || regionSize() == 0) {
+        return false;
+    }
+
+    const AudioBatchHeader hdr = header();
+    std::vector<AudioBatchJob> table(jobs_.size());
+    for (size_t i = 0; i < jobs_.size(); ++i) {
+        table[i] = job(i);
+    }
+    if (!writeSharedMemory(fd, 0, &hdr, sizeof(hdr))
+        || !writeSharedMemory(fd, AUDIO_BATCH_HEADER_SIZE, table.data(),
+                              table.size() * sizeof(AudioBatchJob))) {
+        return false;
+    }
+
+    for (size_t i = 0; i < table.size(); ++i) {
+        const AudioBatchJob& j = table[i];
+        if (!writeSharedMemory(fd, j.inputOffset, clips_[i].pcm,
+                               static_cast<size_t>(j.frames) * j.channels * sizeof(float))) {
+            return false;
+        }
+        if (clips_[i].hasChain
+            && !writeSharedMemory(fd, j.chainOffset, &chains_[clips_[i].chainIndex],
+                                  sizeof(AudioChainDescriptor))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace HostAudio
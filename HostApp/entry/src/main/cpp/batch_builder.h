@@ -0,0 +1,96 @@
+/**
+ * batch_builder.h — packs many clips into one PROCESS_BATCH_CODE region
+ *
+ * Clips are added one by one; the builder lays out the AudioBatchHeader,
+ * the AudioBatchJob table, and every clip's input / output PCM (and
+ * optional chain descriptor) at AUDIO_BATCH_ALIGN-aligned offsets, then
+ * copies everything into a mapped region or a shared-memory fd in one go.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "AudioSharedBuffer.h"
+
+namespace HostAudio {
+
+class BatchBuilder {
+public:
+    /**
+     * @param inPlace   true = each job's output overwrites its input
+     *                  (halves the region size)
+     */
+    explicit BatchBuilder(bool inPlace = false);
+
+    /**
+     * Add a clip processed with gain + soft clip (or bypass).
+     * The PCM is not copied until pack(); it must stay valid until then.
+     *
+     * @param pcm        float32 interleaved samples (frames × channels)
+     * @return job index, or -1 when the table is full or the clip invalid
+     */
+    int32_t addClip(const float* pcm, uint32_t sampleRate, uint32_t channels,
+                    uint32_t frames, float gain, uint32_t bypass);
+
+    /**
+     * Add a clip processed by a chain instead of gain / bypass.
+     * The descriptor is copied into the builder.
+     */
+    int32_t addChainClip(const float* pcm, uint32_t sampleRate, uint32_t channels,
+                         uint32_t frames, const AudioChainDescriptor& chain);
+
+    /** Let the service spread the jobs over its worker pool. */
+    void setParallel(bool parallel) { parallel_ = parallel; }
+
+    /** Drop all clips. */
+    void clear();
+
+    size_t jobCount() const { return jobs_.size(); }
+
+    /** Bytes needed for the region (0 if it would exceed 4 GiB). */
+    size_t regionSize() const;
+
+    /**
+     * Descriptor of job @p index with absolute offsets, as written by pack().
+     * Use outputOffset / frames × channels to read the result back.
+     */
+    AudioBatchJob job(size_t index) const;
+
+    /**
+     * Write header, job table, input PCM and chain descriptors into a
+     * mapped region of at least regionSize() bytes.
+     */
+    bool pack(void* region, size_t size) const;
+
+    /**
+     * Same as pack() but into a shared-memory fd (see createSharedMemory),
+     * which must be at least regionSize() bytes.
+     */
+    bool packToFd(int fd) const;
+
+private:
+    struct Clip {
+        const float* pcm;
+        uint64_t     inputRel;    /* offsets relative to the data area */
+        uint64_t     outputRel;
+        uint64_t     chainRel;    /* valid when hasChain */
+        bool         hasChain;
+        size_t       chainIndex;
+    };
+
+    int32_t append(const float* pcm, uint32_t sampleRate, uint32_t channels, uint32_t frames,
+                   float gain, uint32_t bypass, const AudioChainDescriptor* chain);
+    AudioBatchHeader header() const;
+
+    bool inPlace_;
+    bool parallel_ = false;
+    uint64_t dataBytes_ = 0;      /* bytes used after the job table */
+    std::vector<AudioBatchJob>        jobs_;    /* offsets filled in by job() */
+    std::vector<Clip>                 clips_;
+    std::vector<AudioChainDescriptor> chains_;
+};
+
+} // namespace HostAudio
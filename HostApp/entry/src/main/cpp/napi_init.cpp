@@ -5,27 +5,149 @@
  *
  *   generateSineWave(sampleRate: number, frames: number,
  *                    channels: number, freqHz: number): ArrayBuffer
- *       Returns a float32 interleaved PCM buffer.
+ *       Returns a float32 interleaved PCM buffer (empty for invalid input).
+ *
+ *   generateSignalInto(buffer: ArrayBuffer, config: SignalConfig): number
+ *       Renders a test signal (sine / multi-tone / log sweep / white or pink
+ *       noise / impulse, see SignalGenerator) straight into buffer; returns
+ *       the frames written or -1 for an invalid config.
+ *
+ *   generateSignalToSharedMemory(fd: number, offset: number, frames: number,
+ *                                config: SignalConfig): boolean
+ *       Same, rendered straight into a shared region (e.g. the input PCM).
  *
  *   buildHeader(sampleRate: number, channels: number, frames: number,
- *               gain: number, bypass: number): number[]
- *       Returns 128 raw bytes of AudioSharedHeader for writing to Ashmem.
+ *               gain: number, bypass: number, format?: number, flags?: number,
+ *               outputRate?: number, srcQuality?: number): number[]
+ *       Returns the raw bytes of a v2 AudioSharedHeader (192, more with
+ *       AUDIO_FLAG_TRACE / AUDIO_FLAG_METER) for writing to
+ *       Ashmem (format defaults to AUDIO_FORMAT_FLOAT32; empty for an unknown
+ *       format). PCM offsets are as reported by getSharedLayout(). A
+ *       non-zero outputRate asks the service to convert to that rate with
+ *       AUDIO_SRC_QUALITY_* srcQuality.
+ *
+ *   buildHeaderInto(buffer: ArrayBuffer | Uint8Array, sampleRate: number,
+ *                   channels: number, frames: number, gain: number,
+ *                   bypass: number, format?: number, flags?: number,
+ *                   outputRate?: number, srcQuality?: number): boolean
+ *       Same header serialised straight into the start of buffer; false
+ *       if the view is too small or the format is unknown.
+ *
+ *   getSharedLayout(frames: number, channels: number, format?: number, flags?: number,
+ *                   sampleRate?: number, outputRate?: number)
+ *       : { headerSize: number; inputOffset: number; outputOffset: number;
+ *           outputFrames: number; totalSize: number }
+ *       Region offsets used by buildHeader (each PCM region 64-byte aligned)
+ *       and the size to pass to createSharedMemory. Pass the header's flags
+ *       when they include AUDIO_FLAG_TRACE and / or AUDIO_FLAG_METER (the
+ *       header then grows by 128 / 192 bytes), and both rates for a
+ *       resampled request (outputFrames: the output region's frames).
+ *
+ *   encodePcm(buffer: ArrayBuffer, format: number, dither: boolean): ArrayBuffer
+ *   decodePcm(buffer: ArrayBuffer, format: number): ArrayBuffer
+ *       Convert float32 samples to / from an AUDIO_FORMAT_* encoding.
+ *
+ *   writeWavFile(path: string, buffer: ArrayBuffer, sampleRate: number,
+ *                channels: number, frames: number, bitsPerSample?: number): boolean
+ *       Converts float32 PCM and writes a WAV file: 16 (default) or 24-bit
+ *       PCM, or 32 for IEEE float. Never reads past buffer.byteLength.
+ *
+ *   openWavWriter(path: string, sampleRate: number, channels: number,
+ *                 bitsPerSample: number, dither?: boolean): number
+ *   appendWavWriter(handle: number, buffer: ArrayBuffer): boolean
+ *   finalizeWavWriter(handle: number): boolean
+ *       Streaming WAV output (see WavWriter): open returns a handle (-1 on
+ *       failure), append converts and writes one float32 block, finalize
+ *       patches the sizes (RF64 above 4 GiB) and releases the handle.
+ *
+ *   createSharedMemory(name: string, size: number): number
+ *       Creates an anonymous shared region and returns its fd (-1 on failure).
+ *
+ *   writeSharedMemory(fd: number, offset: number, buffer: ArrayBuffer | TypedArray): boolean
+ *   readSharedMemory(fd: number, offset: number, length: number): ArrayBuffer
+ *       Copy bytes into / out of the region.
+ *
+ *   setLiveControl(fd: number, gain: number, bypass: number, rampFrames?: number): boolean
+ *       Lock-free update of the header's live control block (regions built
+ *       with AUDIO_FLAG_LIVE_CONTROL). Takes effect at the service's next
+ *       256-frame block, ramped over rampFrames (default 10 ms) — also in
+ *       the middle of a running processSession / processSharedMemory.
+ *
+ *   readOutputRange(fd: number): { frameOffset: number; frames: number } | null
+ *       Output frames the last request wrote (a resampled session call
+ *       places them after the previous call's); null for a v1 region.
+ *
+ *   readNonFiniteCount(fd: number): number | null
+ *       NaN / Inf input samples the last guarded request (AUDIO_FLAG_GUARD)
+ *       replaced; null for a v1 region.
+ *
+ *   readMeter(fd: number): HostMeter | null
+ *       Levels the service measured for the last request on a region built
+ *       with AUDIO_FLAG_METER (AUDIO_FLAG_LOUDNESS adds loudnessLufs); null
+ *       if the region is not metered or nothing was measured yet. Read it
+ *       after the request's status is DONE.
  *
- *   writeWavFile(path: string, buffer: ArrayBuffer,
- *                sampleRate: number, channels: number, frames: number): boolean
- *       Converts float32 PCM to PCM-16 and writes a WAV file.
+ *   closeSharedMemory(fd: number): void
+ *
+ *   createBatchRegion(name: string, clips: ArrayBuffer[], sampleRate: number,
+ *                     channels: number, gain: number, bypass: number,
+ *                     parallel: boolean)
+ *       : { fd: number; size: number; outputOffsets: number[] }
+ *       Packs every float32 clip into one PROCESS_BATCH_CODE region (see
+ *       BatchBuilder). fd is -1 on failure; outputOffsets[i] is where job i's
+ *       result can be read back (clip byte length).
+ *
+ *   generateSineWaveAsync(sampleRate, frames, channels, freqHz): Promise<ArrayBuffer>
+ *   writeWavFileAsync(path, buffer, sampleRate, channels, frames,
+ *                     bitsPerSample?): Promise<boolean>
+ *       Same as the synchronous calls, but the work runs on the N-API async
+ *       work pool and the Promise settles on the JS thread. buffer must stay
+ *       untouched until the Promise settles.
+ *
+ *   getAsyncStats(): { queued: number; inFlight: number; completed: number }
+ *       Jobs waiting for a worker, jobs currently running, and jobs settled
+ *       since load — for caller-side backpressure.
+ *
+ *   beginTrace(fd: number, requestId: number): boolean
+ *   endTrace(fd: number): TraceBreakdown | null
+ *       Stamp the host line of an AUDIO_FLAG_TRACE region right before the
+ *       request is sent / right after the reply arrived. endTrace returns
+ *       the per-phase durations in ns (-1 = not stamped) and records the
+ *       request into the native trace buffer when tracing is on.
+ *
+ *   traceNow(): number
+ *   setTracing(enabled: boolean): void
+ *   dumpTrace(path: string): boolean
+ *       CLOCK_MONOTONIC ns; native trace buffer on / off; write it as
+ *       Chrome trace-event JSON.
  */
 
 #include "napi/native_api.h"
 #include "audio_native.h"
+#include "batch_builder.h"
+#include "AudioFormatConvert.h"
+#include "shared_memory.h"
+#include "AudioTrace.h"
 #include <hilog/log.h>
+#include <algorithm>
+#include <atomic>
 #include <cstring>
+#include <map>
+#include <memory>
+#include <mutex>
 
 #define LOG_DOMAIN  0x0000
 #define LOG_TAG     "HostAppNative"
 #define LOGI(fmt, ...) OH_LOG_INFO(LOG_APP, LOG_TAG ": " fmt, ##__VA_ARGS__)
 #define LOGE(fmt, ...) OH_LOG_ERROR(LOG_APP, LOG_TAG ": " fmt, ##__VA_ARGS__)
 
+static napi_value MakeByteBuffer(napi_env env, const std::vector<uint8_t>& bytes);
+static napi_value CreatePcmBuffer(napi_env env, int32_t frames, int32_t channels, float** data);
+static std::string GetStringArg(napi_env env, napi_value value);
+static bool GetBufferArg(napi_env env, napi_value value, void** data, size_t* length);
+static bool GetWavFormatArg(napi_env env, size_t argc, napi_value* args, size_t index,
+                            HostAudio::WavSampleFormat& format);
+
 /* ------------------------------------------------------------------ */
 /*  generateSineWave                                                    */
 /* ------------------------------------------------------------------ */
@@ -45,9 +167,146 @@ static napi_value GenerateSineWave(napi_env env, napi_callback_info info)
 
     LOGI("generateSineWave sr=%d frm=%d ch=%d freq=%.1f", sampleRate, frames, channels, (float)freqHz);
 
-    auto bytes = HostAudio::generateSineWave(sampleRate, frames, channels,
-                                             static_cast<float>(freqHz));
+    /* Render straight into the ArrayBuffer: no intermediate vector */
+    float* pcm = nullptr;
+    napi_value result = CreatePcmBuffer(env, frames, channels, &pcm);
+    if (pcm && !HostAudio::generateSineWaveInto(sampleRate, channels, static_cast<float>(freqHz),
+                                                pcm, static_cast<size_t>(frames))) {
+        LOGE("generateSineWave: invalid parameters");
+    }
+    return result;
+}
+
+static napi_value CreatePcmBuffer(napi_env env, int32_t frames, int32_t channels, float** data)
+{
+    const size_t bytes = frames > 0 && channels > 0
+                       ? static_cast<size_t>(frames) * channels * sizeof(float) : 0;
+    napi_value result;
+    void* raw = nullptr;
+    napi_create_arraybuffer(env, bytes, &raw, &result);
+    if (raw && bytes) {
+        std::memset(raw, 0, bytes);
+    }
+    *data = bytes ? static_cast<float*>(raw) : nullptr;
+    return result;
+}
+
+/* ------------------------------------------------------------------ */
+/*  Signal generator                                                    */
+/* ------------------------------------------------------------------ */
+
+/* Read a JS SignalConfig object; missing fields keep their defaults */
+static void GetSignalConfig(napi_env env, napi_value obj, HostAudio::SignalConfig& cfg)
+{
+    napi_value v;
+    uint32_t u = 0;
+    double d = 0.0;
+
+    if (napi_get_named_property(env, obj, "type", &v) == napi_ok
+        && napi_get_value_uint32(env, v, &u) == napi_ok) {
+        cfg.type = static_cast<HostAudio::SignalType>(u);
+    }
+    if (napi_get_named_property(env, obj, "sampleRate", &v) == napi_ok) {
+        napi_get_value_uint32(env, v, &cfg.sampleRate);
+    }
+    if (napi_get_named_property(env, obj, "channels", &v) == napi_ok) {
+        napi_get_value_uint32(env, v, &cfg.channels);
+    }
+    if (napi_get_named_property(env, obj, "amplitude", &v) == napi_ok
+        && napi_get_value_double(env, v, &d) == napi_ok) {
+        cfg.amplitude = static_cast<float>(d);
+    }
+    if (napi_get_named_property(env, obj, "freqs", &v) == napi_ok
+        && napi_get_array_length(env, v, &u) == napi_ok && u > 0) {
+        cfg.toneCount = u < HostAudio::kMaxSignalTones ? u : HostAudio::kMaxSignalTones;
+        for (uint32_t i = 0; i < cfg.toneCount; ++i) {
+            napi_value e;
+            d = 0.0;
+            napi_get_element(env, v, i, &e);
+            napi_get_value_double(env, e, &d);
+            cfg.toneHz[i] = static_cast<float>(d);
+        }
+    }
+    if (napi_get_named_property(env, obj, "startHz", &v) == napi_ok
+        && napi_get_value_double(env, v, &d) == napi_ok) {
+        cfg.startHz = static_cast<float>(d);
+    }
+    if (napi_get_named_property(env, obj, "endHz", &v) == napi_ok
+        && napi_get_value_double(env, v, &d) == napi_ok) {
+        cfg.endHz = static_cast<float>(d);
+    }
+    if (napi_get_named_property(env, obj, "sweepSeconds", &v) == napi_ok
+        && napi_get_value_double(env, v, &d) == napi_ok) {
+        cfg.sweepSeconds = static_cast<float>(d);
+    }
+    if (napi_get_named_property(env, obj, "seed", &v) == napi_ok) {
+        napi_get_value_uint32(env, v, &cfg.seed);
+    }
+    if (napi_get_named_property(env, obj, "impulsePeriod", &v) == napi_ok) {
+        napi_get_value_uint32(env, v, &cfg.impulsePeriod);
+    }
+}
+
+static napi_value GenerateSignalInto(napi_env env, napi_callback_info info)
+{
+    size_t argc = 2;
+    napi_value args[2];
+    napi_get_cb_info(env, info, &argc, args, nullptr, nullptr);
+
+    void*  bufData = nullptr;
+    size_t bufLen  = 0;
+    napi_get_arraybuffer_info(env, args[0], &bufData, &bufLen);
+
+    HostAudio::SignalConfig cfg;
+    GetSignalConfig(env, args[1], cfg);
+
+    int32_t frames = -1;
+    HostAudio::SignalGenerator gen;
+    if (bufData && gen.configure(cfg)) {
+        const size_t n = bufLen / (sizeof(float) * cfg.channels);
+        gen.generate(static_cast<float*>(bufData), n);
+        frames = static_cast<int32_t>(n);
+    } else {
+        LOGE("generateSignalInto: invalid config type=%u sr=%u ch=%u",
+             static_cast<uint32_t>(cfg.type), cfg.sampleRate, cfg.channels);
+    }
+
+    napi_value result;
+    napi_create_int32(env, frames, &result);
+    return result;
+}
+
+static napi_value GenerateSignalToSharedMemory(napi_env env, napi_callback_info info)
+{
+    size_t argc = 4;
+    napi_value args[4];
+    napi_get_cb_info(env, info, &argc, args, nullptr, nullptr);
+
+    int32_t fd = -1;
+    int64_t offset = 0, frames = 0;
+    napi_get_value_int32(env, args[0], &fd);
+    napi_get_value_int64(env, args[1], &offset);
+    napi_get_value_int64(env, args[2], &frames);
+
+    HostAudio::SignalConfig cfg;
+    GetSignalConfig(env, args[3], cfg);
+
+    HostAudio::SignalGenerator gen;
+    const bool ok = offset >= 0 && frames > 0 && gen.configure(cfg)
+                 && HostAudio::generateSignalToSharedMemory(gen, fd, static_cast<size_t>(offset),
+                                                            static_cast<size_t>(frames));
+    if (!ok) {
+        LOGE("generateSignalToSharedMemory failed fd=%d off=%lld frm=%lld",
+             fd, static_cast<long long>(offset), static_cast<long long>(frames));
+    }
 
+    napi_value result;
+    napi_get_boolean(env, ok, &result);
+    return result;
+}
+
+static napi_value MakeByteBuffer(napi_env env, const std::vector<uint8_t>& bytes)
+{
     napi_value result;
     void* data = nullptr;
     napi_create_arraybuffer(env, bytes.size(), &data, &result);
@@ -62,21 +321,37 @@ static napi_value GenerateSineWave(napi_env env, napi_callback_info info)
 /* ------------------------------------------------------------------ */
 static napi_value BuildHeader(napi_env env, napi_callback_info info)
 {
-    size_t argc = 5;
-    napi_value args[5];
+    size_t argc = 9;
+    napi_value args[9];
     napi_get_cb_info(env, info, &argc, args, nullptr, nullptr);
 
-    int32_t sampleRate = 44100, channels = 2, frames = 44100, bypass = 0;
-    double  gain = 0.5;
+    int32_t  sampleRate = 44100, channels = 2, frames = 44100, bypass = 0;
+    double   gain = 0.5;
+    uint32_t format = AUDIO_FORMAT_FLOAT32, flags = 0;
+    uint32_t outputRate = 0, srcQuality = AUDIO_SRC_QUALITY_DEFAULT;
 
     napi_get_value_int32(env, args[0], &sampleRate);
     napi_get_value_int32(env, args[1], &channels);
     napi_get_value_int32(env, args[2], &frames);
     napi_get_value_double(env, args[3], &gain);
     napi_get_value_int32(env, args[4], &bypass);
+    /* arg5 .. arg8 are optional */
+    if (argc > 5) {
+        napi_get_value_uint32(env, args[5], &format);
+    }
+    if (argc > 6) {
+        napi_get_value_uint32(env, args[6], &flags);
+    }
+    if (argc > 7) {
+        napi_get_value_uint32(env, args[7], &outputRate);
+    }
+    if (argc > 8) {
+        napi_get_value_uint32(env, args[8], &srcQuality);
+    }
 
-    auto bytes = HostAudio::buildHeader(sampleRate, channels, frames,
-                                        static_cast<float>(gain), bypass);
+    auto bytes = HostAudio::buildFormatHeader(sampleRate, channels, frames,
+                                              static_cast<float>(gain), bypass, format, flags,
+                                              outputRate, srcQuality);
 
     /* Return as number[] (each element is a byte value 0-255) */
     napi_value arr;
@@ -89,21 +364,217 @@ static napi_value BuildHeader(napi_env env, napi_callback_info info)
     return arr;
 }
 
+static napi_value BuildHeaderInto(napi_env env, napi_callback_info info)
+{
+    size_t argc = 10;
+    napi_value args[10];
+    napi_get_cb_info(env, info, &argc, args, nullptr, nullptr);
+
+    void*    bufData = nullptr;
+    size_t   bufLen  = 0;
+    int32_t  sampleRate = 44100, channels = 2, frames = 44100, bypass = 0;
+    double   gain = 0.5;
+    uint32_t format = AUDIO_FORMAT_FLOAT32, flags = 0;
+    uint32_t outputRate = 0, srcQuality = AUDIO_SRC_QUALITY_DEFAULT;
+
+    bool ok = argc >= 6 && GetBufferArg(env, args[0], &bufData, &bufLen);
+    if (ok) {
+        napi_get_value_int32(env, args[1], &sampleRate);
+        napi_get_value_int32(env, args[2], &channels);
+        napi_get_value_int32(env, args[3], &frames);
+        napi_get_value_double(env, args[4], &gain);
+        napi_get_value_int32(env, args[5], &bypass);
+        /* arg6 .. arg9 are optional */
+        if (argc > 6) {
+            napi_get_value_uint32(env, args[6], &format);
+        }
+        if (argc > 7) {
+            napi_get_value_uint32(env, args[7], &flags);
+        }
+        if (argc > 8) {
+            napi_get_value_uint32(env, args[8], &outputRate);
+        }
+        if (argc > 9) {
+            napi_get_value_uint32(env, args[9], &srcQuality);
+        }
+        ok = HostAudio::writeFormatHeader(bufData, bufLen, sampleRate, channels, frames,
+                                          static_cast<float>(gain), bypass, format, flags,
+                                          AUDIO_SHM_PCM_ALIGN, outputRate, srcQuality);
+    }
+    if (!ok) {
+        LOGE("buildHeaderInto failed len=%zu format=%u", bufLen, format);
+    }
+
+    napi_value result;
+    napi_get_boolean(env, ok, &result);
+    return result;
+}
+
+static napi_value GetSharedLayout(napi_env env, napi_callback_info info)
+{
+    size_t argc = 6;
+    napi_value args[6];
+    napi_get_cb_info(env, info, &argc, args, nullptr, nullptr);
+
+    uint32_t frames = 0, channels = 0, format = AUDIO_FORMAT_FLOAT32, flags = 0;
+    uint32_t sampleRate = 0, outputRate = 0;
+    if (argc >= 2) {
+        napi_get_value_uint32(env, args[0], &frames);
+        napi_get_value_uint32(env, args[1], &channels);
+    }
+    /* arg2 .. arg5 are optional */
+    if (argc > 2) {
+        napi_get_value_uint32(env, args[2], &format);
+    }
+    if (argc > 3) {
+        napi_get_value_uint32(env, args[3], &flags);
+    }
+    if (argc > 5) {
+        napi_get_value_uint32(env, args[4], &sampleRate);
+        napi_get_value_uint32(env, args[5], &outputRate);
+    }
+    const uint32_t outputFrames = audioSrcCapacityFrames(frames, sampleRate, outputRate);
+    const AudioShmLayout layout = audioShmRateLayout(frames, outputFrames, channels, format, 0, flags,
+                                                     AUDIO_SHM_PCM_ALIGN);
+
+    napi_value obj, valHeader, valInput, valOutput, valOutputFrames, valTotal;
+    napi_create_object(env, &obj);
+    napi_create_uint32(env, layout.headerSize,   &valHeader);
+    napi_create_uint32(env, layout.inputOffset,  &valInput);
+    napi_create_uint32(env, layout.outputOffset, &valOutput);
+    napi_create_uint32(env, outputFrames,        &valOutputFrames);
+    napi_create_uint32(env, layout.totalSize,    &valTotal);
+
+    napi_set_named_property(env, obj, "headerSize",   valHeader);
+    napi_set_named_property(env, obj, "inputOffset",  valInput);
+    napi_set_named_property(env, obj, "outputOffset", valOutput);
+    napi_set_named_property(env, obj, "outputFrames", valOutputFrames);
+    napi_set_named_property(env, obj, "totalSize",    valTotal);
+    return obj;
+}
+
+/* Element size of a TypedArray type, in bytes */
+static size_t TypedArrayElementSize(napi_typedarray_type type)
+{
+    switch (type) {
+        case napi_int8_array:
+        case napi_uint8_array:
+        case napi_uint8_clamped_array:
+            return 1;
+        case napi_int16_array:
+        case napi_uint16_array:
+            return 2;
+        case napi_int32_array:
+        case napi_uint32_array:
+        case napi_float32_array:
+            return 4;
+        default:
+            return 8;
+    }
+}
+
+/**
+ * Raw bytes behind an ArrayBuffer or TypedArray argument. For a TypedArray
+ * @p data already points at its byteOffset and @p length is its byteLength.
+ * @return false (data = nullptr, length = 0) for any other value
+ */
+static bool GetBufferArg(napi_env env, napi_value value, void** data, size_t* length)
+{
+    *data   = nullptr;
+    *length = 0;
+
+    bool isTyped = false;
+    if (napi_is_typedarray(env, value, &isTyped) == napi_ok && isTyped) {
+        napi_typedarray_type type;
+        size_t     count  = 0;
+        size_t     offset = 0;
+        napi_value arrayBuffer;
+        if (napi_get_typedarray_info(env, value, &type, &count, data,
+                                     &arrayBuffer, &offset) != napi_ok) {
+            *data = nullptr;
+            return false;
+        }
+        *length = count * TypedArrayElementSize(type);
+        return true;
+    }
+    if (napi_get_arraybuffer_info(env, value, data, length) != napi_ok) {
+        *data   = nullptr;
+        *length = 0;
+        return false;
+    }
+    return true;
+}
+
+/* ------------------------------------------------------------------ */
+/*  encodePcm / decodePcm                                               */
+/* ------------------------------------------------------------------ */
+static napi_value EncodePcm(napi_env env, napi_callback_info info)
+{
+    size_t argc = 3;
+    napi_value args[3];
+    napi_get_cb_info(env, info, &argc, args, nullptr, nullptr);
+
+    void*    bufData = nullptr;
+    size_t   bufLen  = 0;
+    uint32_t format  = AUDIO_FORMAT_FLOAT32;
+    bool     dither  = false;
+    napi_get_arraybuffer_info(env, args[0], &bufData, &bufLen);
+    napi_get_value_uint32(env, args[1], &format);
+    napi_get_value_bool(env, args[2], &dither);
+
+    const size_t numSamples = bufLen / sizeof(float);
+    const size_t bps = AudioFormat::bytesPerSample(format);
+    AudioFormat::Dither state;
+    AudioFormat::seedDither(state, 1u);
+
+    napi_value result;
+    void* data = nullptr;
+    napi_create_arraybuffer(env, numSamples * bps, &data, &result);
+    if (data && bufData && numSamples > 0
+        && !AudioFormat::encode(format, static_cast<const float*>(bufData), data, numSamples,
+                                dither ? &state : nullptr)) {
+        LOGE("encodePcm: unknown format %u", format);
+    }
+    return result;
+}
+
+static napi_value DecodePcm(napi_env env, napi_callback_info info)
+{
+    size_t argc = 2;
+    napi_value args[2];
+    napi_get_cb_info(env, info, &argc, args, nullptr, nullptr);
+
+    void*    bufData = nullptr;
+    size_t   bufLen  = 0;
+    uint32_t format  = AUDIO_FORMAT_FLOAT32;
+    napi_get_arraybuffer_info(env, args[0], &bufData, &bufLen);
+    napi_get_value_uint32(env, args[1], &format);
+
+    const size_t bps = AudioFormat::bytesPerSample(format);
+    const size_t numSamples = bps ? bufLen / bps : 0;
+
+    napi_value result;
+    void* data = nullptr;
+    napi_create_arraybuffer(env, numSamples * sizeof(float), &data, &result);
+    if (data && bufData && numSamples > 0) {
+        AudioFormat::decode(format, bufData, static_cast<float*>(data), numSamples);
+    } else if (bps == 0) {
+        LOGE("decodePcm: unknown format %u", format);
+    }
+    return result;
+}
+
 /* ------------------------------------------------------------------ */
 /*  writeWavFile                                                        */
 /* ------------------------------------------------------------------ */
 static napi_value WriteWavFile(napi_env env, napi_callback_info info)
 {
-    size_t argc = 5;
-    napi_value args[5];
+    size_t argc = 6;
+    napi_value args[6];
     napi_get_cb_info(env, info, &argc, args, nullptr, nullptr);
 
     /* arg0: file path (string) */
-    size_t pathLen = 0;
-    napi_get_value_string_utf8(env, args[0], nullptr, 0, &pathLen);
-    std::string path(pathLen + 1, '\0');
-    napi_get_value_string_utf8(env, args[0], &path[0], pathLen + 1, &pathLen);
-    path.resize(pathLen);
+    const std::string path = GetStringArg(env, args[0]);
 
     /* arg1: PCM ArrayBuffer */
     void*  bufData = nullptr;
@@ -116,17 +587,731 @@ static napi_value WriteWavFile(napi_env env, napi_callback_info info)
     napi_get_value_int32(env, args[3], &channels);
     napi_get_value_int32(env, args[4], &frames);
 
-    LOGI("writeWavFile path=%s sr=%d ch=%d frm=%d bufLen=%zu",
-         path.c_str(), sampleRate, channels, frames, bufLen);
+    /* arg5 (optional): bitsPerSample */
+    HostAudio::WavSampleFormat format = HostAudio::WavSampleFormat::Pcm16;
+    bool ok = GetWavFormatArg(env, argc, args, 5, format);
+
+    LOGI("writeWavFile path=%s sr=%d ch=%d frm=%d bits=%u bufLen=%zu",
+         path.c_str(), sampleRate, channels, frames, static_cast<uint32_t>(format), bufLen);
+
+    ok = ok && HostAudio::writeWavFile(path, bufData, static_cast<int>(bufLen),
+                                       sampleRate, channels, frames, format);
+
+    napi_value result;
+    napi_get_boolean(env, ok, &result);
+    return result;
+}
+
+static std::string GetStringArg(napi_env env, napi_value value)
+{
+    size_t len = 0;
+    napi_get_value_string_utf8(env, value, nullptr, 0, &len);
+    std::string str(len + 1, '\0');
+    napi_get_value_string_utf8(env, value, &str[0], len + 1, &len);
+    str.resize(len);
+    return str;
+}
+
+/* Optional bitsPerSample at args[index]; false for an unsupported value */
+static bool GetWavFormatArg(napi_env env, size_t argc, napi_value* args, size_t index,
+                            HostAudio::WavSampleFormat& format)
+{
+    int32_t bits = 0;
+    if (argc <= index || napi_get_value_int32(env, args[index], &bits) != napi_ok) {
+        return true;   /* omitted or undefined: keep the default */
+    }
+    if (!HostAudio::wavSampleFormatFromBits(bits, format)) {
+        LOGE("unsupported WAV bitsPerSample %d", bits);
+        return false;
+    }
+    return true;
+}
+
+/* ------------------------------------------------------------------ */
+/*  Streaming WAV writer                                                */
+/* ------------------------------------------------------------------ */
+static std::mutex g_wavWritersLock;
+static std::map<int32_t, std::unique_ptr<HostAudio::WavWriter>> g_wavWriters;
+static int32_t g_nextWavWriterId = 1;
+
+static napi_value OpenWavWriter(napi_env env, napi_callback_info info)
+{
+    size_t argc = 5;
+    napi_value args[5];
+    napi_get_cb_info(env, info, &argc, args, nullptr, nullptr);
+
+    const std::string path = GetStringArg(env, args[0]);
+    int32_t sampleRate = 0, channels = 0;
+    napi_get_value_int32(env, args[1], &sampleRate);
+    napi_get_value_int32(env, args[2], &channels);
+
+    HostAudio::WavSampleFormat format = HostAudio::WavSampleFormat::Pcm16;
+    bool ok = GetWavFormatArg(env, argc, args, 3, format);
+
+    bool dither = false;
+    if (argc > 4) {
+        napi_get_value_bool(env, args[4], &dither);
+    }
+
+    int32_t handle = -1;
+    auto writer = std::make_unique<HostAudio::WavWriter>();
+    if (ok && sampleRate > 0 && channels > 0
+        && writer->open(path, static_cast<uint32_t>(sampleRate),
+                        static_cast<uint32_t>(channels), format, dither)) {
+        std::lock_guard<std::mutex> lock(g_wavWritersLock);
+        handle = g_nextWavWriterId++;
+        g_wavWriters.emplace(handle, std::move(writer));
+    }
+    LOGI("openWavWriter path=%s sr=%d ch=%d bits=%u -> %d",
+         path.c_str(), sampleRate, channels, static_cast<uint32_t>(format), handle);
+
+    napi_value result;
+    napi_create_int32(env, handle, &result);
+    return result;
+}
+
+static napi_value AppendWavWriter(napi_env env, napi_callback_info info)
+{
+    size_t argc = 2;
+    napi_value args[2];
+    napi_get_cb_info(env, info, &argc, args, nullptr, nullptr);
+
+    int32_t handle = -1;
+    napi_get_value_int32(env, args[0], &handle);
+
+    void*  bufData = nullptr;
+    size_t bufLen  = 0;
+    napi_get_arraybuffer_info(env, args[1], &bufData, &bufLen);
+
+    bool ok = false;
+    {
+        std::lock_guard<std::mutex> lock(g_wavWritersLock);
+        auto it = g_wavWriters.find(handle);
+        if (it != g_wavWriters.end()) {
+            HostAudio::WavWriter& writer = *it->second;
+            /* Whole frames only; a trailing partial frame is ignored */
+            const size_t frameBytes = sizeof(float) * writer.channels();
+            ok = writer.append(static_cast<const float*>(bufData), bufLen / frameBytes);
+        }
+    }
+    if (!ok) {
+        LOGE("appendWavWriter failed handle=%d bufLen=%zu", handle, bufLen);
+    }
+
+    napi_value result;
+    napi_get_boolean(env, ok, &result);
+    return result;
+}
+
+static napi_value FinalizeWavWriter(napi_env env, napi_callback_info info)
+{
+    size_t argc = 1;
+    napi_value args[1];
+    napi_get_cb_info(env, info, &argc, args, nullptr, nullptr);
+
+    int32_t handle = -1;
+    napi_get_value_int32(env, args[0], &handle);
+
+    std::unique_ptr<HostAudio::WavWriter> writer;
+    {
+        std::lock_guard<std::mutex> lock(g_wavWritersLock);
+        auto it = g_wavWriters.find(handle);
+        if (it != g_wavWriters.end()) {
+            writer = std::move(it->second);
+            g_wavWriters.erase(it);
+        }
+    }
+
+    const bool ok = writer && writer->finalize();
+    LOGI("finalizeWavWriter handle=%d frames=%llu ok=%d", handle,
+         writer ? static_cast<unsigned long long>(writer->framesWritten()) : 0ull, ok);
+
+    napi_value result;
+    napi_get_boolean(env, ok, &result);
+    return result;
+}
+
+/* ------------------------------------------------------------------ */
+/*  Shared memory                                                       */
+/* ------------------------------------------------------------------ */
+static napi_value CreateSharedMemory(napi_env env, napi_callback_info info)
+{
+    size_t argc = 2;
+    napi_value args[2];
+    napi_get_cb_info(env, info, &argc, args, nullptr, nullptr);
+
+    /* arg0: region name (string) */
+    size_t nameLen = 0;
+    napi_get_value_string_utf8(env, args[0], nullptr, 0, &nameLen);
+    std::string name(nameLen + 1, '\0');
+    napi_get_value_string_utf8(env, args[0], &name[0], nameLen + 1, &nameLen);
+    name.resize(nameLen);
+
+    /* arg1: size (number) */
+    int64_t size = 0;
+    napi_get_value_int64(env, args[1], &size);
+
+    int fd = size > 0 ? HostAudio::createSharedMemory(name, static_cast<size_t>(size)) : -1;
+    if (fd < 0) {
+        LOGE("createSharedMemory failed name=%s size=%lld", name.c_str(), static_cast<long long>(size));
+    }
+
+    napi_value result;
+    napi_create_int32(env, fd, &result);
+    return result;
+}
+
+static napi_value WriteSharedMemory(napi_env env, napi_callback_info info)
+{
+    size_t argc = 3;
+    napi_value args[3];
+    napi_get_cb_info(env, info, &argc, args, nullptr, nullptr);
+
+    int32_t fd = -1;
+    int64_t offset = 0;
+    napi_get_value_int32(env, args[0], &fd);
+    napi_get_value_int64(env, args[1], &offset);
+
+    void*  bufData = nullptr;
+    size_t bufLen  = 0;
+    GetBufferArg(env, args[2], &bufData, &bufLen);
+
+    bool ok = offset >= 0 && bufData
+              && HostAudio::writeSharedMemory(fd, static_cast<size_t>(offset), bufData, bufLen);
+
+    napi_value result;
+    napi_get_boolean(env, ok, &result);
+    return result;
+}
+
+static napi_value SetLiveControl(napi_env env, napi_callback_info info)
+{
+    size_t argc = 4;
+    napi_value args[4];
+    napi_get_cb_info(env, info, &argc, args, nullptr, nullptr);
+
+    int32_t  fd = -1, bypass = 0;
+    double   gain = 1.0;
+    uint32_t rampFrames = 0;
+    napi_get_value_int32(env, args[0], &fd);
+    napi_get_value_double(env, args[1], &gain);
+    napi_get_value_int32(env, args[2], &bypass);
+    /* arg3 is optional */
+    if (argc > 3) {
+        napi_get_value_uint32(env, args[3], &rampFrames);
+    }
+
+    bool ok = argc >= 3
+              && HostAudio::writeLiveControl(fd, static_cast<float>(gain), bypass != 0, rampFrames);
+    if (!ok) {
+        LOGE("setLiveControl failed fd=%d", fd);
+    }
+
+    napi_value result;
+    napi_get_boolean(env, ok, &result);
+    return result;
+}
+
+/* number[] of the first @p count values */
+template <typename T>
+static napi_value MakeNumberArray(napi_env env, const T* values, uint32_t count)
+{
+    napi_value arr;
+    napi_create_array_with_length(env, count, &arr);
+    for (uint32_t i = 0; i < count; ++i) {
+        napi_value v;
+        napi_create_double(env, static_cast<double>(values[i]), &v);
+        napi_set_element(env, arr, i, v);
+    }
+    return arr;
+}
+
+static napi_value ReadMeter(napi_env env, napi_callback_info info)
+{
+    size_t argc = 1;
+    napi_value args[1];
+    napi_get_cb_info(env, info, &argc, args, nullptr, nullptr);
+
+    int32_t fd = -1;
+    napi_get_value_int32(env, args[0], &fd);
+
+    AudioMeterBlock block;
+    if (argc < 1 || !HostAudio::readMeterBlock(fd, block)
+        || !(block.valid & AUDIO_METER_VALID_LEVELS)) {
+        napi_value result;
+        napi_get_null(env, &result);
+        return result;
+    }
 
-    bool ok = HostAudio::writeWavFile(path, bufData, static_cast<int>(bufLen),
-                                      sampleRate, channels, frames);
+    /* { channels, frames, clipTotal, inPeak[], outPeak[], inRms[], outRms[], clipCount[], loudnessLufs? } */
+    const uint32_t channels = std::min(block.channels, AUDIO_METER_MAX_CHANNELS);
+    napi_value obj, valChannels, valFrames, valClipTotal;
+    napi_create_object(env, &obj);
+    napi_create_uint32(env, channels,        &valChannels);
+    napi_create_uint32(env, block.frames,    &valFrames);
+    napi_create_uint32(env, block.clipTotal, &valClipTotal);
+    napi_set_named_property(env, obj, "channels",  valChannels);
+    napi_set_named_property(env, obj, "frames",    valFrames);
+    napi_set_named_property(env, obj, "clipTotal", valClipTotal);
+    napi_set_named_property(env, obj, "inPeak",    MakeNumberArray(env, block.inPeak, channels));
+    napi_set_named_property(env, obj, "outPeak",   MakeNumberArray(env, block.outPeak, channels));
+    napi_set_named_property(env, obj, "inRms",     MakeNumberArray(env, block.inRms, channels));
+    napi_set_named_property(env, obj, "outRms",    MakeNumberArray(env, block.outRms, channels));
+    napi_set_named_property(env, obj, "clipCount", MakeNumberArray(env, block.clipCount, channels));
+    if (block.valid & AUDIO_METER_VALID_LOUDNESS) {
+        napi_value valLufs;
+        napi_create_double(env, block.loudnessLufs, &valLufs);
+        napi_set_named_property(env, obj, "loudnessLufs", valLufs);
+    }
+    return obj;
+}
+
+static napi_value ReadOutputRange(napi_env env, napi_callback_info info)
+{
+    size_t argc = 1;
+    napi_value args[1];
+    napi_get_cb_info(env, info, &argc, args, nullptr, nullptr);
+
+    int32_t fd = -1;
+    napi_get_value_int32(env, args[0], &fd);
+
+    uint32_t frameOffset = 0, frames = 0;
+    napi_value result;
+    if (argc < 1 || !HostAudio::readOutputRange(fd, frameOffset, frames)) {
+        napi_get_null(env, &result);
+        return result;
+    }
+    napi_value valOffset, valFrames;
+    napi_create_object(env, &result);
+    napi_create_uint32(env, frameOffset, &valOffset);
+    napi_create_uint32(env, frames,      &valFrames);
+    napi_set_named_property(env, result, "frameOffset", valOffset);
+    napi_set_named_property(env, result, "frames",      valFrames);
+    return result;
+}
+
+static napi_value ReadNonFiniteCount(napi_env env, napi_callback_info info)
+{
+    size_t argc = 1;
+    napi_value args[1];
+    napi_get_cb_info(env, info, &argc, args, nullptr, nullptr);
+
+    int32_t fd = -1;
+    napi_get_value_int32(env, args[0], &fd);
+
+    uint32_t count = 0;
+    napi_value result;
+    if (argc < 1 || !HostAudio::readNonFiniteCount(fd, count)) {
+        napi_get_null(env, &result);
+        return result;
+    }
+    napi_create_uint32(env, count, &result);
+    return result;
+}
+
+static napi_value ReadSharedMemory(napi_env env, napi_callback_info info)
+{
+    size_t argc = 3;
+    napi_value args[3];
+    napi_get_cb_info(env, info, &argc, args, nullptr, nullptr);
+
+    int32_t fd = -1;
+    int64_t offset = 0, length = 0;
+    napi_get_value_int32(env, args[0], &fd);
+    napi_get_value_int64(env, args[1], &offset);
+    napi_get_value_int64(env, args[2], &length);
+    if (offset < 0 || length < 0) {
+        length = 0;
+    }
+
+    /* Read straight into the new ArrayBuffer's backing store */
+    napi_value result;
+    void* data = nullptr;
+    napi_create_arraybuffer(env, static_cast<size_t>(length), &data, &result);
+    if (data && length > 0
+        && !HostAudio::readSharedMemory(fd, static_cast<size_t>(offset), data, static_cast<size_t>(length))) {
+        LOGE("readSharedMemory failed fd=%d offset=%lld len=%lld",
+             fd, static_cast<long long>(offset), static_cast<long long>(length));
+    }
+    return result;
+}
+
+static napi_value CloseSharedMemory(napi_env env, napi_callback_info info)
+{
+    size_t argc = 1;
+    napi_value args[1];
+    napi_get_cb_info(env, info, &argc, args, nullptr, nullptr);
+
+    int32_t fd = -1;
+    napi_get_value_int32(env, args[0], &fd);
+    HostAudio::closeSharedMemory(fd);
+
+    napi_value result;
+    napi_get_undefined(env, &result);
+    return result;
+}
+
+/* ------------------------------------------------------------------ */
+/*  Tracing                                                             */
+/* ------------------------------------------------------------------ */
+static napi_value BeginTrace(napi_env env, napi_callback_info info)
+{
+    size_t argc = 2;
+    napi_value args[2];
+    napi_get_cb_info(env, info, &argc, args, nullptr, nullptr);
+
+    int32_t fd = -1;
+    int64_t requestId = 0;
+    napi_get_value_int32(env, args[0], &fd);
+    napi_get_value_int64(env, args[1], &requestId);
+
+    const bool ok = argc >= 2 && requestId > 0
+                    && HostAudio::beginRequestTrace(fd, static_cast<uint64_t>(requestId));
 
     napi_value result;
     napi_get_boolean(env, ok, &result);
     return result;
 }
 
+static void SetInt64Property(napi_env env, napi_value obj, const char* name, int64_t value)
+{
+    napi_value v;
+    napi_create_int64(env, value, &v);
+    napi_set_named_property(env, obj, name, v);
+}
+
+static napi_value EndTrace(napi_env env, napi_callback_info info)
+{
+    size_t argc = 1;
+    napi_value args[1];
+    napi_get_cb_info(env, info, &argc, args, nullptr, nullptr);
+
+    int32_t fd = -1;
+    napi_get_value_int32(env, args[0], &fd);
+
+    AudioTraceBlock block;
+    if (!HostAudio::endRequestTrace(fd, block)) {
+        napi_value result;
+        napi_get_null(env, &result);
+        return result;
+    }
+    AudioTrace::recordRequest(block);
+    const AudioTrace::Breakdown d = AudioTrace::breakdown(block);
+
+    /* { requestId, complete, totalNs, sendNs, mapNs, setupNs, dspNs, writeBackNs, finishNs, replyNs } */
+    napi_value obj, valComplete;
+    napi_create_object(env, &obj);
+    napi_get_boolean(env, d.complete, &valComplete);
+    SetInt64Property(env, obj, "requestId",   static_cast<int64_t>(block.requestId));
+    napi_set_named_property(env, obj, "complete", valComplete);
+    SetInt64Property(env, obj, "totalNs",     d.totalNs);
+    SetInt64Property(env, obj, "sendNs",      d.sendNs);
+    SetInt64Property(env, obj, "mapNs",       d.mapNs);
+    SetInt64Property(env, obj, "setupNs",     d.setupNs);
+    SetInt64Property(env, obj, "dspNs",       d.dspNs);
+    SetInt64Property(env, obj, "writeBackNs", d.writeBackNs);
+    SetInt64Property(env, obj, "finishNs",    d.finishNs);
+    SetInt64Property(env, obj, "replyNs",     d.replyNs);
+    return obj;
+}
+
+static napi_value TraceNow(napi_env env, napi_callback_info /* info */)
+{
+    napi_value result;
+    napi_create_int64(env, AudioTrace::nowNs(), &result);
+    return result;
+}
+
+static napi_value SetTracing(napi_env env, napi_callback_info info)
+{
+    size_t argc = 1;
+    napi_value args[1];
+    napi_get_cb_info(env, info, &argc, args, nullptr, nullptr);
+
+    bool on = false;
+    napi_get_value_bool(env, args[0], &on);
+    AudioTrace::setEnabled(on);
+    LOGI("setTracing %d (compiled in: %d)", on ? 1 : 0, AUDIO_TRACING);
+
+    napi_value result;
+    napi_get_undefined(env, &result);
+    return result;
+}
+
+static napi_value DumpTrace(napi_env env, napi_callback_info info)
+{
+    size_t argc = 1;
+    napi_value args[1];
+    napi_get_cb_info(env, info, &argc, args, nullptr, nullptr);
+
+    const std::string path = GetStringArg(env, args[0]);
+    const bool ok = !path.empty() && AudioTrace::writeChromeTrace(path);
+    LOGI("dumpTrace %s events=%zu ok=%d", path.c_str(), AudioTrace::eventCount(), ok ? 1 : 0);
+
+    napi_value result;
+    napi_get_boolean(env, ok, &result);
+    return result;
+}
+
+/* ------------------------------------------------------------------ */
+/*  createBatchRegion                                                   */
+/* ------------------------------------------------------------------ */
+static napi_value CreateBatchRegion(napi_env env, napi_callback_info info)
+{
+    size_t argc = 7;
+    napi_value args[7];
+    napi_get_cb_info(env, info, &argc, args, nullptr, nullptr);
+
+    size_t nameLen = 0;
+    napi_get_value_string_utf8(env, args[0], nullptr, 0, &nameLen);
+    std::string name(nameLen + 1, '\0');
+    napi_get_value_string_utf8(env, args[0], &name[0], nameLen + 1, &nameLen);
+    name.resize(nameLen);
+
+    uint32_t clipCount = 0, sampleRate = 44100, channels = 2, bypass = 0;
+    double   gain = 1.0;
+    bool     parallel = false;
+    napi_get_array_length(env, args[1], &clipCount);
+    napi_get_value_uint32(env, args[2], &sampleRate);
+    napi_get_value_uint32(env, args[3], &channels);
+    napi_get_value_double(env, args[4], &gain);
+    napi_get_value_uint32(env, args[5], &bypass);
+    napi_get_value_bool(env, args[6], &parallel);
+
+    /* The clip ArrayBuffers stay alive for this call; pack copies them */
+    HostAudio::BatchBuilder builder;
+    builder.setParallel(parallel);
+    bool ok = clipCount > 0 && channels > 0;
+    for (uint32_t i = 0; ok && i < clipCount; ++i) {
+        napi_value clip;
+        void*  data = nullptr;
+        size_t len  = 0;
+        napi_get_element(env, args[1], i, &clip);
+        napi_get_arraybuffer_info(env, clip, &data, &len);
+        const uint32_t frames = static_cast<uint32_t>(len / (channels * sizeof(float)));
+        ok = builder.addClip(static_cast<const float*>(data), sampleRate, channels, frames,
+                             static_cast<float>(gain), bypass) >= 0;
+    }
+
+    const size_t size = ok ? builder.regionSize() : 0;
+    int fd = size > 0 ? HostAudio::createSharedMemory(name, size) : -1;
+    if (fd >= 0 && !builder.packToFd(fd)) {
+        HostAudio::closeSharedMemory(fd);
+        fd = -1;
+    }
+    if (fd < 0) {
+        LOGE("createBatchRegion failed clips=%u ch=%u", clipCount, channels);
+    }
+
+    napi_value obj, valFd, valSize, offsets;
+    napi_create_object(env, &obj);
+    napi_create_int32(env, fd, &valFd);
+    napi_create_double(env, fd >= 0 ? static_cast<double>(size) : 0.0, &valSize);
+    napi_create_array_with_length(env, fd >= 0 ? builder.jobCount() : 0, &offsets);
+    for (uint32_t i = 0; fd >= 0 && i < builder.jobCount(); ++i) {
+        napi_value off;
+        napi_create_uint32(env, builder.job(i).outputOffset, &off);
+        napi_set_element(env, offsets, i, off);
+    }
+    napi_set_named_property(env, obj, "fd",            valFd);
+    napi_set_named_property(env, obj, "size",          valSize);
+    napi_set_named_property(env, obj, "outputOffsets", offsets);
+    return obj;
+}
+
+/* ------------------------------------------------------------------ */
+/*  Async jobs                                                          */
+/* ------------------------------------------------------------------ */
+
+/* run() executes on the N-API async work pool, settle() back on the JS
+ * thread; several jobs may be outstanding at once. */
+struct AsyncJob {
+    napi_async_work work      = nullptr;
+    napi_deferred   deferred  = nullptr;
+    napi_ref        bufferRef = nullptr;   /* keeps a borrowed ArrayBuffer alive */
+
+    virtual ~AsyncJob() = default;
+    virtual void run() = 0;
+    virtual napi_value settle(napi_env env) = 0;
+};
+
+static std::atomic<int32_t> g_asyncQueued { 0 };
+static std::atomic<int32_t> g_asyncInFlight { 0 };
+static std::atomic<int64_t> g_asyncCompleted { 0 };
+
+static void AsyncExecute(napi_env /* env */, void* data)
+{
+    auto* job = static_cast<AsyncJob*>(data);
+    g_asyncQueued.fetch_sub(1, std::memory_order_relaxed);
+    g_asyncInFlight.fetch_add(1, std::memory_order_relaxed);
+    job->run();
+    g_asyncInFlight.fetch_sub(1, std::memory_order_relaxed);
+}
+
+static void RejectJob(napi_env env, napi_deferred deferred, const char* message)
+{
+    napi_value msg, err;
+    napi_create_string_utf8(env, message, NAPI_AUTO_LENGTH, &msg);
+    napi_create_error(env, nullptr, msg, &err);
+    napi_reject_deferred(env, deferred, err);
+}
+
+static void AsyncComplete(napi_env env, napi_status status, void* data)
+{
+    auto* job = static_cast<AsyncJob*>(data);
+    if (status == napi_ok) {
+        napi_resolve_deferred(env, job->deferred, job->settle(env));
+    } else {
+        if (status == napi_cancelled) {
+            g_asyncQueued.fetch_sub(1, std::memory_order_relaxed);   /* never executed */
+        }
+        RejectJob(env, job->deferred, "host async job cancelled");
+    }
+    g_asyncCompleted.fetch_add(1, std::memory_order_relaxed);
+
+    if (job->bufferRef) {
+        napi_delete_reference(env, job->bufferRef);
+    }
+    napi_delete_async_work(env, job->work);
+    delete job;
+}
+
+/**
+ * Queue a job and return its Promise. Takes ownership of @p job.
+ */
+static napi_value QueueAsyncJob(napi_env env, AsyncJob* job, const char* resourceName)
+{
+    napi_value promise, name;
+    napi_create_promise(env, &job->deferred, &promise);
+    napi_create_string_utf8(env, resourceName, NAPI_AUTO_LENGTH, &name);
+
+    g_asyncQueued.fetch_add(1, std::memory_order_relaxed);
+    if (napi_create_async_work(env, nullptr, name, AsyncExecute, AsyncComplete, job, &job->work) != napi_ok
+        || napi_queue_async_work(env, job->work) != napi_ok) {
+        g_asyncQueued.fetch_sub(1, std::memory_order_relaxed);
+        LOGE("%s: failed to queue async work", resourceName);
+        RejectJob(env, job->deferred, "failed to queue host async job");
+        if (job->bufferRef) {
+            napi_delete_reference(env, job->bufferRef);
+        }
+        if (job->work) {
+            napi_delete_async_work(env, job->work);
+        }
+        delete job;
+    }
+    return promise;
+}
+
+struct SineWaveJob : AsyncJob {
+    int    sampleRate = 44100;
+    int    frames     = 44100;
+    int    channels   = 2;
+    float  freqHz     = 440.0f;
+    float* pcm        = nullptr;   /* inside the ArrayBuffer held by bufferRef */
+
+    void run() override
+    {
+        if (pcm) {
+            HostAudio::generateSineWaveInto(sampleRate, channels, freqHz,
+                                            pcm, static_cast<size_t>(frames));
+        }
+    }
+    napi_value settle(napi_env env) override
+    {
+        napi_value result;
+        napi_get_reference_value(env, bufferRef, &result);
+        return result;
+    }
+};
+
+struct WavFileJob : AsyncJob {
+    std::string path;
+    const void* pcm    = nullptr;
+    size_t      pcmLen = 0;
+    int sampleRate = 44100, channels = 2, frames = 44100;
+    HostAudio::WavSampleFormat format = HostAudio::WavSampleFormat::Pcm16;
+    bool ok = false;
+
+    void run() override
+    {
+        ok = HostAudio::writeWavFile(path, pcm, static_cast<int>(pcmLen),
+                                     sampleRate, channels, frames, format);
+    }
+    napi_value settle(napi_env env) override
+    {
+        if (!ok) {
+            LOGE("writeWavFileAsync failed path=%s", path.c_str());
+        }
+        napi_value result;
+        napi_get_boolean(env, ok, &result);
+        return result;
+    }
+};
+
+static napi_value GenerateSineWaveAsync(napi_env env, napi_callback_info info)
+{
+    size_t argc = 4;
+    napi_value args[4];
+    napi_get_cb_info(env, info, &argc, args, nullptr, nullptr);
+
+    auto* job = new SineWaveJob();
+    double freqHz = 440.0;
+    napi_get_value_int32(env, args[0], &job->sampleRate);
+    napi_get_value_int32(env, args[1], &job->frames);
+    napi_get_value_int32(env, args[2], &job->channels);
+    napi_get_value_double(env, args[3], &freqHz);
+    job->freqHz = static_cast<float>(freqHz);
+
+    /* The worker renders straight into this buffer; it is handed back as-is */
+    napi_value buffer = CreatePcmBuffer(env, job->frames, job->channels, &job->pcm);
+    napi_create_reference(env, buffer, 1, &job->bufferRef);
+    return QueueAsyncJob(env, job, "hostGenerateSineWave");
+}
+
+static napi_value WriteWavFileAsync(napi_env env, napi_callback_info info)
+{
+    size_t argc = 6;
+    napi_value args[6];
+    napi_get_cb_info(env, info, &argc, args, nullptr, nullptr);
+
+    HostAudio::WavSampleFormat format = HostAudio::WavSampleFormat::Pcm16;
+    if (!GetWavFormatArg(env, argc, args, 5, format)) {
+        napi_value promise;
+        napi_deferred deferred;
+        napi_create_promise(env, &deferred, &promise);
+        RejectJob(env, deferred, "unsupported WAV bitsPerSample");
+        return promise;
+    }
+
+    auto* job = new WavFileJob();
+    job->path   = GetStringArg(env, args[0]);
+    job->format = format;
+
+    void* bufData = nullptr;
+    napi_get_arraybuffer_info(env, args[1], &bufData, &job->pcmLen);
+    napi_create_reference(env, args[1], 1, &job->bufferRef);
+    job->pcm = bufData;
+
+    napi_get_value_int32(env, args[2], &job->sampleRate);
+    napi_get_value_int32(env, args[3], &job->channels);
+    napi_get_value_int32(env, args[4], &job->frames);
+    return QueueAsyncJob(env, job, "hostWriteWavFile");
+}
+
+static napi_value GetAsyncStats(napi_env env, napi_callback_info /* info */)
+{
+    napi_value obj, valQueued, valInFlight, valCompleted;
+    napi_create_object(env, &obj);
+    napi_create_int32(env, g_asyncQueued.load(std::memory_order_relaxed), &valQueued);
+    napi_create_int32(env, g_asyncInFlight.load(std::memory_order_relaxed), &valInFlight);
+    napi_create_double(env, static_cast<double>(g_asyncCompleted.load(std::memory_order_relaxed)), &valCompleted);
+
+    napi_set_named_property(env, obj, "queued",    valQueued);
+    napi_set_named_property(env, obj, "inFlight",  valInFlight);
+    napi_set_named_property(env, obj, "completed", valCompleted);
+    return obj;
+}
+
 /* ------------------------------------------------------------------ */
 /*  Module registration                                                 */
 /* ------------------------------------------------------------------ */
@@ -136,8 +1321,35 @@ static napi_value Init(napi_env env, napi_value exports)
     napi_property_descriptor desc[] = {
         { "generateSineWave", nullptr, GenerateSineWave, nullptr, nullptr, nullptr, napi_default, nullptr },
         { "buildHeader",      nullptr, BuildHeader,      nullptr, nullptr, nullptr, napi_default, nullptr },
+        { "buildHeaderInto",  nullptr, BuildHeaderInto,  nullptr, nullptr, nullptr, napi_default, nullptr },
+        { "getSharedLayout",  nullptr, GetSharedLayout,  nullptr, nullptr, nullptr, napi_default, nullptr },
         { "writeWavFile",     nullptr, WriteWavFile,     nullptr, nullptr, nullptr, napi_default, nullptr },
+        { "openWavWriter",     nullptr, OpenWavWriter,     nullptr, nullptr, nullptr, napi_default, nullptr },
+        { "appendWavWriter",   nullptr, AppendWavWriter,   nullptr, nullptr, nullptr, napi_default, nullptr },
+        { "finalizeWavWriter", nullptr, FinalizeWavWriter, nullptr, nullptr, nullptr, napi_default, nullptr },
+        { "createSharedMemory", nullptr, CreateSharedMemory, nullptr, nullptr, nullptr, napi_default, nullptr },
+        { "writeSharedMemory",  nullptr, WriteSharedMemory,  nullptr, nullptr, nullptr, napi_default, nullptr },
+        { "readSharedMemory",   nullptr, ReadSharedMemory,   nullptr, nullptr, nullptr, napi_default, nullptr },
+        { "setLiveControl",     nullptr, SetLiveControl,     nullptr, nullptr, nullptr, napi_default, nullptr },
+        { "closeSharedMemory",  nullptr, CloseSharedMemory,  nullptr, nullptr, nullptr, napi_default, nullptr },
+        { "readMeter",          nullptr, ReadMeter,          nullptr, nullptr, nullptr, napi_default, nullptr },
+        { "readOutputRange",    nullptr, ReadOutputRange,    nullptr, nullptr, nullptr, napi_default, nullptr },
+        { "readNonFiniteCount", nullptr, ReadNonFiniteCount, nullptr, nullptr, nullptr, napi_default, nullptr },
+        { "encodePcm",          nullptr, EncodePcm,          nullptr, nullptr, nullptr, napi_default, nullptr },
+        { "decodePcm",          nullptr, DecodePcm,          nullptr, nullptr, nullptr, napi_default, nullptr },
+        { "createBatchRegion",  nullptr, CreateBatchRegion,  nullptr, nullptr, nullptr, napi_default, nullptr },
+        { "generateSignalInto", nullptr, GenerateSignalInto, nullptr, nullptr, nullptr, napi_default, nullptr },
+        { "generateSignalToSharedMemory", nullptr, GenerateSignalToSharedMemory, nullptr, nullptr, nullptr, napi_default, nullptr },
+        { "generateSineWaveAsync", nullptr, GenerateSineWaveAsync, nullptr, nullptr, nullptr, napi_default, nullptr },
+        { "writeWavFileAsync",     nullptr, WriteWavFileAsync,     nullptr, nullptr, nullptr, napi_default, nullptr },
+        { "getAsyncStats",         nullptr, GetAsyncStats,         nullptr, nullptr, nullptr, napi_default, nullptr },
+        { "beginTrace",            nullptr, BeginTrace,            nullptr, nullptr, nullptr, napi_default, nullptr },
+        { "endTrace",              nullptr, EndTrace,              nullptr, nullptr, nullptr, napi_default, nullptr },
+        { "traceNow",              nullptr, TraceNow,              nullptr, nullptr, nullptr, napi_default, nullptr },
+        { "setTracing",            nullptr, SetTracing,            nullptr, nullptr, nullptr, napi_default, nullptr },
+        { "dumpTrace",             nullptr, DumpTrace,             nullptr, nullptr, nullptr, napi_default, nullptr },
     };
+    AudioTrace::setProcessName("HostApp");
     napi_define_properties(env, exports, sizeof(desc) / sizeof(desc[0]), desc);
     return exports;
 }
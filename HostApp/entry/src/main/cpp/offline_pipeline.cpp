@@ -0,0 +1,205 @@
+/**
+ * offline_pipeline.cpp — WAV file → DSP → WAV file with bounded memory
+ */
+
+#include "offline_pipeline.h"
+#include "wav_reader.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace HostAudio {
+
+namespace {
+
+int64_t nowNs()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/*
+ * Slot ring shared by the three stages. Each stage owns a block counter;
+ * block b lives in slot b % slots, and a stage may only start block b once
+ * the stage before it has finished b (the reader: once the writer has
+ * freed the slot). One mutex / condition variable is plenty at block
+ * granularity.
+ */
+struct Ring {
+    std::mutex              mutex;
+    std::condition_variable cv;
+    uint64_t read      = 0;
+    uint64_t processed = 0;
+    uint64_t written   = 0;
+    bool     readDone    = false;
+    bool     processDone = false;
+    bool     abort       = false;
+
+    std::vector<float>  pcm;
+    std::vector<size_t> frames;
+    size_t              slotSamples = 0;
+
+    float* slot(uint64_t block) { return pcm.data() + (block % frames.size()) * slotSamples; }
+
+    void fail()
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        abort = true;
+        cv.notify_all();
+    }
+};
+
+void readerLoop(Ring& ring, WavReader& reader, uint32_t blockFrames, int64_t& busyNs)
+{
+    const uint64_t slots = ring.frames.size();
+    for (;;) {
+        uint64_t block;
+        {
+            std::unique_lock<std::mutex> lock(ring.mutex);
+            ring.cv.wait(lock, [&] { return ring.abort || ring.read - ring.written < slots; });
+            if (ring.abort) {
+                return;
+            }
+            block = ring.read;
+        }
+
+        const int64_t t0 = nowNs();
+        const size_t n = reader.read(ring.slot(block), blockFrames);
+        busyNs += nowNs() - t0;
+
+        std::lock_guard<std::mutex> lock(ring.mutex);
+        if (n == 0) {
+            ring.readDone = true;
+            ring.abort = ring.abort || reader.failed();
+            ring.cv.notify_all();
+            return;
+        }
+        ring.frames[block % slots] = n;
+        ++ring.read;
+        ring.cv.notify_all();
+    }
+}
+
+void writerLoop(Ring& ring, WavWriter& writer, int64_t& busyNs)
+{
+    const uint64_t slots = ring.frames.size();
+    for (;;) {
+        uint64_t block;
+        {
+            std::unique_lock<std::mutex> lock(ring.mutex);
+            ring.cv.wait(lock, [&] {
+                return ring.abort || ring.written < ring.processed || ring.processDone;
+            });
+            if (ring.abort || ring.written == ring.processed) {
+                return;
+            }
+            block = ring.written;
+        }
+
+        const int64_t t0 = nowNs();
+        const bool ok = writer.append(ring.slot(block), ring.frames[block % slots]);
+        busyNs += nowNs() - t0;
+        if (!ok) {
+            ring.fail();
+            return;
+        }
+
+        std::lock_guard<std::mutex> lock(ring.mutex);
+        ++ring.written;
+        ring.cv.notify_all();
+    }
+}
+
+} // namespace
+
+double OfflineReport::realtimeFactor() const
+{
+    if (wallNs <= 0 || sampleRate == 0) {
+        return 0.0;
+    }
+    const double audioSeconds = static_cast<double>(frames) / sampleRate;
+    return audioSeconds / (static_cast<double>(wallNs) * 1e-9);
+}
+
+bool processWavFile(const std::string& inPath, const std::string& outPath,
+                    const OfflineOptions& options, const BlockProcessor& process,
+                    OfflineReport* report)
+{
+    OfflineReport local;
+    OfflineReport& r = report ? *report : local;
+    r = OfflineReport();
+    if (!process || options.blockFrames == 0 || options.slots < 2) {
+        return false;
+    }
+
+    const int64_t start = nowNs();
+    WavReader reader;
+    if (!reader.open(inPath)) {
+        return false;
+    }
+    WavSampleFormat outFormat = reader.format();
+    if (options.outputBits != 0 && !wavSampleFormatFromBits(options.outputBits, outFormat)) {
+        return false;
+    }
+    WavWriter writer;
+    if (!writer.open(outPath, reader.sampleRate(), reader.channels(), outFormat, options.dither)) {
+        return false;
+    }
+
+    const uint32_t channels = reader.channels();
+    Ring ring;
+    ring.slotSamples = static_cast<size_t>(options.blockFrames) * channels;
+    ring.pcm.resize(ring.slotSamples * options.slots);
+    ring.frames.resize(options.slots);
+
+    r.sampleRate  = reader.sampleRate();
+    r.channels    = channels;
+    r.bufferBytes = ring.pcm.size() * sizeof(float);
+
+    std::thread readThread(readerLoop, std::ref(ring), std::ref(reader),
+                           options.blockFrames, std::ref(r.readNs));
+    std::thread writeThread(writerLoop, std::ref(ring), std::ref(writer), std::ref(r.writeNs));
+
+    /* Compute stage on the calling thread */
+    bool processOk = true;
+    for (;;) {
+        uint64_t block;
+        {
+            std::unique_lock<std::mutex> lock(ring.mutex);
+            ring.cv.wait(lock, [&] {
+                return ring.abort || ring.processed < ring.read || ring.readDone;
+            });
+            if (ring.abort || ring.processed == ring.read) {
+                ring.processDone = true;
+                ring.cv.notify_all();
+                break;
+            }
+            block = ring.processed;
+        }
+
+        const int64_t t0 = nowNs();
+        processOk = process(ring.slot(block), ring.frames[block % options.slots], channels);
+        r.processNs += nowNs() - t0;
+        if (!processOk) {
+            ring.fail();
+            break;
+        }
+
+        std::lock_guard<std::mutex> lock(ring.mutex);
+        ++ring.processed;
+        ring.cv.notify_all();
+    }
+
+    readThread.join();
+    writeThread.join();
+
+    const bool finalized = writer.finalize();
+    r.frames = writer.framesWritten();
+    r.wallNs = nowNs() - start;
+    return processOk && finalized && !ring.abort && r.frames == reader.frames();
+}
+
+} // namespace HostAudio
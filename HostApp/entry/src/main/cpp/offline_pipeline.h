@@ -0,0 +1,65 @@
+/**
+ * offline_pipeline.h — WAV file → DSP → WAV file with bounded memory
+ *
+ * Three stages run concurrently over a ring of `slots` float32 blocks:
+ *
+ *   reader thread    WavReader::read() into the next free slot
+ *   calling thread   the BlockProcessor, in place on the slot
+ *   writer thread    WavWriter::append() from the slot, then frees it
+ *
+ * With three slots block N+1 is decoded while block N is processed and
+ * block N−1 is written. Memory is slots × blockFrames × channels floats
+ * plus the reader's mapping window, independent of the file length.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+
+#include "wav_writer.h"
+
+namespace HostAudio {
+
+/**
+ * Processes @p frames interleaved frames in place.
+ * @return false to abort the run
+ */
+using BlockProcessor = std::function<bool(float* pcm, size_t frames, uint32_t channels)>;
+
+struct OfflineOptions {
+    uint32_t blockFrames = 16384;   /* frames per block                     */
+    uint32_t slots       = 3;       /* ring depth, ≥ 2 (3 = triple buffer)  */
+    int      outputBits  = 0;       /* 16, 24, 32 (float); 0 = as the input */
+    bool     dither      = false;   /* TPDF dither for integer output       */
+};
+
+struct OfflineReport {
+    uint64_t frames     = 0;        /* frames written                       */
+    uint32_t sampleRate = 0;
+    uint32_t channels   = 0;
+    int64_t  wallNs     = 0;        /* open to finalize                     */
+    int64_t  readNs     = 0;        /* busy time of each stage              */
+    int64_t  processNs  = 0;
+    int64_t  writeNs    = 0;
+    size_t   bufferBytes = 0;       /* ring memory (excl. mapping window)   */
+
+    /** Seconds of audio per second of wall time (> 1 = faster than realtime). */
+    double realtimeFactor() const;
+};
+
+/**
+ * Run @p inPath through @p process into @p outPath.
+ * The output has the input's rate and channel count; a failed run leaves a
+ * finalized, truncated output file.
+ *
+ * @param report  filled on success and on failure (may be nullptr)
+ * @return false on bad options, an I/O error, or when process returned false
+ */
+bool processWavFile(const std::string& inPath, const std::string& outPath,
+                    const OfflineOptions& options, const BlockProcessor& process,
+                    OfflineReport* report);
+
+} // namespace HostAudio
@@ -0,0 +1,202 @@
+/**
+ * shared_memory.cpp — HostApp shared-memory region helpers
+ */
+
+#include "shared_memory.h"
+#include "AudioLiveControl.h"
+#include "AudioTrace.h"
+
+#include <cerrno>
+#include <cstddef>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace HostAudio {
+
+namespace {
+
+/* memfd sealing from <linux/memfd.h> / <linux/fcntl.h>, which not every
+   sysroot ships */
+#ifdef F_ADD_SEALS
+constexpr unsigned kMfdAllowSealing = MFD_ALLOW_SEALING;
+constexpr int      kAddSeals  = F_ADD_SEALS;
+constexpr int      kSealSeal   = F_SEAL_SEAL;
+constexpr int      kSealShrink = F_SEAL_SHRINK;
+constexpr int      kSealGrow   = F_SEAL_GROW;
+#else
+constexpr unsigned kMfdAllowSealing = 0x0002u;
+constexpr int      kAddSeals  = 1024 + 9;
+constexpr int      kSealSeal   = 0x0001;
+constexpr int      kSealShrink = 0x0002;
+constexpr int      kSealGrow   = 0x0004;
+#endif
+
+} // namespace
+
+int createSharedMemory(const std::string& name, size_t size)
+{
+    if (size == 0) {
+        return -1;
+    }
+
+    int fd = static_cast<int>(syscall(SYS_memfd_create, name.c_str(),
+                                      MFD_CLOEXEC | kMfdAllowSealing));
+    if (fd < 0) {
+        return -1;
+    }
+    /* Fix the size for good: DspService keeps sessions and streams mapped
+       across calls and refuses a region that could still shrink */
+    if (ftruncate(fd, static_cast<off_t>(size)) != 0
+        || fcntl(fd, kAddSeals, kSealShrink | kSealGrow | kSealSeal) != 0) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+bool writeSharedMemory(int fd, size_t offset, const void* src, size_t len)
+{
+    const char* p = static_cast<const char*>(src);
+    while (len > 0) {
+        ssize_t n = pwrite(fd, p, len, static_cast<off_t>(offset));
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            return false;
+        }
+        p      += n;
+        offset += static_cast<size_t>(n);
+        len    -= static_cast<size_t>(n);
+    }
+    return true;
+}
+
+bool readSharedMemory(int fd, size_t offset, void* dst, size_t len)
+{
+    char* p = static_cast<char*>(dst);
+    while (len > 0) {
+        ssize_t n = pread(fd, p, len, static_cast<off_t>(offset));
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            return false;
+        }
+        p      += n;
+        offset += static_cast<size_t>(n);
+        len    -= static_cast<size_t>(n);
+    }
+    return true;
+}
+
+bool writeLiveControl(int fd, float gain, bool bypass, uint32_t rampFrames)
+{
+    if (fd < 0) {
+        return false;
+    }
+    /* The control block ends at the same byte in v1 and v2 headers */
+    constexpr size_t kMapBytes = AUDIO_HDR_OFFSET_CONTROL + AUDIO_CONTROL_SIZE;
+    void* base = mmap(nullptr, kMapBytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (base == MAP_FAILED) {
+        return false;
+    }
+
+    AudioControl::Values v;
+    v.gain       = gain;
+    v.bypass     = bypass ? 1u : 0u;
+    v.rampFrames = rampFrames;
+    AudioControl::write(audioShmControl(base), v);
+
+    munmap(base, kMapBytes);
+    return true;
+}
+
+namespace {
+
+/* Does the header at offset 0 of @p fd carry a trace block? */
+bool regionTraced(int fd)
+{
+    AudioSharedHeader hdr;
+    if (!readSharedMemory(fd, 0, &hdr, AUDIO_HDR_OFFSET_CONTROL)) {
+        return false;
+    }
+    return hdr.magic == AUDIO_SHM_MAGIC && hdr.version == AUDIO_SHM_VERSION
+        && (hdr.flags & AUDIO_FLAG_TRACE) && hdr.headerSize >= AUDIO_SHM_HEADER_SIZE_TRACED;
+}
+
+/* Flags of a v2 header at offset 0 of @p fd that carries a meter block, or 0 */
+uint32_t meteredFlags(int fd)
+{
+    AudioSharedHeader hdr;
+    if (!readSharedMemory(fd, 0, &hdr, AUDIO_HDR_OFFSET_CONTROL)
+        || hdr.magic != AUDIO_SHM_MAGIC || hdr.version != AUDIO_SHM_VERSION
+        || !(hdr.flags & AUDIO_FLAG_METER) || hdr.headerSize < audioShmHeaderSizeFor(hdr.flags)) {
+        return 0;
+    }
+    return hdr.flags;
+}
+
+} // namespace
+
+/* pread / pwrite rather than a mapping: a few dozen bytes per request */
+bool beginRequestTrace(int fd, uint64_t requestId)
+{
+    if (fd < 0 || !regionTraced(fd)) {
+        return false;
+    }
+    AudioTraceBlock block = {};
+    AudioTrace::beginHostTrace(&block, requestId);
+    return writeSharedMemory(fd, AUDIO_SHM_TRACE_OFFSET, &block, offsetof(AudioTraceBlock, _hostPad));
+}
+
+bool endRequestTrace(int fd, AudioTraceBlock& out)
+{
+    const int64_t replyNs = AudioTrace::nowNs();
+    if (fd < 0 || !regionTraced(fd)
+        || !readSharedMemory(fd, AUDIO_SHM_TRACE_OFFSET, &out, sizeof(out))) {
+        return false;
+    }
+    out.hostReplyNs = replyNs;
+    return writeSharedMemory(fd, AUDIO_TRACE_OFFSET_HOST_REPLY, &replyNs, sizeof(replyNs));
+}
+
+bool readMeterBlock(int fd, AudioMeterBlock& out)
+{
+    const uint32_t flags = fd >= 0 ? meteredFlags(fd) : 0u;
+    return flags != 0 && readSharedMemory(fd, audioShmMeterOffset(flags), &out, sizeof(out));
+}
+
+bool readOutputRange(int fd, uint32_t& frameOffset, uint32_t& frames)
+{
+    AudioSharedHeader hdr;
+    if (fd < 0 || !readSharedMemory(fd, 0, &hdr, sizeof(hdr))
+        || hdr.magic != AUDIO_SHM_MAGIC || hdr.version != AUDIO_SHM_VERSION) {
+        return false;
+    }
+    frameOffset = hdr.outputFrameOffset;
+    frames      = hdr.outputFrames;
+    return true;
+}
+
+bool readNonFiniteCount(int fd, uint32_t& count)
+{
+    AudioSharedHeader hdr;
+    if (fd < 0 || !readSharedMemory(fd, 0, &hdr, sizeof(hdr))
+        || hdr.magic != AUDIO_SHM_MAGIC || hdr.version != AUDIO_SHM_VERSION) {
+        return false;
+    }
+    count = hdr.nonFiniteCount;
+    return true;
+}
+
+void closeSharedMemory(int fd)
+{
+    if (fd >= 0) {
+        close(fd);
+    }
+}
+
+} // namespace HostAudio
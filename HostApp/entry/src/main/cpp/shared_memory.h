@@ -0,0 +1,102 @@
+/**
+ * shared_memory.h — HostApp shared-memory region helpers
+ *
+ * Creates the anonymous shared region handed to DspService as a plain fd
+ * (PROCESS_SHM_CODE), so the service can mmap it natively and process the
+ * PCM in place.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "AudioSharedBuffer.h"
+
+namespace HostAudio {
+
+/**
+ * Create an anonymous shared-memory region of the given size. The region
+ * is sealed against resizing (F_SEAL_SHRINK / F_SEAL_GROW), which
+ * DspService requires before it maps a memfd.
+ * @param name  debug name of the region (shows up in /proc/<pid>/maps)
+ * @param size  region size in bytes
+ * @return file descriptor (close with closeSharedMemory), or -1 on failure
+ */
+int createSharedMemory(const std::string& name, size_t size);
+
+/**
+ * Copy bytes into the region.
+ * @param fd      region fd returned by createSharedMemory
+ * @param offset  destination byte offset inside the region
+ * @param src     source bytes
+ * @param len     number of bytes to copy
+ * @return true when all bytes were written
+ */
+bool writeSharedMemory(int fd, size_t offset, const void* src, size_t len);
+
+/**
+ * Copy bytes out of the region.
+ * @param fd      region fd returned by createSharedMemory
+ * @param offset  source byte offset inside the region
+ * @param dst     destination buffer (at least len bytes)
+ * @param len     number of bytes to copy
+ * @return true when all bytes were read
+ */
+bool readSharedMemory(int fd, size_t offset, void* dst, size_t len);
+
+/**
+ * Update the live gain / bypass of an AudioSharedHeader region (one that
+ * was set up with AUDIO_FLAG_LIVE_CONTROL). Maps only the header page and
+ * does a seqlock write into its control block, so it is safe while the
+ * service is processing the region — no IPC, no locks.
+ * @param rampFrames  smoothing length, 0 = 10 ms
+ * @return false if the header page cannot be mapped
+ */
+bool writeLiveControl(int fd, float gain, bool bypass, uint32_t rampFrames);
+
+/**
+ * Start the trace of the next request on an AudioSharedHeader region
+ * whose header was built with AUDIO_FLAG_TRACE: writes requestId, pid /
+ * tid and hostSendNs into the host line of its trace block. Call right
+ * before sending the request.
+ * @return false if the region is not traced or cannot be accessed
+ */
+bool beginRequestTrace(int fd, uint64_t requestId);
+
+/**
+ * Finish the trace after the reply arrived: stamps hostReplyNs (taken on
+ * entry) and copies the whole trace block, service line included, to @p out.
+ * @return false if the region is not traced or cannot be accessed
+ */
+bool endRequestTrace(int fd, AudioTraceBlock& out);
+
+/**
+ * Copy the meter block of an AudioSharedHeader region whose header was
+ * built with AUDIO_FLAG_METER. Read it after the request finished:
+ * valid is 0 until the service has metered one.
+ * @return false if the region is not metered or cannot be read
+ */
+bool readMeterBlock(int fd, AudioMeterBlock& out);
+
+/**
+ * Output frames the last request on a v2 region wrote: [frameOffset,
+ * frameOffset + frames) of the output region (outputFrameOffset /
+ * outputFrames). Read it after the request's status is DONE.
+ * @return false for a v1 region or one that cannot be read
+ */
+bool readOutputRange(int fd, uint32_t& frameOffset, uint32_t& frames);
+
+/**
+ * NaN / Inf input samples the service replaced in the last guarded request
+ * on a v2 region (nonFiniteCount, AUDIO_FLAG_GUARD). Read it after the
+ * request finished; a strict request that failed still reports it.
+ * @return false for a v1 region or one that cannot be read
+ */
+bool readNonFiniteCount(int fd, uint32_t& count);
+
+/** Close a region fd returned by createSharedMemory. */
+void closeSharedMemory(int fd);
+
+} // namespace HostAudio
@@ -0,0 +1,147 @@
+/**
+ * signal_generator.h — test-signal oscillators for load and accuracy runs
+ *
+ * SignalGenerator renders one mono signal, duplicated to every channel of
+ * the interleaved output, in fixed blocks of kBlockFrames:
+ *
+ *   Sine / MultiTone  rotating phasors (complex recurrence), 8 lanes wide,
+ *                     re-seeded from a double phase accumulator per block
+ *   Sweep             exponential (log) sweep startHz → endHz over
+ *                     sweepSeconds, then restarts; double phase accumulator
+ *                     and a polynomial sine, 8 lanes wide
+ *   WhiteNoise        8 interleaved xorshift32 lanes, uniform in [-1, 1)
+ *   PinkNoise         white noise through Paul Kellet's 1/f filter
+ *   Impulse           one full-scale sample every impulsePeriod frames
+ *
+ * generate() continues where the previous call stopped, so a long signal
+ * can be produced block by block (e.g. straight into stream ring slots)
+ * and matches a single-call render sample for sample.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace HostAudio {
+
+enum class SignalType : uint32_t {
+    Sine       = 0,
+    MultiTone  = 1,
+    Sweep      = 2,
+    WhiteNoise = 3,
+    PinkNoise  = 4,
+    Impulse    = 5,
+};
+
+constexpr uint32_t kMaxSignalTones = 8;
+
+struct SignalConfig {
+    SignalType type       = SignalType::Sine;
+    uint32_t   sampleRate = 44100;
+    uint32_t   channels   = 2;
+    /** Peak level; MultiTone splits it evenly over the tones */
+    float      amplitude  = 1.0f;
+
+    /** Sine uses toneHz[0]; MultiTone sums toneHz[0 .. toneCount) */
+    uint32_t   toneCount  = 1;
+    float      toneHz[kMaxSignalTones] = { 440.0f };
+
+    /** Sweep range, both in (0, sampleRate / 2] */
+    float      startHz      = 20.0f;
+    float      endHz        = 20000.0f;
+    float      sweepSeconds = 10.0f;
+
+    /** Noise seed (any value) */
+    uint32_t   seed = 1;
+
+    /** Frames between impulses; 0 = a single impulse at frame 0 */
+    uint32_t   impulsePeriod = 0;
+};
+
+class SignalGenerator {
+public:
+    /** Frames rendered per internal block (multiple of the lane width). */
+    static constexpr uint32_t kBlockFrames = 256;
+
+    SignalGenerator() = default;
+
+    /**
+     * Validate @p cfg and rewind to frame 0.
+     * @return false for zero rate / channels, out-of-range frequencies
+     *         or an unknown type; the generator then outputs silence
+     */
+    bool configure(const SignalConfig& cfg);
+
+    /** Rewind to frame 0 with the current configuration. */
+    void reset();
+
+    /** Render the next @p frames frames, interleaved, into @p dst. */
+    void generate(float* dst, size_t frames);
+
+    /** Frames produced since configure() / reset(). */
+    uint64_t position() const { return position_; }
+
+    const SignalConfig& config() const { return cfg_; }
+
+    /** True after a successful configure(). */
+    bool valid() const { return valid_; }
+
+private:
+    static constexpr uint32_t kLanes = 8;
+
+    void renderBlock();
+    void renderTones();
+    void renderSweep();
+    void renderNoise(bool pink);
+    void renderImpulse();
+
+    SignalConfig cfg_;
+    bool         valid_    = false;
+    uint64_t     position_ = 0;
+
+    alignas(32) float block_[kBlockFrames];
+    uint32_t     blockPos_ = kBlockFrames;   /* next unread sample of block_ */
+    uint64_t     rendered_ = 0;              /* frames rendered into blocks  */
+
+    /* Sine / MultiTone: per-tone phase and per-step rotation */
+    double       tonePhase_[kMaxSignalTones] = {};
+    double       toneOmega_[kMaxSignalTones] = {};
+    float        toneRotRe_[kMaxSignalTones] = {};
+    float        toneRotIm_[kMaxSignalTones] = {};
+    double       toneLaneRe_[kMaxSignalTones][kLanes] = {};   /* e^{ikω}     */
+    double       toneLaneIm_[kMaxSignalTones][kLanes] = {};
+
+    /* Sweep */
+    double       sweepPhase_ = 0.0;
+    double       sweepOmega_ = 0.0;
+    double       sweepOmega0_ = 0.0;
+    double       sweepRatio8_ = 1.0;          /* omega growth per lane step  */
+    double       sweepSum_[kLanes + 1] = {};  /* Σ r^j, j < k               */
+    alignas(16) float sweepSumF_[kLanes] = {};
+    uint64_t     sweepFrames_ = 0;             /* sweep length, lane multiple */
+    uint64_t     sweepLeft_ = 0;               /* frames until the restart    */
+
+    /* Noise */
+    alignas(16) uint32_t noise_[kLanes] = {};
+    float        pink_[7] = {};
+};
+
+/**
+ * Convenience one-shot render: configure a generator and fill @p dst.
+ * @return false if @p cfg is invalid (dst is left untouched)
+ */
+bool generateSignal(const SignalConfig& cfg, float* dst, size_t frames);
+
+/**
+ * Render straight into a shared-memory region (e.g. the Ashmem input PCM),
+ * mapping only the target range.
+ * @param fd      region fd (see createSharedMemory)
+ * @param offset  byte offset of the first frame inside the region
+ * @param frames  frames to render, continuing from gen's current position
+ * @return false if the range lies outside the region, cannot be mapped,
+ *         or gen is not configured
+ */
+bool generateSignalToSharedMemory(SignalGenerator& gen, int fd, size_t offset, size_t frames);
+
+} // namespace HostAudio
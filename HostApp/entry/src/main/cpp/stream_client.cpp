@@ -0,0 +1,129 @@
+/**
+ * stream_client.cpp — HostApp side of the block-streaming protocol
+ */
+
+#include "stream_client.h"
+#include "shared_memory.h"
+#include "AudioLiveControl.h"
+
+#include <cstring>
+#include <sys/mman.h>
+
+namespace HostAudio {
+
+StreamClient::~StreamClient()
+{
+    close();
+}
+
+bool StreamClient::open(const AudioStream::StreamConfig& cfg)
+{
+    close();
+
+    const size_t size = AudioStream::regionSize(cfg);
+    if (size == 0) {
+        return false;
+    }
+
+    int fd = createSharedMemory("audio_stream_shm", size);
+    if (fd < 0) {
+        return false;
+    }
+    void* base = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (base == MAP_FAILED) {
+        closeSharedMemory(fd);
+        return false;
+    }
+    AudioStream::RingGeometry geometry;
+    if (!AudioStream::initRegion(base, size, cfg)
+        || !AudioStream::validateRegion(base, size, &geometry)) {
+        munmap(base, size);
+        closeSharedMemory(fd);
+        return false;
+    }
+
+    fd_     = fd;
+    size_   = size;
+    base_   = base;
+    hdr_      = static_cast<AudioStreamHeader*>(base);
+    geometry_ = geometry;
+    input_    = AudioStream::BlockProducer(hdr_, geometry_, AudioStream::Ring::Input);
+    output_   = AudioStream::BlockConsumer(hdr_, geometry_, AudioStream::Ring::Output);
+    return true;
+}
+
+void StreamClient::close()
+{
+    if (hdr_) {
+        AudioStream::closeRegion(hdr_);
+    }
+    if (base_) {
+        munmap(base_, size_);
+    }
+    closeSharedMemory(fd_);
+
+    fd_       = -1;
+    size_     = 0;
+    base_     = nullptr;
+    hdr_      = nullptr;
+    geometry_ = AudioStream::RingGeometry();
+}
+
+bool StreamClient::push(const float* pcm, uint32_t frames, uint32_t flags, int timeoutMs)
+{
+    if (!hdr_ || frames > geometry_.blockFrames) {
+        return false;
+    }
+    float* slot = input_.acquire(timeoutMs);
+    if (!slot) {
+        return false;
+    }
+    std::memcpy(slot, pcm, static_cast<size_t>(frames) * geometry_.channels * sizeof(float));
+    input_.publish(frames, flags);
+    return true;
+}
+
+bool StreamClient::pushSignal(SignalGenerator& gen, uint32_t frames, uint32_t flags, int timeoutMs)
+{
+    if (!hdr_ || frames > geometry_.blockFrames || !gen.valid()
+        || gen.config().channels != geometry_.channels) {
+        return false;
+    }
+    float* slot = input_.acquire(timeoutMs);
+    if (!slot) {
+        return false;
+    }
+    gen.generate(slot, frames);
+    input_.publish(frames, flags);
+    return true;
+}
+
+uint32_t StreamClient::pull(float* dst, uint32_t* flags, int timeoutMs)
+{
+    if (!hdr_) {
+        return 0;
+    }
+    uint32_t frames = 0;
+    const float* src = output_.acquire(timeoutMs, &frames, flags);
+    if (!src) {
+        return 0;
+    }
+    std::memcpy(dst, src, static_cast<size_t>(frames) * geometry_.channels * sizeof(float));
+    output_.release();
+    return frames;
+}
+
+bool StreamClient::setLiveControl(float gain, bool bypass, uint32_t rampFrames)
+{
+    if (!hdr_) {
+        return false;
+    }
+    AudioControl::Values v;
+    v.gain       = gain;
+    v.bypass     = bypass ? 1u : 0u;
+    v.rampFrames = rampFrames;
+    AudioControl::write(&hdr_->control, v);
+    return true;
+}
+
+} // namespace HostAudio
@@ -0,0 +1,88 @@
+/**
+ * stream_client.h — HostApp side of the block-streaming protocol
+ *
+ * Owns an AudioStreamBuffer region: creates and maps it, pushes input
+ * blocks into the input ring and pulls processed blocks from the output
+ * ring. fd() is handed to DspService once via OPEN_STREAM_CODE.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "AudioStreamRing.h"
+#include "signal_generator.h"
+
+namespace HostAudio {
+
+class StreamClient {
+public:
+    StreamClient() = default;
+    ~StreamClient();
+
+    StreamClient(const StreamClient&) = delete;
+    StreamClient& operator=(const StreamClient&) = delete;
+
+    /**
+     * Create, map and initialise a stream region.
+     * @return false if cfg is invalid or the region cannot be created
+     */
+    bool open(const AudioStream::StreamConfig& cfg);
+
+    /** Mark the stream closed, unmap and close the fd. */
+    void close();
+
+    int    fd() const { return fd_; }
+    size_t size() const { return size_; }
+    AudioStreamHeader* header() const { return hdr_; }
+
+    /**
+     * Copy up to blockFrames frames into the next input slot.
+     * @param pcm        float32 interleaved frames
+     * @param frames     number of frames (≤ blockFrames)
+     * @param flags      AUDIO_STREAM_BLOCK_* (e.g. END on the last block)
+     * @param timeoutMs  < 0 waits until a slot is free
+     * @return false on timeout or if the stream is closed
+     */
+    bool push(const float* pcm, uint32_t frames, uint32_t flags, int timeoutMs);
+
+    /**
+     * Render the next frames of @p gen straight into the next input slot,
+     * so a long test signal never exists as a whole in memory.
+     * @param frames  number of frames (≤ blockFrames)
+     * @return false on timeout, if the stream is closed, or if gen is not
+     *         configured for this stream's channel count
+     */
+    bool pushSignal(SignalGenerator& gen, uint32_t frames, uint32_t flags, int timeoutMs);
+
+    /**
+     * Copy the next processed block out of the output ring.
+     * @param dst        room for blockFrames × channels floats
+     * @param flags      receives AUDIO_STREAM_BLOCK_* (may be nullptr)
+     * @param timeoutMs  < 0 waits until a block is available
+     * @return number of frames copied, 0 on timeout / closed
+     */
+    uint32_t pull(float* dst, uint32_t* flags, int timeoutMs);
+
+    /**
+     * Change gain / bypass while blocks are in flight. Lock-free seqlock
+     * write into the header's control line; the DSP ramps to the new values
+     * from its next block on.
+     * @param rampFrames  smoothing length, 0 = 10 ms
+     * @return false if the stream is not open
+     */
+    bool setLiveControl(float gain, bool bypass, uint32_t rampFrames = 0);
+
+private:
+    int                       fd_   = -1;
+    size_t                    size_ = 0;
+    void*                     base_ = nullptr;
+    AudioStreamHeader*        hdr_  = nullptr;
+    /* Configuration as written at open; the service shares the header */
+    AudioStream::RingGeometry geometry_;
+    AudioStream::BlockProducer input_;
+    AudioStream::BlockConsumer output_;
+};
+
+} // namespace HostAudio
@@ -10,6 +10,7 @@
  * @param channels    number of audio channels (typically 2)
  * @param freqHz      frequency of the sine wave in Hz (e.g. 440.0)
  * @returns ArrayBuffer containing interleaved float32 PCM samples
+ *          (empty for invalid parameters)
  */
 export declare function generateSineWave(
   sampleRate: number,
@@ -19,29 +20,178 @@ export declare function generateSineWave(
 ): ArrayBuffer;
 
 /**
- * Serialise an AudioSharedHeader into a 128-byte array.
+ * Test-signal description for generateSignalInto / generateSignalToSharedMemory.
+ * Omitted fields keep their defaults.
+ */
+export class SignalConfig {
+  /** 0 sine (default), 1 multi-tone, 2 log sweep, 3 white noise, 4 pink noise, 5 impulse */
+  type?: number;
+  /** default 44100 */
+  sampleRate?: number;
+  /** every channel gets the same signal; default 2 */
+  channels?: number;
+  /** peak level (multi-tone splits it over the tones); default 1.0 */
+  amplitude?: number;
+  /** tone frequencies in Hz: sine uses freqs[0], multi-tone up to 8; default [440] */
+  freqs?: number[];
+  /** log sweep range in Hz (≤ sampleRate / 2) and length; it then restarts */
+  startHz?: number;
+  endHz?: number;
+  sweepSeconds?: number;
+  /** noise seed */
+  seed?: number;
+  /** frames between impulses; 0 = a single impulse at frame 0 */
+  impulsePeriod?: number;
+}
+
+/**
+ * Render a test signal straight into buffer (float32 interleaved, whole
+ * frames), without an intermediate copy.
+ * @returns frames written, or -1 for an invalid config
+ */
+export declare function generateSignalInto(
+  buffer: ArrayBuffer,
+  config: SignalConfig
+): number;
+
+/**
+ * Render a test signal straight into a shared region, e.g. the input PCM
+ * of a PROCESS_SHM_CODE region (offset = header.inputOffset).
+ * @param fd      fd returned by createSharedMemory
+ * @param offset  byte offset of the first frame (multiple of 4)
+ * @param frames  number of frames to render
+ * @returns true on success, false for an invalid config or range
+ */
+export declare function generateSignalToSharedMemory(
+  fd: number,
+  offset: number,
+  frames: number,
+  config: SignalConfig
+): boolean;
+
+/**
+ * Serialise a (v2) AudioSharedHeader into a byte array (192 bytes, more
+ * with the trace / meter flags). The PCM regions sit where
+ * getSharedLayout() says.
  * @param sampleRate  stream sample rate
  * @param channels    number of channels
  * @param frames      number of frames
  * @param gain        DSP gain value (0.0 ~ 2.0)
  * @param bypass      0 = process,  1 = bypass
- * @returns number[] of length 128, each element is a byte (0-255)
+ * @param format      PCM format for input and output: 0 = float32 (default),
+ *                    1 = int16, 2 = packed int24, 3 = planar float32
+ * @param flags       1 = TPDF-dither integer output, 2 = live control
+ *                    (see setLiveControl), 4 = trace block (see
+ *                    beginTrace), 8 = meter block (see readMeter),
+ *                    16 = also measure loudness (with 8), 32 = end a
+ *                    resampled session stream (see readOutputRange),
+ *                    64 = guard: flush subnormals, replace NaN / Inf
+ *                    input with 0 and count it (see readNonFiniteCount),
+ *                    128 = fail the request on NaN / Inf (with 64);
+ *                    default 0
+ * @param outputRate  have the service convert to this rate (8000 ~ 384000)
+ *                    before processing; 0 / omitted = no conversion
+ * @param srcQuality  conversion quality: 1 = low, 2 = medium (default),
+ *                    3 = high
+ * @returns number[] of getSharedLayout().headerSize bytes (192; 320 with
+ *          flag 4; +192 with flag 8), each element is a byte (0-255);
+ *          empty for an unknown format
  */
 export declare function buildHeader(
   sampleRate: number,
   channels: number,
   frames: number,
   gain: number,
-  bypass: number
+  bypass: number,
+  format?: number,
+  flags?: number,
+  outputRate?: number,
+  srcQuality?: number
 ): number[];
 
 /**
- * Convert float32 PCM to PCM-16 and write a standard WAV file.
- * @param path       absolute destination path on the device
- * @param buffer     ArrayBuffer containing float32 interleaved PCM
- * @param sampleRate stream sample rate
- * @param channels   number of audio channels
- * @param frames     number of sample frames
+ * Same header as buildHeader(), serialised straight into the first
+ * headerSize bytes of buffer (no number[] round trip).
+ * @param buffer  destination; a Uint8Array view writes at its byteOffset
+ * @returns false if buffer is shorter than the header or format is unknown
+ */
+export declare function buildHeaderInto(
+  buffer: ArrayBuffer | Uint8Array,
+  sampleRate: number,
+  channels: number,
+  frames: number,
+  gain: number,
+  bypass: number,
+  format?: number,
+  flags?: number,
+  outputRate?: number,
+  srcQuality?: number
+): boolean;
+
+/** Region offsets of a header built by buildHeader / buildHeaderInto */
+export class SharedLayout {
+  /** Header bytes at offset 0 */
+  headerSize: number;
+  /** Byte offset of the input PCM (64-byte aligned) */
+  inputOffset: number;
+  /** Byte offset of the output PCM (64-byte aligned) */
+  outputOffset: number;
+  /** Frames the output region holds (more than frames when upsampling) */
+  outputFrames: number;
+  /** Region size to pass to createSharedMemory */
+  totalSize: number;
+}
+
+/**
+ * Where buildHeader() places the PCM regions for a given geometry.
+ * @param format  PCM format (see buildHeader); default float32
+ * @param flags   the header's flags; the trace (4) and meter (8) flags
+ *                change the layout
+ * @param sampleRate  input rate of a resampled request
+ * @param outputRate  its outputRate; both omitted = no conversion
+ */
+export declare function getSharedLayout(
+  frames: number,
+  channels: number,
+  format?: number,
+  flags?: number,
+  sampleRate?: number,
+  outputRate?: number
+): SharedLayout;
+
+/**
+ * Convert float32 PCM to a compact format for the shared region.
+ * @param buffer  float32 samples
+ * @param format  target format (see buildHeader)
+ * @param dither  add TPDF dither when the target is an integer format
+ * @returns encoded samples
+ */
+export declare function encodePcm(
+  buffer: ArrayBuffer,
+  format: number,
+  dither: boolean
+): ArrayBuffer;
+
+/**
+ * Convert PCM in any format (see buildHeader) back to float32.
+ * @param buffer  encoded samples
+ * @param format  source format
+ * @returns float32 samples
+ */
+export declare function decodePcm(
+  buffer: ArrayBuffer,
+  format: number
+): ArrayBuffer;
+
+/**
+ * Convert float32 PCM and write a standard WAV file. Conversion is chunked,
+ * so memory use does not grow with the buffer length.
+ * @param path          absolute destination path on the device
+ * @param buffer        ArrayBuffer containing float32 interleaved PCM
+ * @param sampleRate    stream sample rate
+ * @param channels      number of audio channels
+ * @param frames        number of sample frames (capped at buffer.byteLength)
+ * @param bitsPerSample 16 (default) or 24 for PCM, 32 for IEEE float
  * @returns true on success, false on failure
  */
 export declare function writeWavFile(
@@ -49,5 +199,267 @@ export declare function writeWavFile(
   buffer: ArrayBuffer,
   sampleRate: number,
   channels: number,
-  frames: number
+  frames: number,
+  bitsPerSample?: number
+): boolean;
+
+/**
+ * Start a streaming WAV file. Append float32 blocks with appendWavWriter()
+ * and close it with finalizeWavWriter(); files over 4 GiB become RF64.
+ * @param path          absolute destination path on the device
+ * @param sampleRate    stream sample rate
+ * @param channels      number of audio channels
+ * @param bitsPerSample 16 or 24 for PCM, 32 for IEEE float
+ * @param dither        TPDF-dither 16 / 24-bit output (default false)
+ * @returns writer handle, or -1 on failure
+ */
+export declare function openWavWriter(
+  path: string,
+  sampleRate: number,
+  channels: number,
+  bitsPerSample: number,
+  dither?: boolean
+): number;
+
+/**
+ * Convert and append one block of float32 interleaved PCM.
+ * @param handle  handle returned by openWavWriter
+ * @param buffer  whole frames of float32 PCM
+ * @returns true on success
+ */
+export declare function appendWavWriter(
+  handle: number,
+  buffer: ArrayBuffer
+): boolean;
+
+/**
+ * Patch the WAV sizes, close the file and release the handle.
+ * @param handle  handle returned by openWavWriter
+ * @returns true if every block and the header were written
+ */
+export declare function finalizeWavWriter(handle: number): boolean;
+
+/**
+ * Create an anonymous shared-memory region for the PROCESS_SHM_CODE request.
+ * @param name  debug name of the region
+ * @param size  region size in bytes
+ * @returns file descriptor, or -1 on failure
+ */
+export declare function createSharedMemory(
+  name: string,
+  size: number
+): number;
+
+/**
+ * Copy an ArrayBuffer (or a typed-array view of one) into the shared region.
+ * @param fd      fd returned by createSharedMemory
+ * @param offset  destination byte offset
+ * @param buffer  bytes to copy
+ * @returns true on success
+ */
+export declare function writeSharedMemory(
+  fd: number,
+  offset: number,
+  buffer: ArrayBuffer | Uint8Array | Float32Array
+): boolean;
+
+/**
+ * Copy bytes out of the shared region.
+ * @param fd      fd returned by createSharedMemory
+ * @param offset  source byte offset
+ * @param length  number of bytes to read
+ * @returns ArrayBuffer of the requested length
+ */
+export declare function readSharedMemory(
+  fd: number,
+  offset: number,
+  length: number
+): ArrayBuffer;
+
+/**
+ * Change gain / bypass of a region whose header was built with flags
+ * AUDIO_FLAG_LIVE_CONTROL (2), without IPC and without rewriting the
+ * header. The service picks the values up at its next 256-frame block —
+ * even in the middle of a running call — and ramps to them.
+ * @param fd          fd returned by createSharedMemory
+ * @param rampFrames  smoothing length in frames (default 0 = 10 ms)
+ * @returns false if the header cannot be mapped
+ */
+export declare function setLiveControl(
+  fd: number,
+  gain: number,
+  bypass: number,
+  rampFrames?: number
 ): boolean;
+
+/** Levels the service measured for one request (see readMeter) */
+export class HostMeter {
+  channels: number;
+  /** Frames per channel the levels cover */
+  frames: number;
+  /** Linear levels per channel, 1.0 = full scale */
+  inPeak: number[];
+  outPeak: number[];
+  inRms: number[];
+  outRms: number[];
+  /** Samples driven into saturation, per channel */
+  clipCount: number[];
+  clipTotal: number;
+  /** BS.1770 short-term loudness in LUFS (flag 16; -Infinity for silence) */
+  loudnessLufs?: number;
+}
+
+/**
+ * Read the meter block of a region whose header was built with flag 8,
+ * after the request finished (status DONE).
+ * @returns null if the region is not metered, no request was metered yet
+ *          or the stream has more than 8 channels
+ */
+export declare function readMeter(fd: number): HostMeter | null;
+
+/** Output frames one request wrote (see readOutputRange) */
+export class OutputRange {
+  /** First frame written in the output region */
+  frameOffset: number;
+  frames: number;
+}
+
+/**
+ * Where the last request wrote its output, for resampled requests whose
+ * frame count differs from the input's. Read it after status is DONE.
+ * @param fd  region fd
+ * @returns null for a v1 region or one that cannot be read
+ */
+export declare function readOutputRange(fd: number): OutputRange | null;
+
+/**
+ * NaN / Inf input samples the last guarded request (flag 64) replaced with
+ * 0. With flag 128 a non-zero count fails the request with status -1.
+ * @param fd  region fd
+ * @returns null for a v1 region or one that cannot be read
+ */
+export declare function readNonFiniteCount(fd: number): number | null;
+
+/**
+ * Close a region fd returned by createSharedMemory.
+ * @param fd  region fd
+ */
+export declare function closeSharedMemory(fd: number): void;
+
+/** Region returned by createBatchRegion() */
+export class BatchRegion {
+  /** shared-memory fd (close with closeSharedMemory), -1 on failure */
+  fd: number;
+  /** region size in bytes, for PROCESS_BATCH_CODE */
+  size: number;
+  /** byte offset of each job's output PCM (same length as its clip) */
+  outputOffsets: number[];
+}
+
+/**
+ * Pack many float32 clips into one PROCESS_BATCH_CODE region.
+ * Offsets are 64-byte aligned; every clip uses the same format and params.
+ * @param name        debug name of the region
+ * @param clips       float32 interleaved PCM, one ArrayBuffer per job
+ * @param sampleRate  sample rate of every clip
+ * @param channels    channel count of every clip
+ * @param gain        DSP gain value (0.0 ~ 2.0)
+ * @param bypass      0 = process,  1 = bypass
+ * @param parallel    let the service run jobs concurrently
+ * @returns BatchRegion
+ */
+export declare function createBatchRegion(
+  name: string,
+  clips: ArrayBuffer[],
+  sampleRate: number,
+  channels: number,
+  gain: number,
+  bypass: number,
+  parallel: boolean
+): BatchRegion;
+
+/**
+ * Promise variant of generateSineWave(); the synthesis runs on a native worker.
+ */
+export declare function generateSineWaveAsync(
+  sampleRate: number,
+  frames: number,
+  channels: number,
+  freqHz: number
+): Promise<ArrayBuffer>;
+
+/**
+ * Promise variant of writeWavFile(); conversion and file I/O run on a native
+ * worker. Do not modify buffer until the Promise settles.
+ */
+export declare function writeWavFileAsync(
+  path: string,
+  buffer: ArrayBuffer,
+  sampleRate: number,
+  channels: number,
+  frames: number,
+  bitsPerSample?: number
+): Promise<boolean>;
+
+/** Counters returned by getAsyncStats() */
+export class AsyncJobStats {
+  /** Jobs queued but not yet picked up by a worker */
+  queued: number;
+  /** Jobs currently executing */
+  inFlight: number;
+  /** Jobs settled (resolved or rejected) since the library was loaded */
+  completed: number;
+}
+
+/** Snapshot of the async job counters, for caller-side backpressure. */
+export declare function getAsyncStats(): AsyncJobStats;
+
+/** Per-phase durations of one traced request, in ns; -1 = not stamped */
+export class TraceBreakdown {
+  requestId: number;
+  /** false when the service did not stamp this request id */
+  complete: boolean;
+  /** beginTrace → endTrace */
+  totalNs: number;
+  /** IPC request leg: beginTrace → service received the request */
+  sendNs: number;
+  /** Service: region mapped / session looked up */
+  mapNs: number;
+  /** Service: header validation, chain setup */
+  setupNs: number;
+  dspNs: number;
+  /** Service: status and timing stored in the header */
+  writeBackNs: number;
+  /** Service: remaining handler time until the reply */
+  finishNs: number;
+  /** IPC reply leg: service reply → endTrace */
+  replyNs: number;
+}
+
+/**
+ * Stamp requestId and the send time into a trace-flagged region (header
+ * built with flags including 4). Call right before sendMessageRequest.
+ * @param requestId  correlation id (> 0), echoed by DspService
+ * @returns false if the region carries no trace block
+ */
+export declare function beginTrace(fd: number, requestId: number): boolean;
+
+/**
+ * Stamp the reply time and read back both sides' stamps. Also records the
+ * request into the native trace buffer when setTracing(true).
+ * @returns null if the region carries no trace block
+ */
+export declare function endTrace(fd: number): TraceBreakdown | null;
+
+/** CLOCK_MONOTONIC in nanoseconds, the clock of all trace stamps. */
+export declare function traceNow(): number;
+
+/** Record traced requests into the native trace buffer (off by default). */
+export declare function setTracing(enabled: boolean): void;
+
+/**
+ * Write the native trace buffer as Chrome trace-event JSON (open it in
+ * chrome://tracing or Perfetto).
+ * @returns false on an I/O error or when tracing is compiled out
+ */
+export declare function dumpTrace(path: string): boolean;
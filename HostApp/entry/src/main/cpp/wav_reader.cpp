@@ -0,0 +1,227 @@
+/**
+ * wav_reader.cpp — memory-mapped WAV reader with bounded memory
+ */
+
+#include "wav_reader.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace HostAudio {
+
+namespace {
+
+constexpr uint16_t kWaveFormatPcm        = 1;
+constexpr uint16_t kWaveFormatFloat      = 3;
+constexpr uint16_t kWaveFormatExtensible = 0xFFFE;
+
+constexpr uint32_t kSize32Unknown = 0xFFFFFFFFu;   /* RF64: see ds64      */
+
+uint16_t getLe16(const uint8_t* p)
+{
+    return static_cast<uint16_t>(p[0] | (p[1] << 8));
+}
+
+uint32_t getLe32(const uint8_t* p)
+{
+    return getLe16(p) | (static_cast<uint32_t>(getLe16(p + 2)) << 16);
+}
+
+uint64_t getLe64(const uint8_t* p)
+{
+    return getLe32(p) | (static_cast<uint64_t>(getLe32(p + 4)) << 32);
+}
+
+bool readAt(int fd, uint64_t offset, void* dst, size_t bytes)
+{
+    uint8_t* out = static_cast<uint8_t*>(dst);
+    while (bytes != 0) {
+        const ssize_t n = pread(fd, out, bytes, static_cast<off_t>(offset));
+        if (n <= 0) {
+            return false;
+        }
+        out    += n;
+        offset += static_cast<uint64_t>(n);
+        bytes  -= static_cast<size_t>(n);
+    }
+    return true;
+}
+
+bool sampleFormat(uint16_t tag, uint16_t bits, WavSampleFormat& out)
+{
+    if (tag == kWaveFormatPcm && (bits == 16 || bits == 24)) {
+        return wavSampleFormatFromBits(bits, out);
+    }
+    if (tag == kWaveFormatFloat && bits == 32) {
+        out = WavSampleFormat::Float32;
+        return true;
+    }
+    return false;
+}
+
+uint32_t audioFormatOf(WavSampleFormat format)
+{
+    switch (format) {
+    case WavSampleFormat::Pcm16: return AUDIO_FORMAT_S16;
+    case WavSampleFormat::Pcm24: return AUDIO_FORMAT_S24_PACKED;
+    default:                     return AUDIO_FORMAT_FLOAT32;
+    }
+}
+
+} // namespace
+
+WavReader::~WavReader()
+{
+    close();
+}
+
+bool WavReader::open(const std::string& path)
+{
+    if (isOpen()) {
+        return false;
+    }
+    fd_ = ::open(path.c_str(), O_RDONLY);
+    if (fd_ < 0) {
+        return false;
+    }
+
+    struct stat st {};
+    uint8_t riff[12];
+    if (fstat(fd_, &st) != 0 || !readAt(fd_, 0, riff, sizeof(riff))
+        || (std::memcmp(riff, "RIFF", 4) != 0 && std::memcmp(riff, "RF64", 4) != 0)
+        || std::memcmp(riff + 8, "WAVE", 4) != 0) {
+        close();
+        return false;
+    }
+    fileSize_ = static_cast<uint64_t>(st.st_size);
+
+    /* Walk the chunk list up to "data"; fmt and ds64 must come before it */
+    uint64_t ds64DataSize = 0;
+    uint64_t dataSize = 0;
+    bool haveFmt = false;
+    bool haveData = false;
+    uint16_t tag = 0, bits = 0, blockAlign = 0;
+    uint64_t off = sizeof(riff);
+    while (!haveData && off + 8 <= fileSize_) {
+        uint8_t chunk[8];
+        if (!readAt(fd_, off, chunk, sizeof(chunk))) {
+            break;
+        }
+        const uint32_t size = getLe32(chunk + 4);
+        const uint64_t body = off + 8;
+
+        if (std::memcmp(chunk, "ds64", 4) == 0 && size >= 16) {
+            uint8_t ds64[16];
+            if (!readAt(fd_, body, ds64, sizeof(ds64))) {
+                break;
+            }
+            ds64DataSize = getLe64(ds64 + 8);
+        } else if (std::memcmp(chunk, "fmt ", 4) == 0 && size >= 16) {
+            uint8_t fmt[40] = {};
+            if (!readAt(fd_, body, fmt, std::min<size_t>(size, sizeof(fmt)))) {
+                break;
+            }
+            tag         = getLe16(fmt);
+            channels_   = getLe16(fmt + 2);
+            sampleRate_ = getLe32(fmt + 4);
+            blockAlign  = getLe16(fmt + 12);
+            bits        = getLe16(fmt + 14);
+            if (tag == kWaveFormatExtensible && size >= 40) {
+                tag = getLe16(fmt + 24);      /* first two bytes of the subformat GUID */
+            }
+            haveFmt = true;
+        } else if (std::memcmp(chunk, "data", 4) == 0) {
+            dataOffset_ = body;
+            dataSize    = size == kSize32Unknown && ds64DataSize != 0 ? ds64DataSize : size;
+            haveData    = true;
+        }
+        off = body + size + (size & 1u);
+    }
+
+    if (!haveFmt || !haveData || !sampleFormat(tag, bits, format_)
+        || channels_ == 0 || sampleRate_ == 0 || blockAlign != channels_ * (bits / 8u)) {
+        close();
+        return false;
+    }
+
+    /* An unfinalized or cut-off file: use what is actually there */
+    dataSize    = std::min(dataSize, fileSize_ - std::min(dataOffset_, fileSize_));
+    frameBytes_ = blockAlign;
+    frames_     = dataSize / frameBytes_;
+    framesRead_ = 0;
+    failed_     = false;
+    return true;
+}
+
+void WavReader::close()
+{
+    unmapWindow();
+    if (fd_ >= 0) {
+        ::close(fd_);
+        fd_ = -1;
+    }
+    frames_ = framesRead_ = 0;
+}
+
+bool WavReader::mapWindow(uint64_t offset)
+{
+    unmapWindow();
+
+    const uint64_t page  = static_cast<uint64_t>(sysconf(_SC_PAGESIZE));
+    const uint64_t start = offset / page * page;
+    const size_t   size  = static_cast<size_t>(std::min<uint64_t>(kWindowBytes, fileSize_ - start));
+    void* p = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd_, static_cast<off_t>(start));
+    if (p == MAP_FAILED) {
+        return false;
+    }
+    madvise(p, size, MADV_SEQUENTIAL);
+
+    window_      = static_cast<const uint8_t*>(p);
+    windowStart_ = start;
+    windowSize_  = size;
+    return true;
+}
+
+void WavReader::unmapWindow()
+{
+    if (window_) {
+        munmap(const_cast<uint8_t*>(window_), windowSize_);
+        window_     = nullptr;
+        windowSize_ = 0;
+    }
+}
+
+size_t WavReader::read(float* dst, size_t frames)
+{
+    if (!isOpen() || failed_ || !dst) {
+        return 0;
+    }
+
+    const uint32_t audioFormat = audioFormatOf(format_);
+    size_t done = 0;
+    while (done < frames && framesRead_ < frames_) {
+        const uint64_t pos = dataOffset_ + framesRead_ * frameBytes_;
+        if (!window_ || pos < windowStart_ || pos + frameBytes_ > windowStart_ + windowSize_) {
+            if (!mapWindow(pos)) {
+                failed_ = true;
+                break;
+            }
+        }
+
+        const size_t inWindow = static_cast<size_t>((windowStart_ + windowSize_ - pos) / frameBytes_);
+        const size_t n = static_cast<size_t>(std::min<uint64_t>(
+            std::min(frames - done, inWindow), frames_ - framesRead_));
+        AudioFormat::decode(audioFormat, window_ + (pos - windowStart_),
+                            dst + done * channels_, n * channels_);
+        done        += n;
+        framesRead_ += n;
+    }
+    return done;
+}
+
+} // namespace HostAudio
@@ -0,0 +1,88 @@
+/**
+ * wav_reader.h — memory-mapped WAV reader with bounded memory
+ *
+ * open() parses the RIFF (or RF64) chunk list with pread(); read() then
+ * decodes the data chunk through a sliding read-only mapping of
+ * kWindowBytes. Moving the window unmaps the previous one, so the mapped
+ * and resident size stays at one window however long the file is, and
+ * files above 4 GiB read fine on 32-bit processes too.
+ *
+ * Accepted encodings are the ones WavWriter produces: 16- and 24-bit PCM
+ * and 32-bit IEEE float, plain or as WAVE_FORMAT_EXTENSIBLE.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "wav_writer.h"
+
+namespace HostAudio {
+
+class WavReader {
+public:
+    /** Size of the mapping window (a multiple of every page size in use). */
+    static constexpr size_t kWindowBytes = 4u << 20;
+
+    WavReader() = default;
+    ~WavReader();
+
+    WavReader(const WavReader&) = delete;
+    WavReader& operator=(const WavReader&) = delete;
+
+    /**
+     * Open @p path and parse its header.
+     * @return false if already open, on an I/O error, or if the file is not
+     *         a WAV file in one of the accepted encodings
+     */
+    bool open(const std::string& path);
+
+    /** Unmap the window and close the file. */
+    void close();
+
+    bool isOpen() const { return fd_ >= 0; }
+
+    uint32_t sampleRate() const { return sampleRate_; }
+    uint32_t channels() const { return channels_; }
+    WavSampleFormat format() const { return format_; }
+
+    /** Frames in the data chunk (truncated files: the frames present). */
+    uint64_t frames() const { return frames_; }
+
+    /** Frames returned by read() so far. */
+    uint64_t framesRead() const { return framesRead_; }
+
+    /**
+     * Decode up to @p frames frames as float32 interleaved into @p dst.
+     * @return frames decoded; 0 at the end of the data or on an I/O error
+     *         (failed() tells the two apart)
+     */
+    size_t read(float* dst, size_t frames);
+
+    /** True after a mapping error. */
+    bool failed() const { return failed_; }
+
+private:
+    /* Map the window holding file offset @p offset */
+    bool mapWindow(uint64_t offset);
+    void unmapWindow();
+
+    int             fd_ = -1;
+    uint64_t        fileSize_    = 0;
+    uint64_t        dataOffset_  = 0;
+    uint64_t        frames_      = 0;
+    uint64_t        framesRead_  = 0;
+    uint32_t        sampleRate_  = 0;
+    uint32_t        channels_    = 0;
+    uint32_t        frameBytes_  = 0;
+    WavSampleFormat format_      = WavSampleFormat::Pcm16;
+    bool            failed_      = false;
+
+    const uint8_t*  window_      = nullptr;
+    uint64_t        windowStart_ = 0;   /* file offset of window_[0]      */
+    size_t          windowSize_  = 0;
+};
+
+} // namespace HostAudio
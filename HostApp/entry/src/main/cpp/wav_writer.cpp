@@ -0,0 +1,222 @@
+/**
+ * wav_writer.cpp — streaming WAV writer with bounded memory
+ */
+
+#include "wav_writer.h"
+
+#include <algorithm>
+
+namespace HostAudio {
+
+namespace {
+
+constexpr uint16_t kWaveFormatPcm   = 1;
+constexpr uint16_t kWaveFormatFloat = 3;
+
+constexpr uint32_t kJunkSize = 28;           /* = sizeof ds64 body        */
+constexpr uint32_t kOffsetRiffSize = 4;
+constexpr uint32_t kOffsetDs64     = 12;
+constexpr uint64_t kMaxRiffSize    = 0xFFFFFFFFull;
+
+void putLe16(std::vector<uint8_t>& v, uint16_t x)
+{
+    v.push_back(static_cast<uint8_t>(x));
+    v.push_back(static_cast<uint8_t>(x >> 8));
+}
+
+void putLe32(std::vector<uint8_t>& v, uint32_t x)
+{
+    putLe16(v, static_cast<uint16_t>(x));
+    putLe16(v, static_cast<uint16_t>(x >> 16));
+}
+
+void putLe64(std::vector<uint8_t>& v, uint64_t x)
+{
+    putLe32(v, static_cast<uint32_t>(x));
+    putLe32(v, static_cast<uint32_t>(x >> 32));
+}
+
+void putId(std::vector<uint8_t>& v, const char* id)
+{
+    v.insert(v.end(), id, id + 4);
+}
+
+} // namespace
+
+bool wavSampleFormatFromBits(int bits, WavSampleFormat& out)
+{
+    switch (bits) {
+    case 16: out = WavSampleFormat::Pcm16;   return true;
+    case 24: out = WavSampleFormat::Pcm24;   return true;
+    case 32: out = WavSampleFormat::Float32; return true;
+    default: return false;
+    }
+}
+
+WavWriter::~WavWriter()
+{
+    if (isOpen()) {
+        finalize();
+    }
+}
+
+bool WavWriter::open(const std::string& path, uint32_t sampleRate, uint32_t channels,
+                     WavSampleFormat format, bool dither)
+{
+    if (isOpen() || sampleRate == 0 || channels == 0 || channels > 0xFFFFu) {
+        return false;
+    }
+    const uint32_t bytesPerSample = static_cast<uint32_t>(format) / 8u;
+    const uint64_t byteRate = static_cast<uint64_t>(sampleRate) * channels * bytesPerSample;
+    if (byteRate > kMaxRiffSize) {
+        return false;
+    }
+
+    const bool isFloat = format == WavSampleFormat::Float32;
+    std::vector<uint8_t> hdr;
+    hdr.reserve(96);
+
+    putId(hdr, "RIFF");
+    putLe32(hdr, 0);                          /* patched by finalize()    */
+    putId(hdr, "WAVE");
+
+    /* Placeholder for ds64, so RF64 needs no data move at finalize() */
+    putId(hdr, "JUNK");
+    putLe32(hdr, kJunkSize);
+    hdr.resize(hdr.size() + kJunkSize, 0);
+
+    putId(hdr, "fmt ");
+    putLe32(hdr, isFloat ? 18u : 16u);
+    putLe16(hdr, isFloat ? kWaveFormatFloat : kWaveFormatPcm);
+    putLe16(hdr, static_cast<uint16_t>(channels));
+    putLe32(hdr, sampleRate);
+    putLe32(hdr, static_cast<uint32_t>(byteRate));
+    putLe16(hdr, static_cast<uint16_t>(channels * bytesPerSample));
+    putLe16(hdr, static_cast<uint16_t>(bytesPerSample * 8u));
+    if (isFloat) {
+        putLe16(hdr, 0);                      /* cbSize                   */
+
+        /* Non-PCM formats carry a fact chunk with the frame count */
+        putId(hdr, "fact");
+        putLe32(hdr, 4);
+        factOffset_ = static_cast<uint32_t>(hdr.size());
+        putLe32(hdr, 0);
+    } else {
+        factOffset_ = 0;
+    }
+
+    putId(hdr, "data");
+    dataSizeOffset_ = static_cast<uint32_t>(hdr.size());
+    putLe32(hdr, 0);
+    headerBytes_ = static_cast<uint32_t>(hdr.size());
+
+    file_.open(path, std::ios::binary | std::ios::trunc);
+    if (!file_.is_open()) {
+        return false;
+    }
+    file_.write(reinterpret_cast<const char*>(hdr.data()), static_cast<std::streamsize>(hdr.size()));
+
+    format_         = format;
+    channels_       = channels;
+    bytesPerSample_ = bytesPerSample;
+    dither_         = dither && !isFloat;
+    failed_         = !file_.good();
+    frames_         = 0;
+    dataBytes_      = 0;
+    AudioFormat::seedDither(ditherState_, 0x9E3779B9u);
+    if (!isFloat) {
+        scratch_.resize(kChunkSamples * bytesPerSample);
+    }
+    return !failed_;
+}
+
+bool WavWriter::append(const float* pcm, size_t frames)
+{
+    if (!isOpen() || failed_ || (!pcm && frames != 0)) {
+        return false;
+    }
+
+    const size_t samples = frames * channels_;
+    if (format_ == WavSampleFormat::Float32) {
+        /* Little-endian IEEE float is the in-memory layout already */
+        file_.write(reinterpret_cast<const char*>(pcm),
+                    static_cast<std::streamsize>(samples * sizeof(float)));
+    } else {
+        const uint32_t audioFormat = format_ == WavSampleFormat::Pcm16
+                                   ? AUDIO_FORMAT_S16 : AUDIO_FORMAT_S24_PACKED;
+        AudioFormat::Dither* dither = dither_ ? &ditherState_ : nullptr;
+        for (size_t pos = 0; pos < samples && file_.good(); pos += kChunkSamples) {
+            const size_t n = std::min(kChunkSamples, samples - pos);
+            AudioFormat::encode(audioFormat, pcm + pos, scratch_.data(), n, dither);
+            file_.write(reinterpret_cast<const char*>(scratch_.data()),
+                        static_cast<std::streamsize>(n * bytesPerSample_));
+        }
+    }
+
+    if (!file_.good()) {
+        failed_ = true;
+        return false;
+    }
+    frames_    += frames;
+    dataBytes_ += static_cast<uint64_t>(samples) * bytesPerSample_;
+    return true;
+}
+
+bool WavWriter::finalize()
+{
+    if (!isOpen()) {
+        return false;
+    }
+
+    /* Chunks are word-aligned: odd data sizes get one pad byte */
+    const uint64_t pad = dataBytes_ & 1u;
+    if (pad) {
+        file_.put('\0');
+    }
+
+    const uint64_t riffSize = headerBytes_ - 8u + dataBytes_ + pad;
+    const bool rf64 = riffSize > kMaxRiffSize;
+
+    auto patch = [this](uint32_t offset, const std::vector<uint8_t>& bytes) {
+        file_.seekp(static_cast<std::streamoff>(offset));
+        file_.write(reinterpret_cast<const char*>(bytes.data()),
+                    static_cast<std::streamsize>(bytes.size()));
+    };
+
+    std::vector<uint8_t> v;
+    if (rf64) {
+        putId(v, "RF64");
+        putLe32(v, 0xFFFFFFFFu);
+        patch(0, v);
+
+        v.clear();
+        putId(v, "ds64");
+        putLe32(v, kJunkSize);
+        putLe64(v, riffSize);
+        putLe64(v, dataBytes_);
+        putLe64(v, frames_);
+        putLe32(v, 0);                        /* no extra size table      */
+        patch(kOffsetDs64, v);
+    } else {
+        putLe32(v, static_cast<uint32_t>(riffSize));
+        patch(kOffsetRiffSize, v);
+    }
+
+    if (factOffset_ != 0) {
+        v.clear();
+        putLe32(v, rf64 || frames_ > kMaxRiffSize ? 0xFFFFFFFFu : static_cast<uint32_t>(frames_));
+        patch(factOffset_, v);
+    }
+
+    v.clear();
+    putLe32(v, rf64 ? 0xFFFFFFFFu : static_cast<uint32_t>(dataBytes_));
+    patch(dataSizeOffset_, v);
+
+    const bool ok = !failed_ && file_.good();
+    file_.close();
+    scratch_.clear();
+    scratch_.shrink_to_fit();
+    return ok && !file_.fail();
+}
+
+} // namespace HostAudio
@@ -0,0 +1,99 @@
+/**
+ * wav_writer.h — streaming WAV writer with bounded memory
+ *
+ * open() writes a provisional header, append() converts float32 blocks in
+ * fixed-size chunks and writes them straight out, finalize() patches the
+ * RIFF / data sizes. Peak memory is one conversion chunk no matter how
+ * long the file gets.
+ *
+ * The header always reserves a 28-byte JUNK chunk after "WAVE". Files that
+ * end up larger than 4 GiB are finalized as RF64 (EBU Tech 3306): "RIFF"
+ * becomes "RF64", the JUNK chunk becomes "ds64" with the 64-bit sizes,
+ * and the 32-bit size fields are set to 0xFFFFFFFF.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "AudioFormatConvert.h"
+
+namespace HostAudio {
+
+/** Sample encoding of the WAV data chunk */
+enum class WavSampleFormat : uint32_t {
+    Pcm16   = 16,   /* WAVE_FORMAT_PCM, 16-bit                */
+    Pcm24   = 24,   /* WAVE_FORMAT_PCM, 24-bit packed         */
+    Float32 = 32,   /* WAVE_FORMAT_IEEE_FLOAT (3), 32-bit     */
+};
+
+/**
+ * Map a bits-per-sample value (16, 24 or 32 = float) to a WavSampleFormat.
+ * @return false for any other value
+ */
+bool wavSampleFormatFromBits(int bits, WavSampleFormat& out);
+
+class WavWriter {
+public:
+    /** Samples converted per chunk; bounds the scratch buffer. */
+    static constexpr size_t kChunkSamples = 16384;
+
+    WavWriter() = default;
+    ~WavWriter();
+
+    WavWriter(const WavWriter&) = delete;
+    WavWriter& operator=(const WavWriter&) = delete;
+
+    /**
+     * Create (truncate) @p path and write a provisional header.
+     * @param dither  TPDF-dither the integer formats (ignored for Float32)
+     * @return false if already open, on bad parameters or an I/O error
+     */
+    bool open(const std::string& path, uint32_t sampleRate, uint32_t channels,
+              WavSampleFormat format, bool dither = false);
+
+    /**
+     * Convert and append @p frames frames of float32 interleaved PCM.
+     * Integer formats clamp to [-1, 1); Float32 is written unchanged.
+     * @return false when not open or on an I/O error
+     */
+    bool append(const float* pcm, size_t frames);
+
+    /**
+     * Patch the header sizes (RF64 above 4 GiB) and close the file.
+     * Called by the destructor if still open.
+     * @return false on an I/O error or when nothing was open
+     */
+    bool finalize();
+
+    bool isOpen() const { return file_.is_open(); }
+
+    uint32_t channels() const { return channels_; }
+
+    /** Frames appended since open(). */
+    uint64_t framesWritten() const { return frames_; }
+
+    /** PCM bytes in the data chunk so far. */
+    uint64_t dataBytes() const { return dataBytes_; }
+
+private:
+    std::ofstream        file_;
+    std::vector<uint8_t> scratch_;
+    AudioFormat::Dither  ditherState_ {};
+    WavSampleFormat      format_   = WavSampleFormat::Pcm16;
+    uint32_t             channels_ = 0;
+    uint32_t             bytesPerSample_ = 0;
+    bool                 dither_   = false;
+    bool                 failed_   = false;
+    uint64_t             frames_   = 0;
+    uint64_t             dataBytes_ = 0;
+    uint32_t             factOffset_ = 0;   /* 0 = no fact chunk        */
+    uint32_t             dataSizeOffset_ = 0;
+    uint32_t             headerBytes_ = 0;
+};
+
+} // namespace HostAudio
@@ -0,0 +1,195 @@
+/**
+ * bench_conv.cpp — convolution stage benchmarks
+ *
+ *   fir_direct         direct-form FIR, one multiply-add per tap and
+ *                      sample (the baseline the FFT path has to beat)
+ *   conv_<isa>         PartitionedConvolver at the partition the chain
+ *                      would pick (autoPartition), per supported ISA
+ *   conv_b<frames>     same on the active ISA at a fixed partition, to
+ *                      check autoPartition against the alternatives
+ *   fft_<isa>          one forward + inverse RealFft of N points
+ *
+ * Buffers are interleaved stereo at 48 kHz; IR lengths go from a short
+ * cabinet (64 taps) to a 1.4 s room (65536 taps). The convolver keeps its
+ * input history across iterations, so every pass after the first runs on
+ * a full delay line, as it does in a stream.
+ */
+
+#include "bench_harness.h"
+#include "dsp_convolver.h"
+#include "dsp_fft.h"
+#include "dsp_kernels.h"
+
+#include <cmath>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace Bench {
+
+namespace {
+
+constexpr uint32_t kChannels = 2;
+constexpr uint32_t kFrames   = 4096;
+
+/* Decaying noise, the rough shape of a measured room response */
+std::vector<float> makeImpulse(uint32_t frames, uint32_t channels)
+{
+    std::vector<float> taps(static_cast<size_t>(frames) * channels);
+    uint32_t seed = 0x1234567u;
+    for (uint32_t ch = 0; ch < channels; ++ch) {
+        for (uint32_t i = 0; i < frames; ++i) {
+            seed = seed * 1664525u + 1013904223u;
+            const float noise = static_cast<float>(seed >> 8) * (2.0f / 16777216.0f) - 1.0f;
+            taps[static_cast<size_t>(ch) * frames + i] =
+                noise * std::exp(-6.0f * static_cast<float>(i) / static_cast<float>(frames));
+        }
+    }
+    return taps;
+}
+
+/* Streaming direct-form FIR on interleaved PCM: per channel a history of
+   the last L − 1 inputs followed by the current buffer */
+class DirectFir {
+public:
+    DirectFir(const std::vector<float>& taps, uint32_t irFrames, uint32_t channels, uint32_t frames)
+        : irFrames_(irFrames), channels_(channels),
+          reversed_(taps.size()),
+          line_(static_cast<size_t>(channels) * (irFrames - 1 + frames))
+    {
+        for (uint32_t ch = 0; ch < channels; ++ch) {
+            for (uint32_t i = 0; i < irFrames; ++i) {
+                reversed_[ch * irFrames + i] = taps[ch * irFrames + irFrames - 1 - i];
+            }
+        }
+    }
+
+    void process(float* pcm, uint32_t frames)
+    {
+        const size_t span = irFrames_ - 1 + frames;
+        for (uint32_t ch = 0; ch < channels_; ++ch) {
+            float* line = line_.data() + ch * span;
+            const float* h = reversed_.data() + ch * irFrames_;
+            for (uint32_t f = 0; f < frames; ++f) {
+                line[irFrames_ - 1 + f] = pcm[f * channels_ + ch];
+            }
+            for (uint32_t f = 0; f < frames; ++f) {
+                const float* x = line + f;
+                float acc = 0.0f;
+                for (uint32_t i = 0; i < irFrames_; ++i) {
+                    acc += h[i] * x[i];
+                }
+                pcm[f * channels_ + ch] = acc;
+            }
+            std::memmove(line, line + frames, (irFrames_ - 1) * sizeof(float));
+        }
+    }
+
+private:
+    uint32_t irFrames_;
+    uint32_t channels_;
+    std::vector<float> reversed_;
+    std::vector<float> line_;
+};
+
+} // namespace
+
+void registerConvSuite(Runner& runner)
+{
+    using namespace DspProcessor;
+
+    const std::vector<uint32_t> irSweep = runner.options().quick
+        ? std::vector<uint32_t> { 256, 16384 }
+        : std::vector<uint32_t> { 64, 256, 1024, 4096, 16384, 65536 };
+    const KernelIsa isas[] = { KernelIsa::Scalar, KernelIsa::Sse2, KernelIsa::Avx2, KernelIsa::Neon };
+
+    const size_t n = static_cast<size_t>(kFrames) * kChannels;
+    std::vector<float> input(n);
+    for (size_t i = 0; i < n; ++i) {
+        input[i] = 0.5f * std::sin(0.0627f * static_cast<float>(i));
+    }
+    std::vector<float> work(n);
+    const uint64_t bytes = 2ull * n * sizeof(float);
+
+    for (uint32_t irFrames : irSweep) {
+        const std::vector<float> taps = makeImpulse(irFrames, kChannels);
+        const uint32_t autoB = PartitionedConvolver::autoPartition(irFrames, kFrames);
+        Params p;
+        p.add("ir", irFrames).add("frames", kFrames).add("channels", kChannels);
+
+        /* 65536 taps is ~5·10^8 multiply-adds per pass: skip in quick runs */
+        if (!runner.options().quick || irFrames <= 4096) {
+            DirectFir fir(taps, irFrames, kChannels, kFrames);
+            runner.measure("fir_direct", p, n, bytes, [&] {
+                std::memcpy(work.data(), input.data(), n * sizeof(float));
+                fir.process(work.data(), kFrames);
+                doNotOptimize(work.data());
+            });
+        }
+
+        for (KernelIsa isa : isas) {
+            if (!isKernelIsaSupported(isa)) {
+                continue;
+            }
+            const KernelIsa saved = activeKernelIsa();
+            forceKernelIsa(isa);
+            PartitionedConvolver conv;
+            const bool ok = conv.configure(taps.data(), kChannels, irFrames, kChannels, autoB, 1.0f, 0.0f);
+            forceKernelIsa(saved);
+            if (!ok) {
+                continue;
+            }
+            Params pb = p;
+            pb.add("partition", autoB);
+            runner.measure(std::string("conv_") + kernelIsaName(isa), pb, n, bytes, [&] {
+                std::memcpy(work.data(), input.data(), n * sizeof(float));
+                conv.process(work.data(), kFrames);
+                doNotOptimize(work.data());
+            });
+        }
+
+        for (uint32_t b = PartitionedConvolver::kMinPartition; b <= kFrames; b *= 4) {
+            PartitionedConvolver conv;
+            if (!conv.configure(taps.data(), kChannels, irFrames, kChannels, b, 1.0f, 0.0f)) {
+                continue;
+            }
+            Params pb = p;
+            pb.add("partition", b);
+            runner.measure("conv_b" + std::to_string(b), pb, n, bytes, [&] {
+                std::memcpy(work.data(), input.data(), n * sizeof(float));
+                conv.process(work.data(), kFrames);
+                doNotOptimize(work.data());
+            });
+        }
+    }
+
+    for (uint32_t size : { 256u, 4096u, 16384u }) {
+        for (KernelIsa isa : isas) {
+            if (!isKernelIsaSupported(isa)) {
+                continue;
+            }
+            const KernelIsa saved = activeKernelIsa();
+            forceKernelIsa(isa);
+            RealFft fft;
+            fft.init(size);
+            forceKernelIsa(saved);
+
+            const size_t m = fft.half();
+            std::vector<float> even(m), odd(m), outEven(m), outOdd(m);
+            for (size_t i = 0; i < m; ++i) {
+                even[i] = std::sin(0.0627f * static_cast<float>(2 * i));
+                odd[i]  = std::sin(0.0627f * static_cast<float>(2 * i + 1));
+            }
+            std::vector<float> re(m), im(m), scratch(fft.workFloats());
+            Params p;
+            p.add("n", size);
+            runner.measure(std::string("fft_") + kernelIsaName(isa), p, size, 4ull * size * sizeof(float), [&] {
+                fft.forward(even.data(), odd.data(), re.data(), im.data(), scratch.data());
+                fft.inverse(re.data(), im.data(), outEven.data(), outOdd.data(), scratch.data());
+                doNotOptimize(outEven.data());
+            });
+        }
+    }
+}
+
+} // namespace Bench
@@ -0,0 +1,274 @@
+/**
+ * bench_dsp.cpp — DspService core benchmarks
+ *
+ *   process_audio_bypass   DspProcessor::processAudio, bypass = true
+ *   process_audio_gain     DspProcessor::processAudio, gain + soft clip
+ *   process_audio_pooled   same, output in a recycled BufferPool block
+ *                          (the N-API processAudio path)
+ *   process_audio_inplace  processAudioInto with src == dst
+ *   softclip_<isa>         in-place soft-clip kernel for each supported ISA
+ *   process_frames_<fmt>   DspProcessor::processFrames on s16 / s24 PCM,
+ *                          gain + soft clip + dithered re-encode
+ *   live_control_steady    LiveControl::process, control block unchanged
+ *                          (one seqlock poll per 256 frames)
+ *   live_control_ramp      same, with a gain change ramped over the
+ *                          whole buffer every iteration (per-sample path)
+ *   shared_region_v2       processMappedRegion on a v2 region (aligned
+ *                          header fields, 64-byte-aligned PCM)
+ *   shared_region_v1       same on a packed v1 region, PCM regions back
+ *                          to back (the compatibility path)
+ *   stage_<kind>_fixed     one-stage ProcessingChain (biquad, dc_blocker,
+ *                          compressor) on the kernels generated for this
+ *                          channel count and block size
+ *   stage_<kind>_generic   same stage on the runtime-channel kernels
+ *   chain_fixed            biquad → DC blocker → compressor → biquad,
+ *                          generated kernels
+ *   chain_generic          same chain, runtime-channel kernels
+ *   chain_denormal_ieee    the chain on a tail decaying through the
+ *                          subnormal range, IEEE subnormals (the default)
+ *   chain_denormal_ftz     same inside a DenormalScope: flush-to-zero /
+ *                          denormals-are-zero, as AUDIO_FLAG_GUARD runs it
+ *   process_frames_guard   processFrames gain + soft clip on float32 with
+ *                          a FrameGuard (guard soft-clip kernel, NaN / Inf
+ *                          counted); compare with process_audio_inplace
+ *
+ * The stage / chain cases restore the input before every pass (the copy is
+ * included in both variants) so the recursive filters never drift into
+ * overflow or denormals across iterations; the denormal cases restore a
+ * tail that is subnormal from the start on purpose.
+ */
+
+#include "bench_harness.h"
+#include "dsp_buffer_pool.h"
+#include "dsp_chain.h"
+#include "dsp_denormals.h"
+#include "dsp_kernels.h"
+#include "dsp_live_control.h"
+#include "dsp_processor.h"
+#include "dsp_shared_memory.h"
+#include "audio_native.h"
+#include "AudioFormatConvert.h"
+#include "AudioLiveControl.h"
+
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+namespace Bench {
+
+namespace {
+
+std::vector<float> makeSignal(size_t numSamples)
+{
+    std::vector<float> pcm(numSamples);
+    for (size_t i = 0; i < numSamples; ++i) {
+        pcm[i] = 0.9f * std::sin(0.0627f * static_cast<float>(i));
+    }
+    return pcm;
+}
+
+/* A decaying tone from 1e-36 down past the smallest subnormal (~1.4e-45)
+   over the buffer: nearly every sample, and every filter state fed by it,
+   is subnormal */
+std::vector<float> makeDenormalTail(size_t numSamples)
+{
+    std::vector<float> pcm(numSamples);
+    const double decay = std::log(1e-10) / static_cast<double>(numSamples);
+    for (size_t i = 0; i < numSamples; ++i) {
+        pcm[i] = static_cast<float>(1e-36 * std::exp(decay * static_cast<double>(i))
+                                    * std::sin(0.0627 * static_cast<double>(i)));
+    }
+    return pcm;
+}
+
+/* Page-aligned start inside @p storage, as an mmap of the region would be */
+uint8_t* pageAligned(std::vector<uint8_t>& storage, size_t bytes)
+{
+    storage.resize(bytes + AUDIO_SHM_PAGE_ALIGN);
+    const uintptr_t addr = reinterpret_cast<uintptr_t>(storage.data());
+    return reinterpret_cast<uint8_t*>((addr + AUDIO_SHM_PAGE_ALIGN - 1) & ~uintptr_t(AUDIO_SHM_PAGE_ALIGN - 1));
+}
+
+AudioChainDescriptor makeChain(std::initializer_list<AudioChainStage> stages)
+{
+    AudioChainDescriptor desc {};
+    desc.magic = AUDIO_CHAIN_MAGIC;
+    for (const AudioChainStage& stage : stages) {
+        desc.stages[desc.stageCount++] = stage;
+    }
+    return desc;
+}
+
+} // namespace
+
+void registerDspSuite(Runner& runner)
+{
+    using namespace DspProcessor;
+
+    for (uint32_t frames : runner.framesSweep()) {
+        for (uint32_t channels : runner.channelsSweep()) {
+            const size_t n = static_cast<size_t>(frames) * channels;
+            const std::vector<float> input = makeSignal(n);
+            const uint64_t bytes = 2ull * n * sizeof(float);
+
+            Params p;
+            p.add("frames", frames).add("channels", channels);
+
+            runner.measure("process_audio_bypass", p, n, bytes, [&] {
+                auto res = processAudio(input.data(), static_cast<int>(n), 1.0f, true);
+                doNotOptimize(res.outputBytes.data());
+            });
+            runner.measure("process_audio_gain", p, n, bytes, [&] {
+                auto res = processAudio(input.data(), static_cast<int>(n), 1.5f, false);
+                doNotOptimize(res.outputBytes.data());
+            });
+            runner.measure("process_audio_pooled", p, n, bytes, [&] {
+                void* out = BufferPool::instance().acquire(n * sizeof(float));
+                processAudioInto(input.data(), static_cast<float*>(out), n, 1.5f, false, false);
+                doNotOptimize(out);
+                BufferPool::instance().release(out);
+            });
+            std::vector<float> inplace(input);
+            runner.measure("process_audio_inplace", p, n, bytes, [&] {
+                processAudioInto(inplace.data(), inplace.data(), n, 1.5f, false, false);
+                doNotOptimize(inplace.data());
+            });
+
+            std::vector<float> work(input);
+            for (KernelIsa isa : { KernelIsa::Scalar, KernelIsa::Sse2,
+                                   KernelIsa::Avx2, KernelIsa::Neon }) {
+                if (!isKernelIsaSupported(isa)) {
+                    continue;
+                }
+                const KernelIsa saved = activeKernelIsa();
+                forceKernelIsa(isa);
+                const SoftClipKernel kernel = softClipKernel();
+                runner.measure(std::string("softclip_") + kernelIsaName(isa), p, n, bytes, [&] {
+                    kernel(input.data(), work.data(), n, 1.5f);
+                    doNotOptimize(work.data());
+                });
+                forceKernelIsa(saved);
+            }
+
+            for (uint32_t format : { AUDIO_FORMAT_S16, AUDIO_FORMAT_S24_PACKED }) {
+                const size_t bps = AudioFormat::bytesPerSample(format);
+                std::vector<uint8_t> packedIn(n * bps);
+                std::vector<uint8_t> packedOut(n * bps);
+                AudioFormat::encode(format, input.data(), packedIn.data(), n, nullptr);
+                const PcmView view { packedIn.data(), packedOut.data(), format, channels, frames };
+                const char* name = format == AUDIO_FORMAT_S16 ? "process_frames_s16"
+                                                              : "process_frames_s24";
+                runner.measure(name, p, n, 2ull * n * bps, [&] {
+                    processFrames(view, 0, frames, 1.5f, false, true, nullptr, false);
+                    doNotOptimize(packedOut.data());
+                });
+            }
+
+            alignas(64) AudioControlBlock control {};
+            AudioControl::Values values;
+            values.gain = 1.5f;
+            AudioControl::write(&control, values);
+            LiveControl live;
+            if (live.attach(&control, 48000, channels)) {
+                runner.measure("live_control_steady", p, n, bytes, [&] {
+                    live.process(input.data(), work.data(), frames);
+                    doNotOptimize(work.data());
+                });
+                values.rampFrames = frames;
+                runner.measure("live_control_ramp", p, n, bytes, [&] {
+                    values.gain = values.gain == 1.5f ? 0.5f : 1.5f;
+                    AudioControl::write(&control, values);
+                    live.process(input.data(), work.data(), frames);
+                    doNotOptimize(work.data());
+                });
+            }
+
+            const uint32_t pcmBytes = static_cast<uint32_t>(n * sizeof(float));
+            std::vector<uint8_t> v2Storage;
+            const AudioShmLayout layout = audioShmLayout(frames, channels, AUDIO_FORMAT_FLOAT32, 0, 0);
+            uint8_t* v2 = pageAligned(v2Storage, layout.totalSize);
+            HostAudio::writeFormatHeader(v2, layout.totalSize, 48000, static_cast<int>(channels),
+                                         static_cast<int>(frames), 1.5f, 0, AUDIO_FORMAT_FLOAT32, 0);
+            std::memcpy(v2 + layout.inputOffset, input.data(), pcmBytes);
+            runner.measure("shared_region_v2", p, n, bytes, [&] {
+                processMappedRegion(v2, layout.totalSize);
+                doNotOptimize(v2 + layout.outputOffset);
+            });
+
+            std::vector<uint8_t> v1Storage;
+            const uint32_t v1Size = AUDIO_SHM_HEADER_SIZE_V1 + 2u * pcmBytes;
+            uint8_t* v1 = pageAligned(v1Storage, v1Size);
+            AudioSharedHeaderV1 hdr {};
+            hdr.magic        = AUDIO_SHM_MAGIC;
+            hdr.version      = AUDIO_SHM_VERSION_1;
+            hdr.sampleRate   = 48000;
+            hdr.channels     = channels;
+            hdr.frames       = frames;
+            hdr.format       = AUDIO_FORMAT_FLOAT32;
+            hdr.inputOffset  = AUDIO_SHM_HEADER_SIZE_V1;
+            hdr.outputOffset = AUDIO_SHM_HEADER_SIZE_V1 + pcmBytes;
+            hdr.gain         = 1.5f;
+            std::memcpy(v1, &hdr, sizeof(hdr));
+            std::memcpy(v1 + hdr.inputOffset, input.data(), pcmBytes);
+            runner.measure("shared_region_v1", p, n, bytes, [&] {
+                processMappedRegion(v1, v1Size);
+                doNotOptimize(v1 + hdr.outputOffset);
+            });
+
+            const AudioChainStage biquad { AUDIO_STAGE_BIQUAD, AUDIO_BIQUAD_PEAKING,
+                                                { 1000.0f, 0.7f, 6.0f } };
+            const AudioChainStage dcBlocker { AUDIO_STAGE_DC_BLOCKER, 0, { 20.0f } };
+            const AudioChainStage compressor { AUDIO_STAGE_COMPRESSOR, 0,
+                                                    { -12.0f, 4.0f, 5.0f, 50.0f, 6.0f, 3.0f } };
+            const AudioChainStage lowpass { AUDIO_STAGE_BIQUAD, AUDIO_BIQUAD_LOWPASS,
+                                                 { 8000.0f, 0.707f, 0.0f } };
+            const struct {
+                const char* name;
+                AudioChainDescriptor desc;
+            } chains[] = {
+                { "stage_biquad",     makeChain({ biquad }) },
+                { "stage_dc_blocker", makeChain({ dcBlocker }) },
+                { "stage_compressor", makeChain({ compressor }) },
+                { "chain",            makeChain({ biquad, dcBlocker, compressor, lowpass }) },
+            };
+            for (const auto& c : chains) {
+                for (bool generic : { false, true }) {
+                    ProcessingChain chain;
+                    chain.configure(c.desc, 48000, channels, frames);
+                    if (generic) {
+                        chain.forceGenericKernels();
+                    }
+                    runner.measure(std::string(c.name) + (generic ? "_generic" : "_fixed"),
+                                   p, n, bytes, [&] {
+                        std::memcpy(work.data(), input.data(), n * sizeof(float));
+                        chain.process(work.data(), frames);
+                        doNotOptimize(work.data());
+                    });
+                }
+            }
+
+            const std::vector<float> tail = makeDenormalTail(n);
+            for (bool flush : { false, true }) {
+                ProcessingChain chain;
+                chain.configure(chains[3].desc, 48000, channels, frames);
+                DenormalScope mode(flush);
+                runner.measure(flush ? "chain_denormal_ftz" : "chain_denormal_ieee", p, n, bytes, [&] {
+                    std::memcpy(work.data(), tail.data(), n * sizeof(float));
+                    chain.process(work.data(), frames);
+                    doNotOptimize(work.data());
+                });
+            }
+
+            const PcmView floatView { reinterpret_cast<const uint8_t*>(input.data()),
+                                      reinterpret_cast<uint8_t*>(work.data()),
+                                      AUDIO_FORMAT_FLOAT32, channels, frames };
+            runner.measure("process_frames_guard", p, n, bytes, [&] {
+                FrameGuard guard;
+                processFrames(floatView, 0, frames, 1.5f, false, false, nullptr, false, FrameMeter(), &guard);
+                doNotOptimize(work.data());
+            });
+        }
+    }
+}
+
+} // namespace Bench
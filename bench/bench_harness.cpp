@@ -0,0 +1,158 @@
+/**
+ * bench_harness.cpp — minimal benchmark runner for the native cores
+ */
+
+#include "bench_harness.h"
+#include "dsp_kernels.h"
+#include "dsp_thread_pool.h"
+
+#include <cstdio>
+#include <ctime>
+#include <fstream>
+#include <sstream>
+
+namespace Bench {
+
+namespace {
+
+std::string jsonEscape(const std::string& s)
+{
+    std::string out;
+    for (char c : s) {
+        if (c == '"' || c == '\\') {
+            out += '\\';
+        }
+        out += c;
+    }
+    return out;
+}
+
+} // namespace
+
+Params& Params::add(const std::string& key, const std::string& value)
+{
+    items.emplace_back(key, value);
+    return *this;
+}
+
+Params& Params::add(const std::string& key, long long value)
+{
+    return add(key, std::to_string(value));
+}
+
+std::string Params::str() const
+{
+    std::string out;
+    for (const auto& kv : items) {
+        if (!out.empty()) {
+            out += ' ';
+        }
+        out += kv.first + '=' + kv.second;
+    }
+    return out;
+}
+
+void Runner::addSuite(const char* name, SuiteFn fn)
+{
+    suites_.emplace_back(name, fn);
+}
+
+std::vector<uint32_t> Runner::framesSweep() const
+{
+    if (opts_.quick) {
+        return { 4096, 65536 };
+    }
+    return { 256, 4096, 65536, 1048576 };
+}
+
+std::vector<uint32_t> Runner::channelsSweep() const
+{
+    if (opts_.quick) {
+        return { 2 };
+    }
+    return { 1, 2, 6, 8 };
+}
+
+std::vector<uint32_t> Runner::sampleRateSweep() const
+{
+    if (opts_.quick) {
+        return { 48000 };
+    }
+    return { 44100, 48000, 96000 };
+}
+
+bool Runner::enabled(const std::string& name) const
+{
+    if (opts_.filter.empty()) {
+        return true;
+    }
+    return (currentSuite_ + "/" + name).find(opts_.filter) != std::string::npos;
+}
+
+void Runner::record(const std::string& name, const Params& params, uint64_t iterations,
+                    double nsPerIter, uint64_t samplesPerIter, uint64_t bytesPerIter)
+{
+    Result r;
+    r.suite       = currentSuite_;
+    r.name        = name;
+    r.params      = params;
+    r.iterations  = iterations;
+    r.nsPerIter   = nsPerIter;
+    r.nsPerSample = samplesPerIter ? nsPerIter / static_cast<double>(samplesPerIter) : 0.0;
+    r.gbPerSec    = bytesPerIter ? static_cast<double>(bytesPerIter) / nsPerIter : 0.0;
+    results_.push_back(r);
+
+    std::printf("%-14s %-26s %-36s %12.1f ns/it %9.3f ns/smp %8.2f GB/s\n",
+                r.suite.c_str(), r.name.c_str(), r.params.str().c_str(),
+                r.nsPerIter, r.nsPerSample, r.gbPerSec);
+    std::fflush(stdout);
+}
+
+int Runner::run()
+{
+    std::printf("# isa=%s threads=%u min_time_ms=%.0f\n",
+                DspProcessor::kernelIsaName(DspProcessor::activeKernelIsa()),
+                DspProcessor::WorkerPool::instance().threadCount(), opts_.minTimeMs);
+
+    for (const auto& suite : suites_) {
+        currentSuite_ = suite.first;
+        suite.second(*this);
+    }
+    currentSuite_.clear();
+
+    if (!opts_.jsonPath.empty() && !writeJson()) {
+        std::fprintf(stderr, "failed to write %s\n", opts_.jsonPath.c_str());
+        return 1;
+    }
+    return 0;
+}
+
+bool Runner::writeJson() const
+{
+    std::ostringstream os;
+    os << "{\n  \"schema\": 1,\n"
+       << "  \"timestamp\": " << static_cast<long long>(std::time(nullptr)) << ",\n"
+       << "  \"isa\": \"" << DspProcessor::kernelIsaName(DspProcessor::activeKernelIsa()) << "\",\n"
+       << "  \"threads\": " << DspProcessor::WorkerPool::instance().threadCount() << ",\n"
+       << "  \"results\": [";
+    for (size_t i = 0; i < results_.size(); ++i) {
+        const Result& r = results_[i];
+        os << (i ? ",\n" : "\n") << "    {\"suite\": \"" << jsonEscape(r.suite)
+           << "\", \"name\": \"" << jsonEscape(r.name) << "\", \"params\": {";
+        for (size_t k = 0; k < r.params.items.size(); ++k) {
+            os << (k ? ", " : "") << '"' << jsonEscape(r.params.items[k].first) << "\": \""
+               << jsonEscape(r.params.items[k].second) << '"';
+        }
+        os << "}, \"iterations\": " << r.iterations
+           << ", \"ns_per_iter\": " << r.nsPerIter
+           << ", \"ns_per_sample\": " << r.nsPerSample
+           << ", \"gb_per_s\": " << r.gbPerSec << "}";
+    }
+    os << "\n  ]\n}\n";
+
+    std::ofstream ofs(opts_.jsonPath, std::ios::trunc);
+    ofs << os.str();
+    return ofs.good();
+}
+
+} // namespace Bench
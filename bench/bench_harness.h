@@ -0,0 +1,124 @@
+/**
+ * bench_harness.h — minimal benchmark runner for the native cores
+ *
+ * Suites register with a Runner and call measure() once per parameter
+ * point. Each point is run in growing batches until the minimum time is
+ * reached; the fastest batch is reported as ns/iteration, ns/sample and
+ * GB/s. Results are printed as a table and optionally written as JSON.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace Bench {
+
+/** Ordered key / value pairs describing one benchmark point */
+struct Params {
+    std::vector<std::pair<std::string, std::string>> items;
+
+    Params& add(const std::string& key, const std::string& value);
+    Params& add(const std::string& key, long long value);
+    std::string str() const;
+};
+
+struct Result {
+    std::string suite;
+    std::string name;
+    Params      params;
+    uint64_t    iterations;
+    double      nsPerIter;
+    double      nsPerSample;   /* 0 when the benchmark has no sample count */
+    double      gbPerSec;      /* 0 when the benchmark has no byte count   */
+};
+
+struct Options {
+    double      minTimeMs = 200.0;
+    bool        quick     = false;  /* smaller sweeps for CI smoke runs    */
+    std::string filter;             /* substring match on "suite/name"     */
+    std::string jsonPath;           /* write machine-readable results here */
+};
+
+/** Keep the compiler from discarding a computed value / buffer */
+inline void doNotOptimize(const void* p)
+{
+    asm volatile("" : : "g"(p) : "memory");
+}
+
+class Runner;
+using SuiteFn = void (*)(Runner&);
+
+class Runner {
+public:
+    explicit Runner(Options opts) : opts_(std::move(opts)) {}
+
+    void addSuite(const char* name, SuiteFn fn);
+
+    /** Run every registered suite, print results, write JSON if requested. */
+    int run();
+
+    const Options& options() const { return opts_; }
+
+    /** Frame counts swept by the suites (shorter list in quick mode). */
+    std::vector<uint32_t> framesSweep() const;
+    std::vector<uint32_t> channelsSweep() const;
+    std::vector<uint32_t> sampleRateSweep() const;
+
+    /** True if "suite/name" passes the --filter option. */
+    bool enabled(const std::string& name) const;
+
+    /**
+     * Time fn() and record one result.
+     * @param name            benchmark name within the current suite
+     * @param params          parameter point
+     * @param samplesPerIter  PCM samples handled per call (0 = n/a)
+     * @param bytesPerIter    bytes read + written per call (0 = n/a)
+     */
+    template <typename Fn>
+    void measure(const std::string& name, const Params& params,
+                 uint64_t samplesPerIter, uint64_t bytesPerIter, Fn&& fn)
+    {
+        if (!enabled(name)) {
+            return;
+        }
+        using Clock = std::chrono::steady_clock;
+        fn();  /* warm-up: page faults, lazy init, caches */
+
+        const double minNs = opts_.minTimeMs * 1e6;
+        double totalNs = 0.0, bestNs = 0.0;
+        uint64_t batch = 1, iterations = 0;
+        while (totalNs < minNs) {
+            auto t0 = Clock::now();
+            for (uint64_t i = 0; i < batch; ++i) {
+                fn();
+            }
+            double ns = std::chrono::duration<double, std::nano>(Clock::now() - t0).count();
+            double perIter = ns / static_cast<double>(batch);
+            if (iterations == 0 || perIter < bestNs) {
+                bestNs = perIter;
+            }
+            totalNs    += ns;
+            iterations += batch;
+            if (ns < minNs / 10.0) {
+                batch *= 2;
+            }
+        }
+        record(name, params, iterations, bestNs, samplesPerIter, bytesPerIter);
+    }
+
+private:
+    void record(const std::string& name, const Params& params, uint64_t iterations,
+                double nsPerIter, uint64_t samplesPerIter, uint64_t bytesPerIter);
+    bool writeJson() const;
+
+    Options opts_;
+    std::vector<std::pair<const char*, SuiteFn>> suites_;
+    std::string currentSuite_;
+    std::vector<Result> results_;
+};
+
+} // namespace Bench
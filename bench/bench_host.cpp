@@ -0,0 +1,113 @@
+/**
+ * bench_host.cpp — HostApp core benchmarks
+ *
+ *   generate_sine_wave   HostAudio::generateSineWave
+ *   write_wav_file       HostAudio::writeWavFile (to a temporary file)
+ *   write_wav_file_s24   same, 24-bit PCM output
+ *   write_wav_file_f32   same, IEEE float output
+ *   build_header         HostAudio::buildHeader
+ *   signal_<type>        SignalGenerator::generate into a reused buffer
+ *                        (sine, multitone, sweep, white, pink, impulse)
+ */
+
+#include "bench_harness.h"
+#include "audio_native.h"
+#include "signal_generator.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+namespace Bench {
+
+namespace {
+
+std::string tempWavPath()
+{
+    const char* dir = std::getenv("TMPDIR");
+    return std::string(dir ? dir : "/tmp") + "/audio_bench_out.wav";
+}
+
+} // namespace
+
+void registerHostSuite(Runner& runner)
+{
+    const std::string wavPath = tempWavPath();
+
+    for (uint32_t sampleRate : runner.sampleRateSweep()) {
+        for (uint32_t frames : runner.framesSweep()) {
+            for (uint32_t channels : runner.channelsSweep()) {
+                const size_t n = static_cast<size_t>(frames) * channels;
+
+                Params p;
+                p.add("sr", sampleRate).add("frames", frames).add("channels", channels);
+
+                runner.measure("generate_sine_wave", p, n, n * sizeof(float), [&] {
+                    auto pcm = HostAudio::generateSineWave(static_cast<int>(sampleRate),
+                                                           static_cast<int>(frames),
+                                                           static_cast<int>(channels), 440.0f);
+                    doNotOptimize(pcm.data());
+                });
+
+                std::vector<float> out(n);
+                const std::pair<HostAudio::SignalType, const char*> signals[] = {
+                    { HostAudio::SignalType::Sine,       "signal_sine" },
+                    { HostAudio::SignalType::MultiTone,  "signal_multitone" },
+                    { HostAudio::SignalType::Sweep,      "signal_sweep" },
+                    { HostAudio::SignalType::WhiteNoise, "signal_white" },
+                    { HostAudio::SignalType::PinkNoise,  "signal_pink" },
+                    { HostAudio::SignalType::Impulse,    "signal_impulse" },
+                };
+                for (const auto& sig : signals) {
+                    HostAudio::SignalConfig cfg;
+                    cfg.type       = sig.first;
+                    cfg.sampleRate = sampleRate;
+                    cfg.channels   = channels;
+                    cfg.toneCount  = 4;
+                    cfg.toneHz[1]  = 1000.0f;
+                    cfg.toneHz[2]  = 3000.0f;
+                    cfg.toneHz[3]  = 7000.0f;
+                    cfg.endHz      = 0.45f * static_cast<float>(sampleRate);
+                    HostAudio::SignalGenerator gen;
+                    gen.configure(cfg);
+                    runner.measure(sig.second, p, n, n * sizeof(float), [&] {
+                        gen.generate(out.data(), frames);
+                        doNotOptimize(out.data());
+                    });
+                }
+
+                const auto pcm = HostAudio::generateSineWave(static_cast<int>(sampleRate),
+                                                             static_cast<int>(frames),
+                                                             static_cast<int>(channels), 440.0f);
+                /* float32 read + PCM written */
+                for (HostAudio::WavSampleFormat format : { HostAudio::WavSampleFormat::Pcm16,
+                                                           HostAudio::WavSampleFormat::Pcm24,
+                                                           HostAudio::WavSampleFormat::Float32 }) {
+                    const char* name = format == HostAudio::WavSampleFormat::Pcm16 ? "write_wav_file"
+                                     : format == HostAudio::WavSampleFormat::Pcm24 ? "write_wav_file_s24"
+                                                                                   : "write_wav_file_f32";
+                    const uint64_t bytes = n * (sizeof(float) + static_cast<uint32_t>(format) / 8u);
+                    runner.measure(name, p, n, bytes, [&] {
+                        bool ok = HostAudio::writeWavFile(wavPath, pcm.data(), static_cast<int>(pcm.size()),
+                                                          static_cast<int>(sampleRate),
+                                                          static_cast<int>(channels),
+                                                          static_cast<int>(frames), format);
+                        doNotOptimize(&ok);
+                    });
+                }
+            }
+        }
+
+        Params p;
+        p.add("sr", sampleRate);
+        runner.measure("build_header", p, 0, 128, [&] {
+            auto hdr = HostAudio::buildHeader(static_cast<int>(sampleRate), 2, 48000, 0.5f, 0);
+            doNotOptimize(hdr.data());
+        });
+    }
+
+    std::remove(wavPath.c_str());
+}
+
+} // namespace Bench
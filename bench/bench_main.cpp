@@ -0,0 +1,58 @@
+/**
+ * bench_main.cpp — entry point of the native benchmark suite
+ *
+ *   audio_bench [--quick] [--filter <substr>] [--min-time-ms <ms>]
+ *               [--threads <n>] [--json <path>]
+ */
+
+#include "bench_harness.h"
+#include "dsp_thread_pool.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+namespace Bench {
+void registerDspSuite(Runner& runner);
+void registerConvSuite(Runner& runner);
+void registerSrcSuite(Runner& runner);
+void registerHostSuite(Runner& runner);
+} // namespace Bench
+
+static void usage(const char* argv0)
+{
+    std::printf("usage: %s [--quick] [--filter <substr>] [--min-time-ms <ms>]\n"
+                "          [--threads <n>] [--json <path>]\n", argv0);
+}
+
+int main(int argc, char** argv)
+{
+    Bench::Options opts;
+    for (int i = 1; i < argc; ++i) {
+        const char* arg = argv[i];
+        const bool hasValue = i + 1 < argc;
+        if (std::strcmp(arg, "--quick") == 0) {
+            opts.quick = true;
+            opts.minTimeMs = 20.0;
+        } else if (std::strcmp(arg, "--filter") == 0 && hasValue) {
+            opts.filter = argv[++i];
+        } else if (std::strcmp(arg, "--min-time-ms") == 0 && hasValue) {
+            opts.minTimeMs = std::atof(argv[++i]);
+        } else if (std::strcmp(arg, "--threads") == 0 && hasValue) {
+            DspProcessor::WorkerPool::instance().setThreadCount(
+                static_cast<unsigned>(std::atoi(argv[++i])));
+        } else if (std::strcmp(arg, "--json") == 0 && hasValue) {
+            opts.jsonPath = argv[++i];
+        } else {
+            usage(argv[0]);
+            return std::strcmp(arg, "--help") == 0 ? 0 : 2;
+        }
+    }
+
+    Bench::Runner runner(opts);
+    runner.addSuite("dsp", Bench::registerDspSuite);
+    runner.addSuite("conv", Bench::registerConvSuite);
+    runner.addSuite("src", Bench::registerSrcSuite);
+    runner.addSuite("host", Bench::registerHostSuite);
+    return runner.run();
+}
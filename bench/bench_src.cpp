@@ -0,0 +1,117 @@
+/**
+ * bench_src.cpp — sample-rate converter benchmarks
+ *
+ *   src_<isa>          Resampler::process() of one 4096-frame stereo block
+ *                      per supported ISA and quality, for the common
+ *                      44.1 ↔ 48 kHz pair, a 2:1 decimation and a ratio
+ *                      with too many phases for an exact table (blended
+ *                      rows)
+ *   src_configure_cold configure() with the table cache emptied first:
+ *                      the one-time filter design cost of a new ratio
+ *   src_configure_warm configure() of a ratio already in the cache
+ *
+ * The converter keeps its history across iterations, as in a session, so
+ * every pass after the first runs on a full window. Items are input frames.
+ */
+
+#include "bench_harness.h"
+#include "dsp_kernels.h"
+#include "dsp_resampler.h"
+
+#include <cmath>
+#include <string>
+#include <vector>
+
+namespace Bench {
+
+namespace {
+
+constexpr uint32_t kChannels = 2;
+constexpr uint32_t kFrames   = 4096;
+
+struct Ratio {
+    uint32_t inputRate;
+    uint32_t outputRate;
+};
+
+const char* qualityName(uint32_t quality)
+{
+    switch (quality) {
+        case AUDIO_SRC_QUALITY_LOW:
+            return "low";
+        case AUDIO_SRC_QUALITY_HIGH:
+            return "high";
+        default:
+            return "medium";
+    }
+}
+
+} // namespace
+
+void registerSrcSuite(Runner& runner)
+{
+    using namespace DspProcessor;
+
+    const std::vector<Ratio> ratios = runner.options().quick
+        ? std::vector<Ratio> { { 44100, 48000 }, { 48000, 44099 } }
+        : std::vector<Ratio> { { 44100, 48000 }, { 48000, 44100 }, { 96000, 48000 }, { 48000, 44099 } };
+    const uint32_t qualities[] = { AUDIO_SRC_QUALITY_LOW, AUDIO_SRC_QUALITY_MEDIUM, AUDIO_SRC_QUALITY_HIGH };
+    const KernelIsa isas[] = { KernelIsa::Scalar, KernelIsa::Sse2, KernelIsa::Avx2, KernelIsa::Neon };
+
+    const size_t n = static_cast<size_t>(kFrames) * kChannels;
+    std::vector<float> input(n);
+    for (size_t i = 0; i < n; ++i) {
+        input[i] = 0.5f * std::sin(0.0627f * static_cast<float>(i / kChannels));
+    }
+
+    for (const Ratio& ratio : ratios) {
+        /* Room for one block's output plus the held-back frames */
+        std::vector<float> output(static_cast<size_t>(
+            audioSrcCapacityFrames(kFrames, ratio.inputRate, ratio.outputRate)) * kChannels);
+
+        for (uint32_t quality : qualities) {
+            Params p;
+            p.add("in", ratio.inputRate).add("out", ratio.outputRate)
+             .add("quality", qualityName(quality)).add("frames", kFrames).add("channels", kChannels);
+
+            for (KernelIsa isa : isas) {
+                if (!isKernelIsaSupported(isa)) {
+                    continue;
+                }
+                const KernelIsa saved = activeKernelIsa();
+                forceKernelIsa(isa);
+                Resampler src;
+                const bool ok = src.configure(ratio.inputRate, ratio.outputRate, kChannels, quality);
+                forceKernelIsa(saved);
+                if (!ok) {
+                    continue;
+                }
+                Params pi = p;
+                pi.add("taps", src.taps()).add("phases", src.phases());
+                const uint64_t bytes = (static_cast<uint64_t>(kFrames)
+                                        + src.outputFramesFor(kFrames)) * kChannels * sizeof(float);
+                runner.measure(std::string("src_") + kernelIsaName(isa), pi, kFrames, bytes, [&] {
+                    src.process(input.data(), kFrames, output.data());
+                    doNotOptimize(output.data());
+                });
+            }
+
+            runner.measure("src_configure_cold", p, 1, 0, [&] {
+                Resampler::trimTableCache();
+                Resampler src;
+                src.configure(ratio.inputRate, ratio.outputRate, kChannels, quality);
+                doNotOptimize(&src);
+            });
+
+            Resampler keep;   /* holds the table in the cache */
+            keep.configure(ratio.inputRate, ratio.outputRate, kChannels, quality);
+            runner.measure("src_configure_warm", p, 1, 0, [&] {
+                Resampler src;
+                src.configure(ratio.inputRate, ratio.outputRate, kChannels, quality);
+                doNotOptimize(&src);
+            });
+        }
+    }
+}
+
+} // namespace Bench
@@ -0,0 +1,804 @@
+/**
+ * ipc_bench.cpp — end-to-end latency of the HostApp ↔ DspService protocol
+ *
+ *   ipc_bench [--quick] [--mode legacy|shm|session] [--requests <n>]
+ *             [--frames <n>] [--concurrency <n>] [--json <path>]
+ *             [--trace <path>]
+ *
+ * Emulates the device transport on Linux: the service role runs in a
+ * forked process behind a SOCK_SEQPACKET Unix socket, one service thread
+ * per connection (the Binder thread pool); the host role opens one
+ * connection per client thread. Regions are memfds in the exact
+ * AudioSharedHeader layout, handed over as SCM_RIGHTS, and requests /
+ * replies carry the same fields as DspServiceExtAbility.ets:
+ *
+ *   legacy   PROCESS_AUDIO_CODE    new region per request; the service
+ *            (1001)                copies header + input out, processes,
+ *                                  copies the output back
+ *   shm      PROCESS_SHM_CODE      new region per request, processed in
+ *            (1002)                place by processSharedMemory()
+ *   session  PROCESS_SESSION_CODE  one region per client, mapped once by
+ *            (1005–1007)           OPEN_SESSION_CODE
+ *
+ * Replies carry a harness-only trailer after the protocol fields (service
+ * handler / map / copy times) so every request splits into
+ *
+ *   setup    region create + header + map / unmap on both sides
+ *   copyIn   input PCM into the region, and out of it in the service
+ *   dsp      processingTimeNs from the reply
+ *   copyOut  output PCM back into the region, and out of it in the host
+ *   signal   round trip minus service handler time (socket, fd passing,
+ *            wake-ups)
+ *
+ * Not emulated: the ArkTS number[] conversions of the legacy path and
+ * Binder's own costs; the numbers are a floor for the device.
+ *
+ * --trace builds every region with AUDIO_FLAG_TRACE: both roles stamp the
+ * header's AudioTraceBlock exactly as on the device (the legacy handler
+ * stamps its copy phases by hand), each point prints the mean per-phase
+ * split taken from the blocks, and the host's AudioTrace buffer (the most
+ * recent AudioTrace::kMaxEvents spans) is written to <path> as Chrome
+ * trace-event JSON.
+ */
+
+#include "audio_native.h"
+#include "dsp_processor.h"
+#include "dsp_session.h"
+#include "dsp_shared_memory.h"
+#include "ipc_transport.h"
+#include "shared_memory.h"
+#include "AudioSharedBuffer.h"
+#include "AudioTrace.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace IpcBench {
+
+namespace {
+
+/* Request codes, as in DspServiceExtAbility.ets */
+constexpr uint32_t PROCESS_AUDIO_CODE   = 1001;
+constexpr uint32_t PROCESS_SHM_CODE     = 1002;
+constexpr uint32_t OPEN_SESSION_CODE    = 1005;
+constexpr uint32_t PROCESS_SESSION_CODE = 1006;
+constexpr uint32_t CLOSE_SESSION_CODE   = 1007;
+/* Harness only: stop the service process */
+constexpr uint32_t QUIT_CODE            = 0;
+
+constexpr uint32_t kSampleRate = 48000;
+constexpr uint32_t kChannels   = 2;
+constexpr float    kGain       = 1.5f;
+constexpr int      kWarmup     = 16;    /* requests per client, not recorded */
+
+/* --trace: regions carry a trace block; request ids are unique per run */
+bool                  g_trace = false;
+std::atomic<uint64_t> g_nextRequestId { 1 };
+
+enum class Mode { Legacy, Shm, Session };
+
+const char* modeName(Mode m)
+{
+    switch (m) {
+    case Mode::Legacy: return "legacy";
+    case Mode::Shm:    return "shm";
+    default:           return "session";
+    }
+}
+
+/* CLOCK_MONOTONIC, so harness times and trace stamps line up */
+int64_t nowNs()
+{
+    return AudioTrace::nowNs();
+}
+
+/* Service-side timing appended to every reply */
+struct Trailer {
+    int64_t handlerNs = 0;   /* request received → reply ready   */
+    int64_t setupNs   = 0;   /* map / unmap, lookup              */
+    int64_t copyInNs  = 0;   /* header + input out of the region */
+    int64_t copyOutNs = 0;   /* output back into the region      */
+};
+
+void writeTrailer(Parcel& reply, const Trailer& t)
+{
+    reply.writeLong(t.handlerNs);
+    reply.writeLong(t.setupNs);
+    reply.writeLong(t.copyInNs);
+    reply.writeLong(t.copyOutNs);
+}
+
+Trailer readTrailer(Parcel& reply)
+{
+    Trailer t;
+    t.handlerNs = reply.readLong();
+    t.setupNs   = reply.readLong();
+    t.copyInNs  = reply.readLong();
+    t.copyOutNs = reply.readLong();
+    return t;
+}
+
+/* ------------------------------------------------------------------ */
+/*  Service role                                                        */
+/* ------------------------------------------------------------------ */
+
+/* The legacy ArkTS path: map, copy out, process a private copy, copy back */
+void serveLegacy(Parcel& data, Parcel& reply, int64_t start)
+{
+    const int fd         = data.readFileDescriptor();
+    const int32_t rate   = data.readInt();
+    const int32_t frames = data.readInt();
+    const int32_t ch     = data.readInt();
+    const float gain     = data.readFloat();
+    const int32_t bypass = data.readInt();
+    (void)rate;
+
+    Trailer t;
+    int32_t status = AUDIO_STATUS_ERROR;
+    int64_t dspNs = 0;
+    struct stat st {};
+    void* base = MAP_FAILED;
+    if (data.ok() && fd >= 0 && fstat(fd, &st) == 0) {
+        base = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ | PROT_WRITE,
+                    MAP_SHARED, fd, 0);
+    }
+    const int64_t mapped = nowNs();
+
+    if (base != MAP_FAILED && frames > 0 && ch > 0) {
+        const size_t regionSize = static_cast<size_t>(st.st_size);
+        const size_t pcmBytes = static_cast<size_t>(frames) * ch * sizeof(float);
+
+        /* loadHeader() copies the request line out, like readFromAshmem() */
+        DspProcessor::SharedHeaderView hdr;
+        if (DspProcessor::loadHeader(base, regionSize, hdr)
+            && hdr.inputOffset + pcmBytes <= regionSize && hdr.outputOffset + pcmBytes <= regionSize) {
+            std::vector<float> pcm(pcmBytes / sizeof(float));
+            std::memcpy(pcm.data(), static_cast<uint8_t*>(base) + hdr.inputOffset, pcmBytes);
+            const int64_t copiedIn = nowNs();
+            t.copyInNs = copiedIn - mapped;
+
+            dspNs = DspProcessor::processAudioInto(pcm.data(), pcm.data(), pcm.size(),
+                                                   gain, bypass != 0, true);
+
+            const int64_t copyStart = nowNs();
+            std::memcpy(static_cast<uint8_t*>(base) + hdr.outputOffset, pcm.data(), pcmBytes);
+            status = AUDIO_STATUS_DONE;
+            DspProcessor::storeHeaderStatus(base, hdr, status, dspNs);
+            const int64_t copiedOut = nowNs();
+            t.copyOutNs = copiedOut - copyStart;
+
+            /* The copy-in is this path's "setup" phase; the unmap lands in "reply" */
+            AudioTrace::ServiceStamps stamps;
+            stamps.receiveNs   = start;
+            stamps.mapDoneNs   = mapped;
+            stamps.dspStartNs  = copiedIn;
+            stamps.dspEndNs    = copyStart;
+            stamps.writeBackNs = copiedOut;
+            AudioTrace::publishServiceTrace(AudioTrace::traceBlock(base, hdr.headerSize, hdr.flags,
+                                                                   regionSize), stamps);
+        }
+    }
+
+    const int64_t unmapStart = nowNs();
+    if (base != MAP_FAILED) {
+        munmap(base, static_cast<size_t>(st.st_size));
+    }
+    if (fd >= 0) {
+        close(fd);
+    }
+    const int64_t end = nowNs();
+    t.setupNs   = (mapped - start) + (end - unmapStart);
+    t.handlerNs = end - start;
+
+    reply.writeInt(status == AUDIO_STATUS_DONE ? 0 : -1);
+    reply.writeLong(dspNs);
+    writeTrailer(reply, t);
+}
+
+void serveShm(Parcel& data, Parcel& reply, int64_t start)
+{
+    const int fd = data.readFileDescriptor();
+    const int32_t size = data.readInt();
+
+    DspProcessor::SharedProcessResult res { AUDIO_STATUS_ERROR, 0 };
+    if (data.ok() && fd >= 0 && size > 0) {
+        res = DspProcessor::processSharedMemory(fd, static_cast<size_t>(size), start);
+    }
+    if (fd >= 0) {
+        close(fd);
+    }
+
+    Trailer t;
+    t.handlerNs = nowNs() - start;
+    t.setupNs   = t.handlerNs - res.processingTimeNs;
+    reply.writeInt(res.status == AUDIO_STATUS_DONE ? 0 : -1);
+    reply.writeLong(res.processingTimeNs);
+    writeTrailer(reply, t);
+}
+
+/* The peer's credentials stand in for Binder's calling uid / pid */
+DspProcessor::ClientRef peerClient(int sock)
+{
+    DspProcessor::ClientRef client;
+    struct ucred cred {};
+    socklen_t len = sizeof(cred);
+    if (getsockopt(sock, SOL_SOCKET, SO_PEERCRED, &cred, &len) == 0) {
+        client.uid = static_cast<int32_t>(cred.uid);
+        client.pid = static_cast<int32_t>(cred.pid);
+    }
+    return client;
+}
+
+void serveConnection(int sock)
+{
+    const DspProcessor::ClientRef client = peerClient(sock);
+    Parcel data;
+    Parcel reply;
+    uint32_t code = 0;
+    while (recvParcel(sock, code, data)) {
+        const int64_t start = nowNs();
+        reply.clear();
+        if (code == PROCESS_AUDIO_CODE) {
+            serveLegacy(data, reply, start);
+        } else if (code == PROCESS_SHM_CODE) {
+            serveShm(data, reply, start);
+        } else if (code == OPEN_SESSION_CODE) {
+            const int fd = data.readFileDescriptor();
+            const int32_t size = data.readInt();
+            const int32_t id = data.ok() && fd >= 0 && size > 0
+                             ? DspProcessor::openSession(fd, static_cast<size_t>(size), client)
+                             : AUDIO_STATUS_ERROR;
+            if (fd >= 0) {
+                close(fd);
+            }
+            reply.writeInt(id > 0 ? 0 : -1);
+            reply.writeInt(id);
+        } else if (code == PROCESS_SESSION_CODE) {
+            const int32_t id     = data.readInt();
+            const int32_t offset = data.readInt();
+            const int32_t count  = data.readInt();
+            const DspProcessor::SharedProcessResult res =
+                DspProcessor::processSession(id, static_cast<uint32_t>(offset),
+                                             static_cast<uint32_t>(count), start, client.uid);
+            Trailer t;
+            t.handlerNs = nowNs() - start;
+            t.setupNs   = t.handlerNs - res.processingTimeNs;
+            reply.writeInt(res.status == AUDIO_STATUS_DONE ? 0 : -1);
+            reply.writeLong(res.processingTimeNs);
+            writeTrailer(reply, t);
+        } else if (code == CLOSE_SESSION_CODE) {
+            reply.writeInt(DspProcessor::closeSession(data.readInt(), client.uid) == AUDIO_STATUS_DONE
+                           ? 0 : -1);
+        } else if (code == QUIT_CODE) {
+            DspProcessor::closeAllSessions();
+            _exit(0);
+        } else {
+            reply.writeInt(-1);
+        }
+        if (!sendParcel(sock, code, reply)) {
+            break;
+        }
+    }
+    close(sock);
+}
+
+[[noreturn]] void runService(int listenFd)
+{
+    for (;;) {
+        const int sock = accept4(listenFd, nullptr, nullptr, SOCK_CLOEXEC);
+        if (sock < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            _exit(1);
+        }
+        std::thread(serveConnection, sock).detach();
+    }
+}
+
+/* ------------------------------------------------------------------ */
+/*  Host role                                                           */
+/* ------------------------------------------------------------------ */
+
+/* One request's split, host and service side combined (ns) */
+struct Sample {
+    int64_t totalNs, setupNs, copyInNs, dspNs, copyOutNs, signalNs;
+    AudioTrace::Breakdown trace;   /* --trace only */
+};
+
+/* memfd region in the v2 layout, mapped on the host side */
+struct Region {
+    int            fd   = -1;
+    uint8_t*       base = nullptr;
+    AudioShmLayout layout {};
+
+    bool create(uint32_t frames)
+    {
+        layout = audioShmTracedLayout(frames, kChannels, AUDIO_FORMAT_FLOAT32, 0, g_trace, 0);
+        fd = HostAudio::createSharedMemory("audio-ipc-bench", layout.totalSize);
+        if (fd < 0) {
+            return false;
+        }
+        void* p = mmap(nullptr, layout.totalSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        if (p == MAP_FAILED) {
+            destroy();
+            return false;
+        }
+        base = static_cast<uint8_t*>(p);
+        return HostAudio::writeFormatHeader(base, layout.totalSize, kSampleRate, kChannels,
+                                            static_cast<int>(frames), kGain, 0,
+                                            AUDIO_FORMAT_FLOAT32, g_trace ? AUDIO_FLAG_TRACE : 0u);
+    }
+
+    AudioTraceBlock* trace() const
+    {
+        return AudioTrace::traceBlock(base, layout.headerSize, g_trace ? AUDIO_FLAG_TRACE : 0u,
+                                      layout.totalSize);
+    }
+
+    void destroy()
+    {
+        if (base) {
+            munmap(base, layout.totalSize);
+            base = nullptr;
+        }
+        HostAudio::closeSharedMemory(fd);
+        fd = -1;
+    }
+
+    int32_t status() const
+    {
+        int32_t s;
+        std::memcpy(&s, base + AUDIO_HDR_OFFSET_STATUS, sizeof(s));
+        return s;
+    }
+};
+
+class Client {
+public:
+    Client(int sock, Mode mode, uint32_t frames, const std::vector<float>& input)
+        : sock_(sock), mode_(mode), frames_(frames), input_(input), output_(input.size()) {}
+
+    ~Client()
+    {
+        if (sessionId_ > 0) {
+            Parcel data;
+            data.writeInt(sessionId_);
+            Parcel reply;
+            uint32_t code = 0;
+            if (sendParcel(sock_, CLOSE_SESSION_CODE, data)) {
+                recvParcel(sock_, code, reply);
+            }
+        }
+        session_.destroy();
+    }
+
+    /* Session mode: map once, outside the timed requests */
+    bool open()
+    {
+        if (mode_ != Mode::Session) {
+            return true;
+        }
+        if (!session_.create(frames_)) {
+            return false;
+        }
+        Parcel data;
+        data.writeFileDescriptor(session_.fd);
+        data.writeInt(static_cast<int32_t>(session_.layout.totalSize));
+        Parcel reply;
+        uint32_t code = 0;
+        if (!sendParcel(sock_, OPEN_SESSION_CODE, data) || !recvParcel(sock_, code, reply)) {
+            return false;
+        }
+        const int32_t status = reply.readInt();
+        sessionId_ = reply.readInt();
+        return status == 0 && sessionId_ > 0;
+    }
+
+    bool request(Sample& s)
+    {
+        const size_t pcmBytes = input_.size() * sizeof(float);
+        const int64_t t0 = nowNs();
+
+        Region oneShot;
+        Region& r = mode_ == Mode::Session ? session_ : oneShot;
+        if (mode_ != Mode::Session && !oneShot.create(frames_)) {
+            return false;
+        }
+        const int64_t t1 = nowNs();
+
+        std::memcpy(r.base + r.layout.inputOffset, input_.data(), pcmBytes);
+        const int64_t t2 = nowNs();
+
+        Parcel data;
+        uint32_t code = PROCESS_SESSION_CODE;
+        if (mode_ == Mode::Legacy) {
+            code = PROCESS_AUDIO_CODE;
+            data.writeFileDescriptor(r.fd);
+            data.writeInt(kSampleRate);
+            data.writeInt(static_cast<int32_t>(frames_));
+            data.writeInt(kChannels);
+            data.writeFloat(kGain);
+            data.writeInt(0);
+        } else if (mode_ == Mode::Shm) {
+            code = PROCESS_SHM_CODE;
+            data.writeFileDescriptor(r.fd);
+            data.writeInt(static_cast<int32_t>(r.layout.totalSize));
+        } else {
+            data.writeInt(sessionId_);
+            data.writeInt(0);
+            data.writeInt(static_cast<int32_t>(frames_));
+        }
+        Parcel reply;
+        AudioTraceBlock* trace = r.trace();
+        AudioTrace::beginHostTrace(trace, g_nextRequestId.fetch_add(1, std::memory_order_relaxed));
+        if (!sendParcel(sock_, code, data) || !recvParcel(sock_, code, reply)) {
+            return false;
+        }
+        AudioTrace::endHostTrace(trace);
+        const int64_t t3 = nowNs();
+        if (trace) {
+            const AudioTraceBlock block = *trace;
+            AudioTrace::recordRequest(block);
+            s.trace = AudioTrace::breakdown(block);
+        }
+
+        const int32_t status = reply.readInt();
+        const int64_t dspNs  = reply.readLong();
+        const Trailer svc    = readTrailer(reply);
+        const bool ok = reply.ok() && status == 0 && r.status() == AUDIO_STATUS_DONE;
+        std::memcpy(output_.data(), r.base + r.layout.outputOffset, pcmBytes);
+        const int64_t t4 = nowNs();
+
+        if (mode_ != Mode::Session) {
+            oneShot.destroy();
+        }
+        const int64_t t5 = nowNs();
+
+        s.totalNs   = t5 - t0;
+        s.setupNs   = (t1 - t0) + (t5 - t4) + svc.setupNs;
+        s.copyInNs  = (t2 - t1) + svc.copyInNs;
+        s.dspNs     = dspNs;
+        s.copyOutNs = (t4 - t3) + svc.copyOutNs;
+        s.signalNs  = (t3 - t2) - svc.handlerNs;
+        return ok;
+    }
+
+private:
+    int                       sock_;
+    Mode                      mode_;
+    uint32_t                  frames_;
+    const std::vector<float>& input_;
+    std::vector<float>        output_;
+    Region                    session_;
+    int32_t                   sessionId_ = 0;
+};
+
+int connectService(const sockaddr_un& addr, socklen_t addrLen)
+{
+    const int sock = socket(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0);
+    if (sock >= 0 && connect(sock, reinterpret_cast<const sockaddr*>(&addr), addrLen) != 0) {
+        close(sock);
+        return -1;
+    }
+    return sock;
+}
+
+struct PointResult {
+    Mode     mode;
+    uint32_t frames;
+    uint32_t concurrency;
+    size_t   requests;
+    size_t   failures;
+    double   p50Us, p99Us, p999Us;
+    double   requestsPerSec, mbPerSec;
+    double   setupUs, copyInUs, dspUs, copyOutUs, signalUs;   /* means */
+    /* --trace: mean phases from the trace blocks (send, map, setup, dsp,
+       writeBack, finish, reply) and how many blocks were complete */
+    double   traceUs[7];
+    size_t   traced;
+};
+
+double percentileUs(const std::vector<int64_t>& sorted, double p)
+{
+    const size_t i = std::min(sorted.size() - 1,
+                              static_cast<size_t>(std::floor(p * static_cast<double>(sorted.size()))));
+    return static_cast<double>(sorted[i]) * 1e-3;
+}
+
+bool runPoint(const sockaddr_un& addr, socklen_t addrLen, Mode mode, uint32_t frames,
+              uint32_t concurrency, size_t requests, PointResult& out)
+{
+    std::vector<float> input(static_cast<size_t>(frames) * kChannels);
+    for (size_t i = 0; i < input.size(); ++i) {
+        input[i] = 0.9f * std::sin(0.0627f * static_cast<float>(i));
+    }
+
+    const size_t perClient = std::max<size_t>(1, requests / concurrency);
+    std::vector<std::vector<Sample>> samples(concurrency);
+    std::atomic<size_t> failures { 0 };
+    std::atomic<uint32_t> ready { 0 };
+    std::atomic<bool> go { false };
+    int64_t wallStart = 0;
+
+    std::vector<std::thread> threads;
+    for (uint32_t c = 0; c < concurrency; ++c) {
+        threads.emplace_back([&, c] {
+            const int sock = connectService(addr, addrLen);
+            bool usable = sock >= 0;
+            {
+                Client client(sock, mode, frames, input);
+                usable = usable && client.open();
+                Sample s {};
+                for (int i = 0; usable && i < kWarmup; ++i) {
+                    usable = client.request(s);
+                }
+                ready.fetch_add(1);
+                while (!go.load()) {
+                    std::this_thread::yield();
+                }
+                samples[c].reserve(perClient);
+                for (size_t i = 0; usable && i < perClient; ++i) {
+                    if (client.request(s)) {
+                        samples[c].push_back(s);
+                    } else {
+                        failures.fetch_add(1);
+                    }
+                }
+                if (!usable) {
+                    failures.fetch_add(perClient);
+                }
+            }
+            if (sock >= 0) {
+                close(sock);
+            }
+        });
+    }
+    while (ready.load() != concurrency) {
+        std::this_thread::yield();
+    }
+    wallStart = nowNs();
+    go.store(true);
+    for (std::thread& t : threads) {
+        t.join();
+    }
+    const double wallSec = static_cast<double>(nowNs() - wallStart) * 1e-9;
+
+    std::vector<int64_t> totals;
+    double sums[5] = {};
+    double traceSums[7] = {};
+    size_t traced = 0;
+    for (const auto& list : samples) {
+        for (const Sample& s : list) {
+            totals.push_back(s.totalNs);
+            sums[0] += s.setupNs;
+            sums[1] += s.copyInNs;
+            sums[2] += s.dspNs;
+            sums[3] += s.copyOutNs;
+            sums[4] += s.signalNs;
+            const AudioTrace::Breakdown& b = s.trace;
+            const int64_t phases[7] = { b.sendNs, b.mapNs, b.setupNs, b.dspNs,
+                                        b.writeBackNs, b.finishNs, b.replyNs };
+            if (b.complete && std::all_of(phases, phases + 7, [](int64_t v) { return v >= 0; })) {
+                for (int k = 0; k < 7; ++k) {
+                    traceSums[k] += static_cast<double>(phases[k]);
+                }
+                ++traced;
+            }
+        }
+    }
+    out = PointResult {};
+    out.mode        = mode;
+    out.frames      = frames;
+    out.concurrency = concurrency;
+    out.requests    = totals.size();
+    out.failures    = failures.load();
+    if (totals.empty()) {
+        return false;
+    }
+    std::sort(totals.begin(), totals.end());
+    const double n = static_cast<double>(totals.size());
+    out.p50Us          = percentileUs(totals, 0.50);
+    out.p99Us          = percentileUs(totals, 0.99);
+    out.p999Us         = percentileUs(totals, 0.999);
+    out.requestsPerSec = n / wallSec;
+    out.mbPerSec       = n * 2.0 * input.size() * sizeof(float) / wallSec / 1e6;
+    out.setupUs        = sums[0] / n * 1e-3;
+    out.copyInUs       = sums[1] / n * 1e-3;
+    out.dspUs          = sums[2] / n * 1e-3;
+    out.copyOutUs      = sums[3] / n * 1e-3;
+    out.signalUs       = sums[4] / n * 1e-3;
+    out.traced         = traced;
+    for (int k = 0; k < 7; ++k) {
+        out.traceUs[k] = traced ? traceSums[k] / static_cast<double>(traced) * 1e-3 : 0.0;
+    }
+    return out.failures == 0;
+}
+
+void printRow(const PointResult& r)
+{
+    std::printf("%-8s %7u %4u %9.1f %9.1f %9.1f %10.0f %9.1f | %7.1f %7.1f %7.1f %7.1f %7.1f%s\n",
+                modeName(r.mode), r.frames, r.concurrency, r.p50Us, r.p99Us, r.p999Us,
+                r.requestsPerSec, r.mbPerSec, r.setupUs, r.copyInUs, r.dspUs, r.copyOutUs,
+                r.signalUs, r.failures ? "  (failures)" : "");
+    if (g_trace) {
+        std::printf("  trace (%zu/%zu): send %.1f  map %.1f  setup %.1f  dsp %.1f  "
+                    "writeBack %.1f  finish %.1f  reply %.1f\n",
+                    r.traced, r.requests, r.traceUs[0], r.traceUs[1], r.traceUs[2], r.traceUs[3],
+                    r.traceUs[4], r.traceUs[5], r.traceUs[6]);
+    }
+}
+
+bool writeJson(const std::string& path, const std::vector<PointResult>& results)
+{
+    std::ofstream f(path);
+    if (!f) {
+        return false;
+    }
+    f << "[\n";
+    for (size_t i = 0; i < results.size(); ++i) {
+        const PointResult& r = results[i];
+        f << "  {\"mode\": \"" << modeName(r.mode) << "\", \"frames\": " << r.frames
+          << ", \"channels\": " << kChannels << ", \"concurrency\": " << r.concurrency
+          << ", \"requests\": " << r.requests << ", \"failures\": " << r.failures
+          << ", \"p50_us\": " << r.p50Us << ", \"p99_us\": " << r.p99Us
+          << ", \"p999_us\": " << r.p999Us << ", \"requests_per_sec\": " << r.requestsPerSec
+          << ", \"mb_per_sec\": " << r.mbPerSec << ", \"setup_us\": " << r.setupUs
+          << ", \"copy_in_us\": " << r.copyInUs << ", \"dsp_us\": " << r.dspUs
+          << ", \"copy_out_us\": " << r.copyOutUs << ", \"signal_us\": " << r.signalUs << "}"
+          << (i + 1 < results.size() ? ",\n" : "\n");
+    }
+    f << "]\n";
+    return static_cast<bool>(f);
+}
+
+} // namespace
+
+} // namespace IpcBench
+
+static void usage(const char* argv0)
+{
+    std::printf("usage: %s [--quick] [--mode legacy|shm|session] [--requests <n>]\n"
+                "          [--frames <n>] [--concurrency <n>] [--json <path>]\n"
+                "          [--trace <path>]\n", argv0);
+}
+
+int main(int argc, char** argv)
+{
+    using namespace IpcBench;
+
+    bool quick = false;
+    std::vector<Mode> modes { Mode::Legacy, Mode::Shm, Mode::Session };
+    std::vector<uint32_t> frames;
+    std::vector<uint32_t> concurrency;
+    size_t requests = 0;
+    std::string jsonPath;
+    std::string tracePath;
+
+    for (int i = 1; i < argc; ++i) {
+        const char* arg = argv[i];
+        const bool hasValue = i + 1 < argc;
+        if (std::strcmp(arg, "--quick") == 0) {
+            quick = true;
+        } else if (std::strcmp(arg, "--mode") == 0 && hasValue) {
+            const std::string m = argv[++i];
+            if (m == "legacy") {
+                modes = { Mode::Legacy };
+            } else if (m == "shm") {
+                modes = { Mode::Shm };
+            } else if (m == "session") {
+                modes = { Mode::Session };
+            } else {
+                usage(argv[0]);
+                return 2;
+            }
+        } else if (std::strcmp(arg, "--requests") == 0 && hasValue) {
+            requests = static_cast<size_t>(std::atol(argv[++i]));
+        } else if (std::strcmp(arg, "--frames") == 0 && hasValue) {
+            frames.push_back(static_cast<uint32_t>(std::atoi(argv[++i])));
+        } else if (std::strcmp(arg, "--concurrency") == 0 && hasValue) {
+            concurrency.push_back(static_cast<uint32_t>(std::max(1, std::atoi(argv[++i]))));
+        } else if (std::strcmp(arg, "--json") == 0 && hasValue) {
+            jsonPath = argv[++i];
+        } else if (std::strcmp(arg, "--trace") == 0 && hasValue) {
+            tracePath = argv[++i];
+            g_trace = true;
+        } else {
+            usage(argv[0]);
+            return std::strcmp(arg, "--help") == 0 ? 0 : 2;
+        }
+    }
+    if (frames.empty()) {
+        frames = quick ? std::vector<uint32_t> { 256, 4096 }
+                       : std::vector<uint32_t> { 256, 4096, 65536 };
+    }
+    if (concurrency.empty()) {
+        concurrency = quick ? std::vector<uint32_t> { 1, 2 } : std::vector<uint32_t> { 1, 2, 4 };
+    }
+    if (requests == 0) {
+        requests = quick ? 400 : 4000;
+    }
+
+    /* Abstract socket: nothing to clean up on the filesystem */
+    sockaddr_un addr {};
+    addr.sun_family = AF_UNIX;
+    const int nameLen = std::snprintf(addr.sun_path + 1, sizeof(addr.sun_path) - 1,
+                                      "audio-ipc-bench-%d", static_cast<int>(getpid()));
+    const socklen_t addrLen = static_cast<socklen_t>(offsetof(sockaddr_un, sun_path) + 1 + nameLen);
+
+    const int listenFd = socket(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0);
+    if (listenFd < 0 || bind(listenFd, reinterpret_cast<const sockaddr*>(&addr), addrLen) != 0
+        || listen(listenFd, 64) != 0) {
+        std::perror("ipc_bench: listen");
+        return 1;
+    }
+
+    /* Fork before any thread exists in this process */
+    const pid_t service = fork();
+    if (service < 0) {
+        std::perror("ipc_bench: fork");
+        return 1;
+    }
+    if (service == 0) {
+        runService(listenFd);
+    }
+    close(listenFd);
+    if (g_trace) {
+        AudioTrace::setProcessName("ipc_bench");
+        AudioTrace::setEnabled(true);
+    }
+
+    std::printf("%-8s %7s %4s %9s %9s %9s %10s %9s | %7s %7s %7s %7s %7s\n",
+                "mode", "frames", "conc", "p50 us", "p99 us", "p999 us", "req/s", "MB/s",
+                "setup", "copyIn", "dsp", "copyOut", "signal");
+    std::vector<PointResult> results;
+    bool ok = true;
+    for (Mode mode : modes) {
+        for (uint32_t f : frames) {
+            for (uint32_t c : concurrency) {
+                PointResult r;
+                ok = runPoint(addr, addrLen, mode, f, c, requests, r) && ok;
+                printRow(r);
+                results.push_back(r);
+            }
+        }
+    }
+    std::printf("phase columns: mean us per request (host + service)\n");
+
+    const int quit = connectService(addr, addrLen);
+    if (quit >= 0) {
+        Parcel none;
+        sendParcel(quit, QUIT_CODE, none);
+        close(quit);
+    }
+    int wstatus = 0;
+    waitpid(service, &wstatus, 0);
+
+    if (!jsonPath.empty() && !writeJson(jsonPath, results)) {
+        std::fprintf(stderr, "ipc_bench: cannot write %s\n", jsonPath.c_str());
+        return 1;
+    }
+    if (g_trace && !AudioTrace::writeChromeTrace(tracePath)) {
+        std::fprintf(stderr, "ipc_bench: cannot write %s\n", tracePath.c_str());
+        return 1;
+    }
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,187 @@
+/**
+ * ipc_transport.cpp — Unix-socket stand-in for the HostApp ↔ DspService IPC
+ */
+
+#include "ipc_transport.h"
+
+#include <cerrno>
+#include <cstring>
+
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace IpcBench {
+
+namespace {
+
+/* Largest message: the demo's parcels are a handful of scalars */
+constexpr size_t kMaxMessageBytes = 256;
+
+} // namespace
+
+Parcel::~Parcel()
+{
+    clear();
+}
+
+void Parcel::clear()
+{
+    if (ownsFds_) {
+        for (size_t i = fdPos_; i < fds_.size(); ++i) {
+            close(fds_[i]);
+        }
+    }
+    data_.clear();
+    fds_.clear();
+    ownsFds_ = false;
+    pos_ = fdPos_ = 0;
+    ok_ = true;
+}
+
+void Parcel::writeInt(int32_t v)
+{
+    const uint8_t* p = reinterpret_cast<const uint8_t*>(&v);
+    data_.insert(data_.end(), p, p + sizeof(v));
+}
+
+void Parcel::writeLong(int64_t v)
+{
+    const uint8_t* p = reinterpret_cast<const uint8_t*>(&v);
+    data_.insert(data_.end(), p, p + sizeof(v));
+}
+
+void Parcel::writeFloat(float v)
+{
+    const uint8_t* p = reinterpret_cast<const uint8_t*>(&v);
+    data_.insert(data_.end(), p, p + sizeof(v));
+}
+
+void Parcel::writeFileDescriptor(int fd)
+{
+    if (fds_.size() < kMaxFds) {
+        fds_.push_back(fd);
+    } else {
+        ok_ = false;
+    }
+}
+
+bool Parcel::take(void* dst, size_t bytes)
+{
+    if (pos_ + bytes > data_.size()) {
+        std::memset(dst, 0, bytes);
+        ok_ = false;
+        return false;
+    }
+    std::memcpy(dst, data_.data() + pos_, bytes);
+    pos_ += bytes;
+    return true;
+}
+
+int32_t Parcel::readInt()
+{
+    int32_t v;
+    take(&v, sizeof(v));
+    return v;
+}
+
+int64_t Parcel::readLong()
+{
+    int64_t v;
+    take(&v, sizeof(v));
+    return v;
+}
+
+float Parcel::readFloat()
+{
+    float v;
+    take(&v, sizeof(v));
+    return v;
+}
+
+int Parcel::readFileDescriptor()
+{
+    if (fdPos_ >= fds_.size()) {
+        ok_ = false;
+        return -1;
+    }
+    return fds_[fdPos_++];
+}
+
+bool sendParcel(int sock, uint32_t code, const Parcel& p)
+{
+    if (!p.ok() || p.data_.size() + sizeof(code) > kMaxMessageBytes) {
+        return false;
+    }
+
+    iovec iov[2];
+    iov[0].iov_base = &code;
+    iov[0].iov_len  = sizeof(code);
+    iov[1].iov_base = const_cast<uint8_t*>(p.data_.data());
+    iov[1].iov_len  = p.data_.size();
+
+    alignas(cmsghdr) char control[CMSG_SPACE(sizeof(int) * Parcel::kMaxFds)] = {};
+    msghdr msg {};
+    msg.msg_iov    = iov;
+    msg.msg_iovlen = 2;
+    if (!p.fds_.empty()) {
+        const size_t fdBytes = sizeof(int) * p.fds_.size();
+        msg.msg_control    = control;
+        msg.msg_controllen = CMSG_SPACE(fdBytes);
+        cmsghdr* cm = CMSG_FIRSTHDR(&msg);
+        cm->cmsg_level = SOL_SOCKET;
+        cm->cmsg_type  = SCM_RIGHTS;
+        cm->cmsg_len   = CMSG_LEN(fdBytes);
+        std::memcpy(CMSG_DATA(cm), p.fds_.data(), fdBytes);
+    }
+
+    for (;;) {
+        const ssize_t n = sendmsg(sock, &msg, MSG_NOSIGNAL);
+        if (n >= 0) {
+            return true;
+        }
+        if (errno != EINTR) {
+            return false;
+        }
+    }
+}
+
+bool recvParcel(int sock, uint32_t& code, Parcel& p)
+{
+    p.clear();
+    p.data_.resize(kMaxMessageBytes);
+
+    iovec iov[2];
+    iov[0].iov_base = &code;
+    iov[0].iov_len  = sizeof(code);
+    iov[1].iov_base = p.data_.data();
+    iov[1].iov_len  = p.data_.size();
+
+    alignas(cmsghdr) char control[CMSG_SPACE(sizeof(int) * Parcel::kMaxFds)];
+    msghdr msg {};
+    msg.msg_iov        = iov;
+    msg.msg_iovlen     = 2;
+    msg.msg_control    = control;
+    msg.msg_controllen = sizeof(control);
+
+    ssize_t n;
+    do {
+        n = recvmsg(sock, &msg, MSG_CMSG_CLOEXEC);
+    } while (n < 0 && errno == EINTR);
+    if (n < static_cast<ssize_t>(sizeof(code))) {
+        p.data_.clear();
+        return false;
+    }
+    p.data_.resize(static_cast<size_t>(n) - sizeof(code));
+
+    for (cmsghdr* cm = CMSG_FIRSTHDR(&msg); cm; cm = CMSG_NXTHDR(&msg, cm)) {
+        if (cm->cmsg_level == SOL_SOCKET && cm->cmsg_type == SCM_RIGHTS) {
+            const size_t count = (cm->cmsg_len - CMSG_LEN(0)) / sizeof(int);
+            const int* fds = reinterpret_cast<const int*>(CMSG_DATA(cm));
+            p.fds_.insert(p.fds_.end(), fds, fds + count);
+        }
+    }
+    p.ownsFds_ = true;
+    return true;
+}
+
+} // namespace IpcBench
@@ -0,0 +1,77 @@
+/**
+ * ipc_transport.h — Unix-socket stand-in for the HostApp ↔ DspService IPC
+ *
+ * A Parcel mirrors the parts of MessageParcel the demo uses: writeInt /
+ * writeLong / writeFloat append little-endian values in order, and
+ * writeFileDescriptor attaches an fd (Ashmem on the device, a memfd here).
+ * sendParcel() / recvParcel() move one request or reply as a single
+ * SOCK_SEQPACKET message, the fds as SCM_RIGHTS, so the receiving process
+ * gets its own descriptor for the same region, as with Binder.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace IpcBench {
+
+class Parcel {
+public:
+    /** Most fds one message may carry */
+    static constexpr size_t kMaxFds = 4;
+
+    Parcel() = default;
+    ~Parcel();
+
+    Parcel(const Parcel&) = delete;
+    Parcel& operator=(const Parcel&) = delete;
+
+    void writeInt(int32_t v);
+    void writeLong(int64_t v);
+    void writeFloat(float v);
+
+    /** Attach @p fd; the caller keeps ownership of its descriptor. */
+    void writeFileDescriptor(int fd);
+
+    /* Read in write order; past the end they return 0 / -1 and set !ok() */
+    int32_t readInt();
+    int64_t readLong();
+    float   readFloat();
+
+    /** Next received fd, owned by the caller from now on (-1 if none). */
+    int readFileDescriptor();
+
+    bool ok() const { return ok_; }
+
+    /** Drop all contents (closing received fds not yet read). */
+    void clear();
+
+private:
+    friend bool sendParcel(int sock, uint32_t code, const Parcel& p);
+    friend bool recvParcel(int sock, uint32_t& code, Parcel& p);
+
+    bool take(void* dst, size_t bytes);
+
+    std::vector<uint8_t> data_;
+    std::vector<int>     fds_;          /* to send, or received + unread  */
+    bool                 ownsFds_ = false;
+    size_t               pos_     = 0;
+    size_t               fdPos_   = 0;
+    bool                 ok_      = true;
+};
+
+/**
+ * Send @p p as one message with request / reply code @p code.
+ * @return false on a socket error
+ */
+bool sendParcel(int sock, uint32_t code, const Parcel& p);
+
+/**
+ * Receive one message into @p p (cleared first).
+ * @return false on a socket error or when the peer closed the connection
+ */
+bool recvParcel(int sock, uint32_t& code, Parcel& p);
+
+} // namespace IpcBench
@@ -0,0 +1,384 @@
+/**
+ * AudioFormatConvert.cpp — PCM sample-format converters shared by both sides
+ */
+
+#include "AudioFormatConvert.h"
+
+#include <cmath>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <emmintrin.h>
+#include <tmmintrin.h>
+#define AUDIO_FORMAT_X86 1
+#elif defined(__aarch64__)
+#include <arm_neon.h>
+#define AUDIO_FORMAT_NEON 1
+#endif
+
+namespace AudioFormat {
+
+namespace {
+
+constexpr float kS16Scale    = 32768.0f;
+constexpr float kS16Inv      = 1.0f / 32768.0f;
+constexpr float kS16Min      = -32768.0f;
+constexpr float kS16Max      = 32767.0f;
+constexpr float kS24Scale    = 8388608.0f;
+constexpr float kS24Inv      = 1.0f / 8388608.0f;
+constexpr float kS24Min      = -8388608.0f;
+constexpr float kS24Max      = 8388607.0f;
+constexpr float kUniformUnit = 1.0f / 16777216.0f;   /* 2^-24 */
+
+inline uint32_t xorshift(uint32_t x)
+{
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    return x;
+}
+
+/* Four TPDF values in LSB units, (-1, 1); same sequence as the SIMD paths */
+inline void tpdf4(Dither& d, float out[4])
+{
+    uint32_t a[4], b[4];
+    for (int l = 0; l < 4; ++l) {
+        a[l] = d.lanes[l] = xorshift(d.lanes[l]);
+    }
+    for (int l = 0; l < 4; ++l) {
+        b[l] = d.lanes[l] = xorshift(d.lanes[l]);
+    }
+    for (int l = 0; l < 4; ++l) {
+        out[l] = static_cast<float>(a[l] >> 8) * kUniformUnit
+                 - static_cast<float>(b[l] >> 8) * kUniformUnit;
+    }
+}
+
+/* Scale, dither, clamp (NaN → lo), round to nearest even */
+inline int32_t quantize(float x, float scale, float lo, float hi, float dither)
+{
+    float y = x * scale + dither;
+    y = y > lo ? y : lo;
+    y = y < hi ? y : hi;
+    return static_cast<int32_t>(std::nearbyint(y));
+}
+
+/* Scalar tails: process [i, n) in groups of four so dither lanes line up */
+void floatToS16Tail(const float* src, int16_t* dst, size_t i, size_t n, Dither* dither)
+{
+    float d[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+    for (; i < n; i += 4) {
+        if (dither) {
+            tpdf4(*dither, d);
+        }
+        for (size_t l = 0; l < 4 && i + l < n; ++l) {
+            dst[i + l] = static_cast<int16_t>(quantize(src[i + l], kS16Scale, kS16Min, kS16Max, d[l]));
+        }
+    }
+}
+
+void floatToS24Tail(const float* src, uint8_t* dst, size_t i, size_t n, Dither* dither)
+{
+    float d[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+    for (; i < n; i += 4) {
+        if (dither) {
+            tpdf4(*dither, d);
+        }
+        for (size_t l = 0; l < 4 && i + l < n; ++l) {
+            const int32_t v = quantize(src[i + l], kS24Scale, kS24Min, kS24Max, d[l]);
+            uint8_t* p = dst + (i + l) * 3;
+            p[0] = static_cast<uint8_t>(v);
+            p[1] = static_cast<uint8_t>(v >> 8);
+            p[2] = static_cast<uint8_t>(v >> 16);
+        }
+    }
+}
+
+#if defined(AUDIO_FORMAT_X86)
+
+inline __m128 tpdf4Sse(__m128i& lanes)
+{
+    auto step = [](__m128i x) {
+        x = _mm_xor_si128(x, _mm_slli_epi32(x, 13));
+        x = _mm_xor_si128(x, _mm_srli_epi32(x, 17));
+        return _mm_xor_si128(x, _mm_slli_epi32(x, 5));
+    };
+    const __m128 unit = _mm_set1_ps(kUniformUnit);
+    const __m128i a = lanes = step(lanes);
+    const __m128i b = lanes = step(lanes);
+    return _mm_sub_ps(_mm_mul_ps(_mm_cvtepi32_ps(_mm_srli_epi32(a, 8)), unit),
+                      _mm_mul_ps(_mm_cvtepi32_ps(_mm_srli_epi32(b, 8)), unit));
+}
+
+/* _mm_max_ps / _mm_min_ps return the second operand for NaN, like quantize() */
+inline __m128i quantizeSse(__m128 x, __m128 scale, __m128 lo, __m128 hi, __m128 dither)
+{
+    __m128 y = _mm_add_ps(_mm_mul_ps(x, scale), dither);
+    y = _mm_min_ps(_mm_max_ps(y, lo), hi);
+    return _mm_cvtps_epi32(y);
+}
+
+bool hasSsse3()
+{
+    static const bool supported = __builtin_cpu_supports("ssse3");
+    return supported;
+}
+
+__attribute__((target("ssse3")))
+size_t s24ToFloatSsse3(const uint8_t* src, float* dst, size_t n)
+{
+    const __m128i shuf = _mm_setr_epi8(-1, 0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11);
+    const __m128  inv  = _mm_set1_ps(kS24Inv);
+    size_t i = 0;
+    /* Each load reads 16 bytes for 4 samples (12 bytes): keep 2 samples of slack */
+    for (; i + 6 <= n; i += 4) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i * 3));
+        v = _mm_srai_epi32(_mm_shuffle_epi8(v, shuf), 8);
+        _mm_storeu_ps(dst + i, _mm_mul_ps(_mm_cvtepi32_ps(v), inv));
+    }
+    return i;
+}
+
+__attribute__((target("ssse3")))
+size_t floatToS24Ssse3(const float* src, uint8_t* dst, size_t n, Dither* dither)
+{
+    const __m128i shuf  = _mm_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1);
+    const __m128  scale = _mm_set1_ps(kS24Scale);
+    const __m128  lo    = _mm_set1_ps(kS24Min);
+    const __m128  hi    = _mm_set1_ps(kS24Max);
+    __m128i lanes = dither ? _mm_loadu_si128(reinterpret_cast<const __m128i*>(dither->lanes))
+                           : _mm_setzero_si128();
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        const __m128 d = dither ? tpdf4Sse(lanes) : _mm_setzero_ps();
+        __m128i v = quantizeSse(_mm_loadu_ps(src + i), scale, lo, hi, d);
+        v = _mm_shuffle_epi8(v, shuf);
+        uint8_t* p = dst + i * 3;
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(p), v);
+        const int32_t tail = _mm_cvtsi128_si32(_mm_srli_si128(v, 8));
+        std::memcpy(p + 8, &tail, sizeof(tail));
+    }
+    if (dither) {
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dither->lanes), lanes);
+    }
+    return i;
+}
+
+#elif defined(AUDIO_FORMAT_NEON)
+
+inline float32x4_t tpdf4Neon(uint32x4_t& lanes)
+{
+    auto step = [](uint32x4_t x) {
+        x = veorq_u32(x, vshlq_n_u32(x, 13));
+        x = veorq_u32(x, vshrq_n_u32(x, 17));
+        return veorq_u32(x, vshlq_n_u32(x, 5));
+    };
+    const float32x4_t unit = vdupq_n_f32(kUniformUnit);
+    const uint32x4_t a = lanes = step(lanes);
+    const uint32x4_t b = lanes = step(lanes);
+    return vsubq_f32(vmulq_f32(vcvtq_f32_u32(vshrq_n_u32(a, 8)), unit),
+                     vmulq_f32(vcvtq_f32_u32(vshrq_n_u32(b, 8)), unit));
+}
+
+/* Compare-and-select so NaN clamps to lo, like quantize() */
+inline int32x4_t quantizeNeon(float32x4_t x, float32x4_t scale, float32x4_t lo,
+                              float32x4_t hi, float32x4_t dither)
+{
+    float32x4_t y = vaddq_f32(vmulq_f32(x, scale), dither);
+    y = vbslq_f32(vcgtq_f32(y, lo), y, lo);
+    y = vbslq_f32(vcltq_f32(y, hi), y, hi);
+    return vcvtnq_s32_f32(y);
+}
+
+#endif
+
+} // namespace
+
+void seedDither(Dither& d, uint32_t seed)
+{
+    for (uint32_t l = 0; l < 4; ++l) {
+        /* splitmix32-style hash: distinct, non-zero lanes from any seed */
+        uint32_t z = seed + 0x9e3779b9u * (l + 1);
+        z = (z ^ (z >> 16)) * 0x85ebca6bu;
+        z = (z ^ (z >> 13)) * 0xc2b2ae35u;
+        z ^= z >> 16;
+        d.lanes[l] = z ? z : 0x6d2b79f5u;
+    }
+}
+
+size_t bytesPerSample(uint32_t format)
+{
+    return audioFormatBytes(format);
+}
+
+bool isPlanar(uint32_t format)
+{
+    return format == AUDIO_FORMAT_FLOAT32_PLANAR;
+}
+
+void s16ToFloat(const int16_t* src, float* dst, size_t n)
+{
+    size_t i = 0;
+#if defined(AUDIO_FORMAT_X86)
+    const __m128 inv = _mm_set1_ps(kS16Inv);
+    for (; i + 8 <= n; i += 8) {
+        const __m128i v  = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+        const __m128i lo = _mm_srai_epi32(_mm_unpacklo_epi16(v, v), 16);
+        const __m128i hi = _mm_srai_epi32(_mm_unpackhi_epi16(v, v), 16);
+        _mm_storeu_ps(dst + i,     _mm_mul_ps(_mm_cvtepi32_ps(lo), inv));
+        _mm_storeu_ps(dst + i + 4, _mm_mul_ps(_mm_cvtepi32_ps(hi), inv));
+    }
+#elif defined(AUDIO_FORMAT_NEON)
+    const float32x4_t inv = vdupq_n_f32(kS16Inv);
+    for (; i + 8 <= n; i += 8) {
+        const int16x8_t v = vld1q_s16(src + i);
+        vst1q_f32(dst + i,     vmulq_f32(vcvtq_f32_s32(vmovl_s16(vget_low_s16(v))), inv));
+        vst1q_f32(dst + i + 4, vmulq_f32(vcvtq_f32_s32(vmovl_s16(vget_high_s16(v))), inv));
+    }
+#endif
+    for (; i < n; ++i) {
+        dst[i] = static_cast<float>(src[i]) * kS16Inv;
+    }
+}
+
+void floatToS16(const float* src, int16_t* dst, size_t n, Dither* dither)
+{
+    size_t i = 0;
+#if defined(AUDIO_FORMAT_X86)
+    const __m128 scale = _mm_set1_ps(kS16Scale);
+    const __m128 lo    = _mm_set1_ps(kS16Min);
+    const __m128 hi    = _mm_set1_ps(kS16Max);
+    __m128i lanes = dither ? _mm_loadu_si128(reinterpret_cast<const __m128i*>(dither->lanes))
+                           : _mm_setzero_si128();
+    for (; i + 8 <= n; i += 8) {
+        const __m128 d0 = dither ? tpdf4Sse(lanes) : _mm_setzero_ps();
+        const __m128 d1 = dither ? tpdf4Sse(lanes) : _mm_setzero_ps();
+        const __m128i a = quantizeSse(_mm_loadu_ps(src + i),     scale, lo, hi, d0);
+        const __m128i b = quantizeSse(_mm_loadu_ps(src + i + 4), scale, lo, hi, d1);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_packs_epi32(a, b));
+    }
+    if (dither) {
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dither->lanes), lanes);
+    }
+#elif defined(AUDIO_FORMAT_NEON)
+    const float32x4_t scale = vdupq_n_f32(kS16Scale);
+    const float32x4_t lo    = vdupq_n_f32(kS16Min);
+    const float32x4_t hi    = vdupq_n_f32(kS16Max);
+    uint32x4_t lanes = dither ? vld1q_u32(dither->lanes) : vdupq_n_u32(0);
+    for (; i + 8 <= n; i += 8) {
+        const float32x4_t d0 = dither ? tpdf4Neon(lanes) : vdupq_n_f32(0.0f);
+        const float32x4_t d1 = dither ? tpdf4Neon(lanes) : vdupq_n_f32(0.0f);
+        const int32x4_t a = quantizeNeon(vld1q_f32(src + i),     scale, lo, hi, d0);
+        const int32x4_t b = quantizeNeon(vld1q_f32(src + i + 4), scale, lo, hi, d1);
+        vst1q_s16(dst + i, vcombine_s16(vqmovn_s32(a), vqmovn_s32(b)));
+    }
+    if (dither) {
+        vst1q_u32(dither->lanes, lanes);
+    }
+#endif
+    floatToS16Tail(src, dst, i, n, dither);
+}
+
+void s24ToFloat(const uint8_t* src, float* dst, size_t n)
+{
+    size_t i = 0;
+#if defined(AUDIO_FORMAT_X86)
+    if (hasSsse3()) {
+        i = s24ToFloatSsse3(src, dst, n);
+    }
+#elif defined(AUDIO_FORMAT_NEON)
+    const float32x4_t inv = vdupq_n_f32(kS24Inv);
+    for (; i + 8 <= n; i += 8) {
+        const uint8x8x3_t v = vld3_u8(src + i * 3);
+        /* b0 | b1 << 8 as unsigned, b2 sign-extended as the high part */
+        const uint16x8_t low  = vorrq_u16(vmovl_u8(v.val[0]), vshlq_n_u16(vmovl_u8(v.val[1]), 8));
+        const int16x8_t  high = vmovl_s8(vreinterpret_s8_u8(v.val[2]));
+        const int32x4_t  a = vaddq_s32(vshlq_n_s32(vmovl_s16(vget_low_s16(high)), 16),
+                                       vreinterpretq_s32_u32(vmovl_u16(vget_low_u16(low))));
+        const int32x4_t  b = vaddq_s32(vshlq_n_s32(vmovl_s16(vget_high_s16(high)), 16),
+                                       vreinterpretq_s32_u32(vmovl_u16(vget_high_u16(low))));
+        vst1q_f32(dst + i,     vmulq_f32(vcvtq_f32_s32(a), inv));
+        vst1q_f32(dst + i + 4, vmulq_f32(vcvtq_f32_s32(b), inv));
+    }
+#endif
+    for (; i < n; ++i) {
+        const uint8_t* p = src + i * 3;
+        /* Assemble in the top 24 bits, then shift down to sign-extend */
+        const int32_t v = static_cast<int32_t>((static_cast<uint32_t>(p[0]) << 8)
+                                               | (static_cast<uint32_t>(p[1]) << 16)
+                                               | (static_cast<uint32_t>(p[2]) << 24)) >> 8;
+        dst[i] = static_cast<float>(v) * kS24Inv;
+    }
+}
+
+void floatToS24(const float* src, uint8_t* dst, size_t n, Dither* dither)
+{
+    size_t i = 0;
+#if defined(AUDIO_FORMAT_X86)
+    if (hasSsse3()) {
+        i = floatToS24Ssse3(src, dst, n, dither);
+    }
+#elif defined(AUDIO_FORMAT_NEON)
+    const float32x4_t scale = vdupq_n_f32(kS24Scale);
+    const float32x4_t lo    = vdupq_n_f32(kS24Min);
+    const float32x4_t hi    = vdupq_n_f32(kS24Max);
+    uint32x4_t lanes = dither ? vld1q_u32(dither->lanes) : vdupq_n_u32(0);
+    for (; i + 8 <= n; i += 8) {
+        const float32x4_t d0 = dither ? tpdf4Neon(lanes) : vdupq_n_f32(0.0f);
+        const float32x4_t d1 = dither ? tpdf4Neon(lanes) : vdupq_n_f32(0.0f);
+        const uint32x4_t a = vreinterpretq_u32_s32(quantizeNeon(vld1q_f32(src + i),     scale, lo, hi, d0));
+        const uint32x4_t b = vreinterpretq_u32_s32(quantizeNeon(vld1q_f32(src + i + 4), scale, lo, hi, d1));
+        uint8x8x3_t v;
+        v.val[0] = vmovn_u16(vcombine_u16(vmovn_u32(a), vmovn_u32(b)));
+        v.val[1] = vmovn_u16(vcombine_u16(vmovn_u32(vshrq_n_u32(a, 8)), vmovn_u32(vshrq_n_u32(b, 8))));
+        v.val[2] = vmovn_u16(vcombine_u16(vmovn_u32(vshrq_n_u32(a, 16)), vmovn_u32(vshrq_n_u32(b, 16))));
+        vst3_u8(dst + i * 3, v);
+    }
+    if (dither) {
+        vst1q_u32(dither->lanes, lanes);
+    }
+#endif
+    floatToS24Tail(src, dst, i, n, dither);
+}
+
+bool decode(uint32_t format, const void* src, float* dst, size_t n)
+{
+    switch (format) {
+    case AUDIO_FORMAT_FLOAT32:
+    case AUDIO_FORMAT_FLOAT32_PLANAR:
+        if (dst != src) {
+            std::memmove(dst, src, n * sizeof(float));
+        }
+        return true;
+    case AUDIO_FORMAT_S16:
+        s16ToFloat(static_cast<const int16_t*>(src), dst, n);
+        return true;
+    case AUDIO_FORMAT_S24_PACKED:
+        s24ToFloat(static_cast<const uint8_t*>(src), dst, n);
+        return true;
+    default:
+        return false;
+    }
+}
+
+bool encode(uint32_t format, const float* src, void* dst, size_t n, Dither* dither)
+{
+    switch (format) {
+    case AUDIO_FORMAT_FLOAT32:
+    case AUDIO_FORMAT_FLOAT32_PLANAR:
+        if (dst != src) {
+            std::memmove(dst, src, n * sizeof(float));
+        }
+        return true;
+    case AUDIO_FORMAT_S16:
+        floatToS16(src, static_cast<int16_t*>(dst), n, dither);
+        return true;
+    case AUDIO_FORMAT_S24_PACKED:
+        floatToS24(src, static_cast<uint8_t*>(dst), n, dither);
+        return true;
+    default:
+        return false;
+    }
+}
+
+} // namespace AudioFormat
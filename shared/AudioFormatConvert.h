@@ -0,0 +1,68 @@
+/**
+ * AudioFormatConvert.h — PCM sample-format converters shared by both sides
+ *
+ * Converts between float32 and the compact AUDIO_FORMAT_* encodings of
+ * AudioSharedBuffer.h. Integer → float scales by 2^-(bits-1); float → int
+ * scales by 2^(bits-1), optionally adds TPDF dither of ±1 LSB, clamps to
+ * the integer range and rounds to nearest (ties to even). NaN encodes as
+ * the most negative code.
+ *
+ * Every kernel is vectorised: SSE2 (int16, float) and SSSE3 (packed int24)
+ * on x86-64, NEON on aarch64, with a scalar loop for the tail and for other
+ * targets. The conversions are load/store bound, so wider x86 variants do
+ * not pay off. Callers fuse them with their DSP by converting one
+ * L1-resident block at a time.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "AudioSharedBuffer.h"
+
+namespace AudioFormat {
+
+/**
+ * TPDF dither generator: four xorshift32 lanes, stepped together so SIMD
+ * and scalar code consume the same sequence.
+ */
+struct Dither {
+    uint32_t lanes[4];
+};
+
+/** Seed all lanes from one value (any value, including 0, is fine). */
+void seedDither(Dither& d, uint32_t seed);
+
+/** Bytes per sample of a format, or 0 for an unknown format. */
+size_t bytesPerSample(uint32_t format);
+
+/** True for the planar (channel-major) formats. */
+bool isPlanar(uint32_t format);
+
+/** int16 → float in [-1, 1). */
+void s16ToFloat(const int16_t* src, float* dst, size_t n);
+
+/** float → int16; dither may be nullptr. */
+void floatToS16(const float* src, int16_t* dst, size_t n, Dither* dither);
+
+/** Packed little-endian int24 (3 bytes per sample) → float in [-1, 1). */
+void s24ToFloat(const uint8_t* src, float* dst, size_t n);
+
+/** float → packed little-endian int24; dither may be nullptr. */
+void floatToS24(const float* src, uint8_t* dst, size_t n, Dither* dither);
+
+/**
+ * Decode n samples of any format into float32. Planar float is a plain
+ * copy; the caller handles the channel layout.
+ * @return false for an unknown format
+ */
+bool decode(uint32_t format, const void* src, float* dst, size_t n);
+
+/**
+ * Encode n float32 samples into any format (see decode()).
+ * @return false for an unknown format
+ */
+bool encode(uint32_t format, const float* src, void* dst, size_t n, Dither* dither);
+
+} // namespace AudioFormat
@@ -0,0 +1,83 @@
+/**
+ * AudioLiveControl.cpp — seqlock access to an AudioControlBlock
+ */
+
+#include "AudioLiveControl.h"
+
+#include <algorithm>
+
+namespace AudioControl {
+
+namespace {
+
+template <typename T>
+T loadRelaxed(const T* p)
+{
+    T v;
+    __atomic_load(p, &v, __ATOMIC_RELAXED);
+    return v;
+}
+
+template <typename T>
+void storeRelaxed(T* p, T v)
+{
+    __atomic_store(p, &v, __ATOMIC_RELAXED);
+}
+
+} // namespace
+
+void write(AudioControlBlock* block, const Values& values)
+{
+    /* | 1 also recovers from a writer that died mid-update */
+    const uint32_t odd = __atomic_load_n(&block->sequence, __ATOMIC_RELAXED) | 1u;
+    __atomic_store_n(&block->sequence, odd, __ATOMIC_RELAXED);
+    /* odd sequence must be visible before any field changes */
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+
+    const uint32_t count = std::min(values.paramCount, AUDIO_CONTROL_MAX_PARAMS);
+    storeRelaxed(&block->gain, values.gain);
+    storeRelaxed(&block->bypass, values.bypass);
+    storeRelaxed(&block->rampFrames, values.rampFrames);
+    storeRelaxed(&block->paramCount, count);
+    for (uint32_t i = 0; i < count; ++i) {
+        storeRelaxed(&block->params[i], values.params[i]);
+    }
+
+    /* fields before the even sequence that publishes them */
+    __atomic_store_n(&block->sequence, odd + 1u, __ATOMIC_RELEASE);
+}
+
+bool read(const AudioControlBlock* block, Values& out, uint32_t* sequence)
+{
+    for (int attempt = 0; attempt < kMaxReadRetries; ++attempt) {
+        const uint32_t before = __atomic_load_n(&block->sequence, __ATOMIC_ACQUIRE);
+        if (before & 1u) {
+            continue;
+        }
+
+        out.gain       = loadRelaxed(&block->gain);
+        out.bypass     = loadRelaxed(&block->bypass);
+        out.rampFrames = loadRelaxed(&block->rampFrames);
+        out.paramCount = std::min(loadRelaxed(&block->paramCount), AUDIO_CONTROL_MAX_PARAMS);
+        for (uint32_t i = 0; i < out.paramCount; ++i) {
+            out.params[i] = loadRelaxed(&block->params[i]);
+        }
+
+        /* field loads must complete before the sequence is re-checked */
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+        if (__atomic_load_n(&block->sequence, __ATOMIC_RELAXED) == before) {
+            if (sequence) {
+                *sequence = before;
+            }
+            return true;
+        }
+    }
+    return false;
+}
+
+uint32_t sequence(const AudioControlBlock* block)
+{
+    return __atomic_load_n(&block->sequence, __ATOMIC_ACQUIRE);
+}
+
+} // namespace AudioControl
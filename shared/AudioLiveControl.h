@@ -0,0 +1,52 @@
+/**
+ * AudioLiveControl.h — seqlock access to an AudioControlBlock
+ *
+ * The host is the only writer, the service the only reader, so neither
+ * side ever takes a lock or waits on the other:
+ *
+ *   write():  sequence → odd, store the fields, sequence → next even
+ *   read():   load sequence (even), load the fields, re-load sequence;
+ *             the snapshot is consistent when both loads match
+ *
+ * Every field is accessed with a 32-bit atomic, so a reader racing a
+ * writer sees stale or new words but never a torn one, and simply retries.
+ */
+
+#pragma once
+
+#include <cstdint>
+
+#include "AudioSharedBuffer.h"
+
+namespace AudioControl {
+
+/** The payload of an AudioControlBlock, without the sequence word */
+struct Values {
+    float    gain       = 1.0f;
+    uint32_t bypass     = 0;
+    uint32_t rampFrames = 0;   /* 0 = the reader's default (10 ms) */
+    uint32_t paramCount = 0;
+    float    params[AUDIO_CONTROL_MAX_PARAMS] = {};
+};
+
+/** Reader retries before giving up on a block that keeps changing */
+constexpr int kMaxReadRetries = 16;
+
+/**
+ * Publish new values. Single writer only; never blocks.
+ * paramCount is clamped to AUDIO_CONTROL_MAX_PARAMS.
+ */
+void write(AudioControlBlock* block, const Values& values);
+
+/**
+ * Take a consistent snapshot.
+ * @param sequence  receives the (even) sequence the snapshot belongs to
+ * @return false if the writer was mid-update on every retry; out is then
+ *         unspecified and the caller should keep its previous values
+ */
+bool read(const AudioControlBlock* block, Values& out, uint32_t* sequence);
+
+/** Current sequence word — a cheap "did anything change" check. */
+uint32_t sequence(const AudioControlBlock* block);
+
+} // namespace AudioControl
@@ -3,27 +3,161 @@
  *
  * Shared memory layout between HostApp and DspService:
  *
- *   [ AudioSharedHeader (128 bytes) ]
- *   [ Input  float32 PCM  (frames * channels * 4 bytes) ]
- *   [ Output float32 PCM  (frames * channels * 4 bytes) ]
- *
- * Total size = AUDIO_SHM_HEADER_SIZE + 2 * frames * channels * sizeof(float)
- *
- * Field offsets (packed, no alignment padding):
- *   0  magic              uint32  4
- *   4  version            uint32  4
- *   8  sampleRate         uint32  4
- *  12  channels           uint32  4
- *  16  frames             uint32  4
- *  20  format             uint32  4
- *  24  inputOffset        uint32  4
- *  28  outputOffset       uint32  4
- *  32  status             int32   4
- *  36  processingTimeNs   int64   8
- *  44  gain               float   4
- *  48  bypass             uint32  4
- *  52  _pad               uint8[76] 76
- * 128  (end of header)
+ *   [ AudioSharedHeader (headerSize bytes, AUDIO_SHM_HEADER_SIZE = 192) ]
+ *   [ Input  PCM  (frames * channels * audioFormatBytes(format) bytes)   ]  64-byte aligned
+ *   [ Output PCM  (same size; audioSrcCapacityFrames() when resampling) ]  64-byte aligned
+ *
+ * Offsets and total size: see audioShmLayout().
+ *
+ * Version 2 (current). Every field is naturally aligned and fields are
+ * grouped by writer on separate 64-byte cache lines, so the service
+ * publishing a result never invalidates the line holding the request, and
+ * the host rewriting live parameters never touches the service's line:
+ *
+ *   line 0 — host-owned, written before the request
+ *     0  magic             uint32       32  inputOffset    uint32
+ *     4  version           uint32       36  outputOffset   uint32
+ *     8  headerSize        uint32       40  chainOffset    uint32 (0 = none)
+ *    12  sampleRate        uint32       44  gain           float
+ *    16  channels          uint32       48  bypass         uint32
+ *    20  frames            uint32       52  outputRate     uint32 (0 = sampleRate)
+ *    24  format            uint32       56  srcQuality     uint32 (AUDIO_SRC_QUALITY_*)
+ *    28  flags             uint32 (AUDIO_FLAG_*)       60  _hostPad  uint32
+ *   line 1 — host-owned, rewritten at any time (seqlock)
+ *    64  control           AudioControlBlock 64
+ *   line 2 — service-owned
+ *   128  status            int32
+ *   132  outputFrames      uint32 (frames written to the output region)
+ *   136  processingTimeNs  int64
+ *   144  outputFrameOffset uint32 (first frame written, sessions)
+ *   148  nonFiniteCount    uint32 (NaN / Inf inputs replaced, AUDIO_FLAG_GUARD)
+ *   152  _svcPad           uint8[40]
+ *   192  (end of header)
+ *
+ * headerSize (a multiple of 64, ≥ AUDIO_SHM_HEADER_SIZE) lets later
+ * revisions append lines without a version bump: the service only touches
+ * areas below headerSize. inputOffset, outputOffset and chainOffset must be
+ * ≥ headerSize and multiples of AUDIO_SHM_PCM_ALIGN (a host may choose
+ * AUDIO_SHM_PAGE_ALIGN), so the DSP kernels see cache-line-aligned PCM and
+ * no two regions share a line.
+ *
+ * Version 1 (AudioSharedHeaderV1, still accepted by the service): a
+ * 128-byte packed header. status and processingTimeNs (unaligned at 36)
+ * share line 0 with the request fields, and the PCM regions only need
+ * sample alignment:
+ *
+ *    0 magic  4 version  8 sampleRate  12 channels  16 frames  20 format
+ *   24 inputOffset  28 outputOffset  32 status  36 processingTimeNs
+ *   44 gain  48 bypass  52 chainOffset  56 flags  60 _pad  64 control
+ *
+ * magic / version sit at 0 / 4 and the control block at 64 in both
+ * versions, so a reader can dispatch on the first 8 bytes.
+ *
+ * Live control (AUDIO_FLAG_LIVE_CONTROL): the control block replaces the
+ * gain / bypass pair and may be rewritten by the host at any time, without
+ * IPC or locks. It is a seqlock: the host bumps `sequence` to an odd value,
+ * writes the fields, then bumps it to the next even value; the service
+ * re-reads the block at every block boundary (256 frames), retries while
+ * the sequence is odd or changed under it, and ramps towards new values
+ * over rampFrames so parameter steps never click. See AudioLiveControl.h.
+ *
+ * Request tracing (AUDIO_FLAG_TRACE, v2 only): the header grows by an
+ * AudioTraceBlock of two lines at AUDIO_SHM_TRACE_OFFSET (headerSize ≥
+ * AUDIO_SHM_HEADER_SIZE_TRACED), one per writer:
+ *
+ *   line 3 — host-owned
+ *   192  requestId         uint64 (correlation id, host-chosen)
+ *   200  hostPid / hostTid uint32 × 2
+ *   208  hostSendNs        int64  (just before the request is sent)
+ *   216  hostReplyNs       int64  (reply received)
+ *   line 4 — service-owned, written once before the reply
+ *   256  serviceRequestId  uint64 (requestId as the service saw it)
+ *   264  servicePid / Tid  uint32 × 2
+ *   272  receiveNs  280 mapDoneNs  288 dspStartNs  296 dspEndNs
+ *   304  writeBackNs  312 replyNs                        int64 each
+ *
+ * Timestamps are CLOCK_MONOTONIC nanoseconds, one clock for every process
+ * on the device, so host and service stamps subtract directly; 0 means the
+ * phase was not recorded. See AudioTrace.h.
+ *
+ * Metering (AUDIO_FLAG_METER, v2 only): the service measures levels in
+ * the same pass as the processing and stores them, before status, in an
+ * AudioMeterBlock of three service-owned lines at audioShmMeterOffset()
+ * — right after the result line, or after the trace block when both are
+ * present (headerSize ≥ audioShmHeaderSizeFor(flags)):
+ *
+ *   +0   channels  uint32 (metered; 0 = more than AUDIO_METER_MAX_CHANNELS)
+ *   +4   frames    uint32      +8  clipTotal  uint32
+ *   +12  loudnessLufs float (AUDIO_FLAG_LOUDNESS, else 0)
+ *   +16  valid     uint32 (AUDIO_METER_VALID_*)
+ *   +32  inPeak[8]   +64 outPeak[8]   +96 inRms[8]   +128 outRms[8]  float
+ *   +160 clipCount[8] uint32
+ *
+ * Peaks and RMS are linear (1.0 = full scale). clipCount counts samples
+ * the soft clip drove into saturation (|input × gain| > 1); for chains
+ * and bypassed audio, output samples beyond full scale. loudnessLufs is
+ * ITU-R BS.1770 short-term loudness (K-weighted, last 3 s).
+ *
+ * Optional processing-chain extension region (chainOffset != 0):
+ *
+ *   [ AudioChainDescriptor (520 bytes) ] placed between header and PCM,
+ *   inputOffset / outputOffset shifted past it by the host.
+ *
+ * When a chain is present it replaces the gain / bypass pair: the service
+ * runs every stage in order, in place, on the output region.
+ *
+ * Impulse responses (AUDIO_STAGE_CONVOLVER): the stage's subtype is the
+ * byte offset of an AudioImpulseHeader anywhere in the same region (4-byte
+ * aligned; after the output PCM is the usual place), followed directly by
+ * the taps as planar float32, channel 0 first:
+ *
+ *   [ AudioImpulseHeader (32 bytes) ][ channels × frames float32 taps ]
+ *
+ * One IR channel is applied to every stream channel; otherwise the IR has
+ * one channel per stream channel. The service reads the taps once, when
+ * the chain is configured (per request, or once per session).
+ *
+ * Sample-rate conversion (v2 only): outputRate != 0 and != sampleRate asks
+ * the service to convert the input to outputRate before processing; gain,
+ * chain, live control and meters then run at outputRate. The output region
+ * holds audioSrcCapacityFrames(frames, sampleRate, outputRate) frames (see
+ * audioShmRateLayout()) and must not overlap the input. Rates are limited
+ * to [AUDIO_SRC_MIN_RATE, AUDIO_SRC_MAX_RATE]. The service reports where
+ * it wrote in outputFrameOffset / outputFrames (without conversion: the
+ * processed range). A one-shot request flushes the converter and yields
+ * audioSrcOutputFrames(frames, ...) frames at offset 0. Over a session the
+ * converter keeps its state between calls: a call yields the frames whose
+ * filter window is complete, and AUDIO_FLAG_SRC_FLUSH ends the stream so
+ * the held-back tail comes out too. Results of successive calls are laid
+ * out one after the other, restarting at 0 with every call at input frame
+ * 0, so a pass over the input region always fits the output region.
+ * Batch jobs and streams do not convert.
+ *
+ * Guard mode (AUDIO_FLAG_GUARD, header or batch job): the request runs
+ * with subnormals flushed to zero (FTZ / DAZ on x86, FZ on aarch64) on
+ * the service thread and every worker it uses, and NaN / ±Inf input
+ * samples are replaced by 0 in the kernels' first pass over them. The
+ * number replaced goes to nonFiniteCount (v2 header, AudioBatchJob);
+ * AUDIO_FLAG_GUARD_STRICT also fails the request with AUDIO_STATUS_ERROR
+ * when it is not 0. Integer formats cannot carry such values and are not
+ * scanned.
+ *
+ * PCM formats: input and output both use header.format. Interleaved
+ * formats store frame by frame; AUDIO_FORMAT_FLOAT32_PLANAR stores one
+ * plane of `frames` samples per channel, channel 0 first. Integer formats
+ * are little-endian, full scale = ±1.0; AUDIO_FLAG_DITHER adds TPDF dither
+ * when the service writes them.
+ *
+ * Batch layout (PROCESS_BATCH_CODE), many short clips in one transaction:
+ *
+ *   [ AudioBatchHeader (64 bytes)                    ]
+ *   [ AudioBatchJob × jobCount (64 bytes each)       ]
+ *   [ per-job input / output PCM, chain descriptors  ]  each AUDIO_BATCH_ALIGN-aligned
+ *
+ * Every job carries its own geometry, gain / bypass (or chainOffset), and
+ * gets its own status and processingTimeNs (and nonFiniteCount in guard
+ * mode) written back by the service.
+ * All offsets are absolute from the start of the region.
  */
 
 #pragma once
@@ -32,44 +166,589 @@
 
 /* Magic 0x41534844: bytes 0x41='A' 0x53='S' 0x48='H' 0x44='D' (big-endian read) */
 #define AUDIO_SHM_MAGIC    0x41534844u
-#define AUDIO_SHM_VERSION  1u
-#define AUDIO_SHM_HEADER_SIZE 128u
+#define AUDIO_SHM_VERSION  2u
+#define AUDIO_SHM_VERSION_1  1u
+#define AUDIO_SHM_HEADER_SIZE    192u   /* v2 */
+#define AUDIO_SHM_HEADER_SIZE_V1 128u
+
+/* Trace block (AUDIO_FLAG_TRACE) right after the v2 header lines */
+#define AUDIO_SHM_TRACE_OFFSET         192u
+#define AUDIO_SHM_TRACE_SIZE           128u
+#define AUDIO_SHM_HEADER_SIZE_TRACED   320u
+
+/* Meter block (AUDIO_FLAG_METER), after the trace block if there is one */
+#define AUDIO_SHM_METER_SIZE         192u
+#define AUDIO_METER_MAX_CHANNELS     8u
+#define AUDIO_METER_VALID_LEVELS     1u   /* peaks, RMS, clip counts         */
+#define AUDIO_METER_VALID_LOUDNESS   2u   /* loudnessLufs                    */
+
+/* Alignment of v2 PCM / chain regions: minimum, and page for hosts that want it */
+#define AUDIO_SHM_PCM_ALIGN   64u
+#define AUDIO_SHM_PAGE_ALIGN  4096u
 
-/* PCM format */
-#define AUDIO_FORMAT_FLOAT32 0u
+/* PCM format (header.format / AudioBatchJob.format) */
+#define AUDIO_FORMAT_FLOAT32         0u   /* float32, interleaved              */
+#define AUDIO_FORMAT_S16             1u   /* int16, interleaved                */
+#define AUDIO_FORMAT_S24_PACKED      2u   /* int24 in 3 bytes, interleaved     */
+#define AUDIO_FORMAT_FLOAT32_PLANAR  3u   /* float32, one plane per channel    */
+
+/* header.flags / AudioBatchJob.flags */
+#define AUDIO_FLAG_DITHER        1u   /* TPDF-dither integer output samples       */
+#define AUDIO_FLAG_LIVE_CONTROL  2u   /* gain / bypass come from header.control
+                                         (AudioSharedHeader only)                */
+#define AUDIO_FLAG_TRACE         4u   /* header carries an AudioTraceBlock
+                                         (AudioSharedHeader only)                */
+#define AUDIO_FLAG_METER         8u   /* header carries an AudioMeterBlock
+                                         (AudioSharedHeader only)                */
+#define AUDIO_FLAG_LOUDNESS     16u   /* also measure BS.1770 short-term
+                                         loudness (with AUDIO_FLAG_METER)        */
+#define AUDIO_FLAG_SRC_FLUSH    32u   /* session call ends the resampled stream:
+                                         emit the held-back tail and reset   */
+#define AUDIO_FLAG_GUARD        64u   /* flush subnormals, replace and count
+                                         NaN / Inf input samples             */
+#define AUDIO_FLAG_GUARD_STRICT 128u  /* AUDIO_FLAG_GUARD, and fail a request
+                                         that had any                        */
+
+/* Sample-rate conversion (header.outputRate / header.srcQuality) */
+#define AUDIO_SRC_QUALITY_DEFAULT  0u   /* = AUDIO_SRC_QUALITY_MEDIUM          */
+#define AUDIO_SRC_QUALITY_LOW      1u   /* 16 taps, ~60 dB stop band           */
+#define AUDIO_SRC_QUALITY_MEDIUM   2u   /* 48 taps, ~90 dB                     */
+#define AUDIO_SRC_QUALITY_HIGH     3u   /* 128 taps, ~120 dB                   */
+#define AUDIO_SRC_MIN_RATE         8000u
+#define AUDIO_SRC_MAX_RATE         384000u
+#define AUDIO_SRC_MAX_TAPS         128u  /* filter length of the best quality,
+                                           at the lower of the two rates    */
 
 /* Status codes written by DspService into header.status */
 #define AUDIO_STATUS_IDLE        0
 #define AUDIO_STATUS_PROCESSING  1
 #define AUDIO_STATUS_DONE        2
 #define AUDIO_STATUS_ERROR      -1
+#define AUDIO_STATUS_BUSY       -2   /* refused by admission control; the
+                                         request was not run, retry later   */
 
 /* Byte offsets used by ArkTS DataView (must match struct layout below) */
-#define AUDIO_HDR_OFFSET_STATUS          32
-#define AUDIO_HDR_OFFSET_PROC_TIME_NS    36
+#define AUDIO_HDR_OFFSET_VERSION         4
+#define AUDIO_HDR_OFFSET_HEADER_SIZE     8
+#define AUDIO_HDR_OFFSET_FLAGS           28
+#define AUDIO_HDR_OFFSET_INPUT           32
+#define AUDIO_HDR_OFFSET_OUTPUT          36
+#define AUDIO_HDR_OFFSET_CHAIN           40
 #define AUDIO_HDR_OFFSET_GAIN            44
 #define AUDIO_HDR_OFFSET_BYPASS          48
+#define AUDIO_HDR_OFFSET_OUTPUT_RATE     52
+#define AUDIO_HDR_OFFSET_SRC_QUALITY     56
+#define AUDIO_HDR_OFFSET_CONTROL         64
+#define AUDIO_HDR_OFFSET_STATUS          128
+#define AUDIO_HDR_OFFSET_OUTPUT_FRAMES   132
+#define AUDIO_HDR_OFFSET_PROC_TIME_NS    136
+#define AUDIO_HDR_OFFSET_OUTPUT_FRAME_OFFSET 144
+#define AUDIO_HDR_OFFSET_NON_FINITE      148
 
-#pragma pack(push, 1)
+/* AudioTraceBlock fields, absolute from the start of the region */
+#define AUDIO_TRACE_OFFSET_REQUEST_ID      192
+#define AUDIO_TRACE_OFFSET_HOST_PID        200
+#define AUDIO_TRACE_OFFSET_HOST_SEND       208
+#define AUDIO_TRACE_OFFSET_HOST_REPLY      216
+#define AUDIO_TRACE_OFFSET_SERVICE         256   /* service-owned line */
+#define AUDIO_TRACE_OFFSET_SVC_REQUEST_ID  256
+#define AUDIO_TRACE_OFFSET_SVC_PID         264
+#define AUDIO_TRACE_OFFSET_RECEIVE         272
+#define AUDIO_TRACE_OFFSET_MAP_DONE        280
+#define AUDIO_TRACE_OFFSET_DSP_START       288
+#define AUDIO_TRACE_OFFSET_DSP_END         296
+#define AUDIO_TRACE_OFFSET_WRITE_BACK      304
+#define AUDIO_TRACE_OFFSET_REPLY           312
+
+/* AudioMeterBlock fields, relative to audioShmMeterOffset() */
+#define AUDIO_METER_OFFSET_CHANNELS     0
+#define AUDIO_METER_OFFSET_FRAMES       4
+#define AUDIO_METER_OFFSET_CLIP_TOTAL   8
+#define AUDIO_METER_OFFSET_LOUDNESS     12
+#define AUDIO_METER_OFFSET_VALID        16
+#define AUDIO_METER_OFFSET_IN_PEAK      32
+#define AUDIO_METER_OFFSET_OUT_PEAK     64
+#define AUDIO_METER_OFFSET_IN_RMS       96
+#define AUDIO_METER_OFFSET_OUT_RMS      128
+#define AUDIO_METER_OFFSET_CLIP_COUNT   160
+
+/* The same for AudioSharedHeaderV1 */
+#define AUDIO_HDR_V1_OFFSET_INPUT          24
+#define AUDIO_HDR_V1_OFFSET_OUTPUT         28
+#define AUDIO_HDR_V1_OFFSET_STATUS         32
+#define AUDIO_HDR_V1_OFFSET_PROC_TIME_NS   36
+#define AUDIO_HDR_V1_OFFSET_GAIN           44
+#define AUDIO_HDR_V1_OFFSET_BYPASS         48
+#define AUDIO_HDR_V1_OFFSET_CHAIN          52
+#define AUDIO_HDR_V1_OFFSET_FLAGS          56
+
+/* Live control block (see AudioControlBlock) */
+#define AUDIO_CONTROL_SIZE        64u
+#define AUDIO_CONTROL_MAX_PARAMS  11u
+
+/* Processing-chain descriptor (see AudioChainDescriptor) */
+#define AUDIO_CHAIN_MAGIC       0x4348414eu   /* 'CHAN' */
+#define AUDIO_CHAIN_MAX_STAGES  16u
+
+/* Stage types (AudioChainStage.type) and their params[] */
+#define AUDIO_STAGE_GAIN_SOFTCLIP  1u   /* [0] gain                          */
+#define AUDIO_STAGE_BIQUAD         2u   /* [0] freqHz [1] Q [2] gainDb       */
+#define AUDIO_STAGE_COMPRESSOR     3u   /* [0] thresholdDb [1] ratio
+                                           [2] attackMs [3] releaseMs
+                                           [4] kneeDb [5] makeupDb           */
+#define AUDIO_STAGE_DC_BLOCKER     4u   /* [0] cutoffHz                      */
+#define AUDIO_STAGE_CONVOLVER      5u   /* [0] wetGain [1] dryGain
+                                           [2] partitionFrames (0 = auto);
+                                           subtype = AudioImpulseHeader
+                                           offset in the region            */
+
+/* Impulse response of a convolver stage (see AudioImpulseHeader) */
+#define AUDIO_IR_MAGIC        0x49524631u   /* 'IRF1' */
+#define AUDIO_IR_HEADER_SIZE  32u
+#define AUDIO_IR_MAX_FRAMES   (1u << 20)    /* taps per channel (21.8 s at 48 kHz) */
+
+/* Biquad shapes (AudioChainStage.subtype for AUDIO_STAGE_BIQUAD) */
+#define AUDIO_BIQUAD_LOWPASS    0u
+#define AUDIO_BIQUAD_HIGHPASS   1u
+#define AUDIO_BIQUAD_BANDPASS   2u
+#define AUDIO_BIQUAD_NOTCH      3u
+#define AUDIO_BIQUAD_PEAKING    4u
+#define AUDIO_BIQUAD_LOWSHELF   5u
+#define AUDIO_BIQUAD_HIGHSHELF  6u
+
+/*
+ * Seqlock-protected live parameters. Naturally aligned (all 32-bit words);
+ * placed on a 64-byte boundary in both AudioSharedHeader and
+ * AudioStreamHeader. Written only by the host, read only by the service.
+ */
+typedef struct AudioControlBlock {
+    uint32_t sequence;           /* even = stable, odd = host is writing  */
+    float    gain;               /* target gain, 0.0 ~ 2.0                */
+    uint32_t bypass;             /* target bypass, 0 or 1                 */
+    uint32_t rampFrames;         /* smoothing length, 0 = 10 ms           */
+    uint32_t paramCount;         /* valid params[] entries (reserved, 0)  */
+    float    params[AUDIO_CONTROL_MAX_PARAMS];   /* reserved for chain
+                                                    parameters            */
+} AudioControlBlock;
+
+/* Version 2: natural alignment, one writer per cache line (see top) */
 typedef struct AudioSharedHeader {
+    /* line 0 — host-owned request */
     uint32_t magic;              /* AUDIO_SHM_MAGIC                       */
     uint32_t version;            /* AUDIO_SHM_VERSION                     */
+    uint32_t headerSize;         /* ≥ AUDIO_SHM_HEADER_SIZE, × 64         */
+    uint32_t sampleRate;         /* e.g. 44100                            */
+    uint32_t channels;           /* e.g. 2                                */
+    uint32_t frames;             /* number of audio frames                */
+    uint32_t format;             /* AUDIO_FORMAT_*                        */
+    uint32_t flags;              /* AUDIO_FLAG_*                          */
+    uint32_t inputOffset;        /* byte offset of input PCM, × 64        */
+    uint32_t outputOffset;       /* byte offset of output PCM, × 64       */
+    uint32_t chainOffset;        /* AudioChainDescriptor offset, 0 = none */
+    float    gain;               /* applied gain, 0.0 ~ 2.0               */
+    uint32_t bypass;             /* 0 = process,  1 = bypass              */
+    uint32_t outputRate;         /* converted rate, 0 = sampleRate        */
+    uint32_t srcQuality;         /* AUDIO_SRC_QUALITY_*                   */
+    uint32_t _hostPad;
+    /* line 1 — host-owned, seqlock */
+    AudioControlBlock control;   /* live gain / bypass (LIVE_CONTROL)     */
+    /* line 2 — service-owned result */
+    int32_t  status;             /* AUDIO_STATUS_*  (set by DspService)   */
+    uint32_t outputFrames;       /* frames written  (set by DspService)   */
+    int64_t  processingTimeNs;   /* nanoseconds     (set by DspService)   */
+    uint32_t outputFrameOffset;  /* first frame written (DspService)      */
+    uint32_t nonFiniteCount;     /* NaN / Inf replaced (GUARD, DspService) */
+    uint8_t  _svcPad[40];
+} AudioSharedHeader;
+
+/* Per-request timestamps (AUDIO_FLAG_TRACE), one writer per line */
+typedef struct AudioTraceBlock {
+    /* host-owned */
+    uint64_t requestId;          /* correlation id, 0 = none              */
+    uint32_t hostPid;
+    uint32_t hostTid;
+    int64_t  hostSendNs;
+    int64_t  hostReplyNs;
+    uint8_t  _hostPad[32];
+    /* service-owned */
+    uint64_t serviceRequestId;   /* copy of requestId when stamped        */
+    uint32_t servicePid;
+    uint32_t serviceTid;
+    int64_t  receiveNs;          /* request handed to the service         */
+    int64_t  mapDoneNs;          /* region mapped / session looked up     */
+    int64_t  dspStartNs;
+    int64_t  dspEndNs;
+    int64_t  writeBackNs;        /* output + status stored in the region  */
+    int64_t  replyNs;            /* handler done, reply about to be sent  */
+} AudioTraceBlock;
+
+/* Per-request levels (AUDIO_FLAG_METER), written by the service only */
+typedef struct AudioMeterBlock {
+    uint32_t channels;           /* channels metered, 0 = none            */
+    uint32_t frames;             /* frames metered                        */
+    uint32_t clipTotal;          /* sum of clipCount[]                    */
+    float    loudnessLufs;       /* BS.1770 short-term, LUFS              */
+    uint32_t valid;              /* AUDIO_METER_VALID_*                   */
+    uint32_t _pad[3];
+    float    inPeak[AUDIO_METER_MAX_CHANNELS];     /* max |x|, linear     */
+    float    outPeak[AUDIO_METER_MAX_CHANNELS];
+    float    inRms[AUDIO_METER_MAX_CHANNELS];      /* linear              */
+    float    outRms[AUDIO_METER_MAX_CHANNELS];
+    uint32_t clipCount[AUDIO_METER_MAX_CHANNELS];  /* saturated samples   */
+} AudioMeterBlock;
+
+/* Version 1: packed, kept so older hosts keep working */
+#pragma pack(push, 1)
+typedef struct AudioSharedHeaderV1 {
+    uint32_t magic;              /* AUDIO_SHM_MAGIC                       */
+    uint32_t version;            /* AUDIO_SHM_VERSION_1                   */
     uint32_t sampleRate;         /* e.g. 44100                            */
     uint32_t channels;           /* e.g. 2                                */
     uint32_t frames;             /* number of audio frames                */
-    uint32_t format;             /* AUDIO_FORMAT_FLOAT32                  */
+    uint32_t format;             /* AUDIO_FORMAT_*                        */
     uint32_t inputOffset;        /* byte offset of input PCM from buf[0]  */
     uint32_t outputOffset;       /* byte offset of output PCM from buf[0] */
     int32_t  status;             /* AUDIO_STATUS_*  (set by DspService)   */
     int64_t  processingTimeNs;   /* nanoseconds     (set by DspService)   */
     float    gain;               /* applied gain, 0.0 ~ 2.0               */
     uint32_t bypass;             /* 0 = process,  1 = bypass              */
-    uint8_t  _pad[76];           /* pad to AUDIO_SHM_HEADER_SIZE = 128    */
-} AudioSharedHeader;
+    uint32_t chainOffset;        /* AudioChainDescriptor offset, 0 = none */
+    uint32_t flags;              /* AUDIO_FLAG_*                          */
+    uint8_t  _pad[4];            /* control block starts on byte 64       */
+    AudioControlBlock control;   /* live gain / bypass (LIVE_CONTROL)     */
+} AudioSharedHeaderV1;
 #pragma pack(pop)
 
-/* Total Ashmem size for a given stream */
+typedef struct AudioChainStage {
+    uint32_t type;               /* AUDIO_STAGE_*                         */
+    uint32_t subtype;            /* AUDIO_BIQUAD_* for biquad stages      */
+    float    params[6];          /* stage parameters, see AUDIO_STAGE_*   */
+} AudioChainStage;
+
+typedef struct AudioChainDescriptor {
+    uint32_t        magic;       /* AUDIO_CHAIN_MAGIC                     */
+    uint32_t        stageCount;  /* ≤ AUDIO_CHAIN_MAX_STAGES              */
+    AudioChainStage stages[AUDIO_CHAIN_MAX_STAGES];
+} AudioChainDescriptor;
+
+typedef struct AudioImpulseHeader {
+    uint32_t magic;              /* AUDIO_IR_MAGIC                        */
+    uint32_t channels;           /* 1 (every channel) or stream channels  */
+    uint32_t frames;             /* taps per channel, ≤ AUDIO_IR_MAX_FRAMES */
+    uint32_t sampleRate;         /* rate of the IR, 0 = the stream's      */
+    uint32_t _reserved[4];       /* 0; taps follow at AUDIO_IR_HEADER_SIZE */
+} AudioImpulseHeader;
+
+/* Batch job table (see AudioBatchHeader / AudioBatchJob) */
+#define AUDIO_BATCH_MAGIC          0x41424154u   /* 'ABAT' */
+#define AUDIO_BATCH_VERSION        1u
+#define AUDIO_BATCH_HEADER_SIZE    64u
+#define AUDIO_BATCH_JOB_SIZE       64u
+#define AUDIO_BATCH_MAX_JOBS       4096u
+#define AUDIO_BATCH_ALIGN          64u
+#define AUDIO_BATCH_FLAG_PARALLEL  1u   /* jobs may run concurrently */
+
+#pragma pack(push, 1)
+typedef struct AudioBatchHeader {
+    uint32_t magic;              /* AUDIO_BATCH_MAGIC                     */
+    uint32_t version;            /* AUDIO_BATCH_VERSION                   */
+    uint32_t jobCount;           /* 1 ~ AUDIO_BATCH_MAX_JOBS              */
+    uint32_t flags;              /* AUDIO_BATCH_FLAG_*                    */
+    int32_t  status;             /* AUDIO_STATUS_*  (set by DspService)   */
+    uint32_t jobsFailed;         /* jobs with status ERROR (DspService)   */
+    int64_t  processingTimeNs;   /* whole batch     (set by DspService)   */
+    uint8_t  _pad[32];           /* pad to AUDIO_BATCH_HEADER_SIZE = 64   */
+} AudioBatchHeader;
+
+typedef struct AudioBatchJob {
+    uint32_t inputOffset;        /* byte offset of input PCM              */
+    uint32_t outputOffset;       /* byte offset of output PCM (may equal
+                                    inputOffset for in-place processing)  */
+    uint32_t frames;
+    uint32_t channels;
+    uint32_t sampleRate;
+    uint32_t format;             /* AUDIO_FORMAT_*                        */
+    float    gain;
+    uint32_t bypass;
+    uint32_t chainOffset;        /* AudioChainDescriptor offset, 0 = none */
+    int32_t  status;             /* AUDIO_STATUS_*  (set by DspService)   */
+    int64_t  processingTimeNs;   /* this job        (set by DspService)   */
+    uint32_t flags;              /* AUDIO_FLAG_*                          */
+    uint32_t nonFiniteCount;     /* NaN / Inf replaced (GUARD, DspService) */
+    uint8_t  _pad[8];            /* pad to AUDIO_BATCH_JOB_SIZE = 64      */
+} AudioBatchJob;
+#pragma pack(pop)
+
+#ifdef __cplusplus
+static_assert(sizeof(AudioControlBlock) == AUDIO_CONTROL_SIZE, "AudioControlBlock size");
+static_assert(sizeof(AudioSharedHeader) == AUDIO_SHM_HEADER_SIZE, "AudioSharedHeader size");
+static_assert(__builtin_offsetof(AudioSharedHeader, version) == AUDIO_HDR_OFFSET_VERSION
+              && __builtin_offsetof(AudioSharedHeader, headerSize) == AUDIO_HDR_OFFSET_HEADER_SIZE
+              && __builtin_offsetof(AudioSharedHeader, flags) == AUDIO_HDR_OFFSET_FLAGS
+              && __builtin_offsetof(AudioSharedHeader, inputOffset) == AUDIO_HDR_OFFSET_INPUT
+              && __builtin_offsetof(AudioSharedHeader, outputOffset) == AUDIO_HDR_OFFSET_OUTPUT
+              && __builtin_offsetof(AudioSharedHeader, chainOffset) == AUDIO_HDR_OFFSET_CHAIN
+              && __builtin_offsetof(AudioSharedHeader, gain) == AUDIO_HDR_OFFSET_GAIN
+              && __builtin_offsetof(AudioSharedHeader, bypass) == AUDIO_HDR_OFFSET_BYPASS
+              && __builtin_offsetof(AudioSharedHeader, outputRate) == AUDIO_HDR_OFFSET_OUTPUT_RATE
+              && __builtin_offsetof(AudioSharedHeader, srcQuality) == AUDIO_HDR_OFFSET_SRC_QUALITY,
+              "AudioSharedHeader request fields");
+static_assert(__builtin_offsetof(AudioSharedHeader, control) == AUDIO_HDR_OFFSET_CONTROL,
+              "AudioSharedHeader control offset");
+static_assert(__builtin_offsetof(AudioSharedHeader, status) == AUDIO_HDR_OFFSET_STATUS
+              && __builtin_offsetof(AudioSharedHeader, outputFrames) == AUDIO_HDR_OFFSET_OUTPUT_FRAMES
+              && __builtin_offsetof(AudioSharedHeader, processingTimeNs) == AUDIO_HDR_OFFSET_PROC_TIME_NS
+              && __builtin_offsetof(AudioSharedHeader, outputFrameOffset) == AUDIO_HDR_OFFSET_OUTPUT_FRAME_OFFSET
+              && __builtin_offsetof(AudioSharedHeader, nonFiniteCount) == AUDIO_HDR_OFFSET_NON_FINITE
+              && AUDIO_HDR_OFFSET_PROC_TIME_NS % 8 == 0,
+              "AudioSharedHeader result fields");
+/* One writer per cache line: request, live control, result */
+static_assert(AUDIO_HDR_OFFSET_SRC_QUALITY + 4 <= AUDIO_HDR_OFFSET_CONTROL
+              && AUDIO_HDR_OFFSET_CONTROL % AUDIO_SHM_PCM_ALIGN == 0
+              && AUDIO_HDR_OFFSET_STATUS == AUDIO_HDR_OFFSET_CONTROL + AUDIO_CONTROL_SIZE
+              && AUDIO_SHM_HEADER_SIZE % AUDIO_SHM_PCM_ALIGN == 0,
+              "AudioSharedHeader cache-line split");
+static_assert(sizeof(AudioTraceBlock) == AUDIO_SHM_TRACE_SIZE
+              && AUDIO_SHM_TRACE_OFFSET == AUDIO_SHM_HEADER_SIZE
+              && AUDIO_SHM_HEADER_SIZE_TRACED == AUDIO_SHM_TRACE_OFFSET + AUDIO_SHM_TRACE_SIZE,
+              "AudioTraceBlock size");
+static_assert(AUDIO_SHM_TRACE_OFFSET + __builtin_offsetof(AudioTraceBlock, hostPid) == AUDIO_TRACE_OFFSET_HOST_PID
+              && AUDIO_SHM_TRACE_OFFSET + __builtin_offsetof(AudioTraceBlock, hostSendNs) == AUDIO_TRACE_OFFSET_HOST_SEND
+              && AUDIO_SHM_TRACE_OFFSET + __builtin_offsetof(AudioTraceBlock, hostReplyNs) == AUDIO_TRACE_OFFSET_HOST_REPLY
+              && AUDIO_SHM_TRACE_OFFSET + __builtin_offsetof(AudioTraceBlock, serviceRequestId) == AUDIO_TRACE_OFFSET_SERVICE
+              && AUDIO_SHM_TRACE_OFFSET + __builtin_offsetof(AudioTraceBlock, servicePid) == AUDIO_TRACE_OFFSET_SVC_PID
+              && AUDIO_SHM_TRACE_OFFSET + __builtin_offsetof(AudioTraceBlock, receiveNs) == AUDIO_TRACE_OFFSET_RECEIVE
+              && AUDIO_SHM_TRACE_OFFSET + __builtin_offsetof(AudioTraceBlock, mapDoneNs) == AUDIO_TRACE_OFFSET_MAP_DONE
+              && AUDIO_SHM_TRACE_OFFSET + __builtin_offsetof(AudioTraceBlock, dspStartNs) == AUDIO_TRACE_OFFSET_DSP_START
+              && AUDIO_SHM_TRACE_OFFSET + __builtin_offsetof(AudioTraceBlock, dspEndNs) == AUDIO_TRACE_OFFSET_DSP_END
+              && AUDIO_SHM_TRACE_OFFSET + __builtin_offsetof(AudioTraceBlock, writeBackNs) == AUDIO_TRACE_OFFSET_WRITE_BACK
+              && AUDIO_SHM_TRACE_OFFSET + __builtin_offsetof(AudioTraceBlock, replyNs) == AUDIO_TRACE_OFFSET_REPLY
+              && AUDIO_TRACE_OFFSET_SERVICE % AUDIO_SHM_PCM_ALIGN == 0,
+              "AudioTraceBlock layout");
+static_assert(sizeof(AudioMeterBlock) == AUDIO_SHM_METER_SIZE
+              && AUDIO_SHM_METER_SIZE % AUDIO_SHM_PCM_ALIGN == 0
+              && __builtin_offsetof(AudioMeterBlock, frames) == AUDIO_METER_OFFSET_FRAMES
+              && __builtin_offsetof(AudioMeterBlock, clipTotal) == AUDIO_METER_OFFSET_CLIP_TOTAL
+              && __builtin_offsetof(AudioMeterBlock, loudnessLufs) == AUDIO_METER_OFFSET_LOUDNESS
+              && __builtin_offsetof(AudioMeterBlock, valid) == AUDIO_METER_OFFSET_VALID
+              && __builtin_offsetof(AudioMeterBlock, inPeak) == AUDIO_METER_OFFSET_IN_PEAK
+              && __builtin_offsetof(AudioMeterBlock, outPeak) == AUDIO_METER_OFFSET_OUT_PEAK
+              && __builtin_offsetof(AudioMeterBlock, inRms) == AUDIO_METER_OFFSET_IN_RMS
+              && __builtin_offsetof(AudioMeterBlock, outRms) == AUDIO_METER_OFFSET_OUT_RMS
+              && __builtin_offsetof(AudioMeterBlock, clipCount) == AUDIO_METER_OFFSET_CLIP_COUNT,
+              "AudioMeterBlock layout");
+static_assert(sizeof(AudioSharedHeaderV1) == AUDIO_SHM_HEADER_SIZE_V1, "AudioSharedHeaderV1 size");
+static_assert(__builtin_offsetof(AudioSharedHeaderV1, status) == AUDIO_HDR_V1_OFFSET_STATUS
+              && __builtin_offsetof(AudioSharedHeaderV1, processingTimeNs) == AUDIO_HDR_V1_OFFSET_PROC_TIME_NS
+              && __builtin_offsetof(AudioSharedHeaderV1, chainOffset) == AUDIO_HDR_V1_OFFSET_CHAIN
+              && __builtin_offsetof(AudioSharedHeaderV1, flags) == AUDIO_HDR_V1_OFFSET_FLAGS
+              && __builtin_offsetof(AudioSharedHeaderV1, control) == AUDIO_HDR_OFFSET_CONTROL,
+              "AudioSharedHeaderV1 layout");
+static_assert(sizeof(AudioImpulseHeader) == AUDIO_IR_HEADER_SIZE, "AudioImpulseHeader size");
+static_assert(sizeof(AudioBatchHeader) == AUDIO_BATCH_HEADER_SIZE, "AudioBatchHeader size");
+static_assert(sizeof(AudioBatchJob) == AUDIO_BATCH_JOB_SIZE, "AudioBatchJob size");
+#endif
+
+/* Byte offset of the first PCM / descriptor byte after a job table */
+static inline uint32_t audioBatchDataOffset(uint32_t jobCount)
+{
+    uint32_t end = AUDIO_BATCH_HEADER_SIZE + jobCount * AUDIO_BATCH_JOB_SIZE;
+    return (end + AUDIO_BATCH_ALIGN - 1u) & ~(AUDIO_BATCH_ALIGN - 1u);
+}
+
+/*
+ * Control block of a mapped AudioSharedHeader of either version (it is at
+ * AUDIO_HDR_OFFSET_CONTROL in both). Goes through the byte offset because
+ * v1 is packed; the block itself is aligned as long as the mapping is
+ * (mmap returns page-aligned addresses).
+ */
+static inline AudioControlBlock* audioShmControl(void* base)
+{
+    return (AudioControlBlock*)((uint8_t*)base + AUDIO_HDR_OFFSET_CONTROL);
+}
+
+/*
+ * Trace block of a mapped v2 header, or NULL when the request is not traced
+ * (flag clear, or headerSize / the mapping too small to hold the block).
+ */
+static inline AudioTraceBlock* audioShmTrace(void* base, uint32_t headerSize, uint32_t flags,
+                                             uint64_t mappedSize)
+{
+    if (!(flags & AUDIO_FLAG_TRACE) || headerSize < AUDIO_SHM_HEADER_SIZE_TRACED
+        || mappedSize < AUDIO_SHM_HEADER_SIZE_TRACED) {
+        return (AudioTraceBlock*)0;
+    }
+    return (AudioTraceBlock*)((uint8_t*)base + AUDIO_SHM_TRACE_OFFSET);
+}
+
+/* Start of the meter block: after the trace block when there is one */
+static inline uint32_t audioShmMeterOffset(uint32_t flags)
+{
+    return (flags & AUDIO_FLAG_TRACE) ? AUDIO_SHM_HEADER_SIZE_TRACED : AUDIO_SHM_HEADER_SIZE;
+}
+
+/* Smallest v2 headerSize that holds the blocks @p flags ask for */
+static inline uint32_t audioShmHeaderSizeFor(uint32_t flags)
+{
+    if (flags & AUDIO_FLAG_METER) {
+        return audioShmMeterOffset(flags) + AUDIO_SHM_METER_SIZE;
+    }
+    return (flags & AUDIO_FLAG_TRACE) ? AUDIO_SHM_HEADER_SIZE_TRACED : AUDIO_SHM_HEADER_SIZE;
+}
+
+/*
+ * Meter block of a mapped v2 header, or NULL when the request is not
+ * metered (flag clear, or headerSize / the mapping too small for it).
+ */
+static inline AudioMeterBlock* audioShmMeter(void* base, uint32_t headerSize, uint32_t flags,
+                                             uint64_t mappedSize)
+{
+    const uint32_t end = audioShmHeaderSizeFor(flags);
+    if (!(flags & AUDIO_FLAG_METER) || headerSize < end || mappedSize < end) {
+        return (AudioMeterBlock*)0;
+    }
+    return (AudioMeterBlock*)((uint8_t*)base + audioShmMeterOffset(flags));
+}
+
+/* Bytes per sample of a PCM format, 0 for an unknown format */
+static inline uint32_t audioFormatBytes(uint32_t format)
+{
+    switch (format) {
+    case AUDIO_FORMAT_FLOAT32:
+    case AUDIO_FORMAT_FLOAT32_PLANAR:
+        return 4u;
+    case AUDIO_FORMAT_S16:
+        return 2u;
+    case AUDIO_FORMAT_S24_PACKED:
+        return 3u;
+    default:
+        return 0u;
+    }
+}
+
+/* Round n up to a power-of-two alignment */
+static inline uint32_t audioShmAlignUp(uint32_t n, uint32_t align)
+{
+    return (n + align - 1u) & ~(align - 1u);
+}
+
+/* Region offsets of a v2 header (see audioShmLayout()) */
+typedef struct AudioShmLayout {
+    uint32_t headerSize;
+    uint32_t chainOffset;        /* 0 when no chain descriptor            */
+    uint32_t inputOffset;
+    uint32_t outputOffset;
+    uint32_t totalSize;          /* bytes to allocate for the region      */
+} AudioShmLayout;
+
+/*
+ * Output frames of a one-shot conversion of @p frames input frames,
+ * ceil(frames · outputRate / inputRate); @p frames when either rate is 0
+ * or they are equal (no conversion).
+ */
+static inline uint32_t audioSrcOutputFrames(uint32_t frames, uint32_t inputRate, uint32_t outputRate)
+{
+    if (inputRate == 0u || outputRate == 0u || inputRate == outputRate) {
+        return frames;
+    }
+    return (uint32_t)(((uint64_t)frames * outputRate + inputRate - 1u) / inputRate);
+}
+
+/*
+ * Input frames a converter may hold back for look-ahead: half its filter,
+ * which spans AUDIO_SRC_MAX_TAPS frames of the lower rate at most.
+ */
+static inline uint32_t audioSrcHoldFrames(uint32_t inputRate, uint32_t outputRate)
+{
+    uint64_t taps = AUDIO_SRC_MAX_TAPS;
+    if (outputRate != 0u && inputRate > outputRate) {
+        taps = ((uint64_t)AUDIO_SRC_MAX_TAPS * inputRate + outputRate - 1u) / outputRate;
+    }
+    return (uint32_t)(((taps + 7u) & ~(uint64_t)7u) / 2u);
+}
+
+/*
+ * Output region frames of a resampled request with @p frames input frames:
+ * room for a whole pass over the input plus the frames held back from
+ * earlier session calls. @p frames when there is no conversion.
+ */
+static inline uint32_t audioSrcCapacityFrames(uint32_t frames, uint32_t inputRate, uint32_t outputRate)
+{
+    if (inputRate == 0u || outputRate == 0u || inputRate == outputRate) {
+        return frames;
+    }
+    return audioSrcOutputFrames(frames + audioSrcHoldFrames(inputRate, outputRate), inputRate, outputRate);
+}
+
+/*
+ * v2 layout: [header (+ trace / meter blocks)][chain descriptor][input PCM]
+ * [output PCM], every region starting on a multiple of align
+ * (AUDIO_SHM_PCM_ALIGN or AUDIO_SHM_PAGE_ALIGN; 0 = AUDIO_SHM_PCM_ALIGN).
+ * The header grows by the blocks AUDIO_FLAG_TRACE / AUDIO_FLAG_METER in
+ * @p flags ask for; other flags do not change the layout. The output
+ * region holds @p outputFrames frames (a resampled request, see
+ * audioSrcCapacityFrames()).
+ */
+static inline AudioShmLayout audioShmRateLayout(uint32_t frames, uint32_t outputFrames, uint32_t channels,
+                                                uint32_t format, int withChain, uint32_t flags,
+                                                uint32_t align)
+{
+    AudioShmLayout l;
+    const uint32_t frameBytes = channels * audioFormatBytes(format);
+    if (align < AUDIO_SHM_PCM_ALIGN) {
+        align = AUDIO_SHM_PCM_ALIGN;
+    }
+    l.headerSize   = audioShmHeaderSizeFor(flags);
+    l.chainOffset  = withChain ? audioShmAlignUp(l.headerSize, align) : 0u;
+    l.inputOffset  = audioShmAlignUp(withChain ? l.chainOffset + (uint32_t)sizeof(AudioChainDescriptor)
+                                               : l.headerSize, align);
+    l.outputOffset = audioShmAlignUp(l.inputOffset + frames * frameBytes, align);
+    l.totalSize    = l.outputOffset + outputFrames * frameBytes;
+    return l;
+}
+
+/* audioShmRateLayout() with as many output frames as input frames */
+static inline AudioShmLayout audioShmFlagsLayout(uint32_t frames, uint32_t channels, uint32_t format,
+                                                 int withChain, uint32_t flags, uint32_t align)
+{
+    return audioShmRateLayout(frames, frames, channels, format, withChain, flags, align);
+}
+
+/* audioShmFlagsLayout() with or without a trace block only */
+static inline AudioShmLayout audioShmTracedLayout(uint32_t frames, uint32_t channels, uint32_t format,
+                                                  int withChain, int withTrace, uint32_t align)
+{
+    return audioShmFlagsLayout(frames, channels, format, withChain,
+                               withTrace ? AUDIO_FLAG_TRACE : 0u, align);
+}
+
+/* audioShmTracedLayout() without a trace block */
+static inline AudioShmLayout audioShmLayout(uint32_t frames, uint32_t channels, uint32_t format,
+                                            int withChain, uint32_t align)
+{
+    return audioShmTracedLayout(frames, channels, format, withChain, 0, align);
+}
+
+/* Total Ashmem size for a given float32 stream */
 static inline uint32_t audioShmTotalSize(uint32_t frames, uint32_t channels)
 {
-    return AUDIO_SHM_HEADER_SIZE + 2u * frames * channels * (uint32_t)sizeof(float);
+    return audioShmLayout(frames, channels, AUDIO_FORMAT_FLOAT32, 0, 0u).totalSize;
+}
+
+/* Total Ashmem size for a stream that carries an AudioChainDescriptor */
+static inline uint32_t audioShmChainTotalSize(uint32_t frames, uint32_t channels)
+{
+    return audioShmLayout(frames, channels, AUDIO_FORMAT_FLOAT32, 1, 0u).totalSize;
+}
+
+/* Bytes of an impulse response block: header plus planar float32 taps */
+static inline uint32_t audioImpulseBytes(uint32_t channels, uint32_t frames)
+{
+    return AUDIO_IR_HEADER_SIZE + channels * frames * (uint32_t)sizeof(float);
+}
+
+/* Total Ashmem size for a given stream in any PCM format */
+static inline uint32_t audioShmFormatTotalSize(uint32_t frames, uint32_t channels, uint32_t format)
+{
+    return audioShmLayout(frames, channels, format, 0, 0u).totalSize;
 }
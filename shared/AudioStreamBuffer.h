@@ -0,0 +1,114 @@
+/**
+ * AudioStreamBuffer.h
+ *
+ * Streaming shared memory layout between HostApp and DspService.
+ * Binder is used only to hand the region over (OPEN_STREAM_CODE) and to
+ * tear it down (CLOSE_STREAM_CODE); blocks then flow through two lock-free
+ * single-producer / single-consumer rings with futex wakeups:
+ *
+ *   [ AudioStreamHeader (384 bytes)                      ]
+ *   [ Input  slots: blockCount × slotStride  (host → DSP) ]
+ *   [ Output slots: blockCount × slotStride  (DSP → host) ]
+ *
+ * Each slot is an AudioStreamSlot (64 bytes) followed by
+ * blockFrames × channels float32 interleaved PCM, padded to 64 bytes.
+ *
+ * Header cache lines (all fields naturally aligned):
+ *     0  configuration (written once by host before OPEN_STREAM_CODE)
+ *    64  inWrite   — input ring write index  (host writes)
+ *   128  inRead    — input ring read index   (DSP writes)
+ *   192  outWrite  — output ring write index (DSP writes)
+ *   256  outRead   — output ring read index  (host writes)
+ *   320  control   — live gain / bypass seqlock (host writes, version 2)
+ *   384  (end of header)
+ *
+ * Indices are free-running uint32 block counters; the slot of index i is
+ * i & (blockCount - 1), so blockCount must be a power of two. Each index
+ * word doubles as the futex word the opposite side sleeps on.
+ *
+ * Version 2 added the control line: the DSP re-reads it between blocks and
+ * ramps gain / bypass per sample (see AudioLiveControl.h). Version 1
+ * regions (320-byte header, slots right after it) are still accepted and
+ * use the gain / bypass fields of the configuration line instead.
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+#include "AudioSharedBuffer.h"
+
+/* Magic 0x41535452: bytes 0x41='A' 0x53='S' 0x54='T' 0x52='R' (big-endian read) */
+#define AUDIO_STREAM_MAGIC          0x41535452u
+#define AUDIO_STREAM_VERSION        2u
+#define AUDIO_STREAM_CACHE_LINE     64u
+#define AUDIO_STREAM_HEADER_SIZE    384u
+#define AUDIO_STREAM_HEADER_SIZE_V1 320u
+#define AUDIO_STREAM_SLOT_HDR_SIZE  64u
+#define AUDIO_STREAM_MAX_BLOCKS     1024u
+
+/* Stream state (header.state) */
+#define AUDIO_STREAM_STATE_OPEN     0u
+#define AUDIO_STREAM_STATE_CLOSED   1u
+
+/* Slot flags (AudioStreamSlot.flags) */
+#define AUDIO_STREAM_BLOCK_END      1u   /* last block of the stream */
+
+typedef struct AudioStreamIndex {
+    uint32_t value;              /* free-running block counter / futex word */
+    uint32_t waiters;            /* > 0 while the other side sleeps on value */
+    uint8_t  _pad[56];           /* one index per cache line               */
+} AudioStreamIndex;
+
+typedef struct AudioStreamHeader {
+    uint32_t magic;              /* AUDIO_STREAM_MAGIC                     */
+    uint32_t version;            /* AUDIO_STREAM_VERSION                   */
+    uint32_t sampleRate;         /* e.g. 44100                             */
+    uint32_t channels;           /* e.g. 2                                 */
+    uint32_t blockFrames;        /* frames per slot                        */
+    uint32_t blockCount;         /* slots per ring (power of two)          */
+    uint32_t format;             /* AUDIO_FORMAT_FLOAT32                   */
+    uint32_t slotStride;         /* bytes per slot incl. AudioStreamSlot   */
+    uint32_t inputSlotsOffset;   /* byte offset of input ring slots        */
+    uint32_t outputSlotsOffset;  /* byte offset of output ring slots       */
+    uint32_t state;              /* AUDIO_STREAM_STATE_*                   */
+    float    gain;               /* initial gain (version 1: live gain)    */
+    uint32_t bypass;             /* initial bypass (version 1: live)       */
+    uint8_t  _pad[12];           /* pad configuration line to 64 bytes     */
+    AudioStreamIndex inWrite;
+    AudioStreamIndex inRead;
+    AudioStreamIndex outWrite;
+    AudioStreamIndex outRead;
+    AudioControlBlock control;   /* version ≥ 2 only                       */
+} AudioStreamHeader;
+
+typedef struct AudioStreamSlot {
+    uint32_t frames;             /* valid frames in this block             */
+    uint32_t flags;              /* AUDIO_STREAM_BLOCK_*                   */
+    uint64_t sequence;           /* block index within the stream          */
+    uint8_t  _pad[48];           /* PCM starts on the next cache line      */
+} AudioStreamSlot;
+
+#ifdef __cplusplus
+static_assert(sizeof(AudioStreamIndex) == AUDIO_STREAM_CACHE_LINE, "AudioStreamIndex size");
+static_assert(sizeof(AudioStreamHeader) == AUDIO_STREAM_HEADER_SIZE, "AudioStreamHeader size");
+static_assert(__builtin_offsetof(AudioStreamHeader, control) == AUDIO_STREAM_HEADER_SIZE_V1,
+              "AudioStreamHeader control offset");
+static_assert(sizeof(AudioStreamSlot) == AUDIO_STREAM_SLOT_HDR_SIZE, "AudioStreamSlot size");
+#endif
+
+/* Bytes per slot for a given block geometry (PCM padded to a cache line) */
+static inline uint32_t audioStreamSlotStride(uint32_t blockFrames, uint32_t channels)
+{
+    uint32_t pcm = blockFrames * channels * (uint32_t)sizeof(float);
+    pcm = (pcm + AUDIO_STREAM_CACHE_LINE - 1u) & ~(AUDIO_STREAM_CACHE_LINE - 1u);
+    return AUDIO_STREAM_SLOT_HDR_SIZE + pcm;
+}
+
+/* Total region size for a given stream geometry */
+static inline uint32_t audioStreamTotalSize(uint32_t blockFrames, uint32_t channels,
+                                            uint32_t blockCount)
+{
+    return AUDIO_STREAM_HEADER_SIZE
+           + 2u * blockCount * audioStreamSlotStride(blockFrames, channels);
+}
@@ -0,0 +1,312 @@
+/**
+ * AudioStreamRing.cpp — SPSC block rings over an AudioStreamBuffer region
+ */
+
+#include "AudioStreamRing.h"
+#include "AudioLiveControl.h"
+
+#include <cerrno>
+#include <chrono>
+#include <climits>
+#include <cstring>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+
+namespace AudioStream {
+
+namespace {
+
+constexpr int kSpinCount = 64;
+
+uint32_t loadAcquire(const uint32_t* p)
+{
+    return __atomic_load_n(p, __ATOMIC_ACQUIRE);
+}
+
+/* Sleep while *word == expected (process-shared futex, no PRIVATE flag). */
+void futexWait(uint32_t* word, uint32_t expected, int timeoutMs)
+{
+    struct timespec ts;
+    struct timespec* pts = nullptr;
+    if (timeoutMs >= 0) {
+        ts.tv_sec  = timeoutMs / 1000;
+        ts.tv_nsec = static_cast<long>(timeoutMs % 1000) * 1000000L;
+        pts = &ts;
+    }
+    syscall(SYS_futex, word, FUTEX_WAIT, expected, pts, nullptr, 0);
+}
+
+void futexWakeAll(uint32_t* word)
+{
+    syscall(SYS_futex, word, FUTEX_WAKE, INT_MAX, nullptr, nullptr, 0);
+}
+
+/* Publish a new index value and wake the peer if it is sleeping on it. */
+void storeAndWake(AudioStreamIndex* idx, uint32_t value)
+{
+    __atomic_store_n(&idx->value, value, __ATOMIC_SEQ_CST);
+    if (__atomic_load_n(&idx->waiters, __ATOMIC_SEQ_CST) != 0) {
+        futexWakeAll(&idx->value);
+    }
+}
+
+/*
+ * Wait until ready(idx->value) holds, the stream closes or the timeout
+ * expires. Spins briefly before registering as a waiter and sleeping.
+ */
+template <typename Ready>
+bool waitFor(const AudioStreamHeader* hdr, AudioStreamIndex* idx,
+             int timeoutMs, Ready ready)
+{
+    for (int i = 0; i < kSpinCount; ++i) {
+        if (ready(loadAcquire(&idx->value))) {
+            return true;
+        }
+    }
+    if (timeoutMs == 0) {
+        return false;
+    }
+
+    const auto deadline = std::chrono::steady_clock::now()
+                          + std::chrono::milliseconds(timeoutMs < 0 ? 0 : timeoutMs);
+    for (;;) {
+        if (isClosed(hdr)) {
+            return ready(loadAcquire(&idx->value));
+        }
+
+        int sliceMs = -1;
+        if (timeoutMs > 0) {
+            auto left = std::chrono::duration_cast<std::chrono::milliseconds>(
+                deadline - std::chrono::steady_clock::now()).count();
+            if (left <= 0) {
+                return ready(loadAcquire(&idx->value));
+            }
+            sliceMs = static_cast<int>(left);
+        }
+
+        __atomic_fetch_add(&idx->waiters, 1u, __ATOMIC_SEQ_CST);
+        uint32_t seen = __atomic_load_n(&idx->value, __ATOMIC_SEQ_CST);
+        if (!ready(seen) && !isClosed(hdr)) {
+            futexWait(&idx->value, seen, sliceMs);
+        }
+        __atomic_fetch_sub(&idx->waiters, 1u, __ATOMIC_SEQ_CST);
+
+        if (ready(loadAcquire(&idx->value))) {
+            return true;
+        }
+    }
+}
+
+bool isPowerOfTwo(uint32_t v)
+{
+    return v != 0 && (v & (v - 1)) == 0;
+}
+
+uint8_t* slotsBase(AudioStreamHeader* hdr, const RingGeometry& geometry, Ring ring)
+{
+    auto* base = reinterpret_cast<uint8_t*>(hdr);
+    return base + (ring == Ring::Input ? geometry.inputSlotsOffset : geometry.outputSlotsOffset);
+}
+
+AudioStreamSlot* slotAt(uint8_t* slots, uint32_t blockCount, uint32_t slotStride, uint32_t index)
+{
+    const uint32_t i = index & (blockCount - 1u);
+    return reinterpret_cast<AudioStreamSlot*>(slots + static_cast<size_t>(i) * slotStride);
+}
+
+/* Read a peer-writable word exactly once (no re-load after a check) */
+uint32_t loadOnce(const uint32_t* p)
+{
+    return __atomic_load_n(p, __ATOMIC_RELAXED);
+}
+
+float* slotPcm(AudioStreamSlot* slot)
+{
+    return reinterpret_cast<float*>(reinterpret_cast<uint8_t*>(slot) + AUDIO_STREAM_SLOT_HDR_SIZE);
+}
+
+} // namespace
+
+/* ------------------------------------------------------------------ */
+/*  Region setup                                                        */
+/* ------------------------------------------------------------------ */
+size_t regionSize(const StreamConfig& cfg)
+{
+    if (cfg.channels == 0 || cfg.blockFrames == 0
+        || !isPowerOfTwo(cfg.blockCount) || cfg.blockCount > AUDIO_STREAM_MAX_BLOCKS) {
+        return 0;
+    }
+    const uint64_t stride = AUDIO_STREAM_SLOT_HDR_SIZE
+        + ((static_cast<uint64_t>(cfg.blockFrames) * cfg.channels * sizeof(float)
+            + AUDIO_STREAM_CACHE_LINE - 1) & ~static_cast<uint64_t>(AUDIO_STREAM_CACHE_LINE - 1));
+    const uint64_t total = AUDIO_STREAM_HEADER_SIZE + 2u * cfg.blockCount * stride;
+    return total > UINT32_MAX ? 0 : static_cast<size_t>(total);
+}
+
+bool initRegion(void* base, size_t size, const StreamConfig& cfg)
+{
+    const size_t need = regionSize(cfg);
+    if (!base || need == 0 || size < need) {
+        return false;
+    }
+
+    std::memset(base, 0, AUDIO_STREAM_HEADER_SIZE);
+    auto* hdr = static_cast<AudioStreamHeader*>(base);
+    hdr->magic             = AUDIO_STREAM_MAGIC;
+    hdr->version           = AUDIO_STREAM_VERSION;
+    hdr->sampleRate        = cfg.sampleRate;
+    hdr->channels          = cfg.channels;
+    hdr->blockFrames       = cfg.blockFrames;
+    hdr->blockCount        = cfg.blockCount;
+    hdr->format            = AUDIO_FORMAT_FLOAT32;
+    hdr->slotStride        = audioStreamSlotStride(cfg.blockFrames, cfg.channels);
+    hdr->inputSlotsOffset  = AUDIO_STREAM_HEADER_SIZE;
+    hdr->outputSlotsOffset = AUDIO_STREAM_HEADER_SIZE + cfg.blockCount * hdr->slotStride;
+    hdr->state             = AUDIO_STREAM_STATE_OPEN;
+    hdr->gain              = cfg.gain;
+    hdr->bypass            = cfg.bypass;
+
+    AudioControl::Values live;
+    live.gain   = cfg.gain;
+    live.bypass = cfg.bypass;
+    AudioControl::write(&hdr->control, live);
+    return true;
+}
+
+bool validateRegion(const void* base, size_t size, RingGeometry* geometry)
+{
+    if (!base || size < AUDIO_STREAM_HEADER_SIZE_V1) {
+        return false;
+    }
+    /* One private copy: the peer may rewrite the line while we check it */
+    const auto* hdr = static_cast<const AudioStreamHeader*>(base);
+    RingGeometry g;
+    g.version           = loadOnce(&hdr->version);
+    g.sampleRate        = loadOnce(&hdr->sampleRate);
+    g.channels          = loadOnce(&hdr->channels);
+    g.blockFrames       = loadOnce(&hdr->blockFrames);
+    g.blockCount        = loadOnce(&hdr->blockCount);
+    g.slotStride        = loadOnce(&hdr->slotStride);
+    g.inputSlotsOffset  = loadOnce(&hdr->inputSlotsOffset);
+    g.outputSlotsOffset = loadOnce(&hdr->outputSlotsOffset);
+    if (loadOnce(&hdr->magic) != AUDIO_STREAM_MAGIC || loadOnce(&hdr->format) != AUDIO_FORMAT_FLOAT32
+        || (g.version != 1u && g.version != AUDIO_STREAM_VERSION)) {
+        return false;
+    }
+    /* Version 1 has no control line: its slots start right after outRead */
+    const uint32_t headerSize = g.version == 1u ? AUDIO_STREAM_HEADER_SIZE_V1
+                                                : AUDIO_STREAM_HEADER_SIZE;
+
+    StreamConfig cfg { g.sampleRate, g.channels, g.blockFrames, g.blockCount, 1.0f, 0 };
+    const size_t need = regionSize(cfg);
+    if (need == 0
+        || need - (AUDIO_STREAM_HEADER_SIZE - headerSize) > size
+        || g.slotStride != audioStreamSlotStride(cfg.blockFrames, cfg.channels)
+        || g.inputSlotsOffset != headerSize
+        || g.outputSlotsOffset != headerSize + cfg.blockCount * g.slotStride) {
+        return false;
+    }
+    if (geometry) {
+        *geometry = g;
+    }
+    return true;
+}
+
+void closeRegion(AudioStreamHeader* hdr)
+{
+    __atomic_store_n(&hdr->state, AUDIO_STREAM_STATE_CLOSED, __ATOMIC_SEQ_CST);
+    futexWakeAll(&hdr->inWrite.value);
+    futexWakeAll(&hdr->inRead.value);
+    futexWakeAll(&hdr->outWrite.value);
+    futexWakeAll(&hdr->outRead.value);
+}
+
+bool isClosed(const AudioStreamHeader* hdr)
+{
+    return loadAcquire(&hdr->state) == AUDIO_STREAM_STATE_CLOSED;
+}
+
+/* ------------------------------------------------------------------ */
+/*  BlockProducer                                                       */
+/* ------------------------------------------------------------------ */
+BlockProducer::BlockProducer(AudioStreamHeader* hdr, const RingGeometry& geometry, Ring ring)
+    : hdr_(hdr),
+      write_(ring == Ring::Input ? &hdr->inWrite : &hdr->outWrite),
+      read_(ring == Ring::Input ? &hdr->inRead : &hdr->outRead),
+      slots_(slotsBase(hdr, geometry, ring)),
+      blockCount_(geometry.blockCount),
+      slotStride_(geometry.slotStride),
+      blockFrames_(geometry.blockFrames),
+      pos_(loadAcquire(&write_->value))
+{
+}
+
+float* BlockProducer::acquire(int timeoutMs)
+{
+    if (isClosed(hdr_)) {
+        return nullptr;
+    }
+    const uint32_t pos = pos_;
+    const uint32_t count = blockCount_;
+    bool ok = waitFor(hdr_, read_, timeoutMs,
+                      [pos, count](uint32_t r) { return pos - r < count; });
+    if (!ok || isClosed(hdr_)) {
+        return nullptr;
+    }
+    return slotPcm(slotAt(slots_, blockCount_, slotStride_, pos_));
+}
+
+void BlockProducer::publish(uint32_t frames, uint32_t flags)
+{
+    AudioStreamSlot* slot = slotAt(slots_, blockCount_, slotStride_, pos_);
+    slot->frames   = frames < blockFrames_ ? frames : blockFrames_;
+    slot->flags    = flags;
+    slot->sequence = pos_;
+    ++pos_;
+    storeAndWake(write_, pos_);
+}
+
+/* ------------------------------------------------------------------ */
+/*  BlockConsumer                                                       */
+/* ------------------------------------------------------------------ */
+BlockConsumer::BlockConsumer(AudioStreamHeader* hdr, const RingGeometry& geometry, Ring ring)
+    : hdr_(hdr),
+      write_(ring == Ring::Input ? &hdr->inWrite : &hdr->outWrite),
+      read_(ring == Ring::Input ? &hdr->inRead : &hdr->outRead),
+      slots_(slotsBase(hdr, geometry, ring)),
+      blockCount_(geometry.blockCount),
+      slotStride_(geometry.slotStride),
+      blockFrames_(geometry.blockFrames),
+      pos_(loadAcquire(&read_->value))
+{
+}
+
+const float* BlockConsumer::acquire(int timeoutMs, uint32_t* frames, uint32_t* flags)
+{
+    const uint32_t pos = pos_;
+    bool ok = waitFor(hdr_, write_, timeoutMs,
+                      [pos](uint32_t w) { return w != pos; });
+    if (!ok) {
+        return nullptr;
+    }
+
+    AudioStreamSlot* slot = slotAt(slots_, blockCount_, slotStride_, pos_);
+    if (frames) {
+        const uint32_t claimed = loadOnce(&slot->frames);
+        *frames = claimed < blockFrames_ ? claimed : blockFrames_;
+    }
+    if (flags) {
+        *flags = loadOnce(&slot->flags);
+    }
+    return slotPcm(slot);
+}
+
+void BlockConsumer::release()
+{
+    ++pos_;
+    storeAndWake(read_, pos_);
+}
+
+} // namespace AudioStream
@@ -0,0 +1,135 @@
+/**
+ * AudioStreamRing.h — SPSC block rings over an AudioStreamBuffer region
+ *
+ * Shared by HostApp (input producer / output consumer) and DspService
+ * (input consumer / output producer). All calls are lock-free on the fast
+ * path; a side that has to wait sleeps on the opposite index with a
+ * process-shared futex and is woken by the peer's publish / release.
+ *
+ * The configuration line lives in memory the peer can write at any time,
+ * so it is read exactly once: validateRegion() checks a private copy and
+ * hands it out as a RingGeometry, and producers / consumers index slots
+ * through that copy only. A peer rewriting blockCount, slotStride or
+ * blockFrames after the open cannot move an access outside the region.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "AudioStreamBuffer.h"
+
+namespace AudioStream {
+
+/** Which of the two rings in the region a producer / consumer works on */
+enum class Ring {
+    Input,   /* host → DSP */
+    Output,  /* DSP  → host */
+};
+
+/** Geometry of a stream region */
+struct StreamConfig {
+    uint32_t sampleRate;
+    uint32_t channels;
+    uint32_t blockFrames;
+    uint32_t blockCount;   /* power of two, ≤ AUDIO_STREAM_MAX_BLOCKS */
+    float    gain;
+    uint32_t bypass;
+};
+
+/** Validated copy of a region's configuration line */
+struct RingGeometry {
+    uint32_t version           = 0;
+    uint32_t sampleRate        = 0;
+    uint32_t channels          = 0;
+    uint32_t blockFrames       = 0;
+    uint32_t blockCount        = 0;
+    uint32_t slotStride        = 0;
+    uint32_t inputSlotsOffset  = 0;
+    uint32_t outputSlotsOffset = 0;
+};
+
+/** Region size required for cfg (0 if cfg is invalid). */
+size_t regionSize(const StreamConfig& cfg);
+
+/**
+ * Lay out a fresh stream header at base. Called once by the host.
+ * @return false if cfg is invalid or size is too small
+ */
+bool initRegion(void* base, size_t size, const StreamConfig& cfg);
+
+/**
+ * Check magic, version, geometry and that all slots fit in size.
+ * The configuration line is copied once and only the copy is checked.
+ * @param geometry  receives the checked copy (may be nullptr)
+ */
+bool validateRegion(const void* base, size_t size, RingGeometry* geometry = nullptr);
+
+/** Mark the stream closed and wake every sleeper on both rings. */
+void closeRegion(AudioStreamHeader* hdr);
+
+/** True once closeRegion() has been called by either side. */
+bool isClosed(const AudioStreamHeader* hdr);
+
+/** Writer side of one ring. */
+class BlockProducer {
+public:
+    BlockProducer() = default;
+    /** @param geometry  as returned by validateRegion() for hdr's region */
+    BlockProducer(AudioStreamHeader* hdr, const RingGeometry& geometry, Ring ring);
+
+    /**
+     * Wait for a free slot.
+     * @param timeoutMs  0 = poll, < 0 = wait until space or close
+     * @return PCM area of the slot (geometry blockFrames × channels floats), or
+     *         nullptr on timeout / close
+     */
+    float* acquire(int timeoutMs);
+
+    /** Publish the slot returned by acquire() to the consumer. */
+    void publish(uint32_t frames, uint32_t flags = 0);
+
+private:
+    AudioStreamHeader* hdr_         = nullptr;
+    AudioStreamIndex*  write_       = nullptr;
+    AudioStreamIndex*  read_        = nullptr;
+    uint8_t*           slots_       = nullptr;
+    uint32_t           blockCount_  = 0;
+    uint32_t           slotStride_  = 0;
+    uint32_t           blockFrames_ = 0;
+    uint32_t           pos_         = 0;   /* local copy of write_->value */
+};
+
+/** Reader side of one ring. */
+class BlockConsumer {
+public:
+    BlockConsumer() = default;
+    /** @param geometry  as returned by validateRegion() for hdr's region */
+    BlockConsumer(AudioStreamHeader* hdr, const RingGeometry& geometry, Ring ring);
+
+    /**
+     * Wait for a published block.
+     * @param timeoutMs  0 = poll, < 0 = wait until data or close
+     * @param frames     receives the number of valid frames (at most the
+     *                   geometry's blockFrames, whatever the slot claims)
+     * @param flags      receives AUDIO_STREAM_BLOCK_* flags (may be nullptr)
+     * @return PCM area of the block, or nullptr on timeout / close-and-drained
+     */
+    const float* acquire(int timeoutMs, uint32_t* frames, uint32_t* flags);
+
+    /** Hand the block returned by acquire() back to the producer. */
+    void release();
+
+private:
+    AudioStreamHeader* hdr_         = nullptr;
+    AudioStreamIndex*  write_       = nullptr;
+    AudioStreamIndex*  read_        = nullptr;
+    uint8_t*           slots_       = nullptr;
+    uint32_t           blockCount_  = 0;
+    uint32_t           slotStride_  = 0;
+    uint32_t           blockFrames_ = 0;
+    uint32_t           pos_         = 0;   /* local copy of read_->value */
+};
+
+} // namespace AudioStream
@@ -0,0 +1,311 @@
+/**
+ * AudioTrace.cpp — cross-process request tracing
+ */
+
+#include "AudioTrace.h"
+
+#if AUDIO_TRACING
+
+#include <atomic>
+#include <cinttypes>
+#include <cstdio>
+#include <vector>
+
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace AudioTrace {
+
+namespace {
+
+/*
+ * One ring slot. The writer that claimed ticket t marks the slot odd
+ * (2t + 1), stores the fields, then publishes it even (2t + 2); a reader
+ * keeps a slot only if it saw the same even sequence before and after
+ * copying it, so a slot being overwritten is skipped, never torn.
+ */
+struct Slot {
+    uint64_t    sequence;
+    const char* name;
+    uint64_t    requestId;
+    uint32_t    pid;
+    uint32_t    tid;
+    int64_t     beginNs;
+    int64_t     endNs;
+};
+
+struct Event {
+    const char* name;
+    uint64_t    requestId;
+    uint32_t    pid;
+    uint32_t    tid;
+    int64_t     beginNs;
+    int64_t     endNs;
+};
+
+std::atomic<bool>        g_enabled { false };
+std::atomic<uint64_t>    g_nextTicket { 0 };
+std::atomic<uint64_t>    g_firstTicket { 0 };   /* raised by clear()   */
+std::atomic<const char*> g_processName { nullptr };
+Slot                     g_slots[kMaxEvents];
+
+template <typename T>
+void storeRelaxed(T* p, T v)
+{
+    __atomic_store(p, &v, __ATOMIC_RELAXED);
+}
+
+template <typename T>
+T loadRelaxed(const T* p)
+{
+    T v;
+    __atomic_load(p, &v, __ATOMIC_RELAXED);
+    return v;
+}
+
+uint32_t currentPid()
+{
+    static const uint32_t pid = static_cast<uint32_t>(getpid());
+    return pid;
+}
+
+uint32_t currentTid()
+{
+    static thread_local const uint32_t tid = static_cast<uint32_t>(syscall(SYS_gettid));
+    return tid;
+}
+
+void push(const char* name, uint64_t requestId, uint32_t pid, uint32_t tid,
+          int64_t beginNs, int64_t endNs)
+{
+    const uint64_t ticket = g_nextTicket.fetch_add(1, std::memory_order_relaxed);
+    Slot& s = g_slots[ticket % kMaxEvents];
+
+    __atomic_store_n(&s.sequence, 2 * ticket + 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    storeRelaxed(&s.name, name);
+    storeRelaxed(&s.requestId, requestId);
+    storeRelaxed(&s.pid, pid);
+    storeRelaxed(&s.tid, tid);
+    storeRelaxed(&s.beginNs, beginNs);
+    storeRelaxed(&s.endNs, endNs);
+    __atomic_store_n(&s.sequence, 2 * ticket + 2, __ATOMIC_RELEASE);
+}
+
+/* A span only when both ends were stamped and in order */
+void pushSpan(const char* name, uint64_t requestId, uint32_t pid, uint32_t tid,
+              int64_t beginNs, int64_t endNs)
+{
+    if (beginNs > 0 && endNs >= beginNs) {
+        push(name, requestId, pid, tid, beginNs, endNs);
+    }
+}
+
+int64_t span(int64_t beginNs, int64_t endNs)
+{
+    return beginNs > 0 && endNs >= beginNs ? endNs - beginNs : -1;
+}
+
+void pushServiceSpans(const AudioTraceBlock& b)
+{
+    const uint64_t id = b.serviceRequestId;
+    pushSpan("handle",     id, b.servicePid, b.serviceTid, b.receiveNs,   b.replyNs);
+    pushSpan("map",        id, b.servicePid, b.serviceTid, b.receiveNs,   b.mapDoneNs);
+    pushSpan("setup",      id, b.servicePid, b.serviceTid, b.mapDoneNs,   b.dspStartNs);
+    pushSpan("dsp",        id, b.servicePid, b.serviceTid, b.dspStartNs,  b.dspEndNs);
+    pushSpan("write-back", id, b.servicePid, b.serviceTid, b.dspEndNs,    b.writeBackNs);
+    pushSpan("finish",     id, b.servicePid, b.serviceTid, b.writeBackNs, b.replyNs);
+}
+
+/* Snapshot of every published slot, oldest first */
+std::vector<Event> snapshot()
+{
+    std::vector<Event> events;
+    const uint64_t end = g_nextTicket.load(std::memory_order_acquire);
+    uint64_t begin = g_firstTicket.load(std::memory_order_relaxed);
+    if (end - begin > kMaxEvents) {
+        begin = end - kMaxEvents;
+    }
+    events.reserve(static_cast<size_t>(end - begin));
+
+    for (uint64_t ticket = begin; ticket < end; ++ticket) {
+        const Slot& s = g_slots[ticket % kMaxEvents];
+        const uint64_t want = 2 * ticket + 2;
+        if (__atomic_load_n(&s.sequence, __ATOMIC_ACQUIRE) != want) {
+            continue;   /* still being written, or already overwritten */
+        }
+        Event e;
+        e.name      = loadRelaxed(&s.name);
+        e.requestId = loadRelaxed(&s.requestId);
+        e.pid       = loadRelaxed(&s.pid);
+        e.tid       = loadRelaxed(&s.tid);
+        e.beginNs   = loadRelaxed(&s.beginNs);
+        e.endNs     = loadRelaxed(&s.endNs);
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+        if (__atomic_load_n(&s.sequence, __ATOMIC_RELAXED) == want) {
+            events.push_back(e);
+        }
+    }
+    return events;
+}
+
+} // namespace
+
+bool enabled()
+{
+    return g_enabled.load(std::memory_order_relaxed);
+}
+
+void setEnabled(bool on)
+{
+    g_enabled.store(on, std::memory_order_relaxed);
+}
+
+void setProcessName(const char* name)
+{
+    g_processName.store(name, std::memory_order_relaxed);
+}
+
+void beginHostTrace(AudioTraceBlock* block, uint64_t requestId)
+{
+    if (!block) {
+        return;
+    }
+    block->requestId   = requestId;
+    block->hostPid     = currentPid();
+    block->hostTid     = currentTid();
+    block->hostReplyNs = 0;
+    block->hostSendNs  = nowNs();
+}
+
+void endHostTrace(AudioTraceBlock* block)
+{
+    if (block) {
+        block->hostReplyNs = nowNs();
+    }
+}
+
+void publishServiceTrace(AudioTraceBlock* block, const ServiceStamps& stamps)
+{
+    if (!block) {
+        return;
+    }
+    const int64_t replyNs = stamps.replyNs != 0 ? stamps.replyNs : nowNs();
+    block->servicePid  = currentPid();
+    block->serviceTid  = currentTid();
+    block->receiveNs   = stamps.receiveNs;
+    block->mapDoneNs   = stamps.mapDoneNs;
+    block->dspStartNs  = stamps.dspStartNs;
+    block->dspEndNs    = stamps.dspEndNs;
+    block->writeBackNs = stamps.writeBackNs;
+    block->replyNs     = replyNs;
+    /* The echoed id last: a host that sees its own id sees these stamps */
+    __atomic_store_n(&block->serviceRequestId, block->requestId, __ATOMIC_RELEASE);
+
+    if (enabled()) {
+        AudioTraceBlock copy = *block;
+        pushServiceSpans(copy);
+    }
+}
+
+Breakdown breakdown(const AudioTraceBlock& b)
+{
+    Breakdown d;
+    d.totalNs  = span(b.hostSendNs, b.hostReplyNs);
+    d.complete = b.requestId != 0 && b.serviceRequestId == b.requestId;
+    if (!d.complete) {
+        return d;
+    }
+    d.sendNs      = span(b.hostSendNs, b.receiveNs);
+    d.mapNs       = span(b.receiveNs, b.mapDoneNs);
+    d.setupNs     = span(b.mapDoneNs, b.dspStartNs);
+    d.dspNs       = span(b.dspStartNs, b.dspEndNs);
+    d.writeBackNs = span(b.dspEndNs, b.writeBackNs);
+    d.finishNs    = span(b.writeBackNs, b.replyNs);
+    d.replyNs     = span(b.replyNs, b.hostReplyNs);
+    return d;
+}
+
+void record(const char* name, uint64_t requestId, int64_t beginNs, int64_t endNs)
+{
+    if (enabled()) {
+        pushSpan(name, requestId, currentPid(), currentTid(), beginNs, endNs);
+    }
+}
+
+void recordRequest(const AudioTraceBlock& b)
+{
+    if (!enabled()) {
+        return;
+    }
+    const uint64_t id = b.requestId;
+    pushSpan("request", id, b.hostPid, b.hostTid, b.hostSendNs, b.hostReplyNs);
+    if (b.serviceRequestId != id) {
+        return;   /* the service never stamped this request */
+    }
+    pushSpan("ipc-send",  id, b.hostPid, b.hostTid, b.hostSendNs, b.receiveNs);
+    pushSpan("ipc-reply", id, b.hostPid, b.hostTid, b.replyNs,    b.hostReplyNs);
+    pushServiceSpans(b);
+}
+
+size_t eventCount()
+{
+    const uint64_t n = g_nextTicket.load(std::memory_order_relaxed)
+                     - g_firstTicket.load(std::memory_order_relaxed);
+    return static_cast<size_t>(n < kMaxEvents ? n : kMaxEvents);
+}
+
+void clear()
+{
+    /* Tickets only grow: hide everything issued so far from snapshot() */
+    g_firstTicket.store(g_nextTicket.load(std::memory_order_relaxed), std::memory_order_relaxed);
+}
+
+std::string chromeTraceJson()
+{
+    const std::vector<Event> events = snapshot();
+    std::string out = "{\"traceEvents\":[\n";
+    char line[256];
+
+    const char* processName = g_processName.load(std::memory_order_relaxed);
+    bool first = true;
+    if (processName) {
+        std::snprintf(line, sizeof(line),
+                      "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":%" PRIu32
+                      ",\"args\":{\"name\":\"%s\"}}",
+                      currentPid(), processName);
+        out += line;
+        first = false;
+    }
+
+    /* Chrome wants microseconds; keep the nanoseconds as decimals */
+    for (const Event& e : events) {
+        std::snprintf(line, sizeof(line),
+                      "%s{\"name\":\"%s\",\"cat\":\"audio\",\"ph\":\"X\",\"pid\":%" PRIu32
+                      ",\"tid\":%" PRIu32 ",\"ts\":%" PRId64 ".%03d,\"dur\":%" PRId64
+                      ".%03d,\"args\":{\"requestId\":%" PRIu64 "}}",
+                      first ? "" : ",\n", e.name, e.pid, e.tid,
+                      e.beginNs / 1000, static_cast<int>(e.beginNs % 1000),
+                      (e.endNs - e.beginNs) / 1000, static_cast<int>((e.endNs - e.beginNs) % 1000),
+                      e.requestId);
+        out += line;
+        first = false;
+    }
+    out += "\n],\"displayTimeUnit\":\"ns\"}\n";
+    return out;
+}
+
+bool writeChromeTrace(const std::string& path)
+{
+    FILE* f = std::fopen(path.c_str(), "w");
+    if (!f) {
+        return false;
+    }
+    const std::string json = chromeTraceJson();
+    const bool ok = std::fwrite(json.data(), 1, json.size(), f) == json.size();
+    return std::fclose(f) == 0 && ok;
+}
+
+} // namespace AudioTrace
+
+#endif // AUDIO_TRACING
@@ -0,0 +1,164 @@
+/**
+ * AudioTrace.h — cross-process request tracing
+ *
+ * A traced request (AUDIO_FLAG_TRACE) carries an AudioTraceBlock in its
+ * shared header. The host stamps its line around the IPC call, the service
+ * stamps its line once, just before it replies:
+ *
+ *   host      beginHostTrace()    requestId, pid / tid, hostSendNs
+ *   service   publishServiceTrace()  receive → mapDone → dspStart → dspEnd
+ *                                    → writeBack → reply
+ *   host      endHostTrace()      hostReplyNs
+ *
+ * Every stamp is CLOCK_MONOTONIC, which all processes on the device share,
+ * so the completed block is one request's cross-process timeline.
+ *
+ * Each process can also keep a native event buffer: with setEnabled(true),
+ * recordRequest() / publishServiceTrace() append the phases as events to a
+ * fixed, lock-free ring, and chromeTraceJson() dumps it in Chrome trace
+ * event format (chrome://tracing, Perfetto). The host's recordRequest()
+ * already holds both sides of a request; the service's own events cover
+ * hosts that only read the block (e.g. from ArkTS).
+ *
+ * Building with AUDIO_TRACING=0 (CMake: -DAUDIO_ENABLE_TRACING=OFF) turns
+ * every function here into an inline no-op and enabled() into a constant
+ * false, so the hooks in the processing paths compile away entirely.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include <time.h>
+
+#include "AudioSharedBuffer.h"
+
+#ifndef AUDIO_TRACING
+#define AUDIO_TRACING 1
+#endif
+
+namespace AudioTrace {
+
+/** Native ring capacity in events; the oldest are overwritten */
+constexpr size_t kMaxEvents = 16384;
+
+/** CLOCK_MONOTONIC in nanoseconds — the clock of every trace stamp. */
+inline int64_t nowNs()
+{
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<int64_t>(ts.tv_sec) * 1000000000LL + ts.tv_nsec;
+}
+
+/** Service-side stamps of one request; 0 = not taken */
+struct ServiceStamps {
+    int64_t receiveNs   = 0;
+    int64_t mapDoneNs   = 0;
+    int64_t dspStartNs  = 0;
+    int64_t dspEndNs    = 0;
+    int64_t writeBackNs = 0;
+    int64_t replyNs     = 0;   /* 0 = stamped by publishServiceTrace() */
+};
+
+/** Phase durations of a completed block, in nanoseconds; -1 = missing */
+struct Breakdown {
+    int64_t totalNs     = -1;  /* hostSend → hostReply                   */
+    int64_t sendNs      = -1;  /* hostSend → receive (IPC request leg)   */
+    int64_t mapNs       = -1;  /* receive → mapDone                      */
+    int64_t setupNs     = -1;  /* mapDone → dspStart (header, chain)     */
+    int64_t dspNs       = -1;  /* dspStart → dspEnd                      */
+    int64_t writeBackNs = -1;  /* dspEnd → writeBack                     */
+    int64_t finishNs    = -1;  /* writeBack → reply                      */
+    int64_t replyNs     = -1;  /* reply → hostReply (IPC reply leg)      */
+    bool    complete    = false;   /* service line belongs to requestId  */
+};
+
+#if AUDIO_TRACING
+
+/** Native event recording switch (the header stamps do not depend on it). */
+bool enabled();
+void setEnabled(bool on);
+
+/** Label this process's events in the dump ("HostApp", "DspService"). */
+void setProcessName(const char* name);
+
+/**
+ * Start the host line: requestId, pid / tid and hostSendNs = now.
+ * Call right before the request is sent. @p block may be null.
+ */
+void beginHostTrace(AudioTraceBlock* block, uint64_t requestId);
+
+/** Stamp hostReplyNs = now (the reply arrived). @p block may be null. */
+void endHostTrace(AudioTraceBlock* block);
+
+/**
+ * Write the whole service line: the requestId found in the host line,
+ * pid / tid and @p stamps (replyNs = now when 0), with the timestamps
+ * stored before the echoed id. Records the service phases when enabled().
+ * @p block may be null.
+ */
+void publishServiceTrace(AudioTraceBlock* block, const ServiceStamps& stamps);
+
+/** Phase durations of @p block (a snapshot taken after the reply). */
+Breakdown breakdown(const AudioTraceBlock& block);
+
+/**
+ * Record one span. @p name must outlive the buffer (a string literal).
+ * No-op unless enabled().
+ */
+void record(const char* name, uint64_t requestId, int64_t beginNs, int64_t endNs);
+
+/**
+ * Record every phase of a completed block: the host spans on the host
+ * pid / tid, the service spans on the service pid / tid. No-op unless
+ * enabled().
+ */
+void recordRequest(const AudioTraceBlock& block);
+
+/** Events currently held (≤ kMaxEvents). */
+size_t eventCount();
+
+/** Drop all recorded events. */
+void clear();
+
+/** The buffer as a Chrome trace JSON object ({"traceEvents": [...]}). */
+std::string chromeTraceJson();
+
+/** chromeTraceJson() into @p path. @return false on an I/O error */
+bool writeChromeTrace(const std::string& path);
+
+#else
+
+inline bool enabled() { return false; }
+inline void setEnabled(bool) {}
+inline void setProcessName(const char*) {}
+inline void beginHostTrace(AudioTraceBlock*, uint64_t) {}
+inline void endHostTrace(AudioTraceBlock*) {}
+inline void publishServiceTrace(AudioTraceBlock*, const ServiceStamps&) {}
+inline Breakdown breakdown(const AudioTraceBlock&) { return Breakdown(); }
+inline void record(const char*, uint64_t, int64_t, int64_t) {}
+inline void recordRequest(const AudioTraceBlock&) {}
+inline size_t eventCount() { return 0; }
+inline void clear() {}
+inline std::string chromeTraceJson() { return "{\"traceEvents\":[]}\n"; }
+inline bool writeChromeTrace(const std::string&) { return false; }
+
+#endif
+
+/**
+ * Trace block of a mapped region, or null when the request is untraced or
+ * tracing is compiled out. See audioShmTrace().
+ */
+inline AudioTraceBlock* traceBlock(void* base, uint32_t headerSize, uint32_t flags, uint64_t mappedSize)
+{
+#if AUDIO_TRACING
+    return audioShmTrace(base, headerSize, flags, mappedSize);
+#else
+    (void)base; (void)headerSize; (void)flags; (void)mappedSize;
+    return nullptr;
+#endif
+}
+
+} // namespace AudioTrace
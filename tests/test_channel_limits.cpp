@@ -0,0 +1,188 @@
+/**
+ * test_channel_limits.cpp — host-controlled channel counts at every entry
+ *
+ * An integer-format request with a chain gathers frames into a fixed
+ * 256 × ProcessingChain::kMaxChannels float block, so a chain must refuse
+ * more channels even when it has no stages. Sends S16 with 16 channels and
+ * an empty chain through a one-shot region, a session and a batch job, and
+ * expects each to be refused without touching the output (build with
+ * -fsanitize=address to see the overflow this guards against).
+ */
+
+#include "audio_native.h"
+#include "dsp_batch.h"
+#include "dsp_chain.h"
+#include "dsp_session.h"
+#include "dsp_shared_memory.h"
+#include "shared_memory.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+using namespace DspProcessor;
+
+namespace {
+
+constexpr uint32_t kRate   = 48000;
+constexpr uint32_t kFrames = 512;
+
+int g_failures = 0;
+
+void expect(bool ok, const char* what)
+{
+    std::printf("  %-52s %s\n", what, ok ? "ok" : "FAILED");
+    g_failures += ok ? 0 : 1;
+}
+
+AudioChainDescriptor emptyChain()
+{
+    AudioChainDescriptor desc;
+    std::memset(&desc, 0, sizeof(desc));
+    desc.magic = AUDIO_CHAIN_MAGIC;
+    return desc;
+}
+
+/* v2 S16 request of @p channels with an empty chain descriptor */
+std::vector<uint8_t> chainRegion(uint32_t channels)
+{
+    const AudioShmLayout layout = audioShmLayout(kFrames, channels, AUDIO_FORMAT_S16, 1,
+                                                 AUDIO_SHM_PCM_ALIGN);
+    std::vector<uint8_t> region(layout.totalSize, 0);
+    const std::vector<uint8_t> header = HostAudio::buildFormatHeader(
+        kRate, static_cast<int>(channels), kFrames, 1.0f, 0, AUDIO_FORMAT_S16, 0);
+    std::memcpy(region.data(), header.data(), header.size());
+
+    AudioSharedHeader hdr;
+    std::memcpy(&hdr, region.data(), sizeof(hdr));
+    hdr.chainOffset  = layout.chainOffset;
+    hdr.inputOffset  = layout.inputOffset;
+    hdr.outputOffset = layout.outputOffset;
+    std::memcpy(region.data(), &hdr, sizeof(hdr));
+
+    const AudioChainDescriptor desc = emptyChain();
+    std::memcpy(region.data() + layout.chainOffset, &desc, sizeof(desc));
+    /* Full-scale input, so a processed output could not stay zero */
+    std::memset(region.data() + layout.inputOffset, 0x7f,
+                static_cast<size_t>(kFrames) * channels * sizeof(int16_t));
+    return region;
+}
+
+bool outputUntouched(const std::vector<uint8_t>& region)
+{
+    AudioSharedHeader hdr;
+    std::memcpy(&hdr, region.data(), sizeof(hdr));
+    const size_t bytes = static_cast<size_t>(kFrames) * hdr.channels * sizeof(int16_t);
+    for (size_t i = 0; i < bytes; ++i) {
+        if (region[hdr.outputOffset + i] != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void testChain()
+{
+    const AudioChainDescriptor desc = emptyChain();
+    expect(ProcessingChain::validate(desc, kRate, ProcessingChain::kMaxChannels),
+           "validate: empty chain, kMaxChannels");
+    expect(!ProcessingChain::validate(desc, kRate, 16), "validate: empty chain, 16 channels");
+    expect(!ProcessingChain::validate(desc, kRate, 0), "validate: empty chain, 0 channels");
+    ProcessingChain chain;
+    expect(!chain.configure(desc, kRate, 16), "configure: empty chain, 16 channels");
+}
+
+void testOneShot()
+{
+    std::vector<uint8_t> ok = chainRegion(2);
+    expect(processMappedRegion(ok.data(), ok.size()).status == AUDIO_STATUS_DONE,
+           "one-shot: empty chain, 2 channels processed");
+
+    std::vector<uint8_t> region = chainRegion(16);
+    const SharedProcessResult r = processMappedRegion(region.data(), region.size());
+    expect(r.status == AUDIO_STATUS_ERROR && outputUntouched(region),
+           "one-shot: empty chain, 16 channels refused");
+}
+
+void testSession()
+{
+    const std::vector<uint8_t> region = chainRegion(16);
+    /* Sealed like any host region, so only the channel count can refuse it */
+    const int fd = HostAudio::createSharedMemory("test_channel_limits", region.size());
+    if (fd < 0 || !HostAudio::writeSharedMemory(fd, 0, region.data(), region.size())) {
+        expect(false, "session: memfd");
+        return;
+    }
+    std::vector<uint8_t> ok = chainRegion(2);
+    const int okFd = HostAudio::createSharedMemory("test_channel_limits", ok.size());
+    const int32_t okId = HostAudio::writeSharedMemory(okFd, 0, ok.data(), ok.size())
+        ? openSession(okFd, ok.size()) : -1;
+    expect(okId >= 0, "session: empty chain, 2 channels opened");
+    if (okId >= 0) {
+        closeSession(okId);
+    }
+    HostAudio::closeSharedMemory(okFd);
+
+    const int32_t id = openSession(fd, region.size());
+    expect(id < 0, "session: empty chain, 16 channels refused at open");
+    if (id >= 0) {
+        closeSession(id);
+    }
+    HostAudio::closeSharedMemory(fd);
+}
+
+void testBatch()
+{
+    constexpr uint32_t kChannels = 16;
+    const uint32_t dataOffset = audioBatchDataOffset(1);
+    const uint32_t pcmBytes = kFrames * kChannels * sizeof(int16_t);
+    const uint32_t chainOffset = dataOffset;
+    const uint32_t inputOffset = dataOffset + 4096;
+    const uint32_t outputOffset = inputOffset + pcmBytes;
+    std::vector<uint8_t> region(outputOffset + pcmBytes, 0);
+
+    AudioBatchHeader hdr;
+    std::memset(&hdr, 0, sizeof(hdr));
+    hdr.magic    = AUDIO_BATCH_MAGIC;
+    hdr.version  = AUDIO_BATCH_VERSION;
+    hdr.jobCount = 1;
+    std::memcpy(region.data(), &hdr, sizeof(hdr));
+
+    AudioBatchJob job;
+    std::memset(&job, 0, sizeof(job));
+    job.inputOffset  = inputOffset;
+    job.outputOffset = outputOffset;
+    job.frames       = kFrames;
+    job.channels     = kChannels;
+    job.sampleRate   = kRate;
+    job.format       = AUDIO_FORMAT_S16;
+    job.gain         = 1.0f;
+    job.chainOffset  = chainOffset;
+    std::memcpy(region.data() + AUDIO_BATCH_HEADER_SIZE, &job, sizeof(job));
+
+    const AudioChainDescriptor desc = emptyChain();
+    std::memcpy(region.data() + chainOffset, &desc, sizeof(desc));
+    std::memset(region.data() + inputOffset, 0x7f, pcmBytes);
+
+    const BatchProcessResult r = processBatchRegion(region.data(), region.size());
+    AudioBatchJob after;
+    std::memcpy(&after, region.data() + AUDIO_BATCH_HEADER_SIZE, sizeof(after));
+    bool untouched = true;
+    for (uint32_t i = 0; i < pcmBytes; ++i) {
+        untouched = untouched && region[outputOffset + i] == 0;
+    }
+    expect(r.jobsFailed == 1 && after.status == AUDIO_STATUS_ERROR && untouched,
+           "batch: empty chain, 16 channels refused");
+}
+
+} // namespace
+
+int main()
+{
+    testChain();
+    testOneShot();
+    testSession();
+    testBatch();
+    return g_failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
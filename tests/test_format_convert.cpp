@@ -0,0 +1,293 @@
+/**
+ * test_format_convert.cpp — PCM converters of shared/AudioFormatConvert
+ *
+ * Checks the documented behaviour of every conversion, at lengths that
+ * exercise both the SIMD body and the scalar tail:
+ *   - S16 / S24 packed → float scale by 2^-(bits-1), and every integer
+ *     code survives int → float → int unchanged;
+ *   - float → int rounds to nearest (ties to even), clamps at ±full scale
+ *     (+1.0 → max code, -1.0 → min code), and encodes NaN as the minimum;
+ *   - TPDF dither moves a code by at most 1 LSB from the undithered one,
+ *     with the triangular distribution's share of ±1 steps, and depends on
+ *     the stream position handed to processFrames();
+ *   - a FLOAT32_PLANAR view processes exactly like the interleaved one,
+ *     with and without a chain.
+ */
+
+#include "AudioFormatConvert.h"
+#include "dsp_chain.h"
+#include "dsp_processor.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <random>
+#include <vector>
+
+using namespace AudioFormat;
+
+namespace {
+
+int g_failures = 0;
+
+void expect(bool ok, const char* what)
+{
+    std::printf("  %-60s %s\n", what, ok ? "ok" : "FAILED");
+    g_failures += ok ? 0 : 1;
+}
+
+struct IntFormat {
+    const char* name;
+    uint32_t    format;
+    int32_t     minCode;
+    int32_t     maxCode;
+    float       scale;
+};
+
+const IntFormat kFormats[] = {
+    { "s16", AUDIO_FORMAT_S16,        -32768,   32767,   32768.0f   },
+    { "s24", AUDIO_FORMAT_S24_PACKED, -8388608, 8388607, 8388608.0f },
+};
+
+int32_t codeAt(const IntFormat& f, const std::vector<uint8_t>& bytes, size_t i)
+{
+    if (f.format == AUDIO_FORMAT_S16) {
+        int16_t v;
+        std::memcpy(&v, bytes.data() + i * 2, sizeof(v));
+        return v;
+    }
+    const uint8_t* p = bytes.data() + i * 3;
+    const int32_t v = p[0] | (p[1] << 8) | (p[2] << 16);
+    return (v ^ 0x800000) - 0x800000;   /* sign-extend 24 bits */
+}
+
+void putCode(const IntFormat& f, std::vector<uint8_t>& bytes, size_t i, int32_t code)
+{
+    if (f.format == AUDIO_FORMAT_S16) {
+        const int16_t v = static_cast<int16_t>(code);
+        std::memcpy(bytes.data() + i * 2, &v, sizeof(v));
+        return;
+    }
+    uint8_t* p = bytes.data() + i * 3;
+    p[0] = static_cast<uint8_t>(code);
+    p[1] = static_cast<uint8_t>(code >> 8);
+    p[2] = static_cast<uint8_t>(code >> 16);
+}
+
+/* The documented float → int mapping, without dither */
+int32_t referenceCode(const IntFormat& f, float x)
+{
+    if (std::isnan(x)) {
+        return f.minCode;
+    }
+    double y = static_cast<double>(x) * f.scale;
+    y = std::min<double>(std::max<double>(y, f.minCode), f.maxCode);
+    return static_cast<int32_t>(std::nearbyint(y));   /* ties to even */
+}
+
+/* Every code → float → code, over all lengths of the tail too */
+void testRoundTrip(const IntFormat& f)
+{
+    const size_t count = static_cast<size_t>(f.maxCode - f.minCode) + 1;
+    const size_t bps = bytesPerSample(f.format);
+    std::vector<uint8_t> in(count * bps), out(count * bps);
+    for (size_t i = 0; i < count; ++i) {
+        putCode(f, in, i, f.minCode + static_cast<int32_t>(i));
+    }
+    std::vector<float> pcm(count);
+    decode(f.format, in.data(), pcm.data(), count);
+    encode(f.format, pcm.data(), out.data(), count, nullptr);
+
+    bool exact = true;
+    for (size_t i = 0; i < count && exact; ++i) {
+        exact = pcm[i] == static_cast<float>(f.minCode + static_cast<int32_t>(i)) / f.scale;
+    }
+    char what[96];
+    std::snprintf(what, sizeof(what), "%s: every code decodes to code / 2^%d", f.name,
+                  f.format == AUDIO_FORMAT_S16 ? 15 : 23);
+    expect(exact, what);
+    std::snprintf(what, sizeof(what), "%s: int -> float -> int is the identity", f.name);
+    expect(in == out, what);
+}
+
+/* Rounding, clamping and NaN, in buffers of every length up to 40 */
+void testEncode(const IntFormat& f)
+{
+    const float inf = std::numeric_limits<float>::infinity();
+    const float lsb = 1.0f / f.scale;
+    std::vector<float> values = {
+        0.0f, -0.0f, 1.0f, -1.0f, 1.0f - lsb, -1.0f + lsb, 1.5f, -1.5f, 1e30f, -1e30f, inf, -inf,
+        std::numeric_limits<float>::quiet_NaN(),
+        0.5f * lsb, -0.5f * lsb, 1.5f * lsb, -1.5f * lsb, 2.5f * lsb, -2.5f * lsb,   /* ties */
+        0.49f * lsb, 0.51f * lsb, -0.49f * lsb, -0.51f * lsb,
+        (static_cast<float>(f.maxCode) - 0.5f) * lsb, (static_cast<float>(f.maxCode) + 0.5f) * lsb,
+    };
+    std::mt19937 rng(1234);
+    std::uniform_real_distribution<float> dist(-1.2f, 1.2f);
+    while (values.size() < 4096 + 37) {
+        values.push_back(dist(rng));
+    }
+
+    const size_t bps = bytesPerSample(f.format);
+    bool ok = true;
+    for (size_t n : { size_t(1), size_t(3), size_t(7), size_t(8), size_t(13), size_t(40), values.size() }) {
+        for (size_t start = 0; start + n <= values.size() && start < 64; start += 29) {
+            std::vector<uint8_t> out(n * bps);
+            encode(f.format, values.data() + start, out.data(), n, nullptr);
+            for (size_t i = 0; i < n; ++i) {
+                if (codeAt(f, out, i) != referenceCode(f, values[start + i])) {
+                    if (ok) {
+                        std::printf("    %s: x=%a got %d want %d\n", f.name, values[start + i],
+                                    codeAt(f, out, i), referenceCode(f, values[start + i]));
+                    }
+                    ok = false;
+                }
+            }
+        }
+    }
+    char what[96];
+    std::snprintf(what, sizeof(what), "%s: round to nearest even, clamp, NaN -> min", f.name);
+    expect(ok, what);
+
+    const float ends[] = { 1.0f, -1.0f };
+    std::vector<uint8_t> out(2 * bps);
+    encode(f.format, ends, out.data(), 2, nullptr);
+    std::snprintf(what, sizeof(what), "%s: +1.0 -> %d, -1.0 -> %d", f.name, f.maxCode, f.minCode);
+    expect(codeAt(f, out, 0) == f.maxCode && codeAt(f, out, 1) == f.minCode, what);
+}
+
+/* Dither: within 1 LSB of the plain code, triangular share of ±1 steps */
+void testDither(const IntFormat& f)
+{
+    constexpr size_t kCount = 1 << 18;
+    const size_t bps = bytesPerSample(f.format);
+    std::vector<float> pcm(kCount);
+    std::mt19937 rng(99);
+    std::uniform_int_distribution<int32_t> code(f.minCode / 2, f.maxCode / 2);
+    for (size_t i = 0; i < kCount; ++i) {
+        /* exact codes: the plain encoding is the code itself */
+        pcm[i] = static_cast<float>(code(rng)) / f.scale;
+    }
+
+    std::vector<uint8_t> plain(kCount * bps), dithered(kCount * bps);
+    encode(f.format, pcm.data(), plain.data(), kCount, nullptr);
+    Dither d;
+    seedDither(d, 7);
+    encode(f.format, pcm.data(), dithered.data(), kCount, &d);
+
+    size_t up = 0, down = 0, far = 0;
+    for (size_t i = 0; i < kCount; ++i) {
+        const int32_t diff = codeAt(f, dithered, i) - codeAt(f, plain, i);
+        up   += diff == 1 ? 1 : 0;
+        down += diff == -1 ? 1 : 0;
+        far  += diff > 1 || diff < -1 ? 1 : 0;
+    }
+    /* TPDF on (-1, 1) LSB: |d| > 0.5 with probability 1/4, half each way */
+    const double upShare = static_cast<double>(up) / kCount;
+    const double downShare = static_cast<double>(down) / kCount;
+    char what[96];
+    std::snprintf(what, sizeof(what), "%s: dither within 1 LSB (%zu beyond)", f.name, far);
+    expect(far == 0, what);
+    std::snprintf(what, sizeof(what), "%s: dither +1 / -1 shares %.3f / %.3f (~0.125)", f.name,
+                  upShare, downShare);
+    expect(std::fabs(upShare - 0.125) < 0.01 && std::fabs(downShare - 0.125) < 0.01, what);
+}
+
+/* processFrames(): same position, same dither; another position, another */
+void testDitherPosition()
+{
+    using namespace DspProcessor;
+    constexpr uint32_t kChannels = 2;
+    constexpr uint32_t kFrames = 4096;
+    std::vector<int16_t> in(kFrames * kChannels, 1000), a(in.size()), b(in.size()), c(in.size());
+    auto run = [&](std::vector<int16_t>& out, uint64_t position) {
+        const PcmView view { reinterpret_cast<const uint8_t*>(in.data()),
+                             reinterpret_cast<uint8_t*>(out.data()), AUDIO_FORMAT_S16, kChannels, kFrames };
+        processFrames(view, 0, kFrames, 0.5f, false, true, nullptr, false, FrameMeter(), nullptr, position);
+    };
+    run(a, 0);
+    run(b, 0);
+    run(c, kFrames);
+    expect(a == b, "processFrames: dither is reproducible for one position");
+    expect(a != c, "processFrames: the next stream position gets new dither");
+}
+
+/* FLOAT32_PLANAR against the interleaved layout of the same frames */
+void testPlanar()
+{
+    using namespace DspProcessor;
+    constexpr uint32_t kChannels = 3;
+    constexpr uint32_t kFrames = 1024;
+    constexpr uint32_t kSplit = 256;
+    std::vector<float> interleaved(kFrames * kChannels), planar(interleaved.size());
+    std::mt19937 rng(5);
+    std::uniform_real_distribution<float> dist(-1.5f, 1.5f);
+    for (uint32_t f = 0; f < kFrames; ++f) {
+        for (uint32_t c = 0; c < kChannels; ++c) {
+            const float x = dist(rng);
+            interleaved[f * kChannels + c] = x;
+            planar[c * kFrames + f] = x;
+        }
+    }
+
+    AudioChainDescriptor desc;
+    std::memset(&desc, 0, sizeof(desc));
+    desc.magic = AUDIO_CHAIN_MAGIC;
+    desc.stageCount = 2;
+    desc.stages[0].type = AUDIO_STAGE_BIQUAD;
+    desc.stages[0].subtype = AUDIO_BIQUAD_LOWPASS;
+    desc.stages[0].params[0] = 2000.0f;
+    desc.stages[0].params[1] = 0.707f;
+    desc.stages[1].type = AUDIO_STAGE_GAIN_SOFTCLIP;
+    desc.stages[1].params[0] = 1.5f;
+
+    for (bool withChain : { false, true }) {
+        ProcessingChain chainI, chainP;
+        if (withChain) {
+            chainI.configure(desc, 48000, kChannels, kFrames);
+            chainP.configure(desc, 48000, kChannels, kFrames);
+        }
+        std::vector<float> outI(interleaved.size()), outP(planar.size());
+        const PcmView viewI { reinterpret_cast<const uint8_t*>(interleaved.data()),
+                              reinterpret_cast<uint8_t*>(outI.data()), AUDIO_FORMAT_FLOAT32,
+                              kChannels, kFrames };
+        const PcmView viewP { reinterpret_cast<const uint8_t*>(planar.data()),
+                              reinterpret_cast<uint8_t*>(outP.data()), AUDIO_FORMAT_FLOAT32_PLANAR,
+                              kChannels, kFrames };
+        /* Two calls each, so the chain state carries across a split. Spans
+           stay whole SIMD vectors in both layouts: a kernel's scalar tail
+           may round differently (see dsp_kernels.h) */
+        for (uint32_t offset : { 0u, kSplit }) {
+            const uint32_t count = offset == 0 ? kSplit : kFrames - kSplit;
+            processFrames(viewI, offset, count, 1.5f, false, false, withChain ? &chainI : nullptr, false);
+            processFrames(viewP, offset, count, 1.5f, false, false, withChain ? &chainP : nullptr, false);
+        }
+        bool same = true;
+        for (uint32_t f = 0; f < kFrames; ++f) {
+            for (uint32_t c = 0; c < kChannels; ++c) {
+                same = same && std::memcmp(&outI[f * kChannels + c], &outP[c * kFrames + f],
+                                           sizeof(float)) == 0;
+            }
+        }
+        expect(same, withChain ? "planar: chain output matches interleaved bit for bit"
+                               : "planar: gain + soft clip matches interleaved bit for bit");
+    }
+}
+
+} // namespace
+
+int main()
+{
+    for (const IntFormat& f : kFormats) {
+        testRoundTrip(f);
+        testEncode(f);
+        testDither(f);
+    }
+    testDitherPosition();
+    testPlanar();
+    return g_failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
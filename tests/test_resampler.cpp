@@ -0,0 +1,356 @@
+/**
+ * test_resampler.cpp — sample-rate converter length, response and streaming
+ *
+ * Checks the Resampler and the resampled session path:
+ *   - a stream of n frames yields audioSrcOutputFrames(n) frames in total,
+ *     for up- / downsampling, an interpolated-phase ratio and lengths from
+ *     1 frame up, and outputFramesFor() / flushFrames() predict every call;
+ *   - each quality preset: a tone inside the pass band keeps its level and
+ *     leaves no more than the preset's stop-band attenuation of residue
+ *     (images, aliases), and tones in the stop band of a downsampler are
+ *     attenuated by it;
+ *   - one call + flush, uneven calls + flush, and a session fed block by
+ *     block with AUDIO_FLAG_SRC_FLUSH on the last call all produce the same
+ *     samples as a one-shot request.
+ */
+
+#include "audio_native.h"
+#include "dsp_resampler.h"
+#include "dsp_session.h"
+#include "dsp_shared_memory.h"
+#include "shared_memory.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+using namespace DspProcessor;
+
+namespace {
+
+int g_failures = 0;
+
+void expect(bool ok, const char* what)
+{
+    std::printf("  %-52s %s\n", what, ok ? "ok" : "FAILED");
+    g_failures += ok ? 0 : 1;
+}
+
+struct RatePair {
+    uint32_t in;
+    uint32_t out;
+};
+
+const RatePair kRates[] = {
+    { 44100, 48000 }, { 48000, 44100 }, { 96000, 48000 }, { 8000, 44100 },
+    { 48000, 44099 },   /* more phases than kMaxExactPhases: interpolated rows */
+};
+
+std::vector<float> tone(size_t frames, uint32_t channels, double freq, uint32_t rate, double amp)
+{
+    std::vector<float> v(frames * channels);
+    for (size_t i = 0; i < frames; ++i) {
+        const double x = amp * std::sin(2.0 * M_PI * freq * static_cast<double>(i) / rate);
+        for (uint32_t c = 0; c < channels; ++c) {
+            v[i * channels + c] = static_cast<float>(c == 0 ? x : -x);
+        }
+    }
+    return v;
+}
+
+/* Whole stream through the converter in calls of the given sizes, then flush */
+std::vector<float> convert(Resampler& src, const std::vector<float>& in, uint32_t channels,
+                           const std::vector<size_t>& calls, bool* predicted = nullptr)
+{
+    const size_t frames = in.size() / channels;
+    std::vector<float> out((audioSrcOutputFrames(static_cast<uint32_t>(frames), src.inputRate(),
+                                                 src.outputRate()) + 1) * channels);
+    size_t produced = 0;
+    size_t done = 0;
+    bool exact = true;
+    for (size_t i = 0; done < frames; ++i) {
+        const size_t n = std::min(calls[i % calls.size()], frames - done);
+        const size_t want = src.outputFramesFor(n);
+        if (produced + want > out.size() / channels) {
+            exact = false;
+            break;
+        }
+        const size_t got = src.process(in.data() + done * channels, n,
+                                       out.data() + produced * channels);
+        exact = exact && got == want;
+        produced += got;
+        done += n;
+    }
+    const size_t tail = src.flushFrames();
+    if (exact && produced + tail <= out.size() / channels) {
+        const size_t got = src.flush(out.data() + produced * channels);
+        exact = got == tail;
+        produced += got;
+    }
+    if (predicted) {
+        *predicted = exact;
+    }
+    out.resize(produced * channels);
+    return out;
+}
+
+/* ------------------------------------------------------------------ */
+/*  Output length                                                       */
+/* ------------------------------------------------------------------ */
+void testLengths()
+{
+    const size_t lengths[] = { 1, 2, 7, 100, 1000, 4096, 48013 };
+    for (const RatePair& r : kRates) {
+        bool ok = true;
+        Resampler src;
+        ok = src.configure(r.in, r.out, 2, AUDIO_SRC_QUALITY_MEDIUM);
+        for (size_t n : lengths) {
+            const std::vector<float> in = tone(n, 2, 440.0, r.in, 0.5);
+            const size_t want = audioSrcOutputFrames(static_cast<uint32_t>(n), r.in, r.out);
+            ok = ok && src.outputFramesFor(n, true) == want;
+            for (const std::vector<size_t>& calls : { std::vector<size_t> { n },
+                                                      std::vector<size_t> { 1, 13, 256, 5 } }) {
+                bool predicted = false;
+                const std::vector<float> out = convert(src, in, 2, calls, &predicted);
+                ok = ok && predicted && out.size() == want * 2;
+            }
+        }
+        char what[80];
+        std::snprintf(what, sizeof(what), "length %u -> %u = audioSrcOutputFrames", r.in, r.out);
+        expect(ok, what);
+    }
+}
+
+/* ------------------------------------------------------------------ */
+/*  Frequency response                                                  */
+/* ------------------------------------------------------------------ */
+
+/* Pass-band edge of a preset, as a fraction of the lower Nyquist */
+double passEdge(uint32_t taps, double attenuationDb)
+{
+    return 1.0 - 2.0 * (attenuationDb - 7.95) / (14.36 * taps);
+}
+
+struct Preset {
+    uint32_t    quality;
+    const char* name;
+    uint32_t    taps;
+    double      attenuationDb;
+};
+
+const Preset kPresets[] = {
+    { AUDIO_SRC_QUALITY_LOW,    "low",    16,  60.0 },
+    { AUDIO_SRC_QUALITY_MEDIUM, "medium", 48,  90.0 },
+    { AUDIO_SRC_QUALITY_HIGH,   "high",   128, 120.0 },
+};
+
+/* Steady-state part of a mono conversion (filter edges cut off) */
+std::vector<double> steadyState(const Preset& p, uint32_t inRate, uint32_t outRate, double freq)
+{
+    constexpr size_t kFrames = 32768;
+    Resampler src;
+    src.configure(inRate, outRate, 1, p.quality);
+    const std::vector<float> in = tone(kFrames, 1, freq, inRate, 0.5);
+    const std::vector<float> out = convert(src, in, 1, { kFrames });
+    const size_t skip = out.size() / 8;
+    return std::vector<double>(out.begin() + skip, out.end() - skip);
+}
+
+/* Least-squares fit of a sinusoid at freq: returns amplitude, residual RMS */
+void fitTone(const std::vector<double>& y, double freq, uint32_t rate, double& amp, double& residual)
+{
+    double ss = 0.0, cc = 0.0, sc = 0.0, ys = 0.0, yc = 0.0;
+    for (size_t i = 0; i < y.size(); ++i) {
+        const double w = 2.0 * M_PI * freq * static_cast<double>(i) / rate;
+        const double s = std::sin(w), c = std::cos(w);
+        ss += s * s; cc += c * c; sc += s * c; ys += y[i] * s; yc += y[i] * c;
+    }
+    const double det = ss * cc - sc * sc;
+    const double a = (ys * cc - yc * sc) / det;
+    const double b = (yc * ss - ys * sc) / det;
+    amp = std::sqrt(a * a + b * b);
+    double err = 0.0;
+    for (size_t i = 0; i < y.size(); ++i) {
+        const double w = 2.0 * M_PI * freq * static_cast<double>(i) / rate;
+        const double e = y[i] - a * std::sin(w) - b * std::cos(w);
+        err += e * e;
+    }
+    residual = std::sqrt(err / y.size());
+}
+
+double rms(const std::vector<double>& y)
+{
+    double sum = 0.0;
+    for (double v : y) {
+        sum += v * v;
+    }
+    return std::sqrt(sum / y.size());
+}
+
+double dB(double ratio)
+{
+    return 20.0 * std::log10(std::max(ratio, 1e-12));
+}
+
+constexpr double kPassRippleDb  = 0.02;
+constexpr double kKaiserSlackDb = 3.0;
+
+void testResponse()
+{
+    const RatePair pairs[] = { { 96000, 48000 }, { 44100, 48000 }, { 48000, 44100 } };
+    for (const Preset& p : kPresets) {
+        const double edge = passEdge(p.taps, p.attenuationDb);
+        double worstGain = 0.0;
+        double worstResidue = -1000.0;
+        double worstStop = -1000.0;
+        for (const RatePair& r : pairs) {
+            const double nyquist = 0.5 * std::min(r.in, r.out);
+            /* Pass band: level and residue of tones up to 90 % of the edge */
+            for (double at : { 0.05, 0.5, 0.9 }) {
+                const double freq = at * edge * nyquist;
+                double amp = 0.0, residual = 0.0;
+                fitTone(steadyState(p, r.in, r.out, freq), freq, r.out, amp, residual);
+                const double gainDb = dB(amp / 0.5);
+                worstGain = std::fabs(gainDb) > std::fabs(worstGain) ? gainDb : worstGain;
+                worstResidue = std::max(worstResidue, dB(residual / (0.5 / std::sqrt(2.0))));
+            }
+            /* Stop band of a downsampler: whatever comes out is alias */
+            if (r.in > r.out) {
+                /* Between the output and the input Nyquist */
+                for (double at : { 0.02, 0.3, 0.9 }) {
+                    const double freq = nyquist + at * (0.5 * r.in - nyquist);
+                    const double level =
+                        rms(steadyState(p, r.in, r.out, freq)) / (0.5 / std::sqrt(2.0));
+                    worstStop = std::max(worstStop, dB(level));
+                }
+            }
+        }
+        /* "~A dB": allow kKaiserSlackDb at the first side lobe */
+        const double floorDb = -(p.attenuationDb - kKaiserSlackDb);
+        char what[96];
+        std::snprintf(what, sizeof(what), "%s: pass band %+.4f dB", p.name, worstGain);
+        expect(std::fabs(worstGain) <= kPassRippleDb, what);
+        std::snprintf(what, sizeof(what), "%s: pass-band residue %.1f dB", p.name, worstResidue);
+        expect(worstResidue <= floorDb, what);
+        std::snprintf(what, sizeof(what), "%s: stop band %.1f dB", p.name, worstStop);
+        expect(worstStop <= floorDb, what);
+    }
+}
+
+/* ------------------------------------------------------------------ */
+/*  Streaming                                                           */
+/* ------------------------------------------------------------------ */
+constexpr uint32_t kStreamChannels = 2;
+constexpr uint32_t kStreamFrames   = 9000;
+constexpr uint32_t kSessionBlock   = 1024;   /* last block is short */
+
+bool sameSamples(const std::vector<float>& a, const std::vector<float>& b)
+{
+    return a.size() == b.size() && std::memcmp(a.data(), b.data(), a.size() * sizeof(float)) == 0;
+}
+
+/* v2 float32 request converting kStreamFrames frames to r.out */
+std::vector<uint8_t> rateRegion(const RatePair& r, const std::vector<float>& in, AudioShmLayout& layout)
+{
+    const uint32_t capacity = audioSrcCapacityFrames(kStreamFrames, r.in, r.out);
+    layout = audioShmRateLayout(kStreamFrames, capacity, kStreamChannels, AUDIO_FORMAT_FLOAT32, 0, 0,
+                                AUDIO_SHM_PCM_ALIGN);
+    std::vector<uint8_t> region(layout.totalSize, 0);
+    const std::vector<uint8_t> header = HostAudio::buildFormatHeader(
+        static_cast<int>(r.in), kStreamChannels, kStreamFrames, 1.0f, 1, AUDIO_FORMAT_FLOAT32, 0,
+        r.out, AUDIO_SRC_QUALITY_MEDIUM);
+    std::memcpy(region.data(), header.data(), header.size());
+    std::memcpy(region.data() + layout.inputOffset, in.data(), in.size() * sizeof(float));
+    return region;
+}
+
+/* One-shot request: the whole stream, flushed */
+std::vector<float> oneShot(const RatePair& r, const std::vector<float>& in)
+{
+    AudioShmLayout layout;
+    std::vector<uint8_t> region = rateRegion(r, in, layout);
+    if (processMappedRegion(region.data(), region.size()).status != AUDIO_STATUS_DONE) {
+        return {};
+    }
+    AudioSharedHeader hdr;
+    std::memcpy(&hdr, region.data(), sizeof(hdr));
+    std::vector<float> out(static_cast<size_t>(hdr.outputFrames) * kStreamChannels);
+    const size_t at = layout.outputOffset
+                      + static_cast<size_t>(hdr.outputFrameOffset) * kStreamChannels * sizeof(float);
+    std::memcpy(out.data(), region.data() + at, out.size() * sizeof(float));
+    return out;
+}
+
+/* Session fed kSessionBlock frames per call, AUDIO_FLAG_SRC_FLUSH on the last */
+std::vector<float> sessionBlocks(const RatePair& r, const std::vector<float>& in)
+{
+    AudioShmLayout layout;
+    const std::vector<uint8_t> region = rateRegion(r, in, layout);
+    const int fd = HostAudio::createSharedMemory("test_resampler", region.size());
+    if (fd < 0 || !HostAudio::writeSharedMemory(fd, 0, region.data(), region.size())) {
+        HostAudio::closeSharedMemory(fd);
+        return {};
+    }
+    const int32_t id = openSession(fd, region.size());
+    std::vector<float> out;
+    for (uint32_t done = 0; id >= 0 && done < kStreamFrames; done += kSessionBlock) {
+        const uint32_t n = std::min(kSessionBlock, kStreamFrames - done);
+        if (done + n == kStreamFrames) {
+            const uint32_t flags = AUDIO_FLAG_SRC_FLUSH;
+            HostAudio::writeSharedMemory(fd, offsetof(AudioSharedHeader, flags), &flags, sizeof(flags));
+        }
+        AudioSharedHeader hdr;
+        if (processSession(id, done, n).status != AUDIO_STATUS_DONE
+            || !HostAudio::readSharedMemory(fd, 0, &hdr, sizeof(hdr))) {
+            out.clear();
+            break;
+        }
+        const size_t at = out.size();
+        out.resize(at + static_cast<size_t>(hdr.outputFrames) * kStreamChannels);
+        const size_t from = layout.outputOffset
+                            + static_cast<size_t>(hdr.outputFrameOffset) * kStreamChannels * sizeof(float);
+        HostAudio::readSharedMemory(fd, from, out.data() + at, (out.size() - at) * sizeof(float));
+    }
+    if (id >= 0) {
+        closeSession(id);
+    }
+    HostAudio::closeSharedMemory(fd);
+    return out;
+}
+
+void testStreaming()
+{
+    for (const RatePair& r : kRates) {
+        const std::vector<float> in = tone(kStreamFrames, kStreamChannels, 997.0, r.in, 0.7);
+        Resampler src;
+        src.configure(r.in, r.out, kStreamChannels, AUDIO_SRC_QUALITY_MEDIUM);
+        const std::vector<float> whole = convert(src, in, kStreamChannels, { kStreamFrames });
+        const std::vector<float> uneven = convert(src, in, kStreamChannels, { 1, 333, 2, 4096, 77 });
+        const std::vector<float> shot = oneShot(r, in);
+        const std::vector<float> session = sessionBlocks(r, in);
+
+        const size_t want = audioSrcOutputFrames(kStreamFrames, r.in, r.out) * kStreamChannels;
+        char what[80];
+        std::snprintf(what, sizeof(what), "%u -> %u: uneven calls = one call", r.in, r.out);
+        expect(whole.size() == want && sameSamples(whole, uneven), what);
+        std::snprintf(what, sizeof(what), "%u -> %u: one-shot request = one call", r.in, r.out);
+        expect(sameSamples(whole, shot), what);
+        std::snprintf(what, sizeof(what), "%u -> %u: session blocks + SRC_FLUSH = one-shot",
+                      r.in, r.out);
+        expect(sameSamples(shot, session), what);
+    }
+}
+
+} // namespace
+
+int main()
+{
+    testLengths();
+    testResponse();
+    testStreaming();
+    return g_failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
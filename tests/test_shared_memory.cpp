@@ -0,0 +1,94 @@
+/**
+ * test_shared_memory.cpp — fds DspService agrees to keep mapped
+ *
+ * Sessions and streams hold their mapping across calls, so regionFitsFd()
+ * must refuse a memfd the host could still shrink (a later access past
+ * the new end would SIGBUS the service). Checks that:
+ *   - HostApp's createSharedMemory() regions are sealed and accepted, and
+ *     ftruncate() on them fails;
+ *   - an unsealed memfd, or one sealed only against growth, is refused;
+ *   - a region larger than the fd, a pipe and a closed fd are refused.
+ */
+
+#include "dsp_shared_memory.h"
+#include "shared_memory.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+using namespace DspProcessor;
+
+namespace {
+
+constexpr size_t kSize = 64 * 1024;
+
+int g_failures = 0;
+
+void expect(bool ok, const char* what)
+{
+    std::printf("  %-52s %s\n", what, ok ? "ok" : "FAILED");
+    g_failures += ok ? 0 : 1;
+}
+
+int plainMemfd(unsigned flags)
+{
+    const int fd = memfd_create("test_shared_memory", MFD_CLOEXEC | flags);
+    if (fd >= 0 && ftruncate(fd, kSize) != 0) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+void testHostRegion()
+{
+    const int fd = HostAudio::createSharedMemory("test_shared_memory", kSize);
+    expect(fd >= 0, "createSharedMemory");
+    expect(regionFitsFd(fd, kSize), "host region accepted");
+    expect(!regionFitsFd(fd, kSize + 1), "host region: larger size refused");
+    expect(ftruncate(fd, kSize / 2) != 0, "host region: shrink fails");
+    expect(ftruncate(fd, kSize * 2) != 0, "host region: grow fails");
+    expect(regionFitsFd(fd, kSize), "host region still accepted");
+    HostAudio::closeSharedMemory(fd);
+}
+
+void testUnsealed()
+{
+    const int fd = plainMemfd(0);
+    expect(fd >= 0 && !regionFitsFd(fd, kSize), "memfd without sealing refused");
+    close(fd);
+
+    const int growOnly = plainMemfd(MFD_ALLOW_SEALING);
+    const bool sealed = growOnly >= 0 && fcntl(growOnly, F_ADD_SEALS, F_SEAL_GROW) == 0;
+    expect(sealed && !regionFitsFd(growOnly, kSize), "memfd sealed against growth only refused");
+    close(growOnly);
+
+    const int shrink = plainMemfd(MFD_ALLOW_SEALING);
+    const bool shrinkSealed = shrink >= 0 && fcntl(shrink, F_ADD_SEALS, F_SEAL_SHRINK) == 0;
+    expect(shrinkSealed && regionFitsFd(shrink, kSize), "memfd sealed against shrinking accepted");
+    close(shrink);
+}
+
+void testOtherFds()
+{
+    int fds[2];
+    if (pipe(fds) == 0) {
+        expect(!regionFitsFd(fds[0], 1), "pipe refused");
+        close(fds[0]);
+        close(fds[1]);
+    }
+    expect(!regionFitsFd(-1, 1), "negative fd refused");
+}
+
+} // namespace
+
+int main()
+{
+    testHostRegion();
+    testUnsealed();
+    testOtherFds();
+    return g_failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
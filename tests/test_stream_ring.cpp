@@ -0,0 +1,251 @@
+/**
+ * test_stream_ring.cpp — SPSC block rings of a stream region
+ *
+ * Drives AudioStream::BlockProducer / BlockConsumer from two threads over
+ * a private region and checks:
+ *   - every block arrives once, in order, with its samples and frame
+ *     count, through many wraparounds of a 4-slot ring and of the 32-bit
+ *     free-running indices; AUDIO_STREAM_BLOCK_END reaches the consumer on
+ *     the last block only;
+ *   - acquire() times out on an empty / full ring, a frame count above
+ *     blockFrames is clamped on both sides;
+ *   - closeRegion() wakes a consumer and a producer blocked without a
+ *     timeout, and a consumer still drains what was published before;
+ *   - validateRegion() refuses a short region, bad magic / version /
+ *     format and every inconsistent geometry field.
+ */
+
+#include "AudioStreamRing.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+using namespace AudioStream;
+
+namespace {
+
+constexpr uint32_t kChannels    = 2;
+constexpr uint32_t kBlockFrames = 64;
+constexpr uint32_t kBlockCount  = 4;
+
+int g_failures = 0;
+
+void expect(bool ok, const char* what)
+{
+    std::printf("  %-52s %s\n", what, ok ? "ok" : "FAILED");
+    g_failures += ok ? 0 : 1;
+}
+
+/* Region storage, 8-byte aligned for the futex words */
+struct Region {
+    std::vector<uint64_t> storage;
+    size_t                size = 0;
+    RingGeometry          geometry;
+
+    Region()
+    {
+        const StreamConfig cfg { 48000, kChannels, kBlockFrames, kBlockCount, 1.0f, 0 };
+        size = regionSize(cfg);
+        storage.assign((size + 7) / 8, 0);
+        initRegion(storage.data(), size, cfg);
+        validateRegion(storage.data(), size, &geometry);
+    }
+
+    AudioStreamHeader* hdr() { return reinterpret_cast<AudioStreamHeader*>(storage.data()); }
+};
+
+float sample(uint32_t block, uint32_t i)
+{
+    return static_cast<float>(block % 1000) + static_cast<float>(i) / 1024.0f;
+}
+
+/* Frames carried by block b: varies, never 0 */
+uint32_t framesOf(uint32_t b)
+{
+    return 1 + (b * 7) % kBlockFrames;
+}
+
+/* Two threads through the input ring, indices starting at startIndex */
+void testTransfer(uint32_t startIndex, uint32_t blocks, const char* what)
+{
+    Region region;
+    region.hdr()->inWrite.value = startIndex;
+    region.hdr()->inRead.value  = startIndex;
+
+    std::thread producer([&] {
+        BlockProducer tx(region.hdr(), region.geometry, Ring::Input);
+        for (uint32_t b = 0; b < blocks; ++b) {
+            float* pcm = tx.acquire(-1);
+            if (!pcm) {
+                return;
+            }
+            const uint32_t frames = framesOf(b);
+            for (uint32_t i = 0; i < frames * kChannels; ++i) {
+                pcm[i] = sample(b, i);
+            }
+            tx.publish(frames, b + 1 == blocks ? AUDIO_STREAM_BLOCK_END : 0);
+        }
+    });
+
+    BlockConsumer rx(region.hdr(), region.geometry, Ring::Input);
+    bool ok = true;
+    bool endSeen = false;
+    uint32_t received = 0;
+    while (!endSeen) {
+        uint32_t frames = 0;
+        uint32_t flags = 0;
+        const float* pcm = rx.acquire(2000, &frames, &flags);
+        if (!pcm) {
+            ok = false;
+            break;
+        }
+        ok = ok && frames == framesOf(received);
+        for (uint32_t i = 0; ok && i < frames * kChannels; ++i) {
+            ok = pcm[i] == sample(received, i);
+        }
+        endSeen = (flags & AUDIO_STREAM_BLOCK_END) != 0;
+        ok = ok && endSeen == (received + 1 == blocks);
+        rx.release();
+        ++received;
+    }
+    producer.join();
+    expect(ok && received == blocks && region.hdr()->inRead.value == startIndex + blocks, what);
+}
+
+void testTimeoutsAndClamp()
+{
+    Region region;
+    BlockProducer tx(region.hdr(), region.geometry, Ring::Output);
+    BlockConsumer rx(region.hdr(), region.geometry, Ring::Output);
+    uint32_t frames = 0;
+
+    expect(rx.acquire(0, &frames, nullptr) == nullptr, "consumer poll on empty ring");
+    const auto t0 = std::chrono::steady_clock::now();
+    const bool timedOut = rx.acquire(30, &frames, nullptr) == nullptr;
+    const auto waited = std::chrono::steady_clock::now() - t0;
+    expect(timedOut && waited >= std::chrono::milliseconds(25), "consumer timeout on empty ring");
+
+    for (uint32_t b = 0; b < kBlockCount; ++b) {
+        tx.acquire(0);
+        tx.publish(kBlockFrames * 4);
+    }
+    expect(tx.acquire(0) == nullptr && tx.acquire(20) == nullptr, "producer timeout on full ring");
+
+    rx.acquire(0, &frames, nullptr);
+    expect(frames == kBlockFrames, "producer clamps frames to blockFrames");
+    rx.release();
+
+    /* A peer writing the slot header directly is clamped on read as well */
+    auto* slot = reinterpret_cast<AudioStreamSlot*>(
+        reinterpret_cast<uint8_t*>(region.hdr()) + region.geometry.outputSlotsOffset
+        + region.geometry.slotStride);
+    slot->frames = 0xffffffffu;
+    rx.acquire(0, &frames, nullptr);
+    expect(frames == kBlockFrames, "consumer clamps a rewritten frame count");
+}
+
+void testClose()
+{
+    {
+        Region region;
+        const float* got = reinterpret_cast<const float*>(1);
+        std::thread waiter([&] {
+            BlockConsumer rx(region.hdr(), region.geometry, Ring::Input);
+            uint32_t frames = 0;
+            got = rx.acquire(-1, &frames, nullptr);
+        });
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        closeRegion(region.hdr());
+        waiter.join();
+        expect(got == nullptr && isClosed(region.hdr()), "close wakes a blocked consumer");
+    }
+    {
+        Region region;
+        BlockProducer tx(region.hdr(), region.geometry, Ring::Input);
+        for (uint32_t b = 0; b < kBlockCount; ++b) {
+            tx.acquire(0);
+            tx.publish(b + 1);
+        }
+        float* got = reinterpret_cast<float*>(1);
+        std::thread waiter([&] { got = tx.acquire(-1); });
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        closeRegion(region.hdr());
+        waiter.join();
+        expect(got == nullptr, "close wakes a blocked producer");
+
+        BlockConsumer rx(region.hdr(), region.geometry, Ring::Input);
+        uint32_t drained = 0;
+        uint32_t frames = 0;
+        bool inOrder = true;
+        while (rx.acquire(-1, &frames, nullptr)) {
+            inOrder = inOrder && frames == ++drained;
+            rx.release();
+        }
+        expect(drained == kBlockCount && inOrder, "consumer drains published blocks after close");
+        expect(tx.acquire(0) == nullptr, "producer refused after close");
+    }
+}
+
+template <typename Edit>
+bool acceptsAfter(Edit edit, size_t sizeDelta = 0)
+{
+    Region region;
+    edit(*region.hdr());
+    return validateRegion(region.storage.data(), region.size - sizeDelta);
+}
+
+void testValidate()
+{
+    Region region;
+    RingGeometry g;
+    expect(validateRegion(region.storage.data(), region.size, &g)
+           && g.blockCount == kBlockCount && g.channels == kChannels
+           && g.blockFrames == kBlockFrames, "valid region accepted, geometry copied");
+
+    auto same = [](AudioStreamHeader&) {};
+    expect(!acceptsAfter(same, 1), "region one byte short refused");
+    expect(!validateRegion(region.storage.data(), AUDIO_STREAM_HEADER_SIZE_V1 - 1),
+           "region shorter than a header refused");
+    expect(!validateRegion(nullptr, region.size), "null region refused");
+
+    struct Case {
+        const char* what;
+        void (*edit)(AudioStreamHeader&);
+    };
+    const Case cases[] = {
+        { "bad magic refused",                [](AudioStreamHeader& h) { h.magic ^= 1; } },
+        { "unknown version refused",          [](AudioStreamHeader& h) { h.version = 3; } },
+        { "non-float format refused",         [](AudioStreamHeader& h) { h.format += 1; } },
+        { "zero channels refused",            [](AudioStreamHeader& h) { h.channels = 0; } },
+        { "zero blockFrames refused",         [](AudioStreamHeader& h) { h.blockFrames = 0; } },
+        { "blockCount not a power of two",    [](AudioStreamHeader& h) { h.blockCount = 3; } },
+        { "blockCount zero refused",          [](AudioStreamHeader& h) { h.blockCount = 0; } },
+        { "blockCount above the maximum",
+          [](AudioStreamHeader& h) { h.blockCount = AUDIO_STREAM_MAX_BLOCKS * 2; } },
+        { "blockCount grown past the region", [](AudioStreamHeader& h) { h.blockCount *= 2; } },
+        { "channels grown past the region",   [](AudioStreamHeader& h) { h.channels *= 2; } },
+        { "slotStride mismatch refused",      [](AudioStreamHeader& h) { h.slotStride += 64; } },
+        { "inputSlotsOffset moved refused",   [](AudioStreamHeader& h) { h.inputSlotsOffset += 64; } },
+        { "outputSlotsOffset moved refused",  [](AudioStreamHeader& h) { h.outputSlotsOffset -= 64; } },
+        { "version 1 with a v2 layout refused", [](AudioStreamHeader& h) { h.version = 1; } },
+    };
+    for (const Case& c : cases) {
+        expect(!acceptsAfter(c.edit), c.what);
+    }
+}
+
+} // namespace
+
+int main()
+{
+    testTransfer(0, 20000, "two threads, 20000 blocks through 4 slots");
+    testTransfer(0xfffffff0u, 1000, "two threads across 32-bit index wraparound");
+    testTimeoutsAndClamp();
+    testClose();
+    testValidate();
+    return g_failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}